@@ -0,0 +1,614 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  batch.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_PDF_BATCH_H
+#define FAML_PDF_BATCH_H
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#include "generator.h"
+#include "font_factory.h"
+#include "docx.h"
+#include "pptx.h"
+#include "xlsx.h"
+
+namespace faml {
+	namespace pdf {
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_batch
+		 *
+		 *  The basic_batch class converts many docx/pptx/xlsx files in
+		 *  one process. The font factory and the process-wide tables
+		 *  (font metrics, CID map, glyph advances, line breaking classes)
+		 *  are built by the first job and reused by the following jobs.
+		 *  An error in a job is recorded in its result, and the rest of
+		 *  the jobs are continued.
+		 *
+		 *  If workers() is greater than 1, the jobs after the first one
+		 *  are converted by the worker processes forked from this
+		 *  process (POSIX only). The workers inherit the tables built by
+		 *  the first job, so that the tables are shared without locks.
+		 *  Threads are not used, because the tables are built lazily
+		 *  and the library has no locks.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_batch {
+		public:
+			typedef size_t size_type;
+			typedef CharT char_type;
+			typedef std::basic_string<CharT, Traits> string_type;
+			typedef faml::officex::basic_preset_geometry<CharT, Traits> preset_type;
+			
+			struct result_type {
+				string_type input;
+				string_type output;
+				bool success;
+				string_type message;	// error message (if failed)
+				double seconds;			// wall clock time
+				size_type pages;
+				size_type bytes;
+				
+				result_type() :
+					input(), output(), success(false), message(),
+					seconds(0.0), pages(0), bytes(0) {}
+			};
+			
+			basic_batch() : ff_(), presets_(), dpi_(0.0), res_(0.0), version_(1.7), workers_(1) {}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  main operator
+			 *
+			 *  Converts the input file to the output file. The converter
+			 *  is chosen by the extension of the input file. If the output
+			 *  is empty, the extension of the input is replaced by ".pdf".
+			 *
+			 *  The output is opened only after the type of the input is
+			 *  checked and the input is opened, and the output must not
+			 *  be the input file. When the job fails, the output is removed
+			 *  only if it did not exist before the job.
+			 */
+			/* ------------------------------------------------------------- */
+			result_type operator()(const string_type& input, const string_type& output = string_type()) {
+				result_type dest;
+				dest.input = input;
+				dest.output = output.empty() ? this->xoutput(input) : output;
+				
+				double start = wall_clock();
+				profile::shared().clear(); // left by the job that failed before finish()
+				bool created = false;
+				try {
+					string_type ext = this->xextension(input);
+					if (ext != LITERAL(".docx") && ext != LITERAL(".pptx") && ext != LITERAL(".xlsx")) {
+						throw std::runtime_error("unsupported file type");
+					}
+					
+					std::basic_ifstream<CharT, Traits> in(input.c_str(), std::ios_base::in | std::ios_base::binary);
+					if (!in.is_open()) throw std::runtime_error("cannot open the input file");
+					if (this->xsame(input, dest.output)) throw std::runtime_error("the output file is the input file");
+					
+					created = !this->xexists(dest.output);
+					std::basic_ofstream<CharT, Traits> out(dest.output.c_str(), std::ios_base::out | std::ios_base::binary);
+					if (!out.is_open()) {
+						created = false;
+						throw std::runtime_error("cannot open the output file");
+					}
+					
+					basic_generator<CharT, Traits> pm(out, version_);
+					if (ext == LITERAL(".docx")) {
+						basic_docx<CharT, Traits> doc(in, ff_);
+						doc.dpi(dpi_);
+						if (!doc(out, pm)) throw std::runtime_error("failed to convert the docx file");
+					}
+					else if (ext == LITERAL(".pptx")) {
+						basic_pptx<CharT, Traits> doc(in, ff_);
+						doc.dpi(dpi_);
+						doc.resolution(res_);
+						if (!presets_.empty()) doc.presets(presets_);
+						if (!doc(out, pm)) throw std::runtime_error("failed to convert the pptx file");
+					}
+					else if (ext == LITERAL(".xlsx")) {
+						basic_xlsx<CharT, Traits> doc(in, ff_);
+						doc.dpi(dpi_);
+						doc.resolution(res_);
+						if (!presets_.empty()) doc.presets(presets_);
+						if (!doc(out, pm)) throw std::runtime_error("failed to convert the xlsx file");
+					}
+					
+					pm.finish();
+					dest.pages = pm.pages().size();
+					dest.bytes = static_cast<size_type>(out.tellp());
+					dest.success = out.good();
+					if (!dest.success) dest.message = LITERAL("failed to write the output file");
+				}
+				catch (std::exception& e) {
+					dest.message = e.what();
+				}
+				dest.seconds = wall_clock() - start;
+				
+				if (!dest.success && created) std::remove(dest.output.c_str());
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  run
+			 *
+			 *  Converts each input file in [first, last), and writes the
+			 *  result of each job to dest. When the jobs are converted by
+			 *  the workers, the results are written in the order of
+			 *  completion.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class InIter, class OutIter>
+			OutIter run(InIter first, InIter last, OutIter dest) {
+				range_source<InIter> src(first, last);
+				return this->xrun(src, dest);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  run
+			 *
+			 *  Reads the input files from the stream (one path per line)
+			 *  until EOF, so that the jobs can be fed through a pipe.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutIter>
+			OutIter run(std::basic_istream<CharT, Traits>& in, OutIter dest) {
+				stream_source src(in);
+				return this->xrun(src, dest);
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  Access methods.
+			/* ------------------------------------------------------------- */
+			font_factory& font() { return ff_; }
+			preset_type& presets() { return presets_; }
+			void dpi(double value) { dpi_ = value; }
+			double dpi() const { return dpi_; }
+			void resolution(double value) { res_ = value; }
+			double resolution() const { return res_; }
+			void version(double value) { version_ = value; }
+			double version() const { return version_; }
+			void workers(size_type n) { workers_ = (n > 0) ? n : 1; }
+			size_type workers() const { return workers_; }
+			
+		private:
+			font_factory ff_;
+			preset_type presets_; // compiled once and shared by all jobs
+			double dpi_;
+			double res_;
+			double version_;
+			size_type workers_;
+			
+			/* ------------------------------------------------------------- */
+			//  range_source
+			/* ------------------------------------------------------------- */
+			template <class InIter>
+			class range_source {
+			public:
+				range_source(InIter first, InIter last) : first_(first), last_(last) {}
+				
+				bool operator()(string_type& dest) {
+					if (first_ == last_) return false;
+					dest = *first_;
+					++first_;
+					return true;
+				}
+				
+			private:
+				InIter first_;
+				InIter last_;
+			};
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  stream_source
+			 *
+			 *  Reads the input files from the stream (one path per line)
+			 *  until EOF. The empty lines are skipped.
+			 */
+			/* ------------------------------------------------------------- */
+			class stream_source {
+			public:
+				explicit stream_source(std::basic_istream<CharT, Traits>& in) : in_(in) {}
+				
+				bool operator()(string_type& dest) {
+					while (std::getline(in_, dest)) {
+						if (!dest.empty() && dest.at(dest.size() - 1) == LITERAL('\r')) dest.erase(dest.size() - 1);
+						if (!dest.empty()) return true;
+					}
+					return false;
+				}
+				
+			private:
+				std::basic_istream<CharT, Traits>& in_;
+			};
+			
+			/* ------------------------------------------------------------- */
+			//  xrun
+			/* ------------------------------------------------------------- */
+			template <class Source, class OutIter>
+			OutIter xrun(Source& src, OutIter dest) {
+				string_type path;
+#ifndef _WIN32
+				if (workers_ > 1) {
+					// The first job builds the tables that the workers inherit.
+					if (!src(path)) return dest;
+					*dest = (*this)(path);
+					++dest;
+					return this->xrun_workers(src, dest);
+				}
+#endif
+				while (src(path)) {
+					*dest = (*this)(path);
+					++dest;
+				}
+				return dest;
+			}
+			
+#ifndef _WIN32
+			/* ------------------------------------------------------------- */
+			//  worker_type
+			/* ------------------------------------------------------------- */
+			struct worker_type {
+				pid_t pid;
+				int in;				// jobs (batch -> worker)
+				int out;			// results (worker -> batch)
+				bool busy;
+				string_type job;	// the current job
+				
+				worker_type() : pid(-1), in(-1), out(-1), busy(false), job() {}
+			};
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xrun_workers
+			 *
+			 *  Sends each job to an idle worker through a pipe and
+			 *  receives the result. If a worker terminates abnormally, its
+			 *  job fails and no more jobs are sent to it. If no worker is
+			 *  available, the rest of the jobs are converted in this
+			 *  process.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class Source, class OutIter>
+			OutIter xrun_workers(Source& src, OutIter dest) {
+				void (*sigpipe)(int) = std::signal(SIGPIPE, SIG_IGN);
+				std::vector<worker_type> v;
+				for (size_type i = 0; i < workers_; ++i) {
+					worker_type w;
+					if (!this->xspawn(w, v)) break;
+					v.push_back(w);
+				}
+				
+				string_type path;
+				bool rest = true;
+				size_type busy = 0;
+				for (size_type i = 0; i < v.size() && rest; ++i) {
+					if ((rest = src(path))) busy += this->xdispatch(v.at(i), path, dest);
+				}
+				
+				std::vector<struct pollfd> fds;
+				std::vector<size_type> index;
+				while (busy > 0) {
+					fds.clear();
+					index.clear();
+					for (size_type i = 0; i < v.size(); ++i) {
+						if (!v.at(i).busy) continue;
+						struct pollfd elem;
+						elem.fd = v.at(i).out;
+						elem.events = POLLIN;
+						elem.revents = 0;
+						fds.push_back(elem);
+						index.push_back(i);
+					}
+					
+					if (::poll(&fds.at(0), fds.size(), -1) < 0) {
+						if (errno == EINTR) continue;
+						break;
+					}
+					
+					for (size_type i = 0; i < fds.size(); ++i) {
+						if (fds.at(i).revents == 0) continue;
+						worker_type& w = v.at(index.at(i));
+						result_type r;
+						if (!this->xreceive(w.out, r)) r = this->xabort(w);
+						*dest = r;
+						++dest;
+						w.busy = false;
+						--busy;
+						if (rest && w.pid > 0 && (rest = src(path))) busy += this->xdispatch(w, path, dest);
+					}
+				}
+				
+				for (size_type i = 0; i < v.size(); ++i) {
+					if (v.at(i).pid > 0) this->xclose(v.at(i));
+				}
+				std::signal(SIGPIPE, sigpipe);
+				
+				while (rest && src(path)) {
+					*dest = (*this)(path);
+					++dest;
+				}
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xspawn
+			 *
+			 *  Forks a worker. The worker converts the jobs received from
+			 *  the pipe until EOF, and exits without flushing the stdio
+			 *  buffers inherited from this process.
+			 */
+			/* ------------------------------------------------------------- */
+			bool xspawn(worker_type& dest, const std::vector<worker_type>& v) {
+				int jobs[2];
+				int results[2];
+				if (::pipe(jobs) != 0) return false;
+				if (::pipe(results) != 0) {
+					::close(jobs[0]);
+					::close(jobs[1]);
+					return false;
+				}
+				
+				pid_t pid = ::fork();
+				if (pid < 0) {
+					::close(jobs[0]);
+					::close(jobs[1]);
+					::close(results[0]);
+					::close(results[1]);
+					return false;
+				}
+				
+				if (pid == 0) {
+					::close(jobs[1]);
+					::close(results[0]);
+					for (size_type i = 0; i < v.size(); ++i) {
+						::close(v.at(i).in);
+						::close(v.at(i).out);
+					}
+					
+					int status = 0;
+					try {
+						string_type path;
+						while (this->xreceive(jobs[0], path)) {
+							if (!this->xsend(results[1], (*this)(path))) break;
+						}
+					}
+					catch (...) {
+						status = 1;
+					}
+					::_exit(status);
+				}
+				
+				::close(jobs[0]);
+				::close(results[1]);
+				dest.pid = pid;
+				dest.in = jobs[1];
+				dest.out = results[0];
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xdispatch
+			/* ------------------------------------------------------------- */
+			template <class OutIter>
+			size_type xdispatch(worker_type& w, const string_type& path, OutIter& dest) {
+				w.job = path;
+				if (this->xsend(w.in, path)) {
+					w.busy = true;
+					return 1;
+				}
+				
+				*dest = this->xabort(w);
+				++dest;
+				return 0;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xabort
+			/* ------------------------------------------------------------- */
+			result_type xabort(worker_type& w) {
+				result_type dest;
+				dest.input = w.job;
+				dest.output = this->xoutput(w.job);
+				dest.message = LITERAL("the worker process was terminated");
+				this->xclose(w);
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xclose
+			/* ------------------------------------------------------------- */
+			void xclose(worker_type& w) {
+				::close(w.in);
+				::close(w.out);
+				int status = 0;
+				while (::waitpid(w.pid, &status, 0) < 0 && errno == EINTR) {}
+				w.pid = -1;
+				w.busy = false;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xsend
+			/* ------------------------------------------------------------- */
+			bool xsend(int fd, const string_type& s) {
+				size_type n = s.size();
+				return this->xwrite(fd, &n, sizeof(n)) &&
+					this->xwrite(fd, s.data(), n * sizeof(char_type));
+			}
+			
+			bool xsend(int fd, const result_type& r) {
+				int success = r.success ? 1 : 0;
+				return this->xsend(fd, r.input) &&
+					this->xsend(fd, r.output) &&
+					this->xsend(fd, r.message) &&
+					this->xwrite(fd, &success, sizeof(success)) &&
+					this->xwrite(fd, &r.seconds, sizeof(r.seconds)) &&
+					this->xwrite(fd, &r.pages, sizeof(r.pages)) &&
+					this->xwrite(fd, &r.bytes, sizeof(r.bytes));
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xreceive
+			/* ------------------------------------------------------------- */
+			bool xreceive(int fd, string_type& s) {
+				size_type n = 0;
+				if (!this->xread(fd, &n, sizeof(n))) return false;
+				s.resize(n);
+				return n == 0 || this->xread(fd, &s.at(0), n * sizeof(char_type));
+			}
+			
+			bool xreceive(int fd, result_type& r) {
+				int success = 0;
+				if (!this->xreceive(fd, r.input) ||
+					!this->xreceive(fd, r.output) ||
+					!this->xreceive(fd, r.message) ||
+					!this->xread(fd, &success, sizeof(success)) ||
+					!this->xread(fd, &r.seconds, sizeof(r.seconds)) ||
+					!this->xread(fd, &r.pages, sizeof(r.pages)) ||
+					!this->xread(fd, &r.bytes, sizeof(r.bytes))) return false;
+				r.success = (success != 0);
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xwrite
+			/* ------------------------------------------------------------- */
+			bool xwrite(int fd, const void* p, size_type n) {
+				const char* s = static_cast<const char*>(p);
+				while (n > 0) {
+					ssize_t k = ::write(fd, s, n);
+					if (k < 0 && errno == EINTR) continue;
+					if (k <= 0) return false;
+					s += k;
+					n -= static_cast<size_type>(k);
+				}
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xread
+			/* ------------------------------------------------------------- */
+			bool xread(int fd, void* p, size_type n) {
+				char* s = static_cast<char*>(p);
+				while (n > 0) {
+					ssize_t k = ::read(fd, s, n);
+					if (k < 0 && errno == EINTR) continue;
+					if (k <= 0) return false;
+					s += k;
+					n -= static_cast<size_type>(k);
+				}
+				return true;
+			}
+#endif // _WIN32
+			
+			/* ------------------------------------------------------------- */
+			//  xextension
+			/* ------------------------------------------------------------- */
+			string_type xextension(const string_type& path) {
+				typename string_type::size_type pos = path.find_last_of(LITERAL("./\\"));
+				if (pos == string_type::npos || path.at(pos) != LITERAL('.')) return string_type();
+				string_type dest = path.substr(pos);
+				for (typename string_type::iterator it = dest.begin(); it != dest.end(); ++it) {
+					if (*it >= LITERAL('A') && *it <= LITERAL('Z')) *it = *it - LITERAL('A') + LITERAL('a');
+				}
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xexists
+			/* ------------------------------------------------------------- */
+			bool xexists(const string_type& path) {
+				struct stat st;
+				return ::stat(path.c_str(), &st) == 0;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xsame
+			 *
+			 *  Returns true if the two paths refer to the same file. The
+			 *  links (or the different spellings of the same path) are
+			 *  detected by the device and the inode number except on
+			 *  Windows.
+			 */
+			/* ------------------------------------------------------------- */
+			bool xsame(const string_type& x, const string_type& y) {
+				if (x == y) return true;
+#ifndef _WIN32
+				struct stat sx, sy;
+				if (::stat(x.c_str(), &sx) != 0 || ::stat(y.c_str(), &sy) != 0) return false;
+				return sx.st_dev == sy.st_dev && sx.st_ino == sy.st_ino;
+#else
+				return false;
+#endif
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xoutput
+			/* ------------------------------------------------------------- */
+			string_type xoutput(const string_type& path) {
+				string_type ext = this->xextension(path);
+				return path.substr(0, path.size() - ext.size()) + LITERAL(".pdf");
+			}
+		};
+		
+		typedef basic_batch<char> batch;
+	}
+}
+
+#endif // FAML_PDF_BATCH_H
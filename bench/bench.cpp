@@ -0,0 +1,250 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  bench/bench.cpp
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  bench
+ *
+ *  The conversion benchmark. Each input is generated in memory by
+ *  fixture.h (so no sample files are needed), converted to PDF into a
+ *  memory stream, and the result of each case is written to stdout as
+ *  one JSON object per line. Usage:
+ *
+ *    bench [scale [repeat [name ...]]]
+ *
+ *  scale multiplies the size of each input (default 1), repeat is the
+ *  number of runs of each case (default 3; the fastest run is reported),
+ *  and the names restrict the cases to run (docx, pptx, xlsx, text, png,
+ *  gif, jpeg, emf, wmf). Build it from this directory, e.g.:
+ *
+ *    g++ -O2 -DFAML_USE_ZLIB -I.. -I<clx> bench.cpp -o bench -lz
+ *
+ *  peak_rss_kb is the peak resident set size of the process so far, so
+ *  run one case per process when comparing the memory usage.
+ */
+/* ------------------------------------------------------------------------- */
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "fixture.h"
+#include "generator.h"
+#include "font.h"
+#include "text.h"
+#include "docx.h"
+#include "pptx.h"
+#include "xlsx.h"
+#include "png.h"
+#include "gif.h"
+#include "jpeg.h"
+#include "emf.h"
+#include "wmf.h"
+
+namespace {
+	typedef size_t size_type;
+	
+	/* --------------------------------------------------------------------- */
+	//  case_type
+	/* --------------------------------------------------------------------- */
+	struct case_type {
+		const char* name;
+		std::string (*make)(size_type n);
+		size_type size;	// size of the input at scale 1
+	};
+	
+	std::string make_docx(size_type n) { return faml::bench::docx(n); }
+	std::string make_pptx(size_type n) { return faml::bench::pptx(n); }
+	std::string make_xlsx(size_type n) { return faml::bench::xlsx(n, 12); }
+	std::string make_text(size_type n) { return faml::bench::text(n); }
+	std::string make_png(size_type n) { return faml::bench::png(n, n * 3 / 4); }
+	std::string make_gif(size_type n) { return faml::bench::gif(n, n * 3 / 4); }
+	std::string make_jpeg(size_type n) { return faml::bench::jpeg(n, n * 3 / 4); }
+	std::string make_emf(size_type n) { return faml::bench::emf(n); }
+	std::string make_wmf(size_type n) { return faml::bench::wmf(n); }
+	
+	const case_type cases[] = {
+		{ "docx", make_docx, 2000 },	// paragraphs
+		{ "pptx", make_pptx, 50 },		// slides
+		{ "xlsx", make_xlsx, 5000 },	// rows
+		{ "text", make_text, 20000 },	// lines
+		{ "png",  make_png,  1600 },	// width
+		{ "gif",  make_gif,  1600 },
+		{ "jpeg", make_jpeg, 1600 },
+		{ "emf",  make_emf,  20000 },	// polygons
+		{ "wmf",  make_wmf,  20000 }
+	};
+	
+	/* --------------------------------------------------------------------- */
+	//  now
+	/* --------------------------------------------------------------------- */
+	double now() {
+		struct timeval tv;
+		gettimeofday(&tv, NULL);
+		return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1000000.0;
+	}
+	
+	/* --------------------------------------------------------------------- */
+	//  peak_rss
+	/* --------------------------------------------------------------------- */
+	long peak_rss() {
+		struct rusage ru;
+		if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+		return ru.ru_maxrss; // KB on Linux
+	}
+	
+	/* --------------------------------------------------------------------- */
+	/*
+	 *  convert
+	 *
+	 *  Converts the input to PDF in the same way as the command line
+	 *  tools, and returns the number of written pages.
+	 */
+	/* --------------------------------------------------------------------- */
+	size_type convert(const std::string& name, std::istream& in, std::ostream& out) {
+		using namespace faml::pdf;
+		const page_property page(595, 842);
+		
+		generator pm(out);
+		bool status = false;
+		if (name == "docx") {
+			docx doc(in);
+			status = doc(out, pm);
+		}
+		else if (name == "pptx") {
+			pptx doc(in, pm.font());
+			status = doc(out, pm);
+		}
+		else if (name == "xlsx") {
+			xlsx doc(in);
+			status = doc(out, pm);
+		}
+		else if (name == "text") {
+			font f("Century", charset::win);
+			font fj("HeiseiMin-W3", charset::win);
+			text doc(in, f, fj);
+			status = doc(out, pm);
+		}
+		else if (name == "png") {
+			png doc(in, page);
+			status = doc(out, pm);
+		}
+		else if (name == "gif") {
+			gif doc(in, page);
+			status = doc(out, pm);
+		}
+		else if (name == "jpeg") {
+			jpeg doc(in, page);
+			status = doc(out, pm);
+		}
+		else if (name == "emf") {
+			emf doc(in, page);
+			status = doc(out, pm);
+		}
+		else if (name == "wmf") {
+			wmf doc(in, page);
+			status = doc(out, pm);
+		}
+		else throw std::runtime_error("unknown case: " + name);
+		
+		if (!status) throw std::runtime_error("failed to convert the " + name + " input");
+		pm.finish();
+		return pm.pages().size();
+	}
+	
+	/* --------------------------------------------------------------------- */
+	//  selected
+	/* --------------------------------------------------------------------- */
+	bool selected(const char* name, int argc, char* argv[]) {
+		if (argc <= 3) return true;
+		for (int i = 3; i < argc; ++i) {
+			if (std::strcmp(argv[i], name) == 0) return true;
+		}
+		return false;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	double scale = (argc > 1) ? std::atof(argv[1]) : 1.0;
+	int repeat = (argc > 2) ? std::atoi(argv[2]) : 3;
+	if (scale <= 0.0) scale = 1.0;
+	if (repeat <= 0) repeat = 1;
+	
+	int status = 0;
+	for (size_type i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+		const case_type& c = cases[i];
+		if (!selected(c.name, argc, argv)) continue;
+		
+		try {
+			size_type n = static_cast<size_type>(c.size * scale);
+			if (n == 0) n = 1;
+			const std::string input = c.make(n);
+			
+			double best = -1.0;
+			size_type pages = 0;
+			size_type bytes = 0;
+			for (int k = 0; k < repeat; ++k) {
+				std::istringstream in(input);
+				std::ostringstream out;
+				double start = now();
+				pages = convert(c.name, in, out);
+				double elapsed = now() - start;
+				bytes = out.str().size();
+				if (best < 0.0 || elapsed < best) best = elapsed;
+			}
+			
+			double mb = static_cast<double>(input.size()) / (1024.0 * 1024.0);
+			std::cout << "{\"name\": \"" << c.name << "\""
+				<< ", \"input_bytes\": " << input.size()
+				<< ", \"output_bytes\": " << bytes
+				<< ", \"pages\": " << pages
+				<< ", \"seconds\": " << best
+				<< ", \"pages_per_sec\": " << ((best > 0.0) ? pages / best : 0.0)
+				<< ", \"mb_per_sec\": " << ((best > 0.0) ? mb / best : 0.0)
+				<< ", \"peak_rss_kb\": " << peak_rss()
+				<< "}" << std::endl;
+		}
+		catch (std::exception& e) {
+			std::cout << "{\"name\": \"" << c.name << "\", \"error\": \"" << e.what() << "\"}" << std::endl;
+			status = 1;
+		}
+	}
+	return status;
+}
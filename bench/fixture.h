@@ -0,0 +1,858 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  bench/fixture.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_BENCH_FIXTURE_H
+#define FAML_BENCH_FIXTURE_H
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+namespace faml {
+	namespace bench {
+		typedef size_t size_type;
+		
+		namespace detail {
+			/* ------------------------------------------------------------- */
+			//  put16, put32 (little endian), put16be, put32be (big endian)
+			/* ------------------------------------------------------------- */
+			inline void put16(std::string& dest, unsigned int x) {
+				dest += static_cast<char>(x & 0xff);
+				dest += static_cast<char>((x >> 8) & 0xff);
+			}
+			
+			inline void put32(std::string& dest, unsigned long x) {
+				put16(dest, static_cast<unsigned int>(x & 0xffff));
+				put16(dest, static_cast<unsigned int>((x >> 16) & 0xffff));
+			}
+			
+			inline void put16be(std::string& dest, unsigned int x) {
+				dest += static_cast<char>((x >> 8) & 0xff);
+				dest += static_cast<char>(x & 0xff);
+			}
+			
+			inline void put32be(std::string& dest, unsigned long x) {
+				put16be(dest, static_cast<unsigned int>((x >> 16) & 0xffff));
+				put16be(dest, static_cast<unsigned int>(x & 0xffff));
+			}
+			
+			inline unsigned long crc(const std::string& s) {
+				uLong dest = crc32(0L, Z_NULL, 0);
+				return crc32(dest, reinterpret_cast<const Bytef*>(s.data()), static_cast<uInt>(s.size()));
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  deflate
+			 *
+			 *  Compresses s with zlib. The raw deflate stream (without
+			 *  the zlib header) is returned if raw is true, which is the
+			 *  format of the zip members.
+			 */
+			/* ------------------------------------------------------------- */
+			inline std::string deflate(const std::string& s, bool raw) {
+				z_stream z;
+				z.zalloc = Z_NULL;
+				z.zfree = Z_NULL;
+				z.opaque = Z_NULL;
+				if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+					raw ? -MAX_WBITS : MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+					throw std::runtime_error("deflateInit2 failed");
+				}
+				
+				std::vector<Bytef> buf(deflateBound(&z, static_cast<uLong>(s.size())));
+				z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(s.data()));
+				z.avail_in = static_cast<uInt>(s.size());
+				z.next_out = &buf[0];
+				z.avail_out = static_cast<uInt>(buf.size());
+				int status = ::deflate(&z, Z_FINISH);
+				deflateEnd(&z);
+				if (status != Z_STREAM_END) throw std::runtime_error("deflate failed");
+				return std::string(reinterpret_cast<char*>(&buf[0]), buf.size() - z.avail_out);
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  column (e.g., 0 -> "A", 26 -> "AA")
+			/* ------------------------------------------------------------- */
+			inline std::string column(size_type n) {
+				std::string dest;
+				++n;
+				while (n > 0) {
+					dest.insert(dest.begin(), static_cast<char>('A' + (n - 1) % 26));
+					n = (n - 1) / 26;
+				}
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  sentence
+			 *
+			 *  Returns the n-th line of the sample text. The latin words
+			 *  and the Japanese words (UTF-8 for OOXML, or Shift-JIS for
+			 *  the plain text) are mixed so that both of the fonts and the
+			 *  line breaking rules are used. If len is 0, the number of
+			 *  words varies with n.
+			 */
+			/* ------------------------------------------------------------- */
+			inline std::string sentence(size_type n, bool sjis = false, size_type len = 0) {
+				static const char* words[] = {
+					"The", "quick", "brown", "fox", "jumps", "over", "the", "lazy", "dog.",
+					NULL, NULL,
+					"Lorem", "ipsum", "dolor", "sit", "amet,", "consectetur", "adipiscing", "elit."
+				};
+				static const char* utf8[] = {
+					"\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae",	// nihongo no
+					"\xe6\x96\x87\xe7\xab\xa0\xe3\x81\xa7\xe3\x81\x99\xe3\x80\x82"	// bunsho desu.
+				};
+				static const char* shift_jis[] = {
+					"\x93\xfa\x96\x7b\x8c\xea\x82\xcc",
+					"\x95\xb6\x8f\xcd\x82\xc5\x82\xb7\x81\x42"
+				};
+				static const size_type size = sizeof(words) / sizeof(words[0]);
+				
+				std::ostringstream ss;
+				if (len == 0) len = 12 + n % 17;
+				for (size_type i = 0; i < len; ++i) {
+					if (i > 0) ss << ' ';
+					size_type k = (n * 7 + i) % size;
+					if (words[k]) ss << words[k];
+					else ss << (sjis ? shift_jis : utf8)[k - 9];
+				}
+				return ss.str();
+			}
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  zip_writer
+		 *
+		 *  The zip_writer class builds a zip archive (deflated members,
+		 *  no data descriptors) in memory, which is the container of
+		 *  the OOXML documents.
+		 */
+		/* ----------------------------------------------------------------- */
+		class zip_writer {
+		public:
+			zip_writer() : data_(), dir_(), n_(0) {}
+			
+			void add(const std::string& path, const std::string& s) {
+				std::string z = detail::deflate(s, true);
+				unsigned long crc = detail::crc(s);
+				unsigned long offset = static_cast<unsigned long>(data_.size());
+				
+				detail::put32(data_, 0x04034b50);
+				detail::put16(data_, 20);			// version needed to extract
+				detail::put16(data_, 0);			// flags
+				detail::put16(data_, 8);			// deflated
+				detail::put16(data_, 0);			// time
+				detail::put16(data_, 0x21);			// date (1980-01-01)
+				detail::put32(data_, crc);
+				detail::put32(data_, static_cast<unsigned long>(z.size()));
+				detail::put32(data_, static_cast<unsigned long>(s.size()));
+				detail::put16(data_, static_cast<unsigned int>(path.size()));
+				detail::put16(data_, 0);			// extra field
+				data_ += path;
+				data_ += z;
+				
+				detail::put32(dir_, 0x02014b50);
+				detail::put16(dir_, 20);			// version made by
+				detail::put16(dir_, 20);			// version needed to extract
+				detail::put16(dir_, 0);
+				detail::put16(dir_, 8);
+				detail::put16(dir_, 0);
+				detail::put16(dir_, 0x21);
+				detail::put32(dir_, crc);
+				detail::put32(dir_, static_cast<unsigned long>(z.size()));
+				detail::put32(dir_, static_cast<unsigned long>(s.size()));
+				detail::put16(dir_, static_cast<unsigned int>(path.size()));
+				detail::put16(dir_, 0);				// extra field
+				detail::put16(dir_, 0);				// comment
+				detail::put16(dir_, 0);				// disk number
+				detail::put16(dir_, 0);				// internal attributes
+				detail::put32(dir_, 0);				// external attributes
+				detail::put32(dir_, offset);
+				dir_ += path;
+				++n_;
+			}
+			
+			std::string str() const {
+				std::string dest = data_ + dir_;
+				detail::put32(dest, 0x06054b50);
+				detail::put16(dest, 0);
+				detail::put16(dest, 0);
+				detail::put16(dest, static_cast<unsigned int>(n_));
+				detail::put16(dest, static_cast<unsigned int>(n_));
+				detail::put32(dest, static_cast<unsigned long>(dir_.size()));
+				detail::put32(dest, static_cast<unsigned long>(data_.size()));
+				detail::put16(dest, 0);
+				return dest;
+			}
+			
+		private:
+			std::string data_;
+			std::string dir_;
+			size_type n_;
+		};
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  png
+		 *
+		 *  Returns the w x h RGB (8 bits per channel) gradient image.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::string png(size_type w, size_type h) {
+			std::string raw;
+			raw.reserve((w * 3 + 1) * h);
+			for (size_type y = 0; y < h; ++y) {
+				raw += '\0'; // filter: none
+				for (size_type x = 0; x < w; ++x) {
+					raw += static_cast<char>(x * 255 / (w > 1 ? w - 1 : 1));
+					raw += static_cast<char>(y * 255 / (h > 1 ? h - 1 : 1));
+					raw += static_cast<char>((x + y) & 0xff);
+				}
+			}
+			
+			std::string dest("\x89PNG\r\n\x1a\n", 8);
+			std::string chunk("IHDR");
+			detail::put32be(chunk, static_cast<unsigned long>(w));
+			detail::put32be(chunk, static_cast<unsigned long>(h));
+			chunk += std::string("\x08\x02\x00\x00\x00", 5); // 8 bits, RGB
+			
+			const std::string idat = std::string("IDAT") + detail::deflate(raw, false);
+			const std::string iend("IEND");
+			const std::string* chunks[] = { &chunk, &idat, &iend };
+			for (size_type i = 0; i < 3; ++i) {
+				detail::put32be(dest, static_cast<unsigned long>(chunks[i]->size() - 4));
+				dest += *chunks[i];
+				detail::put32be(dest, detail::crc(*chunks[i]));
+			}
+			return dest;
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  gif
+		 *
+		 *  Returns the w x h image with the 256 color palette. The LZW
+		 *  codes are written uncompressed: the clear code is put every
+		 *  254 pixels so that the code size is always 9 bits.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::string gif(size_type w, size_type h) {
+			std::string dest("GIF89a");
+			detail::put16(dest, static_cast<unsigned int>(w));
+			detail::put16(dest, static_cast<unsigned int>(h));
+			dest += '\xf7'; // global color table (256 colors)
+			dest += '\0';
+			dest += '\0';
+			for (size_type i = 0; i < 256; ++i) {
+				dest += static_cast<char>(i);
+				dest += static_cast<char>(255 - i);
+				dest += static_cast<char>((i * 3) & 0xff);
+			}
+			
+			dest += ',';
+			detail::put16(dest, 0);
+			detail::put16(dest, 0);
+			detail::put16(dest, static_cast<unsigned int>(w));
+			detail::put16(dest, static_cast<unsigned int>(h));
+			dest += '\0';
+			dest += '\x08'; // LZW minimum code size
+			
+			std::string codes;
+			unsigned long bits = 0;
+			int nbits = 0;
+			size_type n = 0;
+			for (size_type i = 0; i <= w * h; ++i) {
+				unsigned int code;
+				if (i == w * h) code = 257; // end of information
+				else if (n % 254 == 0) {
+					code = 256; // clear
+					--i;
+				}
+				else code = static_cast<unsigned int>((i / w + i % w) & 0xff);
+				++n;
+				
+				bits |= static_cast<unsigned long>(code) << nbits;
+				nbits += 9;
+				while (nbits >= 8) {
+					codes += static_cast<char>(bits & 0xff);
+					bits >>= 8;
+					nbits -= 8;
+				}
+			}
+			if (nbits > 0) codes += static_cast<char>(bits & 0xff);
+			
+			for (size_type pos = 0; pos < codes.size(); pos += 255) {
+				size_type len = std::min(static_cast<size_type>(255), codes.size() - pos);
+				dest += static_cast<char>(len);
+				dest += codes.substr(pos, len);
+			}
+			dest += '\0';
+			dest += ';';
+			return dest;
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  jpeg
+		 *
+		 *  Returns the w x h gray baseline JPEG image. Each Huffman
+		 *  table has the only symbol (0), so every 8x8 block is coded
+		 *  as two bits (DC difference 0, EOB) without any encoder.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::string jpeg(size_type w, size_type h) {
+			std::string dest("\xff\xd8", 2);
+			
+			dest += std::string("\xff\xdb", 2);
+			detail::put16be(dest, 67);
+			dest += '\0';
+			dest += std::string(64, '\x01');
+			
+			dest += std::string("\xff\xc0", 2);
+			detail::put16be(dest, 11);
+			dest += '\x08';
+			detail::put16be(dest, static_cast<unsigned int>(h));
+			detail::put16be(dest, static_cast<unsigned int>(w));
+			dest += std::string("\x01\x01\x11\x00", 4);
+			
+			dest += std::string("\xff\xc4", 2);
+			detail::put16be(dest, 2 + 18 * 2);
+			for (int i = 0; i < 2; ++i) {
+				dest += static_cast<char>(i << 4); // DC (0) and AC (1) table 0
+				dest += '\x01';
+				dest += std::string(15, '\0');
+				dest += '\0';
+			}
+			
+			dest += std::string("\xff\xda", 2);
+			detail::put16be(dest, 8);
+			dest += std::string("\x01\x01\x00\x00\x3f\x00", 6);
+			
+			size_type blocks = ((w + 7) / 8) * ((h + 7) / 8);
+			size_type n = (blocks * 2 + 7) / 8;
+			dest += std::string(n, '\0');
+			size_type pad = n * 8 - blocks * 2;
+			if (pad > 0) dest[dest.size() - 1] = static_cast<char>((1 << pad) - 1);
+			
+			dest += std::string("\xff\xd9", 2);
+			return dest;
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  emf
+		 *
+		 *  Returns the enhanced metafile (640 x 480 pixels) that fills
+		 *  n polygons with a solid brush.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::string emf(size_type n) {
+			static const long w = 640;
+			static const long h = 480;
+			
+			std::string body;
+			detail::put32(body, 0x27); // EMR_CREATEBRUSHINDIRECT
+			detail::put32(body, 24);
+			detail::put32(body, 1);
+			detail::put32(body, 0); // BS_SOLID
+			detail::put32(body, 0x00336699);
+			detail::put32(body, 0);
+			
+			detail::put32(body, 0x25); // EMR_SELECTOBJECT
+			detail::put32(body, 12);
+			detail::put32(body, 1);
+			
+			for (size_type i = 0; i < n; ++i) {
+				long x = static_cast<long>((i * 37) % (w - 40));
+				long y = static_cast<long>((i * 53) % (h - 40));
+				detail::put32(body, 0x56); // EMR_POLYGON16
+				detail::put32(body, 8 + 16 + 4 + 4 * 4);
+				detail::put32(body, x);
+				detail::put32(body, y);
+				detail::put32(body, x + 40);
+				detail::put32(body, y + 40);
+				detail::put32(body, 4);
+				detail::put16(body, x);			detail::put16(body, y);
+				detail::put16(body, x + 40);	detail::put16(body, y);
+				detail::put16(body, x + 40);	detail::put16(body, y + 40);
+				detail::put16(body, x);			detail::put16(body, y + 40);
+			}
+			
+			detail::put32(body, 0x0e); // EMR_EOF
+			detail::put32(body, 20);
+			detail::put32(body, 0);
+			detail::put32(body, 16);
+			detail::put32(body, 20);
+			
+			std::string dest;
+			detail::put32(dest, 0x01); // EMR_HEADER
+			detail::put32(dest, 88);
+			detail::put32(dest, 0);
+			detail::put32(dest, 0);
+			detail::put32(dest, w - 1);
+			detail::put32(dest, h - 1);
+			detail::put32(dest, 0);					// frame (0.01 mm)
+			detail::put32(dest, 0);
+			detail::put32(dest, w * 2646 / 100);
+			detail::put32(dest, h * 2646 / 100);
+			detail::put32(dest, 0x464d4520);		// " EMF"
+			detail::put32(dest, 0x00010000);
+			detail::put32(dest, static_cast<unsigned long>(88 + body.size()));
+			detail::put32(dest, static_cast<unsigned long>(n + 4));
+			detail::put16(dest, 2);					// handles
+			detail::put16(dest, 0);
+			detail::put32(dest, 0);					// description
+			detail::put32(dest, 0);
+			detail::put32(dest, 0);					// palette entries
+			detail::put32(dest, 1024);				// device (pixels)
+			detail::put32(dest, 768);
+			detail::put32(dest, 270);				// device (mm)
+			detail::put32(dest, 203);
+			return dest + body;
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  wmf
+		 *
+		 *  Returns the placeable Windows metafile (640 x 480 units)
+		 *  that fills n polygons with a solid brush.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::string wmf(size_type n) {
+			static const unsigned int w = 640;
+			static const unsigned int h = 480;
+			
+			std::string body;
+			detail::put32(body, 7);
+			detail::put16(body, 0x02fc); // META_CREATEBRUSHINDIRECT
+			detail::put16(body, 0); // BS_SOLID
+			detail::put32(body, 0x00996633);
+			detail::put16(body, 0);
+			
+			detail::put32(body, 4);
+			detail::put16(body, 0x012d); // META_SELECTOBJECT
+			detail::put16(body, 0);
+			
+			for (size_type i = 0; i < n; ++i) {
+				unsigned int x = static_cast<unsigned int>((i * 37) % (w - 40));
+				unsigned int y = static_cast<unsigned int>((i * 53) % (h - 40));
+				detail::put32(body, 3 + 1 + 4 * 2);
+				detail::put16(body, 0x0324); // META_POLYGON
+				detail::put16(body, 4);
+				detail::put16(body, x);			detail::put16(body, y);
+				detail::put16(body, x + 40);	detail::put16(body, y);
+				detail::put16(body, x + 40);	detail::put16(body, y + 40);
+				detail::put16(body, x);			detail::put16(body, y + 40);
+			}
+			
+			detail::put32(body, 3);
+			detail::put16(body, 0x0000); // META_EOF
+			
+			std::string dest;
+			detail::put32(dest, 0x9ac6cdd7); // placeable header
+			detail::put16(dest, 0);
+			detail::put16(dest, 0);
+			detail::put16(dest, 0);
+			detail::put16(dest, w);
+			detail::put16(dest, h);
+			detail::put16(dest, 96);
+			detail::put32(dest, 0);
+			unsigned int sum = 0;
+			for (size_type i = 0; i < dest.size(); i += 2) {
+				sum ^= static_cast<unsigned char>(dest[i]) | (static_cast<unsigned char>(dest[i + 1]) << 8);
+			}
+			detail::put16(dest, sum);
+			
+			detail::put16(dest, 1);		// memory metafile
+			detail::put16(dest, 9);		// header size (words)
+			detail::put16(dest, 0x0300);
+			detail::put32(dest, static_cast<unsigned long>(9 + body.size() / 2));
+			detail::put16(dest, 1);		// objects
+			detail::put32(dest, 3 + 1 + 4 * 2);
+			detail::put16(dest, 0);
+			return dest + body;
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  text
+		 *
+		 *  Returns the plain text (Shift-JIS) of n lines.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::string text(size_type n) {
+			std::string dest;
+			for (size_type i = 0; i < n; ++i) {
+				dest += detail::sentence(i, true);
+				dest += '\n';
+			}
+			return dest;
+		}
+		
+		namespace detail {
+			static const char* xml_header = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n";
+			static const char* ns_pkg = "http://schemas.openxmlformats.org/package/2006/";
+			static const char* ns_rel = "http://schemas.openxmlformats.org/officeDocument/2006/relationships";
+			static const char* ns_main = "http://schemas.openxmlformats.org/";
+			
+			/* ------------------------------------------------------------- */
+			//  content_types
+			/* ------------------------------------------------------------- */
+			inline std::string content_types(const std::string& overrides) {
+				std::ostringstream ss;
+				ss << xml_header
+					<< "<Types xmlns=\"" << ns_pkg << "content-types\">"
+					<< "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+					<< "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+					<< "<Default Extension=\"png\" ContentType=\"image/png\"/>"
+					<< overrides << "</Types>";
+				return ss.str();
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  relationships
+			/* ------------------------------------------------------------- */
+			inline std::string relationships(const std::vector<std::pair<std::string, std::string> >& v) {
+				std::ostringstream ss;
+				ss << xml_header << "<Relationships xmlns=\"" << ns_pkg << "relationships\">";
+				for (size_type i = 0; i < v.size(); ++i) {
+					ss << "<Relationship Id=\"rId" << i + 1 << "\" Type=\"" << ns_rel << "/"
+						<< v[i].first << "\" Target=\"" << v[i].second << "\"/>";
+				}
+				ss << "</Relationships>";
+				return ss.str();
+			}
+			
+			inline std::vector<std::pair<std::string, std::string> > rels(
+				const char* type, const std::string& target) {
+				return std::vector<std::pair<std::string, std::string> >(1, std::make_pair(std::string(type), target));
+			}
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  docx
+		 *
+		 *  Returns the Word document of n paragraphs. The runs of each
+		 *  paragraph have the different properties (bold, italic,
+		 *  color, size), and a 4 x 5 table is inserted every 40
+		 *  paragraphs.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::string docx(size_type n) {
+			using namespace detail;
+			std::ostringstream body;
+			body << xml_header
+				<< "<w:document xmlns:r=\"" << ns_rel << "\" xmlns:w=\"" << ns_main << "wordprocessingml/2006/main\">"
+				<< "<w:body>";
+			for (size_type i = 0; i < n; ++i) {
+				body << "<w:p><w:pPr><w:jc w:val=\"" << ((i % 5 == 0) ? "center" : "both") << "\"/></w:pPr>";
+				for (size_type j = 0; j < 3; ++j) {
+					body << "<w:r><w:rPr>";
+					if ((i + j) % 3 == 0) body << "<w:b/>";
+					if ((i + j) % 4 == 1) body << "<w:i/>";
+					if ((i + j) % 5 == 2) body << "<w:color w:val=\"C00000\"/>";
+					body << "<w:sz w:val=\"" << 20 + 2 * ((i + j) % 4) << "\"/></w:rPr>"
+						<< "<w:t xml:space=\"preserve\">" << sentence(i * 3 + j) << " </w:t></w:r>";
+				}
+				body << "</w:p>";
+				
+				if (i % 40 == 39) {
+					body << "<w:tbl><w:tblPr><w:tblW w:w=\"0\" w:type=\"auto\"/><w:tblBorders>"
+						<< "<w:top w:val=\"single\" w:sz=\"4\" w:space=\"0\" w:color=\"000000\"/>"
+						<< "<w:left w:val=\"single\" w:sz=\"4\" w:space=\"0\" w:color=\"000000\"/>"
+						<< "<w:bottom w:val=\"single\" w:sz=\"4\" w:space=\"0\" w:color=\"000000\"/>"
+						<< "<w:right w:val=\"single\" w:sz=\"4\" w:space=\"0\" w:color=\"000000\"/>"
+						<< "<w:insideH w:val=\"single\" w:sz=\"4\" w:space=\"0\" w:color=\"000000\"/>"
+						<< "<w:insideV w:val=\"single\" w:sz=\"4\" w:space=\"0\" w:color=\"000000\"/>"
+						<< "</w:tblBorders></w:tblPr><w:tblGrid>";
+					for (size_type c = 0; c < 4; ++c) body << "<w:gridCol w:w=\"2100\"/>";
+					body << "</w:tblGrid>";
+					for (size_type r = 0; r < 5; ++r) {
+						body << "<w:tr>";
+						for (size_type c = 0; c < 4; ++c) {
+							body << "<w:tc><w:tcPr><w:tcW w:w=\"2100\" w:type=\"dxa\"/></w:tcPr>"
+								<< "<w:p><w:r><w:t>R" << r + 1 << "C" << c + 1 << "</w:t></w:r></w:p></w:tc>";
+						}
+						body << "</w:tr>";
+					}
+					body << "</w:tbl>";
+				}
+			}
+			body << "<w:sectPr><w:pgSz w:w=\"11906\" w:h=\"16838\"/>"
+				<< "<w:pgMar w:top=\"1985\" w:right=\"1701\" w:bottom=\"1701\" w:left=\"1701\""
+				<< " w:header=\"851\" w:footer=\"992\" w:gutter=\"0\"/></w:sectPr>"
+				<< "</w:body></w:document>";
+				
+			std::ostringstream styles;
+			styles << xml_header
+				<< "<w:styles xmlns:w=\"" << ns_main << "wordprocessingml/2006/main\">"
+				<< "<w:docDefaults><w:rPrDefault><w:rPr>"
+				<< "<w:rFonts w:ascii=\"Century\" w:eastAsia=\"MS Mincho\" w:hAnsi=\"Century\"/>"
+				<< "<w:sz w:val=\"21\"/></w:rPr></w:rPrDefault><w:pPrDefault/></w:docDefaults>"
+				<< "<w:style w:type=\"paragraph\" w:default=\"1\" w:styleId=\"a\"><w:name w:val=\"Normal\"/>"
+				<< "<w:pPr><w:widowControl w:val=\"0\"/><w:jc w:val=\"both\"/></w:pPr></w:style>"
+				<< "</w:styles>";
+				
+			std::string main = "application/vnd.openxmlformats-officedocument.wordprocessingml.";
+			zip_writer dest;
+			dest.add("[Content_Types].xml", content_types(
+				"<Override PartName=\"/word/document.xml\" ContentType=\"" + main + "document.main+xml\"/>"
+				"<Override PartName=\"/word/styles.xml\" ContentType=\"" + main + "styles+xml\"/>"));
+			dest.add("_rels/.rels", relationships(rels("officeDocument", "word/document.xml")));
+			dest.add("word/_rels/document.xml.rels", relationships(rels("styles", "styles.xml")));
+			dest.add("word/document.xml", body.str());
+			dest.add("word/styles.xml", styles.str());
+			return dest.str();
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  pptx
+		 *
+		 *  Returns the presentation of n slides. All slides share the
+		 *  master, the layout, and the image (ppt/media/image1.png),
+		 *  and each of them has a title, a bulleted body, and the image.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::string pptx(size_type n) {
+			using namespace detail;
+			const std::string nsdecl = std::string("xmlns:a=\"") + ns_main + "drawingml/2006/main\""
+				+ " xmlns:r=\"" + ns_rel + "\" xmlns:p=\"" + ns_main + "presentationml/2006/main\"";
+			const std::string group = "<p:nvGrpSpPr><p:cNvPr id=\"1\" name=\"\"/><p:cNvGrpSpPr/><p:nvPr/></p:nvGrpSpPr>"
+				"<p:grpSpPr><a:xfrm><a:off x=\"0\" y=\"0\"/><a:ext cx=\"0\" cy=\"0\"/>"
+				"<a:chOff x=\"0\" y=\"0\"/><a:chExt cx=\"0\" cy=\"0\"/></a:xfrm></p:grpSpPr>";
+				
+			// placeholder shapes of the master and the layout.
+			std::ostringstream ph;
+			ph << "<p:sp><p:nvSpPr><p:cNvPr id=\"2\" name=\"Title\"/><p:cNvSpPr><a:spLocks noGrp=\"1\"/></p:cNvSpPr>"
+				<< "<p:nvPr><p:ph type=\"title\"/></p:nvPr></p:nvSpPr><p:spPr><a:xfrm><a:off x=\"457200\" y=\"274638\"/>"
+				<< "<a:ext cx=\"8229600\" cy=\"1143000\"/></a:xfrm><a:prstGeom prst=\"rect\"><a:avLst/></a:prstGeom></p:spPr>"
+				<< "<p:txBody><a:bodyPr anchor=\"ctr\"/><a:lstStyle/><a:p><a:endParaRPr lang=\"en-US\"/></a:p></p:txBody></p:sp>"
+				<< "<p:sp><p:nvSpPr><p:cNvPr id=\"3\" name=\"Body\"/><p:cNvSpPr><a:spLocks noGrp=\"1\"/></p:cNvSpPr>"
+				<< "<p:nvPr><p:ph type=\"body\" idx=\"1\"/></p:nvPr></p:nvSpPr><p:spPr><a:xfrm><a:off x=\"457200\" y=\"1600200\"/>"
+				<< "<a:ext cx=\"5029200\" cy=\"4525963\"/></a:xfrm><a:prstGeom prst=\"rect\"><a:avLst/></a:prstGeom></p:spPr>"
+				<< "<p:txBody><a:bodyPr/><a:lstStyle/><a:p><a:endParaRPr lang=\"en-US\"/></a:p></p:txBody></p:sp>";
+				
+			std::ostringstream master;
+			master << xml_header << "<p:sldMaster " << nsdecl << "><p:cSld>"
+				<< "<p:bg><p:bgPr><a:solidFill><a:srgbClr val=\"FFFFFF\"/></a:solidFill><a:effectLst/></p:bgPr></p:bg>"
+				<< "<p:spTree>" << group << ph.str() << "</p:spTree></p:cSld>"
+				<< "<p:clrMap bg1=\"lt1\" tx1=\"dk1\" bg2=\"lt2\" tx2=\"dk2\" accent1=\"accent1\" accent2=\"accent2\""
+				<< " accent3=\"accent3\" accent4=\"accent4\" accent5=\"accent5\" accent6=\"accent6\""
+				<< " hlink=\"hlink\" folHlink=\"folHlink\"/>"
+				<< "<p:sldLayoutIdLst><p:sldLayoutId id=\"2147483649\" r:id=\"rId1\"/></p:sldLayoutIdLst>"
+				<< "<p:txStyles><p:titleStyle><a:lvl1pPr algn=\"ctr\"><a:defRPr sz=\"4400\">"
+				<< "<a:solidFill><a:srgbClr val=\"000000\"/></a:solidFill><a:latin typeface=\"Arial\"/></a:defRPr></a:lvl1pPr></p:titleStyle>"
+				<< "<p:bodyStyle><a:lvl1pPr marL=\"342900\" indent=\"-342900\" algn=\"l\"><a:buFont typeface=\"Arial\"/>"
+				<< "<a:buChar char=\"&#8226;\"/><a:defRPr sz=\"2800\"><a:solidFill><a:srgbClr val=\"000000\"/></a:solidFill>"
+				<< "<a:latin typeface=\"Arial\"/></a:defRPr></a:lvl1pPr>"
+				<< "<a:lvl2pPr marL=\"742950\" indent=\"-285750\" algn=\"l\"><a:buFont typeface=\"Arial\"/>"
+				<< "<a:buChar char=\"&#8211;\"/><a:defRPr sz=\"2400\"><a:solidFill><a:srgbClr val=\"000000\"/></a:solidFill>"
+				<< "<a:latin typeface=\"Arial\"/></a:defRPr></a:lvl2pPr></p:bodyStyle>"
+				<< "<p:otherStyle><a:lvl1pPr><a:defRPr sz=\"1800\"/></a:lvl1pPr></p:otherStyle></p:txStyles></p:sldMaster>";
+				
+			std::ostringstream layout;
+			layout << xml_header << "<p:sldLayout " << nsdecl << " type=\"obj\" preserve=\"1\"><p:cSld name=\"Content\">"
+				<< "<p:spTree>" << group << ph.str() << "</p:spTree></p:cSld>"
+				<< "<p:clrMapOvr><a:masterClrMapping/></p:clrMapOvr></p:sldLayout>";
+				
+			std::ostringstream pres;
+			pres << xml_header << "<p:presentation " << nsdecl << ">"
+				<< "<p:sldMasterIdLst><p:sldMasterId id=\"2147483648\" r:id=\"rId1\"/></p:sldMasterIdLst><p:sldIdLst>";
+			for (size_type i = 0; i < n; ++i) pres << "<p:sldId id=\"" << 256 + i << "\" r:id=\"rId" << i + 2 << "\"/>";
+			pres << "</p:sldIdLst><p:sldSz cx=\"9144000\" cy=\"6858000\" type=\"screen4x3\"/>"
+				<< "<p:notesSz cx=\"6858000\" cy=\"9144000\"/></p:presentation>";
+				
+			std::vector<std::pair<std::string, std::string> > prels(rels("slideMaster", "slideMasters/slideMaster1.xml"));
+			std::ostringstream overrides;
+			std::string main = "application/vnd.openxmlformats-officedocument.presentationml.";
+			overrides << "<Override PartName=\"/ppt/presentation.xml\" ContentType=\"" << main << "presentation.main+xml\"/>"
+				<< "<Override PartName=\"/ppt/slideMasters/slideMaster1.xml\" ContentType=\"" << main << "slideMaster+xml\"/>"
+				<< "<Override PartName=\"/ppt/slideLayouts/slideLayout1.xml\" ContentType=\"" << main << "slideLayout+xml\"/>";
+				
+			zip_writer dest;
+			for (size_type i = 0; i < n; ++i) {
+				std::ostringstream name;
+				name << "slide" << i + 1 << ".xml";
+				prels.push_back(std::make_pair(std::string("slide"), "slides/" + name.str()));
+				overrides << "<Override PartName=\"/ppt/slides/" << name.str() << "\" ContentType=\"" << main << "slide+xml\"/>";
+				
+				std::ostringstream slide;
+				slide << xml_header << "<p:sld " << nsdecl << "><p:cSld><p:spTree>" << group
+					<< "<p:sp><p:nvSpPr><p:cNvPr id=\"2\" name=\"Title\"/><p:cNvSpPr><a:spLocks noGrp=\"1\"/></p:cNvSpPr>"
+					<< "<p:nvPr><p:ph type=\"title\"/></p:nvPr></p:nvSpPr><p:spPr/><p:txBody><a:bodyPr/><a:lstStyle/>"
+					<< "<a:p><a:r><a:rPr lang=\"en-US\"/><a:t>Slide " << i + 1 << "</a:t></a:r></a:p></p:txBody></p:sp>"
+					<< "<p:sp><p:nvSpPr><p:cNvPr id=\"3\" name=\"Body\"/><p:cNvSpPr><a:spLocks noGrp=\"1\"/></p:cNvSpPr>"
+					<< "<p:nvPr><p:ph idx=\"1\"/></p:nvPr></p:nvSpPr><p:spPr/><p:txBody><a:bodyPr/><a:lstStyle/>";
+				for (size_type j = 0; j < 5; ++j) {
+					slide << "<a:p>" << ((j % 2) ? "<a:pPr lvl=\"1\"/>" : "")
+						<< "<a:r><a:rPr lang=\"ja-JP\"" << ((j == 0) ? " b=\"1\"" : "") << "/><a:t>"
+						<< sentence(i * 5 + j, false, 6) << "</a:t></a:r></a:p>";
+				}
+				slide << "</p:txBody></p:sp>"
+					<< "<p:pic><p:nvPicPr><p:cNvPr id=\"4\" name=\"Picture\"/><p:cNvPicPr><a:picLocks noChangeAspect=\"1\"/>"
+					<< "</p:cNvPicPr><p:nvPr/></p:nvPicPr><p:blipFill><a:blip r:embed=\"rId2\"/><a:stretch><a:fillRect/>"
+					<< "</a:stretch></p:blipFill><p:spPr><a:xfrm><a:off x=\"5715000\" y=\"1905000\"/>"
+					<< "<a:ext cx=\"2857500\" cy=\"2143125\"/></a:xfrm><a:prstGeom prst=\"rect\"><a:avLst/></a:prstGeom>"
+					<< "</p:spPr></p:pic></p:spTree></p:cSld><p:clrMapOvr><a:masterClrMapping/></p:clrMapOvr></p:sld>";
+					
+				std::vector<std::pair<std::string, std::string> > srels(rels("slideLayout", "../slideLayouts/slideLayout1.xml"));
+				srels.push_back(std::make_pair(std::string("image"), std::string("../media/image1.png")));
+				dest.add("ppt/slides/" + name.str(), slide.str());
+				dest.add("ppt/slides/_rels/" + name.str() + ".rels", relationships(srels));
+			}
+			
+			dest.add("[Content_Types].xml", content_types(overrides.str()));
+			dest.add("_rels/.rels", relationships(rels("officeDocument", "ppt/presentation.xml")));
+			dest.add("ppt/presentation.xml", pres.str());
+			dest.add("ppt/_rels/presentation.xml.rels", relationships(prels));
+			dest.add("ppt/slideMasters/slideMaster1.xml", master.str());
+			dest.add("ppt/slideMasters/_rels/slideMaster1.xml.rels",
+				relationships(rels("slideLayout", "../slideLayouts/slideLayout1.xml")));
+			dest.add("ppt/slideLayouts/slideLayout1.xml", layout.str());
+			dest.add("ppt/slideLayouts/_rels/slideLayout1.xml.rels",
+				relationships(rels("slideMaster", "../slideMasters/slideMaster1.xml")));
+			dest.add("ppt/media/image1.png", png(320, 240));
+			return dest.str();
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  xlsx
+		 *
+		 *  Returns the workbook of one worksheet with rows x cols cells.
+		 *  The first column refers to the unique shared strings, the
+		 *  second one to the repeated shared strings, and the others are
+		 *  numbers with the number formats. Two cells are merged every
+		 *  10 rows.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::string xlsx(size_type rows, size_type cols) {
+			using namespace detail;
+			static const size_type categories = 8;
+			cols = std::max(cols, static_cast<size_type>(3));
+			
+			std::ostringstream sst;
+			sst << xml_header << "<sst xmlns=\"" << ns_main << "spreadsheetml/2006/main\" count=\""
+				<< rows * 2 << "\" uniqueCount=\"" << categories + rows << "\">";
+			for (size_type i = 0; i < categories; ++i) sst << "<si><t>Category " << i + 1 << "</t></si>";
+			for (size_type i = 0; i < rows; ++i) sst << "<si><t>" << sentence(i, false, 4) << "</t></si>";
+			sst << "</sst>";
+			
+			std::ostringstream sheet;
+			sheet << xml_header << "<worksheet xmlns=\"" << ns_main << "spreadsheetml/2006/main\" xmlns:r=\"" << ns_rel << "\">"
+				<< "<dimension ref=\"A1:" << column(cols - 1) << rows << "\"/>"
+				<< "<sheetViews><sheetView workbookViewId=\"0\"/></sheetViews>"
+				<< "<sheetFormatPr defaultRowHeight=\"13.5\"/>"
+				<< "<cols><col min=\"1\" max=\"1\" width=\"24.625\" customWidth=\"1\"/>"
+				<< "<col min=\"2\" max=\"" << cols << "\" width=\"11.625\" customWidth=\"1\"/></cols><sheetData>";
+			for (size_type r = 0; r < rows; ++r) {
+				sheet << "<row r=\"" << r + 1 << "\" spans=\"1:" << cols << "\">"
+					<< "<c r=\"A" << r + 1 << "\" s=\"1\" t=\"s\"><v>" << categories + r << "</v></c>"
+					<< "<c r=\"B" << r + 1 << "\" t=\"s\"><v>" << r % categories << "</v></c>";
+				for (size_type c = 2; c < cols; ++c) {
+					sheet << "<c r=\"" << column(c) << r + 1 << "\" s=\"" << 2 + c % 2 << "\"><v>";
+					if (c % 2) sheet << static_cast<double>((r * 31 + c * 17) % 1000) / 1000.0;
+					else sheet << static_cast<double>(r * 1000 + c) * 1.25;
+					sheet << "</v></c>";
+				}
+				sheet << "</row>";
+			}
+			sheet << "</sheetData>";
+			if (rows >= 10) {
+				sheet << "<mergeCells count=\"" << rows / 10 << "\">";
+				for (size_type r = 9; r < rows; r += 10) {
+					sheet << "<mergeCell ref=\"C" << r + 1 << ":D" << r + 1 << "\"/>";
+				}
+				sheet << "</mergeCells>";
+			}
+			sheet << "<pageMargins left=\"0.7\" right=\"0.7\" top=\"0.75\" bottom=\"0.75\" header=\"0.3\" footer=\"0.3\"/>"
+				<< "</worksheet>";
+				
+			std::ostringstream styles;
+			styles << xml_header << "<styleSheet xmlns=\"" << ns_main << "spreadsheetml/2006/main\">"
+				<< "<numFmts count=\"1\"><numFmt numFmtId=\"164\" formatCode=\"#,##0.00;[Red]\\-#,##0.00\"/></numFmts>"
+				<< "<fonts count=\"2\"><font><sz val=\"11\"/><color rgb=\"FF000000\"/><name val=\"MS PGothic\"/></font>"
+				<< "<font><b/><sz val=\"11\"/><color rgb=\"FF1F497D\"/><name val=\"MS PGothic\"/></font></fonts>"
+				<< "<fills count=\"3\"><fill><patternFill patternType=\"none\"/></fill>"
+				<< "<fill><patternFill patternType=\"gray125\"/></fill>"
+				<< "<fill><patternFill patternType=\"solid\"><fgColor rgb=\"FFDCE6F1\"/><bgColor indexed=\"64\"/></patternFill></fill></fills>"
+				<< "<borders count=\"2\"><border><left/><right/><top/><bottom/><diagonal/></border>"
+				<< "<border><left style=\"thin\"><color indexed=\"64\"/></left><right style=\"thin\"><color indexed=\"64\"/></right>"
+				<< "<top style=\"thin\"><color indexed=\"64\"/></top><bottom style=\"thin\"><color indexed=\"64\"/></bottom>"
+				<< "<diagonal/></border></borders>"
+				<< "<cellStyleXfs count=\"1\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\"/></cellStyleXfs>"
+				<< "<cellXfs count=\"4\"><xf numFmtId=\"0\" fontId=\"0\" fillId=\"0\" borderId=\"0\" xfId=\"0\"/>"
+				<< "<xf numFmtId=\"0\" fontId=\"1\" fillId=\"2\" borderId=\"1\" xfId=\"0\" applyFont=\"1\" applyFill=\"1\" applyBorder=\"1\"/>"
+				<< "<xf numFmtId=\"164\" fontId=\"0\" fillId=\"0\" borderId=\"1\" xfId=\"0\" applyNumberFormat=\"1\" applyBorder=\"1\"/>"
+				<< "<xf numFmtId=\"10\" fontId=\"0\" fillId=\"0\" borderId=\"1\" xfId=\"0\" applyNumberFormat=\"1\" applyBorder=\"1\"/>"
+				<< "</cellXfs><cellStyles count=\"1\"><cellStyle name=\"Normal\" xfId=\"0\" builtinId=\"0\"/></cellStyles>"
+				<< "</styleSheet>";
+				
+			std::ostringstream book;
+			book << xml_header << "<workbook xmlns=\"" << ns_main << "spreadsheetml/2006/main\" xmlns:r=\"" << ns_rel << "\">"
+				<< "<sheets><sheet name=\"Sheet1\" sheetId=\"1\" r:id=\"rId1\"/></sheets></workbook>";
+				
+			std::vector<std::pair<std::string, std::string> > brels(rels("worksheet", "worksheets/sheet1.xml"));
+			brels.push_back(std::make_pair(std::string("sharedStrings"), std::string("sharedStrings.xml")));
+			brels.push_back(std::make_pair(std::string("styles"), std::string("styles.xml")));
+			
+			std::string main = "application/vnd.openxmlformats-officedocument.spreadsheetml.";
+			zip_writer dest;
+			dest.add("[Content_Types].xml", content_types(
+				"<Override PartName=\"/xl/workbook.xml\" ContentType=\"" + main + "sheet.main+xml\"/>"
+				"<Override PartName=\"/xl/worksheets/sheet1.xml\" ContentType=\"" + main + "worksheet+xml\"/>"
+				"<Override PartName=\"/xl/sharedStrings.xml\" ContentType=\"" + main + "sharedStrings+xml\"/>"
+				"<Override PartName=\"/xl/styles.xml\" ContentType=\"" + main + "styles+xml\"/>"));
+			dest.add("_rels/.rels", relationships(rels("officeDocument", "xl/workbook.xml")));
+			dest.add("xl/workbook.xml", book.str());
+			dest.add("xl/_rels/workbook.xml.rels", relationships(brels));
+			dest.add("xl/worksheets/sheet1.xml", sheet.str());
+			dest.add("xl/sharedStrings.xml", sst.str());
+			dest.add("xl/styles.xml", styles.str());
+			return dest.str();
+		}
+	}
+}
+
+#endif // FAML_BENCH_FIXTURE_H
@@ -35,7 +35,11 @@
 #ifndef FAML_PDF_CODE_CONVERT_H
 #define FAML_PDF_CODE_CONVERT_H
 
+#include <algorithm>
+#include <cstddef>
 #include <limits>
+#include <string>
+#include <vector>
 
 typedef unsigned char  byte_type;
 typedef unsigned short word_type;
@@ -133,6 +137,103 @@ namespace faml {
 		inline std::string win32conv(InIter first, InIter last) {
 			return code_convert(first, last, win32map);
 		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  utf8_to_utf16be
+		 *
+		 *  Converts the UTF-8 string into the UTF-16BE byte string in a
+		 *  single pass. The result is the same as the one of converting
+		 *  by babel::utf8_to_unicode and to_narrow (i.e., 0x5c is mapped
+		 *  to 0xffe5 and 0xffff is removed) except that characters out
+		 *  of BMP are written as surrogate pairs. Invalid bytes are
+		 *  skipped.
+		 *
+		 *  When runs is given, the byte offsets at which the kind of
+		 *  characters (ASCII or not: see is_ascii()) changes are added
+		 *  to runs. The first element is always 0 unless the result is
+		 *  empty.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <class Container>
+		inline std::string utf8_to_utf16be(const std::string& src, Container* runs) {
+			std::string dest;
+			dest.reserve(src.size() * 2);
+			
+			const unsigned char* p = reinterpret_cast<const unsigned char*>(src.data());
+			const unsigned char* last = p + src.size();
+			int kind = -1; // 0: ASCII, 1: others
+			while (p < last) {
+				if (*p < 0x80 && *p != 0x5c) {
+					if (runs && kind != 0) {
+						runs->push_back(dest.size());
+						kind = 0;
+					}
+					
+					// ASCII fast path: 8 bytes are checked at once.
+					while (last - p >= 8 &&
+						((p[0] | p[1] | p[2] | p[3] | p[4] | p[5] | p[6] | p[7]) & 0x80) == 0 &&
+						std::find(p, p + 8, 0x5c) == p + 8) {
+						char buf[16] = {};
+						for (int i = 0; i < 8; ++i) buf[i * 2 + 1] = static_cast<char>(p[i]);
+						dest.append(buf, sizeof(buf));
+						p += 8;
+					}
+					while (p < last && *p < 0x80 && *p != 0x5c) {
+						dest += '\0';
+						dest += static_cast<char>(*p++);
+					}
+					continue;
+				}
+				
+				unsigned long c = *p;
+				size_t n = 0;
+				if (c == 0x5c) c = 0xffe5;
+				else if (c >= 0xc2 && c <= 0xdf) { c &= 0x1f; n = 1; }
+				else if (c >= 0xe0 && c <= 0xef) { c &= 0x0f; n = 2; }
+				else if (c >= 0xf0 && c <= 0xf4) { c &= 0x07; n = 3; }
+				else {
+					++p;
+					continue;
+				}
+				
+				if (static_cast<size_t>(last - p) <= n) break;
+				size_t i = 1;
+				for (; i <= n; ++i) {
+					if ((p[i] & 0xc0) != 0x80) break;
+					c = (c << 6) | (p[i] & 0x3f);
+				}
+				if (i <= n) {
+					p += i;
+					continue;
+				}
+				p += n + 1;
+				
+				if (c == 0xffff || (c >= 0xd800 && c <= 0xdfff) || c > 0x10ffff) continue;
+				if (runs && kind != 1) {
+					runs->push_back(dest.size());
+					kind = 1;
+				}
+				if (c >= 0x10000) {
+					c -= 0x10000;
+					unsigned long high = 0xd800 | (c >> 10);
+					unsigned long low = 0xdc00 | (c & 0x3ff);
+					dest += static_cast<char>(high >> 8);
+					dest += static_cast<char>(high & 0xff);
+					dest += static_cast<char>(low >> 8);
+					dest += static_cast<char>(low & 0xff);
+				}
+				else {
+					dest += static_cast<char>(c >> 8);
+					dest += static_cast<char>(c & 0xff);
+				}
+			}
+			return dest;
+		}
+		
+		inline std::string utf8_to_utf16be(const std::string& src) {
+			return utf8_to_utf16be(src, static_cast<std::vector<size_t>*>(NULL));
+		}
 	}
 }
 
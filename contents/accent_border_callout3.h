@@ -84,7 +84,7 @@ namespace faml {
 					double oy = -this->height() / 2.0;
 					
 					// Phese 1
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -95,11 +95,11 @@ namespace faml {
 					if (this->is_stroke() && this->is_fill()) out << LITERAL("b") << std::endl;
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					// Phese 2
 					if (this->is_stroke()) {
-						if (entag_) out << LITERAL("q") << std::endl;
+						if (entag_) this->xsave(out);
 						this->setorigin(out);
 						this->setborder(out);
 						this->setbackground(out);
@@ -109,19 +109,19 @@ namespace faml {
 						out << fmt(LITERAL("%f %f l")) % (ox+this->width()*adjust_.at(7)) % (oy+this->height()*(1-adjust_.at(6))) << std::endl;
 						out << fmt(LITERAL("%f %f m")) % (ox+this->width()*adjust_.at(7)) % (oy+this->height()*(1-adjust_.at(6))) << std::endl;
 						out << LITERAL("s") << std::endl;
-						if (entag_) out << LITERAL("Q") << std::endl;
+						if (entag_) this->xrestore(out);
 					}
 					
 					// Phese 3
 					if (this->is_stroke()) {
-						if (entag_) out << LITERAL("q") << std::endl;
+						if (entag_) this->xsave(out);
 						this->setorigin(out);
 						this->setborder(out);
 						this->setbackground(out);
 						out << fmt(LITERAL("%f %f m")) % (ox+this->width()*adjust_.at(1)) % (oy+this->height()) << std::endl;
 						out << fmt(LITERAL("%f %f l")) % (ox+this->width()*adjust_.at(1)) % (oy) << std::endl;
 						out << LITERAL("s") << std::endl;
-						if (entag_) out << LITERAL("Q") << std::endl;
+						if (entag_) this->xrestore(out);
 					}
 					
 					return true;
@@ -83,7 +83,7 @@ namespace faml {
 					
 					// Phese 1
 					if (this->is_fill()) {
-						if (entag_) out << LITERAL("q") << std::endl;
+						if (entag_) this->xsave(out);
 						this->setorigin(out);
 						this->setborder(out);
 						this->setbackground(out);
@@ -92,12 +92,12 @@ namespace faml {
 						out << fmt(LITERAL("%f %f l")) % (ox+this->width()) % (oy+this->height()) << std::endl;
 						out << fmt(LITERAL("%f %f l")) % (ox+this->width()) % (oy) << std::endl;
 						out << LITERAL("f") << std::endl;
-						if (entag_) out << LITERAL("Q") << std::endl;
+						if (entag_) this->xrestore(out);
 					}
 					
 					// Phese 2
 					if (this->is_stroke()) {
-						if (entag_) out << LITERAL("q") << std::endl;
+						if (entag_) this->xsave(out);
 						this->setorigin(out);
 						this->setborder(out);
 						this->setbackground(out);
@@ -106,19 +106,19 @@ namespace faml {
 						out << fmt(LITERAL("%f %f l")) % (ox+this->width()*adjust_.at(5)) % (oy+this->height()*(1-adjust_.at(4))) << std::endl;
 						out << fmt(LITERAL("%f %f m")) % (ox+this->width()*adjust_.at(5)) % (oy+this->height()*(1-adjust_.at(4))) << std::endl;
 						out << LITERAL("s") << std::endl;
-						if (entag_) out << LITERAL("Q") << std::endl;
+						if (entag_) this->xrestore(out);
 					}
 					
 					// Phese 3
 					if (this->is_stroke()) {
-						if (entag_) out << LITERAL("q") << std::endl;
+						if (entag_) this->xsave(out);
 						this->setorigin(out);
 						this->setborder(out);
 						this->setbackground(out);
 						out << fmt(LITERAL("%f %f m")) % (ox+this->width()*adjust_.at(1)) % (oy+this->height()) << std::endl;
 						out << fmt(LITERAL("%f %f l")) % (ox+this->width()*adjust_.at(1)) % (oy) << std::endl;
 						out << LITERAL("s") << std::endl;
-						if (entag_) out << LITERAL("Q") << std::endl;
+						if (entag_) this->xrestore(out);
 					}
 					
 					return true;
@@ -70,7 +70,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke() && !this->is_fill()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -91,7 +91,7 @@ namespace faml {
 					double red = this->background().red() * this->shadow().red();
 					double green = this->background().green() * this->shadow().green();
 					double blue = this->background().blue() * this->shadow().blue();
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					if(this->width()>=this->height()) {
 						out << fmt(LITERAL("%f %f m")) % (ox+this->width()/2.0+this->height()*sh(2700)) % (oy+this->height()/2.0) << std::endl;
 						out << fmt(LITERAL("%f %f l")) % (ox+this->width()/2.0-this->height()*sh(8100)) % (oy+this->height()*sh(2700)) << std::endl;
@@ -106,7 +106,7 @@ namespace faml {
 					else out << LITERAL("s") << std::endl;
 					
 					// Phase 3
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					if(this->width()>=this->height()) {
 						out << fmt(LITERAL("%f %f m")) % (ox+this->width()/2.0+this->height()*sh(8100)) % (oy+this->height()*sh(18900)) << std::endl;
 						out << fmt(LITERAL("%f %f l")) % (ox+this->width()/2.0+this->height()*sh(8100)) % (oy+this->height()*sh(2700)) << std::endl;
@@ -122,7 +122,7 @@ namespace faml {
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
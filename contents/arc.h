@@ -81,7 +81,7 @@ namespace faml {
 					double start_angle = - 360.0 * adjust_.at(1) / 216.0;
 					double end_angle = - 360.0 * adjust_.at(0) / 216.0;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -93,7 +93,7 @@ namespace faml {
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
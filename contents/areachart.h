@@ -2,6 +2,7 @@
 #define FAML_PDF_CONTENTS_AREACHART_H
 
 #include <string>
+#include <vector>
 #include "babel/babel.h"
 #include "clx/format.h"
 #include "chart2d.h"
@@ -52,8 +53,8 @@ namespace faml {
 						out << LITERAL("s") << std::endl;
 					}
 					
+					std::vector<size_type> points;
 					for (size_type i = 0; i < this->in_->size(); ++i) {
-						double x = ox;
 						color bg;
 						if (this->palette_) bg = color(
 							detail::getcolor(i, *this->palette_, this->palette_->size() - 6));
@@ -61,12 +62,14 @@ namespace faml {
 						
 						out << LITERAL("0.5 w") << std::endl;
 						out << fmt(LITERAL("%f %f %f rg")) % bg.red() % bg.green() % bg.blue() << std::endl;
-						for (size_type j = 0; j < this->in_->at(i).size(); ++j) {
+						detail::decimate(this->in_->at(i), width, this->res_, points);
+						for (size_type k = 0; k < points.size(); ++k) {
+							size_type j = points.at(k);
 							double y = oy + this->area_.second * (this->in_->at(i).at(j) / upper);
-							if (j == 0) out << fmt(LITERAL("%f %f m")) % x % y << std::endl;
-							else out << fmt(LITERAL("%f %f l")) % x % y << std::endl;
-							x += width;
+							if (k == 0) out << fmt(LITERAL("%f %f m")) % (ox + width * j) % y << std::endl;
+							else out << fmt(LITERAL("%f %f l")) % (ox + width * j) % y << std::endl;
 						}
+						double x = ox + width * this->in_->at(i).size();
 						out << fmt(LITERAL("%f %f l")) % (x - width) % oy << std::endl;
 						out << fmt(LITERAL("%f %f l")) % ox % oy << std::endl;
 						out << LITERAL("f") << std::endl;
@@ -75,7 +75,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_fill() && !this->is_stroke()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -106,7 +106,7 @@ namespace faml {
 					double blue = this->background().blue() * this->shadow().blue();
 					
 					// Phase 3
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					out << fmt(LITERAL("%f %f m")) % (ox + x) % (oy + y) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width()) % (oy + this->height()) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width()) % oy << std::endl;
@@ -118,7 +118,7 @@ namespace faml {
 					blue = this->background().blue() * this->highlight().blue();
 					
 					// Phase 3
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					out << fmt(LITERAL("%f %f m")) % (ox + x) % (oy + delta) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width()) % oy << std::endl;
 					out << fmt(LITERAL("%f %f l")) % ox % oy << std::endl;
@@ -130,14 +130,14 @@ namespace faml {
 					blue = this->background().blue() / this->highlight().blue();
 					
 					// Phase 4
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					out << fmt(LITERAL("%f %f m")) % (ox + delta) % (oy + delta) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % ox % oy << std::endl;
 					out << fmt(LITERAL("%f %f l")) % ox % (oy + this->height()) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (ox + delta) % (oy + y) << std::endl;
 					this->draw(out, true);
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -86,7 +86,7 @@ namespace faml {
 					double delta = (this->width() < this->height()) ? this->width() * adjust_.at(2) : this->height() * adjust_.at(2);
 					double end_rad = end_angle * (PI / 180.0);
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					//out << LITERAL("q") << std::endl;
 					this->setorigin(out);
 					this->setborder(out);
@@ -100,7 +100,7 @@ namespace faml {
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					//out << LITERAL("Q") << std::endl;
 					
 					return true;
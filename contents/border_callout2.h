@@ -82,7 +82,7 @@ namespace faml {
 					double oy = -this->height() / 2.0;
 					
 					// Phese 1
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -93,11 +93,11 @@ namespace faml {
 					if (this->is_stroke() && this->is_fill()) out << LITERAL("b") << std::endl;
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					// Phese 2
 					if (this->is_stroke()) {
-						if (entag_) out << LITERAL("q") << std::endl;
+						if (entag_) this->xsave(out);
 						this->setorigin(out);
 						this->setborder(out);
 						this->setbackground(out);
@@ -106,7 +106,7 @@ namespace faml {
 						out << fmt(LITERAL("%f %f l")) % (ox+this->width()*adjust_.at(5)) % (oy+this->height()*(1-adjust_.at(4))) << std::endl;
 						out << fmt(LITERAL("%f %f m")) % (ox+this->width()*adjust_.at(5)) % (oy+this->height()*(1-adjust_.at(4))) << std::endl;
 						out << LITERAL("s") << std::endl;
-						if (entag_) out << LITERAL("Q") << std::endl;
+						if (entag_) this->xrestore(out);
 					}
 					
 					return true;
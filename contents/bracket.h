@@ -74,7 +74,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -93,7 +93,7 @@ namespace faml {
 					out << fmt(LITERAL("%f %f l")) % ox % (oy + y) << std::endl;
 					status &= detail::draw_arc(out, ox + x, oy + y, w, h, 3, true);
 					out << LITERAL("S") << std::endl;
-					if (this->entag_) out << LITERAL("Q") << std::endl;
+					if (this->entag_) this->xrestore(out);
 					
 					return status;
 				}
@@ -135,7 +135,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -154,7 +154,7 @@ namespace faml {
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width()) % (oy + y) << std::endl;
 					status &= detail::draw_arc(out, ox + x, oy + y, w, h, 1, true);
 					out << LITERAL("S") << std::endl;
-					if (this->entag_) out << LITERAL("Q") << std::endl;
+					if (this->entag_) this->xrestore(out);
 					
 					return status;
 				}
@@ -199,7 +199,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -235,7 +235,7 @@ namespace faml {
 					out << fmt(LITERAL("%f %f l")) % (ox + x) % (oy + y) << std::endl;
 					status &= detail::draw_arc(out, ox + this->width(), oy + y, w, h, 3, true);
 					out << LITERAL("S") << std::endl;
-					if (this->entag_) out << LITERAL("Q") << std::endl;
+					if (this->entag_) this->xrestore(out);
 					
 					return status;
 				}
@@ -280,7 +280,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -316,7 +316,7 @@ namespace faml {
 					out << fmt(LITERAL("%f %f l")) % (ox + x) % (oy + y) << std::endl;
 					status &= detail::draw_arc_rev(out, ox, oy + y, w, h, 4, true);
 					out << LITERAL("S") << std::endl;
-					if (this->entag_) out << LITERAL("Q") << std::endl;
+					if (this->entag_) this->xrestore(out);
 					
 					return status;
 				}
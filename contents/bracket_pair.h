@@ -76,7 +76,7 @@ namespace faml {
 					double delta = (this->width() < this->height()) ? this->width() * adjust_ : this->height() * adjust_;
 					
 					// Phase 1
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -85,10 +85,10 @@ namespace faml {
 					detail::draw_arc(out, ox+delta, oy+delta, delta, delta, 3, true);
 					out << fmt(LITERAL("%f %f m")) % (ox+delta) % (oy) << std::endl;
 					out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					// Phase 2
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -97,7 +97,7 @@ namespace faml {
 					detail::draw_arc(out, ox+this->width()-delta, oy+this->height()-delta, delta, delta, 1, true);
 					out << fmt(LITERAL("%f %f m")) % (ox+this->width()-delta) % (oy+this->height()) << std::endl;
 					out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
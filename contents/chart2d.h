@@ -4,7 +4,10 @@
 #include <algorithm>
 #include <string>
 #include <ostream>
+#include <cmath>
 #include <map>
+#include <sstream>
+#include <vector>
 #include "clx/lexical_cast.h"
 #include "clx/utf8.h"
 #include "../coordinate.h"
@@ -13,6 +16,7 @@
 #include "../font.h"
 #include "../text_helper.h"
 #include "../text_contents.h"
+#include "../shape_cache.h"
 #include "axis.h"
 #include "polygon.h"
 #include "chart_shape.h"
@@ -108,6 +112,108 @@ namespace faml {
 					
 					return dest;
 				}
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  makemark
+				 *
+				 *  Renders the marker at the origin. The marker is drawn
+				 *  at each data point by put_marker(), so a series renders
+				 *  (and allocates) the marker only once.
+				 */
+				/* --------------------------------------------------------- */
+				template <class Ch, class Tr>
+				std::basic_string<Ch, Tr> makemark(size_t id, const color& bg, const color& fg) {
+					clx::shared_ptr<basic_shape<Ch, Tr> > sh = getmark<Ch, Tr>(coordinate(0.0, 0.0), id);
+					sh->background(bg);
+					sh->border(fg);
+					
+					std::basic_ostringstream<Ch, Tr> ss;
+					(*sh)(ss);
+					return ss.str();
+				}
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  decimate
+				 *
+				 *  Selects the points of the series to be connected by the
+				 *  polyline. Points are placed at every step points, and
+				 *  the plot width is divided into the buckets of 1/res
+				 *  points. The first, minimum, maximum and last points of
+				 *  each bucket are selected, so that the peaks are kept
+				 *  and the polyline differs by at most one device pixel
+				 *  at the resolution. All points are selected if res is 0.
+				 */
+				/* --------------------------------------------------------- */
+				template <class Series>
+				inline void decimate(const Series& v, double step, double res, std::vector<size_t>& dest) {
+					dest.clear();
+					size_t n = v.size();
+					if (res <= 0.0 || step * res >= 1.0) {
+						for (size_t i = 0; i < n; ++i) dest.push_back(i);
+						return;
+					}
+					
+					size_t first = 0;
+					while (first < n) {
+						size_t bucket = static_cast<size_t>(first * step * res);
+						size_t last = first + 1;
+						while (last < n && static_cast<size_t>(last * step * res) == bucket) ++last;
+						
+						size_t lo = first;
+						size_t hi = first;
+						for (size_t i = first + 1; i < last; ++i) {
+							if (v.at(i) < v.at(lo)) lo = i;
+							if (v.at(i) > v.at(hi)) hi = i;
+						}
+						
+						size_t sel[4] = { first, std::min(lo, hi), std::max(lo, hi), last - 1 };
+						for (size_t k = 0; k < 4; ++k) {
+							if (dest.empty() || dest.back() != sel[k]) dest.push_back(sel[k]);
+						}
+						first = last;
+					}
+				}
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  mark_filter
+				 *
+				 *  The mark_filter class skips the markers that are put on
+				 *  the cell (one device pixel, i.e., 1/res points square)
+				 *  where the marker of the same series is already put. This
+				 *  is not lossless: a skipped marker is drawn up to one
+				 *  device pixel away, at the kept marker. Points are given
+				 *  in the order of x coordinate, so only the cells of the
+				 *  current column are kept.
+				 */
+				/* --------------------------------------------------------- */
+				class mark_filter {
+				public:
+					explicit mark_filter(double res) : res_(res), column_(0), cells_() {}
+					
+					bool operator()(double x, double y) {
+						if (res_ <= 0.0) return true;
+						
+						long cx = static_cast<long>(std::floor(x * res_));
+						long cy = static_cast<long>(std::floor(y * res_));
+						if (cells_.empty() || cx != column_) {
+							column_ = cx;
+							cells_.clear();
+						}
+						
+						std::vector<long>::iterator pos = std::lower_bound(cells_.begin(), cells_.end(), cy);
+						if (pos != cells_.end() && *pos == cy) return false;
+						cells_.insert(pos, cy);
+						return true;
+					}
+					
+				private:
+					double res_;
+					long column_;
+					std::vector<long> cells_;
+				};
 			}
 			
 			template <
@@ -141,7 +247,7 @@ namespace faml {
 					fgplot_(), bgplot_(),
 					fgleg_(), bgleg_(),
 					txt_(0),
-					valax_(), palette_(NULL),
+					valax_(), palette_(NULL), marks_(NULL), res_(0.0),
 					origin_(), width_(0.0), height_(0.0) {}
 				
 				explicit chart2d(const coordinate& o, double w, double h) :
@@ -153,7 +259,7 @@ namespace faml {
 					fgplot_(), bgplot_(),
 					fgleg_(), bgleg_(),
 					txt_(0),
-					valax_(), palette_(NULL),
+					valax_(), palette_(NULL), marks_(NULL), res_(0.0),
 					origin_(o), width_(w), height_(h) {}
 				
 				virtual ~chart2d() throw() {}
@@ -215,6 +321,19 @@ namespace faml {
 				void legend_area(const color& cp) { bgleg_ = cp; }
 				void value_axis(const axis_type& cp) { valax_ = cp; }
 				void palette(const palette_type& cp) { palette_ = &cp; }
+				void marks(basic_shape_cache<CharT, Traits>& cp) { marks_ = &cp; }
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  resolution
+				 *
+				 *  Sets the resolution (dots per point) of the page at which
+				 *  the dense series are decimated, i.e., the device dpi / 72.
+				 *  It is not the resolution of the embedded images. The
+				 *  value 0 (default) draws all points.
+				 */
+				/* --------------------------------------------------------- */
+				void resolution(double cp) { res_ = cp; }
 				
 				void data(const container& cp) {
 					in_ = &cp;
@@ -245,6 +364,8 @@ namespace faml {
 				color txt_;
 				axis_type valax_;
 				const palette_type* palette_;
+				basic_shape_cache<CharT, Traits>* marks_; // shares the markers as Form XObjects
+				double res_; // decimation resolution (dots per point)
 				
 				/* --------------------------------------------------------- */
 				//  put_origin
@@ -272,6 +393,27 @@ namespace faml {
 					return true;
 				}
 				
+				/* --------------------------------------------------------- */
+				/*
+				 *  put_marker
+				 *
+				 *  Paints the marker rendered by detail::makemark() at o.
+				 *  When the shape cache is given, the repeated markers are
+				 *  painted by the Form XObject.
+				 */
+				/* --------------------------------------------------------- */
+				void put_marker(ostream_type& out, const string_type& mark, const coordinate& o) {
+					if (marks_) {
+						marks_->paint(out, mark, o);
+						return;
+					}
+					
+					out << LITERAL("q") << std::endl;
+					out << fmt(LITERAL("1 0 0 1 %f %f cm")) % o.x() % o.y() << std::endl;
+					out << mark;
+					out << LITERAL("Q") << std::endl;
+				}
+				
 				/* --------------------------------------------------------- */
 				/*
 				 *  put_data
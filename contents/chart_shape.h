@@ -73,12 +73,12 @@ namespace faml {
 					double x = ox + this->width();
 					double y = oy + this->height();
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
 					
-					out << fmt(LITERAL("%f w")) % weight << std::endl;
+					this->setwidth(out, weight);
 					
 					out << fmt(LITERAL("%f %f m")) % ox % 0 << std::endl;
 					out << fmt(LITERAL("%f %f l")) % x % 0 << std::endl;
@@ -88,7 +88,7 @@ namespace faml {
 					out << fmt(LITERAL("%f %f l")) % 0 % y << std::endl;
 					out << LITERAL("S") << std::endl;
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -123,12 +123,12 @@ namespace faml {
 					double x = ox + this->width();
 					double y = oy + this->height();
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
 					
-					out << fmt(LITERAL("%f w")) % weight << std::endl;
+					this->setwidth(out, weight);
 					
 					out << fmt(LITERAL("%f %f m")) % ox % oy << std::endl;
 					out << fmt(LITERAL("%f %f l")) % x % y << std::endl;
@@ -138,7 +138,7 @@ namespace faml {
 					out << fmt(LITERAL("%f %f l")) % x % oy << std::endl;
 					out << LITERAL("S") << std::endl;
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -173,12 +173,12 @@ namespace faml {
 					double x = ox + this->width();
 					double y = oy + this->height();
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
 					
-					out << fmt(LITERAL("%f w")) % weight << std::endl;
+					this->setwidth(out, weight);
 					
 					out << fmt(LITERAL("%f %f m")) % ox % oy << std::endl;
 					out << fmt(LITERAL("%f %f l")) % x % y << std::endl;
@@ -192,7 +192,7 @@ namespace faml {
 					out << fmt(LITERAL("%f %f l")) % 0 % y << std::endl;
 					out << LITERAL("S") << std::endl;
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -347,7 +347,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke() && !this->is_fill()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -364,7 +364,7 @@ namespace faml {
 					if (this->is_stroke() && this->is_fill()) out << LITERAL("b") << std::endl;
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
-					if (this->entag_) out << LITERAL("Q") << std::endl;
+					if (this->entag_) this->xrestore(out);
 					
 					return status;
 				}
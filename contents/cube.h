@@ -75,7 +75,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_fill() && !this->is_stroke()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -108,7 +108,7 @@ namespace faml {
 					double blue = this->background().blue() * this->highlight().blue();
 					
 					// Phase 3
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					out << fmt(LITERAL("%f %f m")) % (ox + this->width() - delta) % (oy + this->height() - delta) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width() - delta) % oy << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width()) % (oy + delta) << std::endl;
@@ -117,7 +117,7 @@ namespace faml {
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -90,7 +90,7 @@ namespace faml {
 					double curve_dw_h = (this->height() - head_w + eave_w)/2.0;
 					
 					// Phase 1
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -109,23 +109,23 @@ namespace faml {
 					if (this->is_stroke() && this->is_fill()) out << LITERAL("b") << std::endl;
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					// Phase 2
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					double red = this->background().red() * this->highlight().red();
 					double green = this->background().green() * this->highlight().green();
 					double blue = this->background().blue() * this->highlight().blue();
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					detail::draw_arc_rev(out, ox, oy+this->height()-curve_up_h, curve_up_w, curve_up_h, 1);
 					out << fmt(LITERAL("%f %f l")) % (ox+this->width()) % (oy + this->height()-curve_up_h-stick_w) << std::endl;
 					detail::draw_arc(out, ox, oy+this->height()-curve_up_h-stick_w, curve_up_w, curve_up_h, 1, true);
 					if (this->is_stroke() && this->is_fill()) out << LITERAL("b") << std::endl;
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -89,7 +89,7 @@ namespace faml {
 					double curve_r_h = this->height() - head_h;
 					
 					// Phase 1
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -102,23 +102,23 @@ namespace faml {
 					if (this->is_stroke() && this->is_fill()) out << LITERAL("b") << std::endl;
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					// Phase 2
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					double red = this->background().red() * this->highlight().red();
 					double green = this->background().green() * this->highlight().green();
 					double blue = this->background().blue() * this->highlight().blue();
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					detail::draw_arc(out, ox+curve_l_w, oy+this->height(), curve_l_w, curve_l_h, 3);
 					out << fmt(LITERAL("%f %f l")) % (ox+curve_l_w+stick_w) % (oy) << std::endl;
 					detail::draw_arc_rev(out, ox+curve_l_w+stick_w, oy+this->height(), curve_l_w, curve_l_h, 3, true);
 					if (this->is_stroke() && this->is_fill()) out << LITERAL("b") << std::endl;
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
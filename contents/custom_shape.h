@@ -79,7 +79,7 @@ namespace faml {
 					if (v_ == NULL || v_->empty()) return false;
 					if (!this->is_fill() && !this->is_stroke()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					
@@ -98,7 +98,7 @@ namespace faml {
 						this->xputpath(out, v_->at(i));
 					}
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -129,8 +129,7 @@ namespace faml {
 					double x = std::cos(clx::radian(angle)) * src.distance() * h;
 					double y = std::sin(clx::radian(angle)) * src.distance() * v;
 					
-					out << fmt(LITERAL("%f %f %f rg"))
-						% src.fill().red() % src.fill().green() % src.fill().blue() << std::endl;
+					this->setfill(out, src.fill());
 						
 					for (size_type i = 0; i < v_->size(); ++i) {
 						for (size_type j = 0; j < v_->at(i).size(); ++j) {
@@ -159,14 +158,16 @@ namespace faml {
 				/* --------------------------------------------------------- */
 				template <class Container>
 				bool xputpath(ostream_type& out, const Container& src, double x = 0, double y = 0) {
-					//bool fill = src.is_fill();
-					bool fill = this->is_fill();
+					bool fill = this->is_fill() && src.is_fill();
+					bool stroke = this->is_stroke() && src.is_stroke();
 					bool closed = false;
 					for (size_type i = 0; i < src.size(); ++i) {
+						closed = false;
 						if (src.at(i).command() == 3) {
-							// close command.
+							// close command (the path may have some sub-paths).
 							closed = true;
-							break;
+							if (i + 1 < src.size()) out << LITERAL("h") << std::endl;
+							continue;
 						}
 						
 						switch (src.at(i).command()) {
@@ -184,14 +185,14 @@ namespace faml {
 						}
 					}
 					
-					if (closed) {
-					//if (true) {
-						if(this->is_stroke() && fill) out << LITERAL("b") << std::endl;
+					if (!stroke && !fill) out << LITERAL("n") << std::endl;
+					else if (closed) {
+						if(stroke && fill) out << LITERAL("b") << std::endl;
 						else if (fill) out << LITERAL("f") << std::endl;
 						else out << LITERAL("s") << std::endl;
 					}
 					else {
-						if(this->is_stroke() && fill) out << LITERAL("B") << std::endl;
+						if(stroke && fill) out << LITERAL("B") << std::endl;
 						else if (fill) out << LITERAL("F") << std::endl;
 						else out << LITERAL("S") << std::endl;
 					}
@@ -76,7 +76,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke() && !this->is_fill() && !this->is_shading()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -154,7 +154,7 @@ namespace faml {
 					t = (this->width()/2.0 - delta2/2.0) / this->width();
 					double X3 = (1-t)*(1-t)*(1-t)*x1 + 3*(1-t)*(1-t)*t*x2 + 3*(1-t)*t*t*x3 + t*t*t*x4;
 					double Y3 = (1-t)*(1-t)*(1-t)*y1 + 3*(1-t)*(1-t)*t*y2 + 3*(1-t)*t*t*y3 + t*t*t*y4;
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					out << fmt(LITERAL("%f %f m")) % (X1) % (Y1 - delta3 + delta1) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (X1) % (Y1 - delta3 + this->height()) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (X3) % (Y3 + this->height() - delta1) << std::endl;
@@ -167,7 +167,7 @@ namespace faml {
 					t = (this->width()/2.0 + delta2/2.0) / this->width();
 					double X4 = (1-t)*(1-t)*(1-t)*x1 + 3*(1-t)*(1-t)*t*x2 + 3*(1-t)*t*t*x3 + t*t*t*x4;
 					double Y4 = (1-t)*(1-t)*(1-t)*y1 + 3*(1-t)*(1-t)*t*y2 + 3*(1-t)*t*t*y3 + t*t*t*y4;
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					out << fmt(LITERAL("%f %f m")) % (X2) % (Y2 - delta3 + delta1) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (X2) % (Y2 - delta3 + this->height()) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (X4) % (Y4 + this->height() - delta1) << std::endl;
@@ -177,7 +177,7 @@ namespace faml {
 					else out << LITERAL("s") << std::endl;
 					
 					// phase5
-					out << fmt(LITERAL("%f %f %f rg")) % this->background().red() % this->background().green() % this->background().blue() << std::endl;
+					this->setfill(out, this->background());
 					out << fmt(LITERAL("%f %f m")) % (X3) % (Y3) << std::endl;
 					out << fmt(LITERAL("%f %f %f %f %f %f c"))
 							% (x2) % (y2)
@@ -192,7 +192,7 @@ namespace faml {
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
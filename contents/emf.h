@@ -18,6 +18,8 @@
 #include "clx/literal.h"
 #include "clx/format.h"
 #include "clx/utility.h"
+#include "clx/shared_ptr.h"
+#include "metafile.h"
 
 namespace faml {
 	namespace pdf {
@@ -39,8 +41,25 @@ namespace faml {
 				typedef long LONG_type;
 				typedef float FLOAT_type;
 				
-				basic_emf(istream_type& in) :
-					in_(in), origin_(), width_(0), height_(0), OffsetX_(0), OffsetY_(0),
+				explicit basic_emf(istream_type& in) :
+					buffer_(new std::vector<byte_type>()), src_(),
+					origin_(), width_(0), height_(0), OffsetX_(0), OffsetY_(0),
+					scaleh_(1.0), scalev_(1.0), rot_(0.0), flip_(0) {
+					read_metafile(in, *buffer_);
+					if (!buffer_->empty()) src_ = metafile_cursor(&(*buffer_)[0], buffer_->size());
+				}
+				
+				/* ------------------------------------------------------------- */
+				/*
+				 *  constructor
+				 *
+				 *  Parses the metafile in the memory buffer without copying
+				 *  it. The buffer must be alive until the object is used.
+				 */
+				/* ------------------------------------------------------------- */
+				basic_emf(const char_type* data, size_type n) :
+					buffer_(), src_(reinterpret_cast<const byte_type*>(data), n * sizeof(char_type)),
+					origin_(), width_(0), height_(0), OffsetX_(0), OffsetY_(0),
 					scaleh_(1.0), scalev_(1.0), rot_(0.0), flip_(0) {}
 				
 				virtual ~basic_emf() throw() {}
@@ -55,34 +74,20 @@ namespace faml {
 				/* ------------------------------------------------------------- */
 				bool read_header() {
 					
-					DWORD_type RecordType = 0;
-					xgetdata<DWORD_type>(RecordType);
+					DWORD_type RecordType = src_.u32();
 				 	if(xcompare(RecordType,(DWORD_type)0x00000001)){
 				 		
 				 		/* Enhanced Metafile Header */
-				 		DWORD_type RecordSize = 0;		xgetdata<DWORD_type>(RecordSize);
-				 		LONG_type BoundsLeft = 0;		xgetdata<LONG_type>(BoundsLeft);
-				 		LONG_type BoundsTop = 0;		xgetdata<LONG_type>(BoundsTop);
-				 		LONG_type BoundsRight = 0;		xgetdata<LONG_type>(BoundsRight);
-				 		LONG_type BoundsBottom = 0;		xgetdata<LONG_type>(BoundsBottom);
-				 		LONG_type FrameLeft = 0;		xgetdata<LONG_type>(FrameLeft);
-				 		LONG_type FrameTop = 0;			xgetdata<LONG_type>(FrameTop);
-				 		LONG_type FrameRight = 0;		xgetdata<LONG_type>(FrameRight);
-				 		LONG_type FrameBottom = 0;		xgetdata<LONG_type>(FrameBottom);
-				 		DWORD_type Signature = 0;		xgetdata<DWORD_type>(Signature);
-				 		DWORD_type Version = 0;			xgetdata<DWORD_type>(Version);
-				 		DWORD_type Size = 0;			xgetdata<DWORD_type>(Size);
-				 		DWORD_type NumOfRecords = 0;	xgetdata<DWORD_type>(NumOfRecords);
-				 		WORD_type NumOfHandles = 0;		xgetdata<WORD_type>(NumOfHandles);
-				 		WORD_type Reserved = 0;			xgetdata<WORD_type>(Reserved);
-				 		DWORD_type SizeOfDescrip = 0;	xgetdata<DWORD_type>(SizeOfDescrip);
-				 		DWORD_type OffsOfDescrip = 0;	xgetdata<DWORD_type>(OffsOfDescrip);
-				 		DWORD_type NumPalEntries = 0;	xgetdata<DWORD_type>(NumPalEntries);
-				 		LONG_type WidthDevPixels = 0;	xgetdata<LONG_type>(WidthDevPixels);
-						LONG_type HeightDevPixels = 0;	xgetdata<LONG_type>(HeightDevPixels);
-						LONG_type WidthDevMM = 0;		xgetdata<LONG_type>(WidthDevMM);
-						LONG_type HeightDevMM = 0;		xgetdata<LONG_type>(HeightDevMM);
-						int gotsize = 88;
+				 		DWORD_type RecordSize = src_.u32();
+				 		src_.skip(16);						// Bounds (left, top, right, bottom)
+				 		LONG_type FrameLeft = src_.s32();
+				 		LONG_type FrameTop = src_.s32();
+				 		LONG_type FrameRight = src_.s32();
+				 		LONG_type FrameBottom = src_.s32();
+				 		src_.skip(20);						// Signature, Version, Size, NumOfRecords, NumOfHandles, Reserved
+				 		DWORD_type SizeOfDescrip = src_.u32();
+				 		DWORD_type OffsOfDescrip = src_.u32();
+				 		src_.skip(20);						// NumPalEntries, Device (pixels), Device (millimeters)
 						
 				 		margin_Left_ = (double)(FrameLeft * 0.032);
 				 		margin_Top_ = (double)(FrameTop * 0.032);
@@ -103,14 +108,10 @@ namespace faml {
 				 		}
 				 		
 				 		/* Header Extention 1 */
-				 		DWORD_type cdPixelFormat = 0;
-				 		DWORD_type offPixelFormat = 0;
-				 		DWORD_type bOpenGL = 0;
 				 		if(HeaderSize >= 100){
-				 			xgetdata<DWORD_type>(cdPixelFormat);
-				 			xgetdata<DWORD_type>(offPixelFormat);
-				 			xgetdata<DWORD_type>(bOpenGL);
-				 			gotsize += 12;
+				 			DWORD_type cdPixelFormat = src_.u32();
+				 			DWORD_type offPixelFormat = src_.u32();
+				 			src_.skip(4);					// bOpenGL
 				 			
 				 			if((offPixelFormat >= 100) && (offPixelFormat + cdPixelFormat <= RecordSize)){
 				 				if(offPixelFormat < HeaderSize){
@@ -120,43 +121,13 @@ namespace faml {
 				 		}
 				 		
 				 		/* Header Extention 2 */
-				 		DWORD_type MicrometersX = 0;
-				 		DWORD_type MicrometersY = 0;
 				 		if(HeaderSize >= 108){
-				 			xgetdata<DWORD_type>(MicrometersX);
-				 			xgetdata<DWORD_type>(MicrometersY);
-				 			gotsize += 8;
+				 			src_.skip(8);					// MicrometersX, MicrometersY
 				 		}
 				 		
-				 		/* Description String */
-				 		for(int i=gotsize; i<(int)OffsOfDescrip; i++){
-				 			byte_type temp;
-				 			xgetdata<byte_type>(temp);
-				 			gotsize++;
-				 		}
-				 		for(int i=0; i<(int)SizeOfDescrip; i++){
-				 			WORD_type temp;
-				 			xgetdata<WORD_type>(temp);
-				 			gotsize += 2;
-				 		}
-				 		
-				 		/* Pixel Format Descriptor */
-				 		/*if(RecordSize>=100){
-				 			for(int i=gotsize; i<(int)offPixelFormat; i++){
-					 			byte_type temp;
-					 			xgetdata<byte_type>(temp);
-					 			gotsize++;
-					 		}
-					 		for(int i=0; i<(int)cdPixelFormat; i++){
-					 			WORD_type temp;
-					 			xgetdata<WORD_type>(temp);
-					 		}
-				 		}*/
-				 		for(int i=gotsize; i<(int)RecordSize; i++){
-				 			byte_type temp;
-				 			xgetdata<byte_type>(temp);
-				 			gotsize++;
-				 		}
+				 		/* Description String (and the rest of the header) */
+				 		size_type last = std::max(src_.tell(), static_cast<size_type>(OffsOfDescrip)) + SizeOfDescrip * 2;
+				 		src_.seek(std::max(last, static_cast<size_type>(RecordSize)));
 				 		
 				 	}else{
 				 		throw std::runtime_error("Exception : This file is not Enhanced Metafile Format File.\n");
@@ -206,7 +177,8 @@ namespace faml {
 			private:
 				typedef clx::basic_format<CharT, Traits> fmt;
 				
-				istream_type& in_;
+				clx::shared_ptr<std::vector<byte_type> > buffer_; // only for the stream input
+				metafile_cursor src_;
 				coordinate origin_;
 				double width_;
 				double height_;
@@ -227,7 +199,7 @@ namespace faml {
 				struct current_GDI_function {
 					DWORD_type FunctionNumber;
 					DWORD_type RecordSize;
-					std::vector<DWORD_type> Parameters;
+					record_view<DWORD_type> Parameters;
 					current_GDI_function() : FunctionNumber(0), RecordSize(0) {}
 				};
 				current_GDI_function CrFunc_;
@@ -330,15 +302,13 @@ namespace faml {
 					this->setorigin(out);
 					//out << fmt(LITERAL("%f 0 0 %f %d %d cm")) % scaleh_ % scalev_ % OffsetX_ % OffsetY_ << std::endl;
 					
-					while(!in_.fail()){
-						xgetdata<DWORD_type>(CrFunc_.FunctionNumber);
-						xgetdata<DWORD_type>(CrFunc_.RecordSize);
-					 	CrFunc_.Parameters.clear();
-						for(int i=0; i<(int)CrFunc_.RecordSize-8; i+=4){
-							DWORD_type Parameter;
-							xgetdata<DWORD_type>(Parameter);
-							CrFunc_.Parameters.push_back(Parameter);
-						}
+					// RecordSize is the number of bytes including the type and
+					// size fields (8 bytes).
+					while(src_.rest() >= 8){
+						CrFunc_.FunctionNumber = src_.u32();
+						CrFunc_.RecordSize = src_.u32();
+						size_type n = (CrFunc_.RecordSize > 8) ? (CrFunc_.RecordSize - 8 + 3) / 4 : 0;
+						CrFunc_.Parameters = src_.view<DWORD_type>(n);
 						xGDI(out);
 					}
 					
@@ -347,19 +317,6 @@ namespace faml {
 					return true;
 				}
 				
-				/* ------------------------------------------------------------- */
-				//  xgetdata
-				/* ------------------------------------------------------------- */
-				template <class InStream, class Type>
-				bool xgetdata(Type& byte_data) {
-					Type dest = 0;
-					in_.read(reinterpret_cast<char*>(&dest), sizeof(Type));
-					if (in_.gcount() < static_cast<int>(sizeof(Type))) return Type(-1);
-					byte_data = dest;
-					if (in_.fail()) return false;
-					return true;
-				}
-				
 				/* ------------------------------------------------------------- */
 				//  xcompare
 				/* ------------------------------------------------------------- */
@@ -76,7 +76,7 @@ namespace faml {
 					double delta = (this->width() < this->height()) ? this->width() * adjust_ : this->height() * adjust_;
 					
 					// Phase 1
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -86,10 +86,10 @@ namespace faml {
 					out << fmt(LITERAL("%f %f l")) % (ox) % (oy+this->height()) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (ox) % (oy) << std::endl;
 					out << LITERAL("W") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					// Phase 1
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -100,7 +100,7 @@ namespace faml {
 					if (this->is_stroke() && this->is_fill()) out << LITERAL("b") << std::endl;
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
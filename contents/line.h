@@ -72,7 +72,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					
@@ -90,7 +90,7 @@ namespace faml {
 					this->setbackground(out);
 					this->put_shape(out, ox, oy);
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -146,11 +146,9 @@ namespace faml {
 					double ox = -this->width() / 2.0 + (std::cos(clx::radian(angle)) * src.distance() * h);
 					double oy = this->height() / 2.0 - (std::sin(clx::radian(angle)) * src.distance() * v);
 					
-					out << fmt(LITERAL("%f w")) % this->weight() << std::endl;
-					out << fmt(LITERAL("%f %f %f rg"))
-						% src.fill().red() % src.fill().green() % src.fill().blue() << std::endl;
-					out << fmt(LITERAL("%f %f %f RG"))
-						% src.fill().red() % src.fill().green() % src.fill().blue() << std::endl;
+					this->setwidth(out, this->weight());
+					this->setfill(out, src.fill());
+					this->setstroke(out, src.fill());
 					this->put_shape(out, ox, oy);
 					
 					return true;
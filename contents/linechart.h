@@ -2,6 +2,7 @@
 #define FAML_PDF_CONTENTS_LINECHART_H
 
 #include <string>
+#include <vector>
 #include "babel/babel.h"
 #include "clx/format.h"
 #include "chart2d.h"
@@ -63,6 +64,7 @@ namespace faml {
 						x += width;
 					}
 					
+					std::vector<size_type> points;
 					for (size_type i = 0; i < this->in_->size(); ++i) {
 						x = ox + width / 2.0;
 						color ln;
@@ -72,7 +74,9 @@ namespace faml {
 						
 						out << LITERAL("2.0 w") << std::endl;
 						out << fmt(LITERAL("%f %f %f RG")) % ln.red() % ln.green() % ln.blue() << std::endl;
-						for (size_type j = 0; j < this->in_->at(i).size(); ++j) {
+						detail::decimate(this->in_->at(i), width, this->res_, points);
+						for (size_type k = 0; k < points.size(); ++k) {
+							size_type j = points.at(k);
 							//double y = oy + this->area_.second * (this->in_->at(i).at(j) / (upper - lower));
 							double y = 0.0;
 							if (this->valax_.type() == axis::backward) {
@@ -80,9 +84,8 @@ namespace faml {
 									* (1.0 - (this->in_->at(i).at(j) - lower) / (upper - lower));
 							}
 							else y = oy + this->area_.second * ((this->in_->at(i).at(j) - lower) / (upper - lower));
-							if (j == 0) out << fmt(LITERAL("%f %f m")) % x % y << std::endl;
-							else out << fmt(LITERAL("%f %f l")) % x % y << std::endl;
-							x += width;
+							if (k == 0) out << fmt(LITERAL("%f %f m")) % (x + width * j) % y << std::endl;
+							else out << fmt(LITERAL("%f %f l")) % (x + width * j) % y << std::endl;
 						}
 						out << LITERAL("S") << std::endl;
 					}
@@ -110,7 +113,9 @@ namespace faml {
 						if (this->palette_) ln = color(
 							detail::getcolor(i, *this->palette_, this->palette_->size() - 6));
 						else ln = color(detail::getcolor(i));
+						string_type mark = detail::makemark<CharT, Traits>(i, ln, ln);
 						
+						detail::mark_filter visible(this->res_);
 						for (size_type j = 0; j < this->in_->at(i).size(); ++j) {
 							//double y = oy + this->area_.second * (this->in_->at(i).at(j) / upper);
 							double y = 0.0;
@@ -123,10 +128,7 @@ namespace faml {
 							double w = 7.0;
 							double h = 7.0;
 							h = std::max(h - i / 7 * 2.0, 1.0);
-							shape_ptr sh = detail::getmark<CharT, Traits>(coordinate(x - w / 2.0, y - h / 2.0), i);
-							sh->background(ln);
-							sh->border(ln);
-							(*sh)(out);
+							if (visible(x, y)) this->put_marker(out, mark, coordinate(x - w / 2.0, y - h / 2.0));
 							x += width;
 						}
 						//out << LITERAL("S") << std::endl;
@@ -0,0 +1,210 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  contents/metafile.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_PDF_CONTENTS_METAFILE_H
+#define FAML_PDF_CONTENTS_METAFILE_H
+
+#include <cstddef>
+#include <ios>
+#include <istream>
+#include <iterator>
+#include <vector>
+
+namespace faml {
+	namespace pdf {
+		namespace contents {
+			/* ------------------------------------------------------------- */
+			/*
+			 *  record_view
+			 *
+			 *  The record_view class refers to the parameters of a metafile
+			 *  record as the array of little-endian values without copying
+			 *  them. Out of range elements are read as 0.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class Type>
+			class record_view {
+			public:
+				typedef Type value_type;
+				typedef size_t size_type;
+				typedef unsigned char byte_type;
+				
+				record_view() : p_(NULL), n_(0) {}
+				
+				record_view(const byte_type* p, size_type n) : p_(p), n_(n) {}
+				
+				value_type operator[](size_type i) const {
+					if (i >= n_) return value_type(0);
+					const byte_type* p = p_ + i * sizeof(Type);
+					unsigned long dest = 0;
+					for (size_type k = sizeof(Type); k > 0; --k) dest = (dest << 8) | p[k - 1];
+					return static_cast<value_type>(dest);
+				}
+				
+				size_type size() const { return n_; }
+				bool empty() const { return n_ == 0; }
+				const byte_type* data() const { return p_; }
+				
+			private:
+				const byte_type* p_;
+				size_type n_;
+			};
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  metafile_cursor
+			 *
+			 *  The metafile_cursor class reads the metafile (EMF/WMF) data
+			 *  kept in a contiguous memory. All loads are bounds-checked;
+			 *  reading past the end returns 0 and sets the fail flag.
+			 */
+			/* ------------------------------------------------------------- */
+			class metafile_cursor {
+			public:
+				typedef size_t size_type;
+				typedef unsigned char byte_type;
+				
+				metafile_cursor() : p_(NULL), n_(0), pos_(0), fail_(false) {}
+				
+				metafile_cursor(const byte_type* p, size_type n) :
+					p_(p), n_(n), pos_(0), fail_(false) {}
+				
+				unsigned int u8() { return this->xget(1); }
+				unsigned int u16() { return this->xget(2); }
+				unsigned int u32() { return this->xget(4); }
+				int s16() { return static_cast<short>(this->xget(2)); }
+				int s32() { return static_cast<int>(this->xget(4)); }
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  view
+				 *
+				 *  Returns the view of the next n values and advances the
+				 *  cursor. The view is truncated at the end of the data.
+				 */
+				/* --------------------------------------------------------- */
+				template <class Type>
+				record_view<Type> view(size_type n) {
+					if (n > this->rest() / sizeof(Type)) {
+						n = this->rest() / sizeof(Type);
+						fail_ = true;
+					}
+					record_view<Type> dest(p_ + pos_, n);
+					pos_ += n * sizeof(Type);
+					return dest;
+				}
+				
+				bool skip(size_type n) {
+					if (n > this->rest()) {
+						pos_ = n_;
+						fail_ = true;
+						return false;
+					}
+					pos_ += n;
+					return true;
+				}
+				
+				bool seek(size_type pos) {
+					if (pos > n_) {
+						pos_ = n_;
+						fail_ = true;
+						return false;
+					}
+					pos_ = pos;
+					return true;
+				}
+				
+				size_type tell() const { return pos_; }
+				size_type size() const { return n_; }
+				size_type rest() const { return n_ - pos_; }
+				bool fail() const { return fail_; }
+				
+			private:
+				const byte_type* p_;
+				size_type n_;
+				size_type pos_;
+				bool fail_;
+				
+				unsigned int xget(size_type bytes) {
+					if (bytes > this->rest()) {
+						pos_ = n_;
+						fail_ = true;
+						return 0;
+					}
+					
+					unsigned int dest = 0;
+					for (size_type k = bytes; k > 0; --k) dest = (dest << 8) | p_[pos_ + k - 1];
+					pos_ += bytes;
+					return dest;
+				}
+			};
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  read_metafile
+			 *
+			 *  Reads the rest of the stream into dest. It is used when the
+			 *  metafile is given as a stream instead of the memory buffer.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class CharT, class Traits>
+			inline void read_metafile(std::basic_istream<CharT, Traits>& in, std::vector<unsigned char>& dest) {
+				typedef typename std::basic_istream<CharT, Traits>::pos_type pos_type;
+				
+				dest.clear();
+				pos_type cur = in.tellg();
+				if (cur != pos_type(-1) && in.seekg(0, std::ios_base::end)) {
+					pos_type last = in.tellg();
+					in.seekg(cur);
+					if (last != pos_type(-1) && last > cur) {
+						dest.resize(static_cast<size_t>(last - cur) * sizeof(CharT));
+						in.read(reinterpret_cast<CharT*>(&dest[0]), static_cast<std::streamsize>(last - cur));
+						dest.resize(static_cast<size_t>(in.gcount()) * sizeof(CharT));
+					}
+					return;
+				}
+				
+				in.clear();
+				std::istreambuf_iterator<CharT, Traits> first(in), last;
+				for (; first != last; ++first) {
+					CharT c = *first;
+					const unsigned char* p = reinterpret_cast<const unsigned char*>(&c);
+					dest.insert(dest.end(), p, p + sizeof(CharT));
+				}
+			}
+		}
+	}
+}
+
+#endif // FAML_PDF_CONTENTS_METAFILE_H
@@ -79,7 +79,7 @@ namespace faml {
 					//static const double a = 4.0 * (std::sqrt(2.0) - 1.0) / 3.0;
 					
 					// Phase 1
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -90,10 +90,10 @@ namespace faml {
 					detail::draw_arc(out, ox+x, oy+y, w, h, 3, true);
 					detail::draw_arc(out, ox+x, oy+y, w, h, 4, true);
 					out << LITERAL("W") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					// Phase 2
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -106,7 +106,7 @@ namespace faml {
 					if (this->is_stroke() && this->is_fill()) out << LITERAL("b") << std::endl;
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					// Phase 3
 					w  =  this->width() / 2.0 - delta;
@@ -125,7 +125,7 @@ namespace faml {
 						double y2_2 = -h*(1/std::sqrt(2.0)) - dy;
 						double y2_1 =  h*(1/std::sqrt(2.0)) - dy;
 					if (this->is_fill()) {
-						if (entag_) out << LITERAL("q") << std::endl;
+						if (entag_) this->xsave(out);
 						this->setorigin(out);
 						this->setborder(out);
 						this->setbackground(out);
@@ -135,7 +135,7 @@ namespace faml {
 						out << fmt(LITERAL("%f %f l")) % x2_2 % y2_2 << std::endl;
 						out << fmt(LITERAL("%f %f l")) % x2_1 % y2_1 << std::endl;
 						out << LITERAL("f") << std::endl;
-						if (entag_) out << LITERAL("Q") << std::endl;
+						if (entag_) this->xrestore(out);
 					}
 					
 					// Phase 4
@@ -154,7 +154,7 @@ namespace faml {
 						double y2_2 = -h*(1/std::sqrt(2.0)) - dy;
 						double y2_1 =  h*(1/std::sqrt(2.0)) - dy;*/
 						
-						if (entag_) out << LITERAL("q") << std::endl;
+						if (entag_) this->xsave(out);
 						this->setorigin(out);
 						this->setborder(out);
 						this->setbackground(out);
@@ -162,9 +162,9 @@ namespace faml {
 						out << fmt(LITERAL("%f %f l")) % x1_2 % y1_2 << std::endl;
 						out << fmt(LITERAL("%f %f l")) % x1_1 % y1_1 << std::endl;
 						out << LITERAL("s") << std::endl;
-						if (entag_) out << LITERAL("Q") << std::endl;
+						if (entag_) this->xrestore(out);
 						
-						if (entag_) out << LITERAL("q") << std::endl;
+						if (entag_) this->xsave(out);
 						this->setorigin(out);
 						this->setborder(out);
 						this->setbackground(out);
@@ -172,7 +172,7 @@ namespace faml {
 						out << fmt(LITERAL("%f %f l")) % x2_1 % y2_1 << std::endl;
 						out << fmt(LITERAL("%f %f l")) % x2_2 % y2_2 << std::endl;
 						out << LITERAL("s") << std::endl;
-						if (entag_) out << LITERAL("Q") << std::endl;
+						if (entag_) this->xrestore(out);
 					}
 					
 					return true;
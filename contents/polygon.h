@@ -93,7 +93,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke() && !this->is_fill() && !this->is_shading()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					
@@ -114,7 +114,7 @@ namespace faml {
 					this->draw(out, true);
 					
 					if ((this->type() & 0x010)) this->xput_double(out);
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -139,8 +139,7 @@ namespace faml {
 					double x = std::cos(clx::radian(angle)) * src.distance() * h;
 					double y = std::sin(clx::radian(angle)) * src.distance() * v;
 					
-					out << fmt(LITERAL("%f %f %f rg"))
-						% src.fill().red() % src.fill().green() % src.fill().blue() << std::endl;
+					this->setfill(out, src.fill());
 					out << fmt(LITERAL("%f %f m"))
 						% (v_.at(0).x() + x) % (v_.at(0).y() - y) << std::endl;
 					for (size_type i = 1; i < v_.size(); ++i) {
@@ -163,7 +162,7 @@ namespace faml {
 					double weight = this->weight();
 					if ((this->type() & 0x020)) weight /= 2.0;
 					else if ((this->type() & 0x040)) weight *= 2.0;
-					out << fmt(LITERAL("%f w")) % weight << std::endl;
+					this->setwidth(out, weight);
 					
 					double delta = weight + 2.0; //std::max(4.0, std::max(weight, this->weight()));
 					double x = (v_.at(0).x() > 0) ? v_.at(0).x() + delta :
@@ -92,9 +92,9 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (v_.empty()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
-					out << fmt(LITERAL("%f w")) % this->weight() << std::endl;
+					this->setwidth(out, this->weight());
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -110,7 +110,7 @@ namespace faml {
 					else if (this->is_fill()) out << LITERAL("f") << std::endl;
 					else out << LITERAL("s") << std::endl;
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
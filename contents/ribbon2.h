@@ -75,7 +75,7 @@ namespace faml {
 					// No need to draw and/or fill the shape.
 					if (!this->is_stroke() && !this->is_fill() && !this->is_shading()) return true;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					
 					this->setorigin(out);
 					this->setborder(out);
@@ -116,7 +116,7 @@ namespace faml {
 					double blue = this->background().blue() * this->shadow().blue();
 					
 					// phase3
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					out << fmt(LITERAL("%f %f m")) % (ox + this->width()/2.0 - delta2/2.0 + fold_len) % (oy + delta1) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width()/2.0 - delta2/2.0 + fold_len) % (oy + delta1/2.0 - r) << std::endl;
 					detail::draw_arc(out, ox + this->width()/2.0 - delta2/2.0 + fold_len - r, oy + delta1/2.0 - r, r, r, 1, true);
@@ -129,7 +129,7 @@ namespace faml {
 					else out << LITERAL("s") << std::endl;
 					
 					// phase4
-					out << fmt(LITERAL("%f %f %f rg")) % red % green % blue << std::endl;
+					this->setfill(out, color(red, green, blue));
 					out << fmt(LITERAL("%f %f m")) % (ox + this->width()/2.0 + delta2/2.0 - fold_len) % (oy + delta1) << std::endl;
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width()/2.0 + delta2/2.0 - fold_len) % (oy + delta1/2.0 - r) << std::endl;
 					detail::draw_arc_rev(out, ox + this->width()/2.0 + delta2/2.0 - fold_len + r, oy + delta1/2.0 - r, r, r, 2, true);
@@ -142,7 +142,7 @@ namespace faml {
 					else out << LITERAL("s") << std::endl;
 					
 					// phase5
-					out << fmt(LITERAL("%f %f %f rg")) % this->background().red() % this->background().green() % this->background().blue() << std::endl;
+					this->setfill(out, this->background());
 					out << fmt(LITERAL("%f %f m")) % (ox + this->width()/2.0 - delta2/2.0) % (oy + this->height() - r) << std::endl;
 					detail::draw_arc_rev(out, ox + this->width()/2.0 - delta2/2.0 + r, oy + this->height() - r, r, r, 2, true);
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width()/2.0 + delta2/2.0 - r) % (oy + this->height()) << std::endl;
@@ -156,7 +156,7 @@ namespace faml {
 					else out << LITERAL("s") << std::endl;
 					
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -75,7 +75,7 @@ namespace faml {
 					double oy = -this->height() / 2.0;
 					double delta = (this->width() < this->height()) ? this->width() * adjust_ : this->height() * adjust_;
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -87,7 +87,7 @@ namespace faml {
 					out << fmt(LITERAL("%f %f l")) % (ox + this->width()) % (oy) << std::endl;
 					this->draw(out, true);
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
@@ -80,7 +80,7 @@ namespace faml {
 					double delta1 = (this->width() < this->height()) ? this->width() * adjust_.at(0) : this->height() * adjust_.at(0);
 					double delta2 = (this->width() < this->height()) ? this->width() * adjust_.at(1) : this->height() * adjust_.at(1);
 					
-					if (entag_) out << LITERAL("q") << std::endl;
+					if (entag_) this->xsave(out);
 					this->setorigin(out);
 					this->setborder(out);
 					this->setbackground(out);
@@ -94,7 +94,7 @@ namespace faml {
 					detail::draw_arc_rev(out, ox + delta2, oy+delta2, delta2, delta2, 3, true);
 					this->draw(out, true);
 					
-					if (entag_) out << LITERAL("Q") << std::endl;
+					if (entag_) this->xrestore(out);
 					
 					return true;
 				}
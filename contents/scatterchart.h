@@ -76,7 +76,9 @@ namespace faml {
 						if (this->palette_) ln = color(
 							detail::getcolor(i, *this->palette_, this->palette_->size() - 6));
 						else ln = color(detail::getcolor(i));
+						string_type mark = detail::makemark<CharT, Traits>(i, ln, ln);
 						
+						detail::mark_filter visible(this->res_);
 						for (size_type j = 0; j < this->in_->at(i).size(); ++j) {
 							//double y = oy + this->area_.second * (this->in_->at(i).at(j) / upper);
 							double y = 0.0;
@@ -85,10 +87,7 @@ namespace faml {
 									* (1.0 - (this->in_->at(i).at(j) - lower) / (upper - lower));
 							}
 							else y = oy + this->area_.second * ((this->in_->at(i).at(j) - lower) / (upper - lower));
-							shape_ptr sh = detail::getmark<CharT, Traits>(coordinate(x, y), i);
-							sh->background(ln);
-							sh->border(ln);
-							(*sh)(out);
+							if (visible(x, y)) this->put_marker(out, mark, coordinate(x, y));
 							x += width;
 						}
 						//out << LITERAL("S") << std::endl;
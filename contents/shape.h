@@ -41,6 +41,7 @@
 #include "../coordinate.h"
 #include "../color.h"
 #include "../shape_effect.h"
+#include "../text_state.h"
 #include "clx/format.h"
 #include "clx/literal.h"
 
@@ -61,17 +62,18 @@ namespace faml {
 				typedef std::basic_string<CharT, Traits> string_type;
 				typedef faml::basic_shape_effect<CharT, Traits> effect_type;
 				typedef std::map<string_type, effect_type> effect_map;
+				typedef basic_text_state<CharT, Traits> state_type;
 				
 				basic_shape() :
 					origin_(coordinate(0.0, 0.0)),
 					width_(0.0), height_(0.0), angle_(0.0), flip_(0), weight_(0.5),
 					type_(1), shading_(), alpha_(), border_(), background_(),
-					shadow_(0x808080), highlight_(0xcbcbcb), effects_() {}
+					shadow_(0x808080), highlight_(0xcbcbcb), effects_(), state_(NULL) {}
 				
 				explicit basic_shape(const coordinate& o, double w = 0.0, double h = 0.0) :
 					origin_(o), width_(w), height_(h), angle_(0.0), flip_(0), weight_(0.5),
 					type_(1), shading_(), alpha_(), border_(), background_(),
-					shadow_(0x808080), highlight_(0xcbcbcb), effects_() {}
+					shadow_(0x808080), highlight_(0xcbcbcb), effects_(), state_(NULL) {}
 				
 				virtual ~basic_shape() throw() {}
 				virtual bool operator()(ostream_type& out) = 0;
@@ -125,6 +127,18 @@ namespace faml {
 				void highlight(const color& cp) { highlight_ = cp; }
 				void effect(const string_type& name, const effect_type& cp) { effects_[name] = cp; }
 				
+				/* --------------------------------------------------------- */
+				/*
+				 *  state
+				 *
+				 *  Shares the graphics state with the text_contents written
+				 *  to the same stream, so that the w, d, rg, and RG operators
+				 *  setting the value already in effect are skipped. Without
+				 *  the state, all operators are written.
+				 */
+				/* --------------------------------------------------------- */
+				void state(state_type& cp) { state_ = &cp; }
+				
 			protected:
 				bool is_fill() const { return background_.is_valid(); }
 				bool is_stroke() const { return border_.is_valid(); }
@@ -163,58 +177,95 @@ namespace faml {
 					
 				}
 				
+				/* --------------------------------------------------------- */
+				/*
+				 *  xsave, xrestore
+				 *
+				 *  Write q/Q. The shapes must use them instead of writing
+				 *  q/Q directly, so that the shared state is restored with
+				 *  the graphics state.
+				 */
+				/* --------------------------------------------------------- */
+				void xsave(ostream_type& out) {
+					if (state_ != NULL) state_->save(out);
+					else out << LITERAL("q") << std::endl;
+				}
+				
+				void xrestore(ostream_type& out) {
+					if (state_ != NULL) state_->restore(out);
+					else out << LITERAL("Q") << std::endl;
+				}
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  setwidth, setdash, setfill, setstroke
+				 *
+				 *  Write the w, d, rg, and RG operators through the shared
+				 *  state (if any).
+				 */
+				/* --------------------------------------------------------- */
+				void setwidth(ostream_type& out, double w) {
+					this->xput(out, state_type::width, (fmt(LITERAL("%f w")) % w).str());
+				}
+				
+				void setdash(ostream_type& out, const string_type& s) {
+					this->xput(out, state_type::dash, s);
+				}
+				
+				void setfill(ostream_type& out, const color& c) {
+					this->xput(out, state_type::fill,
+						(fmt(LITERAL("%f %f %f rg")) % c.red() % c.green() % c.blue()).str());
+				}
+				
+				void setstroke(ostream_type& out, const color& c) {
+					this->xput(out, state_type::stroke,
+						(fmt(LITERAL("%f %f %f RG")) % c.red() % c.green() % c.blue()).str());
+				}
+				
 				/* --------------------------------------------------------- */
 				//  setborder
 				/* --------------------------------------------------------- */
 				void setborder(ostream_type& out) {
 					double w = this->weight();
 					if (this->is_shading()) w += 1.0;
-					out << fmt(LITERAL("%f w")) % w << std::endl;
+					this->setwidth(out, w);
 					switch (type_) {
 					case 0x001:
-						out << LITERAL("[] 0 d") << std::endl;
+						this->setdash(out, LITERAL("[] 0 d"));
 						break;
 					case 0x002:
-						out << fmt(LITERAL("[%f %f] 0 d"))
-							% (w * 5) % (w * 3) << std::endl;
+						this->setdash(out, (fmt(LITERAL("[%f %f] 0 d"))
+							% (w * 5) % (w * 3)).str());
 						break;
 					case 0x003:
-						out << fmt(LITERAL("[%f %f] 0 d"))
-							% (w * 1) % (w * 1) << std::endl;
+						this->setdash(out, (fmt(LITERAL("[%f %f] 0 d"))
+							% (w * 1) % (w * 1)).str());
 						break;
 					case 0x004:
-						out << fmt(LITERAL("[%f %f] 0 d"))
-							% (w * 1) % (w * 1) << std::endl;
+						this->setdash(out, (fmt(LITERAL("[%f %f] 0 d"))
+							% (w * 1) % (w * 1)).str());
 						break;
 					case 0x005:
-						out << fmt(LITERAL("[%f %f %f %f] 0 d"))
-							% (w * 5) % (w * 2) % (w * 2) % (w * 2) << std::endl;
+						this->setdash(out, (fmt(LITERAL("[%f %f %f %f] 0 d"))
+							% (w * 5) % (w * 2) % (w * 2) % (w * 2)).str());
 						break;
 					case 0x006:
-						out << fmt(LITERAL("[%f %f %f %f %f %f] 2 d"))
-							% (w * 5) % (w * 2) % (w * 2) % (w * 2) % (w * 2) % (w * 2) << std::endl;
+						this->setdash(out, (fmt(LITERAL("[%f %f %f %f %f %f] 2 d"))
+							% (w * 5) % (w * 2) % (w * 2) % (w * 2) % (w * 2) % (w * 2)).str());
 						break;
 					default:
-						out << LITERAL("[] 0 d") << std::endl;
+						this->setdash(out, LITERAL("[] 0 d"));
 						break;
 					}
 					
-					out << fmt(LITERAL("%f %f %f RG"))
-						% this->border().red()
-						% this->border().green()
-						% this->border().blue()
-					<< std::endl;
+					this->setstroke(out, this->border());
 				}
 				
 				/* --------------------------------------------------------- */
 				//  setbackground
 				/* --------------------------------------------------------- */
 				void setbackground(ostream_type& out) {
-					out << fmt(LITERAL("%f %f %f rg"))
-						% this->background().red()
-						% this->background().green()
-						% this->background().blue()
-					<< std::endl;
+					this->setfill(out, this->background());
 					if (this->is_alpha()) {
 						out << fmt(LITERAL("/%s gs")) % this->alpha() << std::endl;
 					}
@@ -241,14 +292,14 @@ namespace faml {
 							else ln = LITERAL("S");
 						}
 						out << fmt(LITERAL("W %s")) % ln << std::endl;
-						out << LITERAL("q") << std::endl;
+						this->xsave(out);
 						out << fmt(LITERAL("%f 0 0 %f %f %f cm"))
 							% this->width() % this->height()
 							% (-this->width() / 2.0)
 							% (-this->height() / 2.0)
 							<< std::endl;
 						out << fmt(LITERAL("/%s sh")) % this->shading() << std::endl;
-						out << LITERAL("Q") << std::endl;
+						this->xrestore(out);
 					}
 					else if (this->is_stroke() && this->is_fill()) {
 						if (close) out << LITERAL("b") << std::endl;
@@ -281,6 +332,12 @@ namespace faml {
 				color shadow_;
 				color highlight_;
 				effect_map effects_;
+				state_type* state_;
+				
+				void xput(ostream_type& out, size_type which, const string_type& s) {
+					if (state_ != NULL) (*state_)(out, which, s);
+					else out << s << std::endl;
+				}
 			};
 		}
 	}
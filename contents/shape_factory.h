@@ -1,6 +1,9 @@
 #ifndef FAML_PDF_CONTENTS_SHAPE_FACTORY_H
 #define FAML_PDF_CONTENTS_SHAPE_FACTORY_H
 
+#include <map>
+#include <string>
+#include "clx/shared_ptr.h"
 #include "shape.h"
 #include "polygon.h"
 #include "circle.h"
@@ -138,162 +141,210 @@
 namespace faml {
 	namespace pdf {
 		namespace contents {
+			namespace detail {
+				/* --------------------------------------------------------- */
+				//  createshape
+				/* --------------------------------------------------------- */
+				template <class Shape, class Ch, class Tr>
+				inline clx::shared_ptr<basic_shape<Ch, Tr> > createshape(const coordinate& o,
+					double w, double h, bool entag) {
+					return clx::shared_ptr<basic_shape<Ch, Tr> >(new Shape(o, w, h, entag));
+				}
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  basic_shape_registry
+				 *
+				 *  The basic_shape_registry class maps the names of preset
+				 *  shapes to the functions that create them. The map is
+				 *  built at the first call of get().
+				 */
+				/* --------------------------------------------------------- */
+				template <class Ch, class Tr>
+				class basic_shape_registry {
+				public:
+					typedef clx::shared_ptr<basic_shape<Ch, Tr> > shape_ptr;
+					typedef shape_ptr (*creator)(const coordinate&, double, double, bool);
+					typedef std::map<std::basic_string<Ch, Tr>, creator> container;
+					
+					static const container& get() {
+						static container v;
+						if (v.empty()) xinit(v);
+						return v;
+					}
+					
+				private:
+					/* ----------------------------------------------------- */
+					//  xinit
+					/* ----------------------------------------------------- */
+					static void xinit(container& v) {
+						v[LITERAL("line")] = &createshape<basic_line<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("straightConnector1")] = &createshape<basic_line<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("ellipse")] = &createshape<basic_ellipse<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("rect")] = &createshape<basic_rectangle<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("roundRect")] = &createshape<basic_round_rect<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("snip1Rect")] = &createshape<basic_snip1_rect<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("snip2SameRect")] = &createshape<basic_snip2_same_rect<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("snip2DiagRect")] = &createshape<basic_snip2_diag_rect<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("snipRoundRect")] = &createshape<basic_snip_round_rect<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("round1Rect")] = &createshape<basic_round1_rect<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("round2SameRect")] = &createshape<basic_round2_same_rect<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("round2DiagRect")] = &createshape<basic_round2_diag_rect<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("triangle")] = &createshape<basic_triangle<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("rtTriangle")] = &createshape<basic_right_triangle<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("can")] = &createshape<basic_cylinder<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("parallelogram")] = &createshape<basic_parallelogram<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("pentagon")] = &createshape<basic_pentagon<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("hexagon")] = &createshape<basic_hexagon<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("trapezoid")] = &createshape<basic_trapezoid<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("diamond")] = &createshape<basic_diamond<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("heptagon")] = &createshape<basic_heptagon<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("octagon")] = &createshape<basic_octagon<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("decagon")] = &createshape<basic_decagon<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("dodecagon")] = &createshape<basic_dodecagon<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("frame")] = &createshape<basic_frame<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("halfFrame")] = &createshape<basic_half_frame<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("corner")] = &createshape<basic_corner<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("diagStripe")] = &createshape<basic_diag_stripe<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("pie")] = &createshape<basic_pie<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("chord")] = &createshape<basic_chord<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("teardrop")] = &createshape<basic_teardrop<Ch, Tr>, Ch, Tr>; // under construction
+						v[LITERAL("plus")] = &createshape<basic_plus<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("cube")] = &createshape<basic_cube<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("bevel")] = &createshape<basic_bevel<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("foldedCorner")] = &createshape<basic_folded_corner<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("donut")] = &createshape<basic_donut<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("noSmoking")] = &createshape<basic_no_smoking<Ch, Tr>, Ch, Tr>; // under construction
+						v[LITERAL("blockArc")] = &createshape<basic_block_arc<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("heart")] = &createshape<basic_heart<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("lightningBolt")] = &createshape<basic_lightning_bolt<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("sun")] = &createshape<basic_sun<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("moon")] = &createshape<basic_moon<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("cloud")] = &createshape<basic_cloud<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("arc")] = &createshape<basic_arc<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("bracketPair")] = &createshape<basic_bracket_pair<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("bracePair")] = &createshape<basic_brace_pair<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("plaque")] = &createshape<basic_plaque<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("leftBracket")] = &createshape<basic_left_bracket<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("rightBracket")] = &createshape<basic_right_bracket<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("leftBrace")] = &createshape<basic_left_brace<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("rightBrace")] = &createshape<basic_right_brace<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("rightArrow")] = &createshape<basic_right_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("leftArrow")] = &createshape<basic_left_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("upArrow")] = &createshape<basic_up_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("downArrow")] = &createshape<basic_down_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("leftRightArrow")] = &createshape<basic_left_right_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("upDownArrow")] = &createshape<basic_up_down_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("quadArrow")] = &createshape<basic_quad_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("leftRightUpArrow")] = &createshape<basic_left_right_up_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("bentArrow")] = &createshape<basic_bent_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("uturnArrow")] = &createshape<basic_uturn_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("leftUpArrow")] = &createshape<basic_left_up_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("bentUpArrow")] = &createshape<basic_bent_up_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("curvedRightArrow")] = &createshape<basic_curved_right_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("curvedLeftArrow")] = &createshape<basic_curved_left_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("curvedUpArrow")] = &createshape<basic_curved_up_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("curvedDownArrow")] = &createshape<basic_curved_down_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("stripedRightArrow")] = &createshape<basic_striped_right_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("notchedRightArrow")] = &createshape<basic_notched_right_arrow<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("homePlate")] = &createshape<basic_home_plate<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("chevron")] = &createshape<basic_chevron<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("rightArrowCallout")] = &createshape<basic_right_arrow_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("downArrowCallout")] = &createshape<basic_down_arrow_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("leftArrowCallout")] = &createshape<basic_left_arrow_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("upArrowCallout")] = &createshape<basic_up_arrow_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("leftRightArrowCallout")] = &createshape<basic_left_right_arrow_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("upDownArrowCallout")] = &createshape<basic_up_down_arrow_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("quadArrowCallout")] = &createshape<basic_quad_arrow_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("mathPlus")] = &createshape<basic_math_plus<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("mathMinus")] = &createshape<basic_math_minus<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("mathMultiply")] = &createshape<basic_math_multiply<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("mathDivide")] = &createshape<basic_math_divide<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("mathEqual")] = &createshape<basic_math_equal<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("mathNotEqual")] = &createshape<basic_math_not_equal<Ch, Tr>, Ch, Tr>; // under construction
+						v[LITERAL("flowChartProcess")] = &createshape<basic_flow_chart_process<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartAlternateProcess")] = &createshape<basic_flow_chart_alternate_process<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartDecision")] = &createshape<basic_flow_chart_decision<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartInputOutput")] = &createshape<basic_flow_chart_input_output<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartPredefinedProcess")] = &createshape<basic_flow_chart_predefined_process<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartInternalStorage")] = &createshape<basic_flow_chart_internal_storage<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartDocument")] = &createshape<basic_flow_chart_document<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartMultidocument")] = &createshape<basic_flow_chart_multidocument<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartTerminator")] = &createshape<basic_flow_chart_terminator<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartPreparation")] = &createshape<basic_flow_chart_preparation<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartManualInput")] = &createshape<basic_flow_chart_manual_input<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartManualOperation")] = &createshape<basic_flow_chart_manual_operation<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartConnector")] = &createshape<basic_flow_chart_connector<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartOffpageConnector")] = &createshape<basic_flow_chart_offpage_connector<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartPunchedCard")] = &createshape<basic_flow_chart_punched_card<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartPunchedTape")] = &createshape<basic_flow_chart_punched_tape<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartSummingJunction")] = &createshape<basic_flow_chart_summing_junction<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartOr")] = &createshape<basic_flow_chart_or<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartCollate")] = &createshape<basic_flow_chart_collate<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartSort")] = &createshape<basic_flow_chart_sort<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartExtract")] = &createshape<basic_flow_chart_extract<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartMerge")] = &createshape<basic_flow_chart_merge<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartOnlineStorage")] = &createshape<basic_flow_chart_online_storage<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartDelay")] = &createshape<basic_flow_chart_delay<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartMagneticTape")] = &createshape<basic_flow_chart_magnetic_tape<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartMagneticDisk")] = &createshape<basic_flow_chart_magnetic_disk<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartMagneticDrum")] = &createshape<basic_flow_chart_magnetic_drum<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("flowChartDisplay")] = &createshape<basic_flow_chart_display<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("irregularSeal1")] = &createshape<basic_irregular_seal1<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("irregularSeal2")] = &createshape<basic_irregular_seal2<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star4")] = &createshape<basic_star4<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star5")] = &createshape<basic_star5<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star6")] = &createshape<basic_star6<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star7")] = &createshape<basic_star7<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star8")] = &createshape<basic_star8<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star10")] = &createshape<basic_star10<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star12")] = &createshape<basic_star12<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star16")] = &createshape<basic_star16<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star24")] = &createshape<basic_star24<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("star32")] = &createshape<basic_star32<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("ribbon2")] = &createshape<basic_ribbon2<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("ribbon")] = &createshape<basic_ribbon<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("ellipseRibbon2")] = &createshape<basic_ellipse_ribbon2<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("ellipseRibbon")] = &createshape<basic_ellipse_ribbon<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("wedgeRectCallout")] = &createshape<basic_wedge_rect_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("wedgeRoundRectCallout")] = &createshape<basic_wedge_round_rect_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("wedgeEllipseCallout")] = &createshape<basic_wedge_ellipse_callout<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("borderCallout1")] = &createshape<basic_border_callout1<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("borderCallout2")] = &createshape<basic_border_callout2<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("borderCallout3")] = &createshape<basic_border_callout3<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("accentCallout1")] = &createshape<basic_accent_callout1<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("accentCallout2")] = &createshape<basic_accent_callout2<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("accentCallout3")] = &createshape<basic_accent_callout3<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("callout1")] = &createshape<basic_callout1<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("callout2")] = &createshape<basic_callout2<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("callout3")] = &createshape<basic_callout3<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("accentBorderCallout1")] = &createshape<basic_accent_border_callout1<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("accentBorderCallout2")] = &createshape<basic_accent_border_callout2<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("accentBorderCallout3")] = &createshape<basic_accent_border_callout3<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("actionButtonBlank")] = &createshape<basic_action_button_blank<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("actionButtonBackPrevious")] = &createshape<basic_action_button_back_previous<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("actionButtonForwardNext")] = &createshape<basic_action_button_forward_next<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("actionButtonBeginning")] = &createshape<basic_action_button_beginning<Ch, Tr>, Ch, Tr>;
+						v[LITERAL("actionButtonEnd")] = &createshape<basic_action_button_end<Ch, Tr>, Ch, Tr>;
+					}
+				};
+			}
+			
 			/* ------------------------------------------------------------- */
-			//  makeshape
+			/*
+			 *  makeshape
+			 *
+			 *  Creates the preset shape specified by name. The function
+			 *  returns the null pointer when name is not supported.
+			 */
 			/* ------------------------------------------------------------- */
 			template <class Ch, class Tr>
 			inline clx::shared_ptr<basic_shape<Ch, Tr> > makeshape(const std::basic_string<Ch, Tr>& name,
 				const coordinate& o, double w, double h, bool entag = true) {
-				typedef clx::shared_ptr<basic_shape<Ch, Tr> > shape_ptr;
-				if (name == LITERAL("line")) return shape_ptr(new basic_line<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("straightConnector1")) return shape_ptr(new basic_line<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("ellipse")) return shape_ptr(new basic_ellipse<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("rect")) return shape_ptr(new basic_rectangle<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("roundRect")) return shape_ptr(new basic_round_rect<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("snip1Rect")) return shape_ptr(new basic_snip1_rect<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("snip2SameRect")) return shape_ptr(new basic_snip2_same_rect<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("snip2DiagRect")) return shape_ptr(new basic_snip2_diag_rect<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("snipRoundRect")) return shape_ptr(new basic_snip_round_rect<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("round1Rect")) return shape_ptr(new basic_round1_rect<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("round2SameRect")) return shape_ptr(new basic_round2_same_rect<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("round2DiagRect")) return shape_ptr(new basic_round2_diag_rect<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("triangle")) return shape_ptr(new basic_triangle<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("rtTriangle")) return shape_ptr(new basic_right_triangle<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("can")) return shape_ptr(new basic_cylinder<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("parallelogram")) return shape_ptr(new basic_parallelogram<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("pentagon")) return shape_ptr(new basic_pentagon<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("hexagon")) return shape_ptr(new basic_hexagon<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("trapezoid")) return shape_ptr(new basic_trapezoid<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("diamond")) return shape_ptr(new basic_diamond<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("heptagon")) return shape_ptr(new basic_heptagon<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("octagon")) return shape_ptr(new basic_octagon<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("decagon")) return shape_ptr(new basic_decagon<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("dodecagon")) return shape_ptr(new basic_dodecagon<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("frame")) return shape_ptr(new basic_frame<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("halfFrame")) return shape_ptr(new basic_half_frame<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("corner")) return shape_ptr(new basic_corner<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("diagStripe")) return shape_ptr(new basic_diag_stripe<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("pie")) return shape_ptr(new basic_pie<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("chord")) return shape_ptr(new basic_chord<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("teardrop")) return shape_ptr(new basic_teardrop<Ch, Tr>(o, w, h, entag)); // under construction
-				if (name == LITERAL("plus")) return shape_ptr(new basic_plus<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("cube")) return shape_ptr(new basic_cube<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("bevel")) return shape_ptr(new basic_bevel<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("foldedCorner")) return shape_ptr(new basic_folded_corner<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("donut")) return shape_ptr(new basic_donut<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("noSmoking")) return shape_ptr(new basic_no_smoking<Ch, Tr>(o, w, h, entag)); // under construction
-				if (name == LITERAL("blockArc")) return shape_ptr(new basic_block_arc<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("heart")) return shape_ptr(new basic_heart<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("lightningBolt")) return shape_ptr(new basic_lightning_bolt<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("sun")) return shape_ptr(new basic_sun<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("moon")) return shape_ptr(new basic_moon<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("cloud")) return shape_ptr(new basic_cloud<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("arc")) return shape_ptr(new basic_arc<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("bracketPair")) return shape_ptr(new basic_bracket_pair<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("bracePair")) return shape_ptr(new basic_brace_pair<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("plaque")) return shape_ptr(new basic_plaque<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("leftBracket")) return shape_ptr(new basic_left_bracket<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("rightBracket")) return shape_ptr(new basic_right_bracket<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("leftBrace")) return shape_ptr(new basic_left_brace<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("rightBrace")) return shape_ptr(new basic_right_brace<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("rightArrow")) return shape_ptr(new basic_right_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("leftArrow")) return shape_ptr(new basic_left_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("upArrow")) return shape_ptr(new basic_up_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("downArrow")) return shape_ptr(new basic_down_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("leftRightArrow")) return shape_ptr(new basic_left_right_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("upDownArrow")) return shape_ptr(new basic_up_down_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("quadArrow")) return shape_ptr(new basic_quad_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("leftRightUpArrow")) return shape_ptr(new basic_left_right_up_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("bentArrow")) return shape_ptr(new basic_bent_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("uturnArrow")) return shape_ptr(new basic_uturn_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("leftUpArrow")) return shape_ptr(new basic_left_up_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("bentUpArrow")) return shape_ptr(new basic_bent_up_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("curvedRightArrow")) return shape_ptr(new basic_curved_right_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("curvedLeftArrow")) return shape_ptr(new basic_curved_left_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("curvedUpArrow")) return shape_ptr(new basic_curved_up_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("curvedDownArrow")) return shape_ptr(new basic_curved_down_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("stripedRightArrow")) return shape_ptr(new basic_striped_right_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("notchedRightArrow")) return shape_ptr(new basic_notched_right_arrow<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("homePlate")) return shape_ptr(new basic_home_plate<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("chevron")) return shape_ptr(new basic_chevron<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("rightArrowCallout")) return shape_ptr(new basic_right_arrow_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("downArrowCallout")) return shape_ptr(new basic_down_arrow_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("leftArrowCallout")) return shape_ptr(new basic_left_arrow_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("upArrowCallout")) return shape_ptr(new basic_up_arrow_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("leftRightArrowCallout")) return shape_ptr(new basic_left_right_arrow_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("upDownArrowCallout")) return shape_ptr(new basic_up_down_arrow_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("quadArrowCallout")) return shape_ptr(new basic_quad_arrow_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("mathPlus")) return shape_ptr(new basic_math_plus<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("mathMinus")) return shape_ptr(new basic_math_minus<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("mathMultiply")) return shape_ptr(new basic_math_multiply<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("mathDivide")) return shape_ptr(new basic_math_divide<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("mathEqual")) return shape_ptr(new basic_math_equal<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("mathNotEqual")) return shape_ptr(new basic_math_not_equal<Ch, Tr>(o, w, h, entag)); // under construction
-				if (name == LITERAL("flowChartProcess")) return shape_ptr(new basic_flow_chart_process<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartAlternateProcess")) return shape_ptr(new basic_flow_chart_alternate_process<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartDecision")) return shape_ptr(new basic_flow_chart_decision<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartInputOutput")) return shape_ptr(new basic_flow_chart_input_output<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartPredefinedProcess")) return shape_ptr(new basic_flow_chart_predefined_process<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartInternalStorage")) return shape_ptr(new basic_flow_chart_internal_storage<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartDocument")) return shape_ptr(new basic_flow_chart_document<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartMultidocument")) return shape_ptr(new basic_flow_chart_multidocument<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartTerminator")) return shape_ptr(new basic_flow_chart_terminator<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartPreparation")) return shape_ptr(new basic_flow_chart_preparation<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartManualInput")) return shape_ptr(new basic_flow_chart_manual_input<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartManualOperation")) return shape_ptr(new basic_flow_chart_manual_operation<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartConnector")) return shape_ptr(new basic_flow_chart_connector<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartOffpageConnector")) return shape_ptr(new basic_flow_chart_offpage_connector<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartPunchedCard")) return shape_ptr(new basic_flow_chart_punched_card<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartPunchedTape")) return shape_ptr(new basic_flow_chart_punched_tape<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartSummingJunction")) return shape_ptr(new basic_flow_chart_summing_junction<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartOr")) return shape_ptr(new basic_flow_chart_or<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartCollate")) return shape_ptr(new basic_flow_chart_collate<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartSort")) return shape_ptr(new basic_flow_chart_sort<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartExtract")) return shape_ptr(new basic_flow_chart_extract<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartMerge")) return shape_ptr(new basic_flow_chart_merge<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartOnlineStorage")) return shape_ptr(new basic_flow_chart_online_storage<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartDelay")) return shape_ptr(new basic_flow_chart_delay<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartMagneticTape")) return shape_ptr(new basic_flow_chart_magnetic_tape<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartMagneticDisk")) return shape_ptr(new basic_flow_chart_magnetic_disk<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartMagneticDrum")) return shape_ptr(new basic_flow_chart_magnetic_drum<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("flowChartDisplay")) return shape_ptr(new basic_flow_chart_display<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("irregularSeal1")) return shape_ptr(new basic_irregular_seal1<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("irregularSeal2")) return shape_ptr(new basic_irregular_seal2<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star4")) return shape_ptr(new basic_star4<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star5")) return shape_ptr(new basic_star5<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star6")) return shape_ptr(new basic_star6<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star7")) return shape_ptr(new basic_star7<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star8")) return shape_ptr(new basic_star8<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star10")) return shape_ptr(new basic_star10<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star12")) return shape_ptr(new basic_star12<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star16")) return shape_ptr(new basic_star16<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star24")) return shape_ptr(new basic_star24<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("star32")) return shape_ptr(new basic_star32<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("ribbon2")) return shape_ptr(new basic_ribbon2<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("ribbon")) return shape_ptr(new basic_ribbon<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("ellipseRibbon2")) return shape_ptr(new basic_ellipse_ribbon2<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("ellipseRibbon")) return shape_ptr(new basic_ellipse_ribbon<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("wedgeRectCallout")) return shape_ptr(new basic_wedge_rect_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("wedgeRoundRectCallout")) return shape_ptr(new basic_wedge_round_rect_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("wedgeEllipseCallout")) return shape_ptr(new basic_wedge_ellipse_callout<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("borderCallout1")) return shape_ptr(new basic_border_callout1<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("borderCallout2")) return shape_ptr(new basic_border_callout2<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("borderCallout3")) return shape_ptr(new basic_border_callout3<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("accentCallout1")) return shape_ptr(new basic_accent_callout1<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("accentCallout2")) return shape_ptr(new basic_accent_callout2<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("accentCallout3")) return shape_ptr(new basic_accent_callout3<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("callout1")) return shape_ptr(new basic_callout1<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("callout2")) return shape_ptr(new basic_callout2<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("callout3")) return shape_ptr(new basic_callout3<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("accentBorderCallout1")) return shape_ptr(new basic_accent_border_callout1<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("accentBorderCallout2")) return shape_ptr(new basic_accent_border_callout2<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("accentBorderCallout3")) return shape_ptr(new basic_accent_border_callout3<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("actionButtonBlank")) return shape_ptr(new basic_action_button_blank<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("actionButtonBackPrevious")) return shape_ptr(new basic_action_button_back_previous<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("actionButtonForwardNext")) return shape_ptr(new basic_action_button_forward_next<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("actionButtonBeginning")) return shape_ptr(new basic_action_button_beginning<Ch, Tr>(o, w, h, entag));
-				if (name == LITERAL("actionButtonEnd")) return shape_ptr(new basic_action_button_end<Ch, Tr>(o, w, h, entag));
-				return shape_ptr();
+				typedef detail::basic_shape_registry<Ch, Tr> registry;
+				typename registry::container::const_iterator pos = registry::get().find(name);
+				if (pos == registry::get().end()) return typename registry::shape_ptr();
+				return (pos->second)(o, w, h, entag);
 			}
 			
 			template <class CharT>
@@ -38,14 +38,18 @@
 #include "../config.h"
 #include <stdexcept>
 #include <algorithm>
+#include <set>
 #include <string>
 #include <iterator>
 #include <istream>
 #include "clx/literal.h"
 #include "clx/format.h"
+#include "clx/shared_ptr.h"
 #include "font.h"
 #include "text_contents.h"
 #include "circle.h"
+#include "metafile.h"
+#include "../dib.h"
 
 namespace faml {
 	namespace pdf {
@@ -64,6 +68,7 @@ namespace faml {
 				typedef std::basic_string<CharT, Traits> string_type;
 				typedef std::basic_istream<CharT, Traits> istream_type;
 				typedef basic_font<CharT, Traits> font_type;
+				typedef basic_dib_cache<CharT, Traits> dib_cache;
 				
 				typedef unsigned char  byte_type;
 				typedef unsigned short WORD_type;
@@ -71,10 +76,28 @@ namespace faml {
 				typedef short SHORT_type;
 				typedef long LONG_type;
 				
-				basic_wmf(istream_type& in) :
-					in_(in), font_(NULL), fontj_(NULL),
+				explicit basic_wmf(istream_type& in) :
+					buffer_(new std::vector<byte_type>()), src_(),
+					font_(NULL), fontj_(NULL), dibs_(NULL),
 					width_(0), height_(0), OffsetX_(0), OffsetY_(0),
-					scaleh_(1.0), scalev_(1.0) {}
+					scaleh_(1.0), scalev_(1.0), refs_() {
+					read_metafile(in, *buffer_);
+					if (!buffer_->empty()) src_ = metafile_cursor(&(*buffer_)[0], buffer_->size());
+				}
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  constructor
+				 *
+				 *  Parses the metafile in the memory buffer without copying
+				 *  it. The buffer must be alive until the object is used.
+				 */
+				/* --------------------------------------------------------- */
+				basic_wmf(const char_type* data, size_type n) :
+					buffer_(), src_(reinterpret_cast<const byte_type*>(data), n * sizeof(char_type)),
+					font_(NULL), fontj_(NULL), dibs_(NULL),
+					width_(0), height_(0), OffsetX_(0), OffsetY_(0),
+					scaleh_(1.0), scalev_(1.0), refs_() {}
 				
 				virtual ~basic_wmf() throw() {}
 				
@@ -87,35 +110,28 @@ namespace faml {
 				//  read_header
 				/* ------------------------------------------------------------- */
 				bool read_header() {
-					DWORD_type Key = 0;
-					xgetdata<DWORD_type>(Key);
+					DWORD_type Key = src_.u32();
 					bool amp = xcompare(Key,(DWORD_type)0x9AC6CDD7);
 				 	if (amp){
 				 		
 				 		/* Placeable WMF Header */
-				 		WORD_type Handle = 0;		xgetdata<WORD_type>(Handle);
-				 		SHORT_type Left = 0;		xgetdata<SHORT_type>(Left);
-				 		SHORT_type Top = 0;			xgetdata<SHORT_type>(Top);
-				 		SHORT_type Right = 0;		xgetdata<SHORT_type>(Right);
-				 		SHORT_type Bottom = 0;		xgetdata<SHORT_type>(Bottom);
-				 		WORD_type Inch = 0;			xgetdata<WORD_type>(Inch);
-				 		DWORD_type Reserved = 0;	xgetdata<DWORD_type>(Reserved);
-				 		WORD_type Checksum = 0;		xgetdata<WORD_type>(Checksum);
+				 		src_.skip(2);						// Handle
+				 		SHORT_type Left = src_.s16();
+				 		SHORT_type Top = src_.s16();
+				 		SHORT_type Right = src_.s16();
+				 		SHORT_type Bottom = src_.s16();
+				 		src_.skip(8);						// Inch, Reserved, Checksum
 				 		width_ = (size_type)(Right-Left);
 				 		height_ = (size_type)(Bottom-Top);
 				 		
 					}else{
-						in_.seekg(0);
+						src_.seek(0);
 					}
 					
 				 	/* Standard WMF Header */
-				 	WORD_type FileType = 0;			xgetdata<WORD_type>(FileType);
-				 	WORD_type HeaderSize = 0;		xgetdata<WORD_type>(HeaderSize);
-				 	WORD_type Version = 0;			xgetdata<WORD_type>(Version);
-				 	DWORD_type FileSize = 0;		xgetdata<DWORD_type>(FileSize);
-				 	WORD_type NumOfObjects = 0;		xgetdata<WORD_type>(NumOfObjects);
-				 	DWORD_type MaxRecordSize = 0;	xgetdata<DWORD_type>(MaxRecordSize);
-				 	WORD_type NumOfParams = 0;		xgetdata<WORD_type>(NumOfParams);
+				 	src_.skip(10);							// FileType, HeaderSize, Version, FileSize
+				 	WORD_type NumOfObjects = src_.u16();
+				 	src_.skip(6);							// MaxRecordSize, NumOfParams
 				 	for(int i=0; i<(int)NumOfObjects; i++){
 				 		BrushObject elem;
 				 		BrushObjectTable_.push_back(elem);
@@ -162,19 +178,44 @@ namespace faml {
 				void font1st(const font_type& f) { font_ = &f; }
 				void font2nd(const font_type& f) { fontj_ = &f; }
 				
+				/* --------------------------------------------------------- */
+				/*
+				 *  images
+				 *
+				 *  Sets the cache where the bitmaps in the metafile are
+				 *  stored. The bitmaps are drawn as the image XObjects, so
+				 *  they are ignored if the cache is not set.
+				 */
+				/* --------------------------------------------------------- */
+				void images(dib_cache& c) { dibs_ = &c; }
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  refs
+				 *
+				 *  Returns the labels of the image XObjects painted by the
+				 *  metafile (the bitmaps stored in the cache).
+				 */
+				/* --------------------------------------------------------- */
+				const std::set<string_type>& refs() const { return refs_; }
+				
 			private:
 				typedef clx::basic_format<CharT, Traits> fmt;
 				typedef basic_text_contents<CharT, Traits> text_contents;
+				typedef typename dib_cache::resource_type dib_type;
 				
-				istream_type& in_;
+				clx::shared_ptr<std::vector<byte_type> > buffer_; // only for the stream input
+				metafile_cursor src_;
 				const font_type* font_;
 				const font_type* fontj_;
+				dib_cache* dibs_;
 				int width_;
 				int height_;
 				int OffsetX_;
 				int OffsetY_;
 				double scaleh_;
 				double scalev_;
+				std::set<string_type> refs_;
 				
 				/* ------------------------------------------------------------- */
 				//  current_GDI_funciton
@@ -182,7 +223,7 @@ namespace faml {
 				struct current_GDI_function {
 					DWORD_type RecordSize;
 					WORD_type FunctionNumber;
-					std::vector<WORD_type> Parameters;
+					record_view<WORD_type> Parameters;
 					current_GDI_function() : RecordSize(0), FunctionNumber(0) {}
 				};
 				current_GDI_function CrFunc_;
@@ -274,33 +315,18 @@ namespace faml {
 				/* ------------------------------------------------------------- */
 				template <class OutStream>
 				bool xmakestream(OutStream& out) {
-					while(!in_.fail()){
-						xgetdata<DWORD_type>(CrFunc_.RecordSize);
-						xgetdata<WORD_type>(CrFunc_.FunctionNumber);
-					 	CrFunc_.Parameters.clear();
-						for(int i=1; i<=(int)CrFunc_.RecordSize-3; i++){
-							WORD_type Parameter;
-							xgetdata<WORD_type>(Parameter);
-							CrFunc_.Parameters.push_back(Parameter);
-						}
+					// RecordSize is the number of words including the size
+					// and function fields (3 words).
+					while(src_.rest() >= 6){
+						CrFunc_.RecordSize = src_.u32();
+						CrFunc_.FunctionNumber = src_.u16();
+						size_type n = (CrFunc_.RecordSize > 3) ? CrFunc_.RecordSize - 3 : 0;
+						CrFunc_.Parameters = src_.view<WORD_type>(n);
 						xGDI(out);
 					}
 					return true;
 				}
 				
-				/* ------------------------------------------------------------- */
-				//  xgetdata
-				/* ------------------------------------------------------------- */
-				template <class InStream, class Type>
-				bool xgetdata(Type& byte_data) {
-					Type dest = 0;
-					in_.read(reinterpret_cast<char*>(&dest), sizeof(Type));
-					if (in_.gcount() < static_cast<int>(sizeof(Type))) return Type(-1);
-					byte_data = dest;
-					if (in_.fail()) return false;
-					return true;
-				}
-				
 				/* ------------------------------------------------------------- */
 				//  xcompare
 				/* ------------------------------------------------------------- */
@@ -713,7 +739,11 @@ namespace faml {
 					if(font_size<0)font_size *= -1;
 					double X = OffsetX_ + (((SHORT_type)CrFunc_.Parameters[1]-CrStat_.OrgX)*(width_/(double)CrStat_.ExtX)*scaleh_);
 					double Y = OffsetY_ - (((SHORT_type)CrFunc_.Parameters[0]-CrStat_.OrgY-CrStat_.ExtY)*(height_/(double)CrStat_.ExtY)*scalev_);
-					std::string str = win32conv(&CrFunc_.Parameters[4],&CrFunc_.Parameters[(int)(CrFunc_.Parameters[2]/2.0)+4]);
+					std::vector<WORD_type> text;
+					for(size_type i=4; i<(size_type)(CrFunc_.Parameters[2]/2.0)+4; i++){
+						text.push_back(CrFunc_.Parameters[i]);
+					}
+					std::string str = win32conv(text.begin(), text.end());
 					out << LITERAL("BT") << std::endl;
 					text_contents txt(str, coordinate(X,Y), *font_, *fontj_, false);
 					txt.font_size(font_size);
@@ -784,82 +814,14 @@ namespace faml {
 					//SHORT_type YDest      = (SHORT_type)CrFunc_.Parameters[8];
 					//SHORT_type XDest      = (SHORT_type)CrFunc_.Parameters[9];
 					
-					// Bitmap Header Info
-					DWORD_type HeaderSize = xcombine<DWORD_type>(CrFunc_.Parameters[10],CrFunc_.Parameters[11]);
-					LONG_type Width = 0;
-					LONG_type Height = 0;
-					DWORD_type Planes = 0;
-					DWORD_type BitCount = 0;
-					DWORD_type Compression = 0;
-					DWORD_type ImageSize = 0;
-					DWORD_type XPelsPerMeter = 0;
-					DWORD_type YPelsPerMeter = 0;
-					DWORD_type ColorUsed = 0;
-					DWORD_type ColorImportant = 0;
-					bool amp = xcompare(HeaderSize, (DWORD_type)0x0000000C);
-					if(amp){
-						// BitmapCoreHeader
-						return true;
-					}else{
-						// BitmapInfoHeader
-						Width = xcombine<LONG_type>(CrFunc_.Parameters[12],CrFunc_.Parameters[13]);
-						Height = xcombine<LONG_type>(CrFunc_.Parameters[14],CrFunc_.Parameters[15]);
-						Planes = (DWORD_type)CrFunc_.Parameters[16];
-						BitCount = (DWORD_type)CrFunc_.Parameters[17];
-						Compression = xcombine<DWORD_type>(CrFunc_.Parameters[18],CrFunc_.Parameters[19]);
-						ImageSize = xcombine<DWORD_type>(CrFunc_.Parameters[20],CrFunc_.Parameters[21]);
-						XPelsPerMeter = xcombine<DWORD_type>(CrFunc_.Parameters[22],CrFunc_.Parameters[23]);
-						YPelsPerMeter = xcombine<DWORD_type>(CrFunc_.Parameters[24],CrFunc_.Parameters[25]);
-						ColorUsed = xcombine<DWORD_type>(CrFunc_.Parameters[26],CrFunc_.Parameters[27]);
-						ColorImportant = xcombine<DWORD_type>(CrFunc_.Parameters[28],CrFunc_.Parameters[29]);
-					}
-					
-					// Colors
-					amp = xcompare(BitCount, (DWORD_type)0x00000018);
-					if(!amp){
-						// Setting Colors
-						return true;
-					}
+					// Bitmap (DIB)
+					const dib_type* dib = this->xbitmap(10, true);
+					if (!dib) return true;
 					
-					// aData
-					if(amp){
-						// 24bit RGB
-						out << LITERAL("q") << std::endl;
-						out << fmt(LITERAL("%f 0 0 %f %d %d cm")) % (width_*scaleh_) % (height_*scalev_) % OffsetX_ % OffsetY_ << std::endl;
-						out << LITERAL("BI") << std::endl;
-						out << fmt(LITERAL("/W %d")) % Width << std::endl;
-						out << fmt(LITERAL("/H %d")) % Height << std::endl;
-						out << LITERAL("/BPC 8") << std::endl;
-						out << LITERAL("/CS /RGB") << std::endl;
-						out << LITERAL("ID") << std::endl;
-						DWORD_type WrittenBytes = 0;
-						int ArrayNumOfLine = (Width*3 + (4-(Width*3)%4)) / 2;
-						double lim = ArrayNumOfLine/3.0 - 1;
-						if(ArrayNumOfLine % 3 == 0) lim = ArrayNumOfLine / 3.0;
-						for(int i=1; i<=Height; i++){
-							int d = CrFunc_.Parameters.size() - i * ArrayNumOfLine;
-							for(int j=0; j<lim; j++){
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3+1],0);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3],1);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3],0);
-								WrittenBytes += 3;
-								if(WrittenBytes % (Width*3) == 0) break;
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3+2],1);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3+2],0);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3+1],1);
-								WrittenBytes += 3;
-							}
-							if(ArrayNumOfLine % 3 == 2){
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+ArrayNumOfLine-1],0);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+ArrayNumOfLine-2],1);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+ArrayNumOfLine-2],0);
-								WrittenBytes += 3;
-							}
-						}
-						out << LITERAL(">") << std::endl;
-						out << LITERAL("EI") << std::endl;
-						out << LITERAL("Q") << std::endl;
-					}
+					out << LITERAL("q") << std::endl;
+					out << fmt(LITERAL("%f 0 0 %f %d %d cm")) % (width_*scaleh_) % (height_*scalev_) % OffsetX_ % OffsetY_ << std::endl;
+					out << fmt(LITERAL("/%s Do")) % dib->label() << std::endl;
+					out << LITERAL("Q") << std::endl;
 					return true;
 				}
 				
@@ -869,7 +831,7 @@ namespace faml {
 					
 					// Record Info
 					//DWORD_type RasterOperation = xcombine<DWORD_type>(CrFunc_.Parameters[0],CrFunc_.Parameters[1]);
-					//SHORT_type ColorUsage = (SHORT_type)CrFunc_.Parameters[2];
+					SHORT_type ColorUsage = (SHORT_type)CrFunc_.Parameters[2];
 					//SHORT_type SrcHeight  = (SHORT_type)CrFunc_.Parameters[3];
 					//SHORT_type SrcWidth   = (SHORT_type)CrFunc_.Parameters[4];
 					//SHORT_type YSrc       = (SHORT_type)CrFunc_.Parameters[5];
@@ -879,84 +841,37 @@ namespace faml {
 					SHORT_type YDest      = (SHORT_type)CrFunc_.Parameters[9];
 					SHORT_type XDest      = (SHORT_type)CrFunc_.Parameters[10];
 					
-					// Bitmap Header Info
-					DWORD_type HeaderSize = xcombine<DWORD_type>(CrFunc_.Parameters[11],CrFunc_.Parameters[12]);
-					LONG_type Width = 0;
-					LONG_type Height = 0;
-					DWORD_type Planes = 0;
-					DWORD_type BitCount = 0;
-					DWORD_type Compression = 0;
-					DWORD_type ImageSize = 0;
-					DWORD_type XPelsPerMeter = 0;
-					DWORD_type YPelsPerMeter = 0;
-					DWORD_type ColorUsed = 0;
-					DWORD_type ColorImportant = 0;
-					bool amp = xcompare(HeaderSize, (DWORD_type)0x0000000C);
-					if(amp){
-						// BitmapCoreHeader
-						return true;
-					}else{
-						// BitmapInfoHeader
-						Width = xcombine<LONG_type>(CrFunc_.Parameters[13],CrFunc_.Parameters[14]);
-						Height = xcombine<LONG_type>(CrFunc_.Parameters[15],CrFunc_.Parameters[16]);
-						Planes = (DWORD_type)CrFunc_.Parameters[17];
-						BitCount = (DWORD_type)CrFunc_.Parameters[18];
-						Compression = xcombine<DWORD_type>(CrFunc_.Parameters[19],CrFunc_.Parameters[20]);
-						ImageSize = xcombine<DWORD_type>(CrFunc_.Parameters[21],CrFunc_.Parameters[22]);
-						XPelsPerMeter = xcombine<DWORD_type>(CrFunc_.Parameters[23],CrFunc_.Parameters[24]);
-						YPelsPerMeter = xcombine<DWORD_type>(CrFunc_.Parameters[25],CrFunc_.Parameters[26]);
-						ColorUsed = xcombine<DWORD_type>(CrFunc_.Parameters[27],CrFunc_.Parameters[28]);
-						ColorImportant = xcombine<DWORD_type>(CrFunc_.Parameters[29],CrFunc_.Parameters[30]);
-					}
-					
-					// Colors
-					amp = xcompare(BitCount, (DWORD_type)0x00000018);
-					if(!amp){
-						// Setting Colors
-						return true;
-					}
+					// Bitmap (DIB). ColorUsage 0 is DIB_RGB_COLORS.
+					const dib_type* dib = this->xbitmap(11, ColorUsage == 0);
+					if (!dib) return true;
 					
-					// aData
-					if(amp){
-						// 24bit RGB
-						out << LITERAL("q") << std::endl;
-						out << fmt(LITERAL("%f 0 0 %f %d %d cm")) % (DestWidth*scaleh_) % (DestHeight*scalev_) % (XDest*scaleh_) % (-(DestHeight+YDest)*scalev_) << std::endl;
-						out << LITERAL("BI") << std::endl;
-						out << fmt(LITERAL("/W %d")) % Width << std::endl;
-						out << fmt(LITERAL("/H %d")) % Height << std::endl;
-						out << LITERAL("/BPC 8") << std::endl;
-						out << LITERAL("/CS /RGB") << std::endl;
-						out << LITERAL("ID") << std::endl;
-						DWORD_type WrittenBytes = 0;
-						int ArrayNumOfLine = (Width*3 + (4-(Width*3)%4)) / 2;
-						double lim = ArrayNumOfLine/3.0 - 1;
-						if(ArrayNumOfLine % 3 == 0) lim = ArrayNumOfLine / 3.0;
-						for(int i=1; i<=Height; i++){
-							int d = CrFunc_.Parameters.size() - i * ArrayNumOfLine;
-							for(int j=0; j<lim; j++){
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3+1],0);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3],1);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3],0);
-								WrittenBytes += 3;
-								if(WrittenBytes % (Width*3) == 0) break;
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3+2],1);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3+2],0);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+j*3+1],1);
-								WrittenBytes += 3;
-							}
-							if(ArrayNumOfLine % 3 == 2){
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+ArrayNumOfLine-1],0);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+ArrayNumOfLine-2],1);
-								out << xdivide<byte_type>(CrFunc_.Parameters[d+ArrayNumOfLine-2],0);
-								WrittenBytes += 3;
-							}
-						}
-						out << LITERAL(">") << std::endl;
-						out << LITERAL("EI") << std::endl;
-						out << LITERAL("Q") << std::endl;
-					}
+					out << LITERAL("q") << std::endl;
+					out << fmt(LITERAL("%f 0 0 %f %d %d cm")) % (DestWidth*scaleh_) % (DestHeight*scalev_) % (XDest*scaleh_) % (-(DestHeight+YDest)*scalev_) << std::endl;
+					out << fmt(LITERAL("/%s Do")) % dib->label() << std::endl;
+					out << LITERAL("Q") << std::endl;
 					return true;
 				}
+				
+				/* ------------------------------------------------------------- */
+				/*
+				 *  xbitmap
+				 *
+				 *  Reads the DIB that begins at Parameters[first] and adds
+				 *  it to the image cache. Returns NULL if the cache is not
+				 *  set or the DIB is not supported.
+				 */
+				/* ------------------------------------------------------------- */
+				const dib_type* xbitmap(size_type first, bool rgb) {
+					if (!dibs_ || CrFunc_.Parameters.size() <= first) return NULL;
+					
+					dib_type dib;
+					const byte_type* p = CrFunc_.Parameters.data() + first * sizeof(WORD_type);
+					size_type n = (CrFunc_.Parameters.size() - first) * sizeof(WORD_type);
+					if (!dib.read(p, n, rgb)) return NULL;
+					const dib_type& dest = dibs_->insert(dib);
+					refs_.insert(dest.label());
+					return &dest;
+				}
 			};
 		}
 	}
@@ -0,0 +1,370 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  dib.h
+ *
+ *  Copyright (c) 2009, Four and More. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_PDF_DIB_H
+#define FAML_PDF_DIB_H
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "utility.h"
+#include "clx/literal.h"
+#include "clx/format.h"
+#include "clx/zstream.h"
+
+namespace faml {
+	namespace pdf {
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  dib_resource
+		 *
+		 *  The dib_resource class decodes the device independent bitmap
+		 *  (i.e., the BITMAPINFO structure followed by the pixels, which
+		 *  is embedded in metafile records) and writes it as the image
+		 *  XObject. 1, 4 and 8 bit images are written as the indexed
+		 *  images without expanding the pixels. The pixels and the
+		 *  color table are freed once the XObject is written, and
+		 *  the digest is kept for finding the duplicates.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class dib_resource {
+		public:
+			typedef size_t size_type;
+			typedef unsigned char byte_type;
+			typedef CharT char_type;
+			typedef std::basic_string<CharT, Traits> string_type;
+			typedef faml::pdf::digest digest_type;
+			typedef clx::basic_zstream<Z_DEFAULT_COMPRESSION, CharT, Traits> zstream;
+			
+			dib_resource() :
+				index_(0), label_(), width_(0), height_(0), bits_(0),
+				colors_(), data_(), digest_() {}
+				
+			/* ------------------------------------------------------------- */
+			/*
+			 *  read
+			 *
+			 *  Reads the packed DIB. If rgb is false, the color table
+			 *  consists of the indices to the logical palette, which is
+			 *  not supported (the method returns false).
+			 */
+			/* ------------------------------------------------------------- */
+			bool read(const byte_type* src, size_type n, bool rgb = true) {
+				if (n < 12) return false;
+				
+				size_type header = this->xget32(src);
+				long width = 0, height = 0;
+				size_type bits = 0, ncolors = 0, entry = 4;
+				if (header == 12) { // BITMAPCOREHEADER
+					width = this->xget16(src + 4);
+					height = static_cast<short>(this->xget16(src + 6));
+					bits = this->xget16(src + 10);
+					entry = 3;
+				}
+				else if (header >= 40 && n >= 40) { // BITMAPINFOHEADER (or later)
+					width = static_cast<long>(static_cast<int>(this->xget32(src + 4)));
+					height = static_cast<long>(static_cast<int>(this->xget32(src + 8)));
+					bits = this->xget16(src + 14);
+					if (this->xget32(src + 16) != 0) return false; // compressed (BI_RLE8, ...)
+					ncolors = this->xget32(src + 32);
+				}
+				else return false;
+				
+				if (width <= 0 || height == 0) return false;
+				if (bits <= 8) {
+					if (!rgb) return false;
+					if (ncolors == 0 || ncolors > (1U << bits)) ncolors = 1 << bits;
+				}
+				else if (bits != 16 && bits != 24 && bits != 32) return false;
+				else if (header >= 40) ncolors = 0;
+				
+				bool bottomup = (height > 0);
+				size_type w = static_cast<size_type>(width);
+				size_type h = static_cast<size_type>(bottomup ? height : -height);
+				size_type stride = (w * bits + 31) / 32 * 4;
+				size_type offset = header + ncolors * entry;
+				if (offset > n || stride * h > n - offset) return false;
+				
+				width_ = w;
+				height_ = h;
+				bits_ = bits;
+				colors_.clear();
+				for (size_type i = 0; i < ncolors; ++i) {
+					const byte_type* p = src + header + i * entry;
+					colors_.push_back((p[2] << 16) | (p[1] << 8) | p[0]);
+				}
+				
+				size_type line = this->xline();
+				data_.resize(line * h);
+				for (size_type i = 0; i < h; ++i) {
+					const byte_type* p = src + offset + (bottomup ? h - i - 1 : i) * stride;
+					byte_type* dest = &data_[i * line];
+					switch (bits_) {
+					case 1:
+					case 4:
+					case 8:
+						std::memcpy(dest, p, line);
+						break;
+					case 16: // X1 R5 G5 B5
+						for (size_type j = 0; j < w; ++j, p += 2) {
+							unsigned int c = p[0] | (p[1] << 8);
+							*dest++ = static_cast<byte_type>(((c >> 10) & 0x1f) * 255 / 31);
+							*dest++ = static_cast<byte_type>(((c >> 5) & 0x1f) * 255 / 31);
+							*dest++ = static_cast<byte_type>((c & 0x1f) * 255 / 31);
+						}
+						break;
+					default: // 24 or 32 (BGR or BGRX)
+					{
+						size_type bytes = bits_ / 8;
+						for (size_type j = 0; j < w; ++j, p += bytes) {
+							*dest++ = p[2];
+							*dest++ = p[1];
+							*dest++ = p[0];
+						}
+						break;
+					}
+					}
+				}
+				
+				digest_ = this->xdigest();
+				return true;
+			}
+			
+			template <class OutStream, class PDFManager>
+			bool operator()(OutStream& out, PDFManager& pm) {
+				if (data_.empty()) return false;
+				if (!this->xobject(out, pm)) return false;
+				std::vector<size_type>().swap(colors_);
+				std::vector<byte_type>().swap(data_);
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  same
+			/* ------------------------------------------------------------- */
+			bool same(const dib_resource& x) const {
+				return width_ == x.width_ && height_ == x.height_ &&
+					bits_ == x.bits_ && digest_ == x.digest_;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  Access methods (get).
+			/* ------------------------------------------------------------- */
+			const string_type& label() const { return label_; }
+			size_type index() const { return index_; }
+			size_type width() const { return width_; }
+			size_type height() const { return height_; }
+			size_type bits() const { return bits_; }
+			const digest_type& digest() const { return digest_; }
+			bool empty() const { return data_.empty(); }
+			
+			/* ------------------------------------------------------------- */
+			//  Access methods (set).
+			/* ------------------------------------------------------------- */
+			void label(const string_type& cp) { label_ = cp; }
+			
+		private:
+			typedef clx::basic_format<CharT, Traits> fmt;
+			
+			size_type index_;
+			string_type label_;
+			size_type width_;
+			size_type height_;
+			size_type bits_;
+			std::vector<size_type> colors_;
+			std::vector<byte_type> data_; // top-down rows without padding
+			digest_type digest_; // of the size, the color table and pixels
+			
+			/* ------------------------------------------------------------- */
+			//  xobject
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager>
+			bool xobject(OutStream& out, PDFManager& pm) {
+				index_ = pm.newindex();
+				
+				out << fmt(LITERAL("%d 0 obj")) % index_ << std::endl;
+				out << LITERAL("<<") << std::endl;
+				out << LITERAL("/Type /XObject") << std::endl;
+				out << LITERAL("/Subtype /Image") << std::endl;
+				out << LITERAL("/Name /") << label_ << std::endl;
+				out << LITERAL("/Width ") << width_ << std::endl;
+				out << LITERAL("/Height ") << height_ << std::endl;
+				out << LITERAL("/BitsPerComponent ") << (colors_.empty() ? 8 : bits_) << std::endl;
+				out << LITERAL("/Filter [ /FlateDecode ]") << std::endl;
+				if (colors_.empty()) out << LITERAL("/ColorSpace /DeviceRGB") << std::endl;
+				else {
+					out << fmt(LITERAL("/ColorSpace [ /Indexed /DeviceRGB %d < ")) % (colors_.size() - 1);
+					for (size_type i = 0; i < colors_.size(); ++i) {
+						out << fmt(LITERAL("%06X ")) % colors_.at(i);
+					}
+					out << LITERAL("> ]") << std::endl;
+				}
+				out << fmt(LITERAL("/Length %d 0 R")) % (pm.index() + 1) << std::endl;
+				out << LITERAL(">>") << std::endl;
+				out << LITERAL("stream") << std::endl;
+				size_type pos = static_cast<size_type>(out.tellp());
+				{
+					zstream z(out);
+					z.write(reinterpret_cast<const char_type*>(&data_[0]), data_.size());
+					z.finish();
+				}
+				out << std::endl;
+				size_type size = static_cast<size_type>(out.tellp()) - pos;
+				out << LITERAL("endstream") << std::endl;
+				out << LITERAL("endobj") << std::endl;
+				out << std::endl;
+				
+				out << fmt(LITERAL("%d 0 obj")) % pm.newindex() << std::endl;
+				out << size << std::endl;
+				out << LITERAL("endobj") << std::endl;
+				out << std::endl;
+				
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xline
+			/* ------------------------------------------------------------- */
+			size_type xline() const {
+				if (bits_ <= 8) return (width_ * bits_ + 7) / 8;
+				return width_ * 3;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xdigest
+			 *
+			 *  Digest of the image size, the color table and pixels.
+			 */
+			/* ------------------------------------------------------------- */
+			digest_type xdigest() const {
+				digest_type dest;
+				dest.update(width_).update(height_).update(bits_);
+				for (size_type i = 0; i < colors_.size(); ++i) dest.update(colors_[i]);
+				dest.update(data_.begin(), data_.end());
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xget16, xget32 (little endian)
+			/* ------------------------------------------------------------- */
+			size_type xget16(const byte_type* p) const {
+				return p[0] | (p[1] << 8);
+			}
+			
+			size_type xget32(const byte_type* p) const {
+				return static_cast<size_type>(p[0] | (p[1] << 8) | (p[2] << 16)) |
+					(static_cast<size_type>(p[3]) << 24);
+			}
+		};
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_dib_cache
+		 *
+		 *  The basic_dib_cache class keeps the bitmaps drawn by metafiles
+		 *  throughout the document, so that the same bitmap is written
+		 *  only once. insert() returns the stored (shared) resource whose
+		 *  label is used in the content stream, and operator() writes
+		 *  the new resources and appends the ones used in the current
+		 *  page to the XObject list of the page resources. The label
+		 *  is given when a resource is stored, so duplicates do not
+		 *  use up the label numbers.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_dib_cache {
+		public:
+			typedef size_t size_type;
+			typedef dib_resource<CharT, Traits> resource_type;
+			typedef std::deque<resource_type> container;
+			
+			basic_dib_cache() : v_(), digest_(), used_(), page_() {}
+			
+			const resource_type& insert(const resource_type& x) {
+				typedef typename std::map<digest, size_type>::const_iterator iterator;
+				iterator pos = digest_.find(x.digest());
+				if (pos != digest_.end() && v_.at(pos->second).same(x)) return this->xuse(pos->second);
+				
+				v_.push_back(x);
+				v_.back().label(makelabel(LITERAL("Im")));
+				digest_.insert(std::make_pair(x.digest(), v_.size() - 1));
+				return this->xuse(v_.size() - 1);
+			}
+			
+			template <class OutStream, class PDFManager, class Container>
+			bool operator()(OutStream& out, PDFManager& pm, Container& dest) {
+				for (size_type i = 0; i < used_.size(); ++i) {
+					resource_type& elem = v_.at(used_.at(i));
+					if (elem.index() == 0 && !elem(out, pm)) return false;
+					
+					typename Container::value_type obj;
+					obj.index = static_cast<int>(elem.index());
+					obj.label = elem.label();
+					dest.push_back(obj);
+				}
+				used_.clear();
+				page_.clear();
+				return true;
+			}
+			
+			bool empty() const { return used_.empty(); }
+			size_type size() const { return v_.size(); }
+			
+		private:
+			container v_;
+			std::map<digest, size_type> digest_;
+			std::vector<size_type> used_; // resources used in the current page
+			std::set<size_type> page_;
+			
+			const resource_type& xuse(size_type n) {
+				if (page_.insert(n).second) used_.push_back(n);
+				return v_.at(n);
+			}
+		};
+	}
+}
+
+#endif // FAML_PDF_DIB_H
@@ -16,6 +16,8 @@
 #include "clx/literal.h"
 #include "clx/format.h"
 #include "clx/shared_ptr.h"
+#include "clx/utility.h"
+#include "clx/vstream.h"
 
 #include "unit.h"
 #include "code_convert.h"
@@ -25,6 +27,9 @@
 #include "text_helper.h"
 #include "jpeg.h"
 #include "png.h"
+#include "resample.h"
+#include "profile.h"
+#include "font_factory.h"
 
 #include "contents/msshape.h"
 #include "contents/wmf.h"
@@ -43,6 +48,7 @@
 #include "contents/scatterchart.h"
 #include "contents/table.h"
 #include "text_contents.h"
+#include "text_state.h"
 
 #include "docx/document.h"
 
@@ -65,10 +71,76 @@ namespace faml {
 			typedef basic_font<CharT, Traits> font_object;
 			typedef std::map<string_type, font_object> font_map;
 			
+			typedef faml::docx::basic_document<CharT, Traits> doc_type;
+			typedef typename doc_type::storage_type storage_type;
+			
 			basic_docx(const string_type& path) :
-				doc_(path), pp_(slide::width, slide::height), f_(),
-				space_(5.4), baseline_(18.0) {
-				this->xinit(path);
+				ff_(xfactory()), doc_(storage_type(path)), pp_(slide::width, slide::height), f_(),
+				space_(5.4), baseline_(18.0), dpi_(0.0) {
+				this->xinit();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  constructor
+			 *
+			 *  The following constructors read the docx data from the
+			 *  input stream, the memory buffer, or the file descriptor
+			 *  without creating any temporary file. The memory buffer is
+			 *  not copied, so it must be alive until the conversion is
+			 *  finished.
+			 */
+			/* ------------------------------------------------------------- */
+			explicit basic_docx(std::basic_istream<CharT, Traits>& in) :
+				ff_(xfactory()), doc_(storage_type(in)), pp_(slide::width, slide::height), f_(),
+				space_(5.4), baseline_(18.0), dpi_(0.0) {
+				this->xinit();
+			}
+			
+			basic_docx(const char_type* data, size_type n) :
+				ff_(xfactory()), doc_(storage_type(data, n)), pp_(slide::width, slide::height), f_(),
+				space_(5.4), baseline_(18.0), dpi_(0.0) {
+				this->xinit();
+			}
+			
+			explicit basic_docx(int fd) :
+				ff_(xfactory()), doc_(storage_type(fd)), pp_(slide::width, slide::height), f_(),
+				space_(5.4), baseline_(18.0), dpi_(0.0) {
+				this->xinit();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  constructor (with the font factory)
+			 *
+			 *  The fonts are created by ff, so the fonts registered to ff
+			 *  (and the properties read from them) are shared with the
+			 *  other documents. The other constructors use the empty
+			 *  factory, i.e., only the built-in fonts.
+			 */
+			/* ------------------------------------------------------------- */
+			basic_docx(const string_type& path, font_factory& ff) :
+				ff_(ff), doc_(storage_type(path)), pp_(slide::width, slide::height), f_(),
+				space_(5.4), baseline_(18.0), dpi_(0.0) {
+				this->xinit();
+			}
+			
+			basic_docx(std::basic_istream<CharT, Traits>& in, font_factory& ff) :
+				ff_(ff), doc_(storage_type(in)), pp_(slide::width, slide::height), f_(),
+				space_(5.4), baseline_(18.0), dpi_(0.0) {
+				this->xinit();
+			}
+			
+			basic_docx(const char_type* data, size_type n, font_factory& ff) :
+				ff_(ff), doc_(storage_type(data, n)), pp_(slide::width, slide::height), f_(),
+				space_(5.4), baseline_(18.0), dpi_(0.0) {
+				this->xinit();
+			}
+			
+			basic_docx(int fd, font_factory& ff) :
+				ff_(ff), doc_(storage_type(fd)), pp_(slide::width, slide::height), f_(),
+				space_(5.4), baseline_(18.0), dpi_(0.0) {
+				this->xinit();
 			}
 			
 			virtual ~basic_docx() throw() {}
@@ -76,23 +148,44 @@ namespace faml {
 			template <class OutStream, class PDFManager>
 			bool operator()(OutStream& out, PDFManager& pm) {
 				// currently implementation
-				for (typename font_map::iterator pos = f_.begin(); pos != f_.end(); ++pos) {
-					(pos->second)(out, pm);
+				{
+					scoped_phase<PDFManager> phase(pm, "font");
+					for (typename font_map::iterator pos = f_.begin(); pos != f_.end(); ++pos) {
+						(pos->second)(out, pm);
+					}
+				}
+				
+				// The images in the body are written with the page where
+				// they are used first (see xput_image_objects()).
+				place_.clear();
+				if (dpi_ > 0.0) {
+					this->xplacement(doc_.header());
+					this->xplacement(doc_.footer());
 				}
 				
-				this->xobjects(out, pm, doc_.texts());
-				this->xobjects(out, pm, doc_.header());
-				this->xobjects(out, pm, doc_.footer());
+				{
+					scoped_phase<PDFManager> phase(pm, "image");
+					this->xobjects(out, pm, doc_.header());
+					this->xobjects(out, pm, doc_.footer());
+				}
 				
 				size_type i = 0;
 				while (i < doc_.size()) {
+					scoped_page<PDFManager> timer(pm);
 					page_object newpage;
 					
 					int idx = 0;
 					idx = this->xcontents(out, pm, i);
 					if (idx < 0) throw std::runtime_error("something was happened in the contents object");
 					newpage.contents(idx);
+					this->xput_image_objects(out, pm);
 					this->xput_font_objects(out, pm);
+					if (!dibs_.empty() && !dibs_(out, pm, cur_.objs)) {
+						throw std::runtime_error("error is occured in metafile bitmap resource.");
+					}
+					if (!this->xput_form_object(out, pm, header_) || !this->xput_form_object(out, pm, footer_)) {
+						throw std::runtime_error("error is occured in header/footer resource.");
+					}
 					idx = this->xresources(out, pm);
 					if (idx < 0) throw std::runtime_error("something was happened in the contents object");
 					newpage.resources(idx);
@@ -100,30 +193,55 @@ namespace faml {
 					newpage.property(pp_);
 					if (!newpage(out, pm)) throw std::runtime_error("something was happened in the page object");
 				}
+				doc_.release();
+				
+				// subsets of the embedded fonts are made from the used glyphs.
+				{
+					scoped_phase<PDFManager> phase(pm, "font");
+					for (typename font_map::iterator pos = f_.begin(); pos != f_.end(); ++pos) {
+						if (!(pos->second).finish(out, pm)) {
+							throw std::runtime_error("error is occured in font file resource.");
+						}
+					}
+				}
 				
 				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  dpi
+			 *
+			 *  Sets the maximum resolution of the embedded images. Images
+			 *  whose resolution at the placed size exceeds the value are
+			 *  downsampled. The value 0 (default) disables downsampling.
+			 */
+			/* ------------------------------------------------------------- */
+			void dpi(double value) { dpi_ = value; }
+			double dpi() const { return dpi_; }
+			
 		private:
 			typedef clx::basic_format<CharT, Traits> fmt;
-			typedef clx::basic_unzip<CharT, Traits> storage_type;
-			typedef faml::docx::basic_document<CharT, Traits> doc_type;
 			typedef basic_font_property<CharT, Traits> font_property;
 			
 			// contents
 			typedef basic_text_contents<CharT, Traits> text_contents;
+			typedef basic_text_state<CharT, Traits> text_state;
 			typedef basic_image_contents<CharT, Traits> image_contents;
 			typedef contents::basic_table<CharT, Traits> table_contents;
 			typedef contents::basic_shape<CharT, Traits> shape_contents;
 			typedef clx::shared_ptr<shape_contents> shape_ptr;
 			
 			// member variables
+			font_factory& ff_;
 			doc_type doc_;
 			storage_type in_;
 			page_property pp_;
 			font_map f_;
 			double space_;
 			double baseline_;
+			double dpi_;
+			basic_placement<CharT, Traits> place_;
 			
 			/* ------------------------------------------------------------- */
 			//  xobject
@@ -134,6 +252,34 @@ namespace faml {
 				string_type path;
 			};
 			std::deque<xobj_type> objs_;
+			basic_dib_cache<CharT, Traits> dibs_; // bitmaps in metafiles
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  form_type
+			 *
+			 *  The form_type structure keeps the header (or footer) that
+			 *  is rendered only once as the Form XObject. Each page paints
+			 *  the form by the Do operator instead of rendering it again.
+			 */
+			/* ------------------------------------------------------------- */
+			struct form_type {
+				int index;					// 0: the object is not written yet
+				string_type label;
+				string_type data;			// content stream (compressed if possible)
+				string_type filter;
+				std::set<string_type> refs;	// XObjects painted in the form
+				double x;					// cursor position after the form is drawn
+				double y;
+				bool cached;
+				bool used;					// used in the current page
+				
+				form_type() :
+					index(0), label(), data(), filter(), refs(),
+					x(0), y(0), cached(false), used(false) {}
+			};
+			form_type header_;
+			form_type footer_;
 			
 			/* ------------------------------------------------------------- */
 			/*
@@ -168,30 +314,41 @@ namespace faml {
 				size_type cht;
 				int interrupt;
 				bool head;
+				text_state* ts;				// state of the content stream being written
+				std::set<string_type>* refs;	// XObjects painted in the form being rendered
 				
 				current_status() :
 					x(0), y(0), width(0), height(0), fonts(), fused(),
 					para(0), tbl(0), objs(), lists(),
-					txt(0), shp(0), img(0), cht(0), interrupt(-1), head(true) {}
+					txt(0), shp(0), img(0), cht(0), interrupt(-1), head(true), ts(NULL), refs(NULL) {}
 			};
 			current_status cur_;
 			
+			/* ------------------------------------------------------------- */
+			//  xfactory
+			/* ------------------------------------------------------------- */
+			static font_factory& xfactory() {
+				static font_factory dest;
+				return dest;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  xinit
 			/* ------------------------------------------------------------- */
-			void xinit(const string_type& path) {
+			void xinit() {
 				string_type latin(LITERAL(DOCX_DEFAULT_LATIN));
 				string_type japan(LITERAL(DOCX_DEFAULT_JAPAN));
 				
-				font_object f(latin, charset::utf16);
-				font_object fj(japan, charset::utf16);
+				font_object f = ff_.create(latin, charset::utf16);
+				font_object fj = ff_.create(japan, charset::utf16);
 				
 				f_[latin] = f;
 				f_[japan] = fj;
 				cur_.fused.insert(latin);
 				cur_.fused.insert(japan);
 				
-				if (!in_.open(path)) throw std::runtime_error("cannot find docx file");
+				in_ = doc_.storage();
+				if (!in_.is_open()) throw std::runtime_error("cannot find docx file");
 			}
 			
 			/* ------------------------------------------------------------- */
@@ -199,6 +356,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager>
 			bool xput_font_objects(OutStream& out, PDFManager& pm) {
+				scoped_phase<PDFManager> phase(pm, "font");
 				for (typename font_map::iterator pos = cur_.fonts.begin();
 					pos != cur_.fonts.end(); ++pos) {
 					(pos->second)(out, pm);
@@ -209,46 +367,130 @@ namespace faml {
 			}
 			
 			/* ------------------------------------------------------------- */
-			//  xobjects
+			/*
+			 *  xplacement
+			 *
+			 *  Collects the largest size at which each image is placed
+			 *  (the size is used to determine the resolution of images).
+			 */
+			/* ------------------------------------------------------------- */
+			template <class Source>
+			void xplacement(const Source& src) {
+				for (size_type i = 0; i < src.size(); ++i) {
+					for (size_type j = 0; j < src.at(i).images().size(); ++j) {
+						place_.add(src.at(i).images().at(j).reference(),
+							src.at(i).images().at(j).width(), src.at(i).images().at(j).height());
+					}
+				}
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xobjects
+			 *
+			 *  Writes the images in src at once. The method is used for
+			 *  the header and footer, which are rendered before the body.
+			 */
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager, class Source>
 			bool xobjects(OutStream& out, PDFManager& pm, const Source& src) {
 				for (size_type i = 0; i < src.size(); ++i) {
 					for (size_type j = 0; j < src.at(i).images().size(); ++j) {
-						string_type ref = src.at(i).images().at(j).reference();
-						if (ref.empty() || ref.compare(0, 5, LITERAL("chart")) == 0) continue;
-						string_type ext = ref.substr(ref.find_last_of(LITERAL(".")));
-						if (ext == LITERAL(".wmf") || ext == LITERAL(".emf")) continue;
-						
-						typename storage_type::iterator pos = in_.find(ref);
-						if (pos == in_.end()) throw std::runtime_error("cannot find image file");
-						std::vector<char_type> s;
-						clx::read(*pos, s);
-						clx::basic_ivstream<CharT, Traits> vs(s);
-						
-						xobj_type elem;
-						elem.path = pos->path();
-						if (ext == LITERAL(".jpeg") || ext == LITERAL(".jpg")) {
-							jpeg_resource<CharT, Traits> jpeg(vs);
-							if (!jpeg(out, pm)) throw std::runtime_error("error is occured in jpeg resource.");
-							elem.index = jpeg.index();
-							elem.label = jpeg.label();
-						}
-						else if (ext == LITERAL(".png")) {
-							png_resource<CharT, Traits> png(vs);
-							if (!png(out, pm)) throw std::runtime_error("error is occured in png resource.");
-							elem.index = png.index();
-							elem.label = png.label();
-						}
-						else continue;
-						
-						objs_.push_back(elem);
+						xobj_type* elem = this->xfind_object(src.at(i).images().at(j).reference());
+						if (elem && elem->index == 0) this->xput_image_object(out, pm, *elem);
 					}
 				}
 				
 				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xput_image_objects
+			 *
+			 *  Writes the images which are painted in the current page
+			 *  for the first time. The label of each image is given when
+			 *  it is painted (see xput_image()), so the image data is read
+			 *  only after the contents of the page are fixed. Images are
+			 *  downsampled at the largest size placed so far.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager>
+			bool xput_image_objects(OutStream& out, PDFManager& pm) {
+				scoped_phase<PDFManager> phase(pm, "image");
+				typedef typename std::deque<xobj_type>::iterator iter;
+				for (iter it = cur_.objs.begin(); it != cur_.objs.end(); ++it) {
+					if (it->index != 0 || it->path.empty()) continue;
+					xobj_type* elem = this->xfind_object(it->path);
+					if (!elem) continue;
+					if (elem->index == 0) this->xput_image_object(out, pm, *elem);
+					it->index = elem->index;
+				}
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xput_image_object
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager>
+			bool xput_image_object(OutStream& out, PDFManager& pm, xobj_type& elem) {
+				string_type ext = elem.path.substr(elem.path.find_last_of(LITERAL(".")));
+				typename storage_type::iterator pos = in_.find(elem.path);
+				if (pos == in_.end()) throw std::runtime_error("cannot find image file");
+				std::vector<char_type> s;
+				clx::read(*pos, s);
+				clx::basic_ivstream<CharT, Traits> vs(s);
+				
+				double pw = 0.0, ph = 0.0;
+				place_.find(elem.path, pw, ph);
+				if (ext == LITERAL(".jpeg") || ext == LITERAL(".jpg")) {
+					jpeg_resource<CharT, Traits> jpeg(vs);
+					jpeg.label(elem.label);
+					jpeg.downsample(dpi_, pw, ph);
+					if (!jpeg(out, pm)) throw std::runtime_error("error is occured in jpeg resource.");
+					elem.index = jpeg.index();
+				}
+				else {
+					png_resource<CharT, Traits> png(vs);
+					png.label(elem.label);
+					png.downsample(dpi_, pw, ph);
+					if (!png(out, pm)) throw std::runtime_error("error is occured in png resource.");
+					elem.index = png.index();
+				}
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xfind_object
+			 *
+			 *  Returns the image XObject of the reference. The object is
+			 *  added (with the new label and without the object number)
+			 *  when the reference is found first. NULL is returned for
+			 *  the references which are not written as image XObjects
+			 *  (charts and metafiles).
+			 */
+			/* ------------------------------------------------------------- */
+			xobj_type* xfind_object(const string_type& ref) {
+				if (ref.empty() || ref.compare(0, 5, LITERAL("chart")) == 0) return NULL;
+				size_type pos = ref.find_last_of(LITERAL("."));
+				if (pos == string_type::npos) return NULL;
+				string_type ext = ref.substr(pos);
+				if (ext != LITERAL(".jpeg") && ext != LITERAL(".jpg") && ext != LITERAL(".png")) return NULL;
+				
+				typedef typename std::deque<xobj_type>::iterator iter;
+				for (iter it = objs_.begin(); it != objs_.end(); ++it) {
+					if (it->path == ref) return &(*it);
+				}
+				
+				xobj_type elem;
+				elem.index = 0;
+				elem.label = makelabel(LITERAL("Im"));
+				elem.path = ref;
+				objs_.push_back(elem);
+				return &objs_.back();
+			}
+			
 			/* ------------------------------------------------------------- */
 			/*
 			 *  xresources
@@ -259,6 +501,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager>
 			int xresources(OutStream& out, PDFManager& pm) {
+				scoped_phase<PDFManager> phase(pm, "resource");
 				int index = static_cast<int>(pm.newindex());
 				
 				string_type proc = LITERAL("/PDF /Text");
@@ -309,6 +552,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager>
 			int xcontents(OutStream& out, PDFManager& pm, size_type& pos) {
+				scoped_phase<PDFManager> phase(pm, "contents");
 				//cur_.fused.clear();
 				std::basic_stringstream<CharT, Traits> ss;
 				string_type filter;
@@ -342,6 +586,8 @@ namespace faml {
 			template <class OutStream>
 			bool xputstream(OutStream& out, size_type& pos) {
 				this->xsetpp();
+				text_state ts;
+				cur_.ts = &ts;
 				
 				cur_.x = pp_.margin().left();
 				cur_.y = cur_.height - twip(doc_.margin_header());
@@ -353,7 +599,7 @@ namespace faml {
 				cur_.margin_top = pp_.margin().top();
 				cur_.margin_bottom = pp_.margin().bottom();
 				*/
-				this->xput_container(out, doc_.header());
+				this->xput_form(out, header_, doc_.header());
 				
 				while (pos < doc_.size()) {
 					bool status = true;
@@ -381,7 +627,140 @@ namespace faml {
 				cur_.margin_top = pp_.margin().top();
 				cur_.margin_bottom = pp_.margin().bottom();
 				*/
-				this->xput_container(out, doc_.footer());
+				this->xput_form(out, footer_, doc_.footer());
+				
+				ts.end(out);
+				cur_.ts = NULL;
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xput_form
+			 *
+			 *  Renders the header (or footer) into the Form XObject when
+			 *  it is called at the first time, and paints the form in the
+			 *  following pages. The header/footer starts at the same
+			 *  position in every page, so the cursor position after
+			 *  drawing is also reused.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class Source>
+			bool xput_form(OutStream& out, form_type& form, const Source& src) {
+				if (src.size() == 0) return true;
+				
+				if (!form.cached) {
+					// The form has its own content stream, and so the state.
+					// The XObjects painted in the form are recorded in refs.
+					std::basic_stringstream<CharT, Traits> raw;
+					text_state ts;
+					text_state* prev = cur_.ts;
+					cur_.ts = &ts;
+					form.refs.clear();
+					cur_.refs = &form.refs;
+					bool status = this->xput_container(raw, src);
+					ts.end(raw);
+					cur_.ts = prev;
+					cur_.refs = NULL;
+					if (!status) return false;
+					string_type s = raw.str();
+					
+#ifdef FAML_USE_ZLIB
+					std::basic_stringstream<CharT, Traits> ss;
+					form.filter = LITERAL("/FlateDecode");
+					{
+						clx::basic_zstream<Z_DEFAULT_COMPRESSION, CharT, Traits> z(ss);
+						z.write(s.c_str(), s.size());
+						z.finish();
+					}
+					form.data = ss.str();
+#else
+					form.data = s;
+#endif
+					form.label = makelabel(LITERAL("Fm"));
+					form.x = cur_.x;
+					form.y = cur_.y;
+					form.cached = true;
+				}
+				
+				cur_.ts->end(out);
+				out << fmt(LITERAL("/%s Do")) % form.label << std::endl;
+				cur_.x = form.x;
+				cur_.y = form.y;
+				form.used = true;
+				
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xput_form_object
+			 *
+			 *  Writes the Form XObject at the first page that uses it, and
+			 *  adds the reference to the resources of the current page.
+			 *  Fonts and images painted in the form are already written
+			 *  at this point, since the form is written just before the
+			 *  resources object of the page.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager>
+			bool xput_form_object(OutStream& out, PDFManager& pm, form_type& form) {
+				if (!form.used) return true;
+				form.used = false;
+				scoped_phase<PDFManager> phase(pm, "form");
+				
+				if (form.index == 0) {
+					form.index = static_cast<int>(pm.newindex());
+					out << fmt(LITERAL("%d 0 obj")) % form.index << std::endl;
+					out << LITERAL("<<") << std::endl;
+					out << LITERAL("/Type /XObject") << std::endl;
+					out << LITERAL("/Subtype /Form") << std::endl;
+					out << fmt(LITERAL("/BBox [ 0 0 %f %f ]")) % pp_.width() % pp_.height() << std::endl;
+					
+					string_type proc = LITERAL("/PDF /Text");
+					out << LITERAL("/Resources <<") << std::endl;
+					out << LITERAL("/Font") << std::endl;
+					out << LITERAL("<<") << std::endl;
+					for (typename std::set<string_type>::const_iterator it = cur_.fused.begin();
+						it != cur_.fused.end(); ++it) {
+						typename font_map::const_iterator pos = f_.find(*it);
+						if (pos == f_.end()) return false;
+						out << fmt(LITERAL("/%s %d 0 R"))
+							% pos->second.label() % pos->second.index() << std::endl;
+					}
+					out << LITERAL(">>") << std::endl;
+					if (!form.refs.empty()) {
+						proc += LITERAL(" /ImageC");
+						out << LITERAL("/XObject") << std::endl;
+						out << LITERAL("<<") << std::endl;
+						std::set<string_type> done;
+						for (size_type i = 0; i < cur_.objs.size(); ++i) {
+							const xobj_type& elem = cur_.objs.at(i);
+							if (form.refs.find(elem.label) == form.refs.end() || !done.insert(elem.label).second) continue;
+							out << fmt(LITERAL("/%s %d 0 R")) % elem.label % elem.index << std::endl;
+						}
+						out << LITERAL(">>") << std::endl;
+					}
+					out << fmt(LITERAL("/ProcSet [ %s ]")) % proc << std::endl;
+					out << LITERAL(">>") << std::endl;
+					
+					out << fmt(LITERAL("/Length %d")) % form.data.size() << std::endl;
+					if (!form.filter.empty()) out << fmt(LITERAL("/Filter [ %s ]")) % form.filter << std::endl;
+					out << LITERAL(">>") << std::endl;
+					out << LITERAL("stream") << std::endl;
+					out << form.data;
+					out << std::endl;
+					out << LITERAL("endstream") << std::endl;
+					out << LITERAL("endobj") << std::endl;
+					out << std::endl;
+					
+					form.data.clear();
+				}
+				
+				xobj_type elem;
+				elem.index = form.index;
+				elem.label = form.label;
+				cur_.objs.push_back(elem);
 				
 				return true;
 			}
@@ -624,7 +1003,7 @@ namespace faml {
 				for (size_type i = pos; i < src.texts().size(); ++i) {
 					string_type latin = src.texts().at(i).font().latin();
 					if (f_.find(latin) == f_.end()) {
-						font_object f(latin, charset::utf16);
+						font_object f = ff_.create(latin, charset::utf16);
 						f_[latin] = f;
 						cur_.fonts[latin] = f;
 						cur_.fused.insert(latin);
@@ -633,16 +1012,14 @@ namespace faml {
 					
 					string_type japan = src.texts().at(i).font().japan();
 					if (f_.find(japan) == f_.end()) {
-						font_object f(japan, charset::utf16);
+						font_object f = ff_.create(japan, charset::utf16);
 						f_[japan] = f;
 						cur_.fonts[japan] = f;
 						cur_.fused.insert(japan);
 					}
 					text_helper hj(f_[japan].property(), charset::utf16);
 					
-					std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(src.texts().at(i).data());
-					string_type s = to_narrow(tmp.begin(), tmp.end());
-					//string_type s = win32conv(tmp.begin(), tmp.end());
+					string_type s = src.texts().at(i).utf16();
 					bool newline = false;
 					if (s.size() >= 2 && s.at(s.size() - 2) == 0x00 &&
 						(s.at(s.size() - 1) == 0x0a || s.at(s.size() - 1) == 0x0d || s.at(s.size() - 1) == 0x0c)) {
@@ -686,6 +1063,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class Source>
 			bool xput_text(OutStream& out, const Source& src, size_type pos) {
+				scoped_timer timer("text");
 				if (pos == 0 && !src.bullet().empty()) this->xput_bullet(out, src);
 				
 				clx::logger::trace(TRACEF("Font: %s, %s",
@@ -693,12 +1071,11 @@ namespace faml {
 					src.texts().at(pos).font().japan().c_str()));
 				clx::logger::trace(TRACEF("Text: %s\n", src.texts().at(pos).data().c_str()));
 				
-				std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(src.texts().at(pos).data());
-				string_type s = to_narrow(tmp.begin(), tmp.end());
+				string_type s = src.texts().at(pos).utf16();
 				
 				string_type latin = src.texts().at(pos).font().latin();
 				if (f_.find(latin) == f_.end()) {
-					font_object f(latin, charset::utf16);
+					font_object f = ff_.create(latin, charset::utf16);
 					f_[latin] = f;
 					cur_.fonts[latin] = f;
 					cur_.fused.insert(latin);
@@ -707,7 +1084,7 @@ namespace faml {
 				
 				string_type japan = src.texts().at(pos).font().japan();
 				if (f_.find(japan) == f_.end()) {
-					font_object f(japan, charset::utf16);
+					font_object f = ff_.create(japan, charset::utf16);
 					f_[japan] = f;
 					cur_.fonts[japan] = f;
 					cur_.fused.insert(japan);
@@ -747,13 +1124,15 @@ namespace faml {
 						this->xmove_horizon(src, pos + 1, s);
 						//continue;
 					}
-					int used = is_ascii(it, s.end(), charset::utf16)
-						? h.getline(it, s.end(), std::inserter(line, line.end()), limit)
-						: hj.getline(it, s.end(), std::inserter(line, line.end()), limit);
+					size_type u = 0, lw = 0;
+					typename string_type::iterator next = is_ascii(it, s.end(), charset::utf16)
+						? h.breakline(it, s.end(), limit, u, lw)
+						: hj.breakline(it, s.end(), limit, u, lw);
+					line.assign(it, next);
+					it = next;
 					
-					double n = is_ascii(line.begin(), line.end(), charset::utf16)
-						? h.width(line.begin(), line.end()) / 1000.0
-						: hj.width(line.begin(), line.end()) / 1000.0;
+					int used = static_cast<int>(u);
+					double n = lw / 1000.0;
 					if (line.empty()) break;
 					
 					size_type deco = src.texts().at(pos).decorate();
@@ -767,6 +1146,7 @@ namespace faml {
 					double top = (vsp - size) / 2.0;
 					text_contents txt(line, coordinate(cur_.x, cur_.y - top),
 						f_[latin], f_[japan]);
+					txt.state(*cur_.ts);
 					txt.font_size(src.texts().at(pos).font().size());
 					txt.font_color(color(rgb));
 					txt.decorate(deco);
@@ -775,15 +1155,13 @@ namespace faml {
 					}
 					
 					if ((deco & text_contents::ruby) && !src.texts().at(pos).ext().empty()) {
-						tmp = babel::utf8_to_unicode(src.texts().at(pos).ext());
-						string_type ext = to_narrow(tmp.begin(), tmp.end());
+						string_type ext = utf8_to_utf16be(src.texts().at(pos).ext());
 						txt.ext(ext);
 						txt.extsize(src.texts().at(pos).extf().size());
 					}
 					
 					if ((deco & text_contents::overlap) && !src.texts().at(pos).ext().empty()) {
-						tmp = babel::utf8_to_unicode(src.texts().at(pos).ext());
-						string_type ext = to_narrow(tmp.begin(), tmp.end());
+						string_type ext = utf8_to_utf16be(src.texts().at(pos).ext());
 						txt.ext(ext);
 						txt.extsize(src.texts().at(pos).extf().size());
 					}
@@ -849,14 +1227,13 @@ namespace faml {
 					s = ss.str();
 				}
 				
-				std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(s);
-				s = to_narrow(tmp.begin(), tmp.end());
-				//s = win32conv(tmp.begin(), tmp.end());
+				s = utf8_to_utf16be(s);
 				
 				double x = cur_.x - twip(src.list_margin());
 				
 				text_contents txt(s, coordinate(x, cur_.y),
 					f_[DOCX_DEFAULT_LATIN], f_[DOCX_DEFAULT_JAPAN]);
+				txt.state(*cur_.ts);
 				txt.font_size(src.font().size());
 				txt.font_color(color(src.font().rgb()));
 				txt(out);
@@ -917,6 +1294,8 @@ namespace faml {
 					sh->adjust(shu(it->second), it->first);
 				}
 #endif
+				cur_.ts->end(out);
+				sh->state(*cur_.ts);
 				(*sh)(out);
 				
 				cur_.y -= src.at(pos).weight() + 5.0;
@@ -1076,7 +1455,9 @@ namespace faml {
 				
 				ch.data(src.at(pos));
 				if (doc_.theme()) ch.palette(doc_.theme()->palette().data());
+				cur_.ts->end(out);
 				ch(out);
+				cur_.ts->invalidate();
 				
 				return true;
 			}
@@ -1098,15 +1479,14 @@ namespace faml {
 					x += std::max(0.0, (cur_.width - cur_.margin_left - cur_.margin_right - w));
 				}
 				
-				typedef typename std::deque<xobj_type>::iterator iter;
-				for (iter it = objs_.begin(); it != objs_.end(); ++it) {
-					if (it->path == src.images().at(pos).reference()) {
-						image_contents image(it->label, coordinate(x, y - h), w, h);
-						image(out);
-						cur_.objs.push_back(*it);
-						//objs_.erase(it);
-						break;
-					}
+				cur_.ts->end(out);
+				xobj_type* elem = this->xfind_object(src.images().at(pos).reference());
+				if (elem) {
+					if (dpi_ > 0.0) place_.add(elem->path, w, h);
+					image_contents image(elem->label, coordinate(x, y - h), w, h);
+					image(out);
+					cur_.objs.push_back(*elem);
+					if (cur_.refs) cur_.refs->insert(elem->label);
 				}
 				
 				string_type ext = src.images().at(pos).reference().substr(
@@ -1116,9 +1496,8 @@ namespace faml {
 					if (it == in_.end()) throw std::runtime_error("cannot find image file");
 					std::vector<char_type> s;
 					clx::read(*it, s);
-					clx::basic_ivstream<CharT, Traits> vs(s);
-					
-					contents::basic_wmf<CharT, Traits> wmf(vs);
+					if (s.empty()) throw std::runtime_error("empty metafile");
+					contents::basic_wmf<CharT, Traits> wmf(&s[0], s.size());
 					try {
 						wmf.read_header();
 					}
@@ -1128,7 +1507,10 @@ namespace faml {
 					wmf.height(h);
 					wmf.font1st(f_[DOCX_DEFAULT_LATIN]);
 					wmf.font2nd(f_[DOCX_DEFAULT_JAPAN]);
+					wmf.images(dibs_);
 					wmf(out);
+					cur_.ts->invalidate();
+					if (cur_.refs) cur_.refs->insert(wmf.refs().begin(), wmf.refs().end());
 				}
 				
 				if (src.images().at(pos).position() == 0) cur_.y -= h;
@@ -1149,6 +1531,9 @@ namespace faml {
 				table_contents tbl;
 				tbl.origin() = coordinate(cur_.x - space_, cur_.y);
 				std::basic_stringstream<CharT, Traits> ss; // stored text.
+				text_state ts; // state of ss, which is written after the table.
+				text_state* prev = cur_.ts;
+				cur_.ts = &ts;
 				
 				double w = cur_.width;
 				double l = cur_.margin_left;
@@ -1194,8 +1579,12 @@ namespace faml {
 				cur_.margin_right = r;
 				
 				// finalize
+				ts.end(ss);
+				cur_.ts = prev;
+				cur_.ts->end(out);
 				tbl(out);
 				out << ss.str();
+				*cur_.ts = ts;
 				return true;
 			}
 			
@@ -40,7 +40,9 @@
 #include <vector>
 #include <map>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
 #include "../officex/bullet.h"
@@ -131,7 +133,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				node_ptr root = doc.first_node(LITERAL("w:numbering"));
 				if (!root) throw std::runtime_error("cannot find <w:numbering> (root) tag");
 				
@@ -142,20 +147,20 @@ namespace faml {
 					this->xread_data(child, elem);
 					attr_ptr attr = child->first_attribute(LITERAL("w:abstractNumId"));
 					if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find w:abstractNumId");
-					tmp[clx::lexical_cast<size_type>(attr->value())] = elem;
+					tmp[officex::number_cast<size_type>(attr->value())] = elem;
 				}
 				
 				for (node_ptr child = root->first_node(LITERAL("w:num")); child; child = child->next_sibling()) {
 					if (string_type(child->name()) != LITERAL("w:num")) continue;
 					attr_ptr attr = child->first_attribute(LITERAL("w:numId"));
 					if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find w:numId");
-					size_type index = clx::lexical_cast<size_type>(attr->value());
+					size_type index = officex::number_cast<size_type>(attr->value());
 					
 					node_ptr pos = child->first_node(LITERAL("w:abstractNumId"));
 					if (!pos) throw std::runtime_error("cannot find <w:abstractNumId> tag");
 					attr = pos->first_attribute(LITERAL("w:val"));
 					if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find w:val");
-					size_type ref = clx::lexical_cast<size_type>(attr->value());
+					size_type ref = officex::number_cast<size_type>(attr->value());
 					v_[index] = tmp[ref];
 				}
 				
@@ -215,11 +220,11 @@ namespace faml {
 						if (tmp) {
 							attr = tmp->first_attribute(LITERAL("w:left"));
 							if (attr && attr->value_size() > 0) {
-								elem.indent = clx::lexical_cast<double>(attr->value());
+								elem.indent = officex::number_cast<double>(attr->value());
 							}
 							attr = tmp->first_attribute(LITERAL("w:hanging"));
 							if (attr && attr->value_size() > 0) {
-								elem.margin = clx::lexical_cast<double>(attr->value());
+								elem.margin = officex::number_cast<double>(attr->value());
 							}
 						}
 					}
@@ -40,8 +40,9 @@
 #include <vector>
 #include "paragraph.h"
 #include "clx/literal.h"
-#include "clx/unzip.h"
+#include "clx/utility.h"
 #include "../officex/reference.h"
+#include "../profile.h"
 
 namespace faml {
 	namespace docx {
@@ -86,7 +87,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				string_type tag;
 				if (Which == 1) tag = LITERAL("w:hdr");
 				else tag = LITERAL("w:ftr");
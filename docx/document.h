@@ -29,20 +29,25 @@
  *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
  *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
- *  Last-modified: Mon 15 Jun 2009 22:24:00 JST
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
  */
 /* ------------------------------------------------------------------------- */
 #ifndef FAML_DOCX_DOCUMENT_H
 #define FAML_DOCX_DOCUMENT_H
 
+#include <iterator>
+#include <map>
 #include <stdexcept>
 #include <string>
 #include <vector>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/literal.h"
+#include "clx/utility.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/shared_ptr.h"
-#include "clx/unzip.h"
+#include "../officex/archive.h"
 #include "../officex/theme.h"
 #include "../officex/reference.h"
 #include "../xlsx/chart.h"
@@ -55,7 +60,48 @@
 namespace faml {
 	namespace docx {
 		/* ----------------------------------------------------------------- */
-		//  basic_document
+		/*
+		 *  basic_block_view
+		 *
+		 *  The basic_block_view class provides the vector-like interface
+		 *  (size() and at()) to the paragraphs (or tables) in the body of
+		 *  the document. Each block is parsed when it is accessed.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <class DocT, class Type>
+		class basic_block_view {
+		public:
+			typedef size_t size_type;
+			typedef Type value_type;
+			typedef const Type& (DocT::*loader_type)(size_type);
+			
+			basic_block_view(DocT& doc, size_type n, loader_type f) :
+				doc_(&doc), size_(n), f_(f) {}
+			
+			bool empty() const { return size_ == 0; }
+			size_type size() const { return size_; }
+			const value_type& at(size_type pos) const { return (doc_->*f_)(pos); }
+			const value_type& operator[](size_type pos) const { return (doc_->*f_)(pos); }
+			
+		private:
+			DocT* doc_;
+			size_type size_;
+			loader_type f_;
+		};
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_document
+		 *
+		 *  The body of document.xml is not converted at once. The class
+		 *  only finds the positions of the top-level blocks (paragraphs
+		 *  and tables) when reading, and each block is parsed when it is
+		 *  accessed through paragraph_at() or table_at(). Only the last accessed
+		 *  paragraph and table are kept, so the memory used for the
+		 *  parsed blocks does not depend on the length of the document.
+		 *  document.xml itself is not kept either: the blocks are read
+		 *  again from the (inflating) archive member when accessed.
+		 */
 		/* ----------------------------------------------------------------- */
 		template <
 			class CharT,
@@ -66,6 +112,7 @@ namespace faml {
 			typedef size_t size_type;
 			typedef CharT char_type;
 			typedef std::basic_string<CharT, Traits> string_type;
+			typedef faml::officex::basic_archive<CharT, Traits> storage_type;
 			typedef std::vector<size_type> container;
 			typedef typename container::value_type value_type;
 			typedef typename container::const_iterator const_iterator;
@@ -74,11 +121,14 @@ namespace faml {
 			typedef faml::xlsx::basic_chart<CharT, Traits> chart_type;
 			typedef basic_container<1, CharT, Traits> header_type;
 			typedef basic_container<2, CharT, Traits> footer_type;
+			typedef basic_block_view<basic_document, paragraph> text_view;
+			typedef basic_block_view<basic_document, txtable> table_view;
 			
 			enum { text = 1, table = 2 };
 			
 			basic_document() :
-				types_(), texts_(), tbls_(),
+				types_(), texts_(), tbls_(), reader_(), ref_(), charts_(),
+				text_(), text_pos_(0), table_(), table_pos_(0),
 				header_(), footer_(),
 				width_(0.0), height_(0.0),
 				margin_top_(0.0), margin_bottom_(0.0),
@@ -87,7 +137,8 @@ namespace faml {
 				in_(), style_(), bullet_(), theme_() {}
 			
 			basic_document(const string_type& path) :
-				types_(), texts_(), tbls_(),
+				types_(), texts_(), tbls_(), reader_(), ref_(), charts_(),
+				text_(), text_pos_(0), table_(), table_pos_(0),
 				header_(), footer_(),
 				width_(0.0), height_(0.0),
 				margin_top_(0.0), margin_bottom_(0.0),
@@ -97,10 +148,36 @@ namespace faml {
 				this->read(path);
 			}
 			
+			explicit basic_document(const storage_type& in) :
+				types_(), texts_(), tbls_(), reader_(), ref_(), charts_(),
+				text_(), text_pos_(0), table_(), table_pos_(0),
+				header_(), footer_(),
+				width_(0.0), height_(0.0),
+				margin_top_(0.0), margin_bottom_(0.0),
+				margin_left_(0.0), margin_right_(0.0),
+				margin_header_(0.0), margin_footer_(0.0),
+				in_(), style_(), bullet_(), theme_() {
+				this->read(in);
+			}
+			
 			virtual ~basic_document() throw() {}
 			
 			basic_document& read(const string_type& path) {
-				if (!in_.open(path)) throw std::runtime_error("cannot find input file");
+				return this->read(storage_type(path));
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  read
+			 *
+			 *  Reads the document from the opened archive. The archive
+			 *  may be built from a file, a stream, a file descriptor, or
+			 *  a memory buffer (see officex/archive.h).
+			 */
+			/* ------------------------------------------------------------- */
+			basic_document& read(const storage_type& in) {
+				if (!in.is_open()) throw std::runtime_error("cannot find input file");
+				in_ = in;
 				
 				// 1. theme1.xml
 				typename storage_type::iterator pos = in_.find(LITERAL("word/theme/theme1.xml"));
@@ -114,10 +191,12 @@ namespace faml {
 				pos = in_.find(LITERAL("word/numbering.xml"));
 				if (pos != in_.end()) bullet_.read(*pos);
 				
-				// 4. document.xml
-				pos = in_.find(LITERAL("word/document.xml"));
-				if (pos == in_.end()) throw std::runtime_error("cannot find document.xml");
-				this->xread(*pos, theme_);
+				// 4. document.xml (only the positions of blocks are read)
+				reader_ = reader_ptr(new reader_type());
+				if (!reader_->open(in_, LITERAL("word/document.xml"))) {
+					throw std::runtime_error("cannot find document.xml");
+				}
+				this->xread(*reader_);
 				
 				// 5. header1.xml
 				pos = in_.find(LITERAL("word/header1.xml"));
@@ -139,8 +218,8 @@ namespace faml {
 			size_type operator[](size_type pos) const { return types_[pos]; }
 			const_iterator begin() const { return types_.begin(); }
 			const_iterator end() const { return types_.end(); }
-			const std::vector<paragraph>& texts() const { return texts_; }
-			const std::vector<txtable>& tables() const { return tbls_; }
+			text_view texts() { return text_view(*this, texts_.size(), &basic_document::paragraph_at); }
+			table_view tables() { return table_view(*this, tbls_.size(), &basic_document::table_at); }
 			const header_type& header() const { return header_; }
 			const footer_type& footer() const { return footer_; }
 			double width() const { return width_; }
@@ -152,9 +231,89 @@ namespace faml {
 			double margin_header() const { return margin_header_; }
 			double margin_footer() const { return margin_footer_; }
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  paragraph_at
+			 *
+			 *  Returns the n-th paragraph in the body. The paragraph is
+			 *  parsed when it is different from the last one, and the
+			 *  last one is released. So, the reference is valid until
+			 *  paragraph_at() is called with the other index or release().
+			 */
+			/* ------------------------------------------------------------- */
+			const paragraph& paragraph_at(size_type n) {
+				if (n >= texts_.size()) throw std::out_of_range("wrong text index");
+				if (text_ && text_pos_ == n) return *text_;
+				
+				text_ = paragraph_ptr();
+				std::vector<char_type> s;
+				rapidxml::xml_document<char> doc;
+				node_ptr root = this->xparse(texts_.at(n), s, doc);
+				
+				paragraph_ptr elem(new paragraph());
+				elem->style(style_);
+				elem->bullets(bullet_);
+				elem->read(root);
+				
+				std::basic_stringstream<CharT, Traits> ss;
+				typedef typename paragraph::image_container::iterator iter;
+				for (iter it = elem->images().begin(); it != elem->images().end(); ++it) {
+					if (ref_.find(it->reference()) == ref_.end()) {
+						throw std::runtime_error("cannot find reference");
+					}
+					
+					string_type tmp = ref_[it->reference()];
+					if (tmp.compare(0, 5, LITERAL("chart")) == 0) {
+						it->reference(tmp);
+						this->xread_chart(tmp, *elem);
+						continue;
+					}
+					
+					ss.str(LITERAL(""));
+					ss << LITERAL("word/media/") << ref_[it->reference()];
+					it->reference(ss.str());
+				}
+				
+				text_ = elem;
+				text_pos_ = n;
+				return *text_;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  table_at
+			 *
+			 *  Returns the n-th table in the body in the same way as
+			 *  paragraph_at().
+			 */
+			/* ------------------------------------------------------------- */
+			const txtable& table_at(size_type n) {
+				if (n >= tbls_.size()) throw std::out_of_range("wrong table index");
+				if (table_ && table_pos_ == n) return *table_;
+				
+				table_ = table_ptr();
+				std::vector<char_type> s;
+				rapidxml::xml_document<char> doc;
+				node_ptr root = this->xparse(tbls_.at(n), s, doc);
+				
+				table_ptr elem(new txtable());
+				elem->read(root, *this);
+				
+				table_ = elem;
+				table_pos_ = n;
+				return *table_;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  release
+			/* ------------------------------------------------------------- */
+			void release() {
+				text_ = paragraph_ptr();
+				table_ = table_ptr();
+			}
+			
 		public:
 		//private: // future works
-			typedef clx::basic_unzip<CharT, Traits> storage_type;
 			typedef faml::officex::basic_theme<CharT, Traits> theme_type;
 			typedef clx::shared_ptr<theme_type> theme_ptr;
 			typedef basic_style<CharT, Traits> style_type;
@@ -169,10 +328,22 @@ namespace faml {
 		private:
 			typedef rapidxml::xml_node<CharT>* node_ptr;
 			typedef rapidxml::xml_attribute<CharT>* attr_ptr;
+			typedef clx::shared_ptr<paragraph> paragraph_ptr;
+			typedef clx::shared_ptr<txtable> table_ptr;
+			typedef typename storage_type::reader reader_type;
+			typedef clx::shared_ptr<reader_type> reader_ptr;
+			typedef std::pair<size_type, size_type> block_type; // [first, last) in document.xml
 			
 			std::vector<size_type> types_;
-			std::vector<paragraph> texts_;
-			std::vector<txtable> tbls_;
+			std::vector<block_type> texts_;
+			std::vector<block_type> tbls_;
+			reader_ptr reader_; // document.xml
+			std::map<string_type, string_type> ref_;
+			std::map<string_type, chart_type> charts_;
+			paragraph_ptr text_;
+			size_type text_pos_;
+			table_ptr table_;
+			size_type table_pos_;
 			header_type header_;
 			footer_type footer_;
 			
@@ -191,69 +362,221 @@ namespace faml {
 			theme_ptr theme_;
 			
 			/* ------------------------------------------------------------- */
-			//  xread
+			/*
+			 *  xread
+			 *
+			 *  Finds the top-level blocks in <w:body> without building the
+			 *  DOM of the whole document. The document is scanned as a
+			 *  stream, and only <w:sectPr> is kept (and parsed) here.
+			 */
 			/* ------------------------------------------------------------- */
 			template <class Ch, class Tr>
-			basic_document& xread(std::basic_istream<Ch, Tr>& in, const theme_ptr& theme) {
-				std::vector<char_type> s;
-				clx::read(in, s);
-				s.push_back(0); // make null terminated string.
+			basic_document& xread(std::basic_istream<Ch, Tr>& in) {
+				this->xread_reference(ref_);
 				
-				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
-				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
-				node_ptr root = doc.first_node(LITERAL("w:document"));
-				if (!root) throw std::runtime_error("cannot find <w:document> (root) tag");
-				node_ptr parent = root->first_node(LITERAL("w:body"));
-				if (!parent) throw std::runtime_error("cannot find <w:body> tag");
-				
-				std::map<string_type, string_type> ref;
-				this->xread_reference(ref);
+				std::basic_streambuf<Ch, Tr>* sbuf = in.rdbuf();
+				size_type pos = 0;
+				token_type tag;
+				bool root = false;
+				while (true) {
+					if (!this->xtoken(sbuf, pos, tag, NULL)) {
+						if (!root) throw std::runtime_error("cannot find <w:document> (root) tag");
+						throw std::runtime_error("cannot find <w:body> tag");
+					}
+					if (tag.type != token_type::open) continue;
+					string_type name = this->xname(tag.text);
+					if (name == LITERAL("w:document")) root = true;
+					else if (name == LITERAL("w:body")) {
+						if (!root) throw std::runtime_error("cannot find <w:document> (root) tag");
+						break;
+					}
+				}
 				
-				for (node_ptr child = parent->first_node(); child; child = child->next_sibling()) {
-					if (string_type(child->name()) == LITERAL("w:p")) {
-						types_.push_back(text);
-						paragraph elem;
-						elem.style(style_);
-						elem.bullets(bullet_);
-						elem.read(child);
-						
-						std::basic_stringstream<CharT, Traits> ss;
-						typedef typename paragraph::image_container::iterator iter;
-						for (iter it = elem.images().begin(); it != elem.images().end(); ++it) {
-							if (ref.find(it->reference()) == ref.end()) {
-								throw std::runtime_error("cannot find reference");
-							}
-							
-							string_type tmp = ref[it->reference()];
-							if (tmp.compare(0, 5, LITERAL("chart")) == 0) {
-								it->reference(tmp);
-								this->xread_chart(tmp, elem);
-								continue;
-							}
-							
-							ss.str(LITERAL(""));
-							ss << LITERAL("word/media/") << ref[it->reference()];
-							it->reference(ss.str());
+				string_type sect;
+				while (true) {
+					if (!this->xtoken(sbuf, pos, tag, NULL)) throw std::runtime_error("cannot find </w:body> tag");
+					if (tag.type == token_type::close) break;
+					if (tag.type != token_type::open && tag.type != token_type::empty) continue;
+					
+					size_type first = tag.first;
+					string_type name = this->xname(tag.text);
+					string_type* capture = NULL;
+					if (name == LITERAL("w:sectPr")) {
+						sect = tag.text;
+						capture = &sect;
+					}
+					
+					int depth = (tag.type == token_type::open) ? 1 : 0;
+					while (depth > 0) {
+						if (!this->xtoken(sbuf, pos, tag, capture)) {
+							throw std::runtime_error("unexpected end of document.xml");
 						}
-						
-						texts_.push_back(elem);
+						if (tag.type == token_type::open) ++depth;
+						else if (tag.type == token_type::close) --depth;
+						if (capture) capture->append(tag.text);
+					}
+					
+					if (name == LITERAL("w:p")) {
+						types_.push_back(text);
+						texts_.push_back(block_type(first, pos));
 					}
-					else if (string_type(child->name()) == LITERAL("w:tbl")) {
+					else if (name == LITERAL("w:tbl")) {
 						types_.push_back(table);
-						txtable elem;
-						elem.read(child, *this);
-						tbls_.push_back(elem);
+						tbls_.push_back(block_type(first, pos));
 					}
 				}
 				
-				node_ptr pos = parent->first_node(LITERAL("w:sectPr"));
-				if (!pos) throw std::runtime_error("cannot find <w:sectPr> tag");
-				this->xread_page(pos);
+				if (sect.empty()) throw std::runtime_error("cannot find <w:sectPr> tag");
+				std::vector<char_type> s(sect.begin(), sect.end());
+				rapidxml::xml_document<char> doc;
+				this->xread_page(this->xparse(s, doc));
 				
 				return *this;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xparse
+			 *
+			 *  Parses the block of document.xml. The buffer s and the DOM
+			 *  doc must be alive while the returned node is used.
+			 */
+			/* ------------------------------------------------------------- */
+			node_ptr xparse(const block_type& b, std::vector<char_type>& s, rapidxml::xml_document<char>& doc) {
+				s.resize(b.second - b.first);
+				reader_->clear();
+				if (!reader_->seekg(b.first) || !reader_->read(&s.at(0), s.size())) {
+					throw std::runtime_error("cannot read the block of document.xml");
+				}
+				return this->xparse(s, doc);
+			}
+			
+			node_ptr xparse(std::vector<char_type>& s, rapidxml::xml_document<char>& doc) {
+				s.push_back(0); // make null terminated string.
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
+				node_ptr root = doc.first_node();
+				if (!root) throw std::runtime_error("cannot parse the block of document.xml");
+				return root;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  token_type
+			 *
+			 *  The markup found by xtoken(): a start tag, an end tag, an
+			 *  empty element tag, or the other one (a comment, CDATA, a
+			 *  processing instruction, or a declaration). first is the
+			 *  position of '<' in document.xml.
+			 */
+			/* ------------------------------------------------------------- */
+			struct token_type {
+				enum { open = 1, close, empty, other };
+				
+				int type;
+				size_type first;
+				string_type text;
+				
+				token_type() : type(0), first(0), text() {}
+			};
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xtoken
+			 *
+			 *  Reads the next markup from sbuf. pos is the position in
+			 *  the document, and it is moved to just after the markup.
+			 *  The character data before the markup is skipped (and
+			 *  appended to capture if it is not NULL). Returns false when
+			 *  the document ends before the markup is completed.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class Ch, class Tr>
+			bool xtoken(std::basic_streambuf<Ch, Tr>* sbuf, size_type& pos, token_type& dest, string_type* capture) {
+				typedef typename Tr::int_type int_type;
+				int_type c = 0;
+				while (!Tr::eq_int_type(c = sbuf->sbumpc(), Tr::eof())) {
+					++pos;
+					if (Tr::to_char_type(c) == '<') break;
+					if (capture) capture->push_back(Tr::to_char_type(c));
+				}
+				if (Tr::eq_int_type(c, Tr::eof())) return false;
+				
+				dest.first = pos - 1;
+				dest.text.assign(1, '<');
+				if (!this->xtoken_char(sbuf, pos, dest.text)) return false;
+				
+				char_type head = dest.text.at(1);
+				if (head == '!') {
+					dest.type = token_type::other;
+					if (!this->xtoken_char(sbuf, pos, dest.text)) return false;
+					if (dest.text.at(2) == '[') return this->xtoken_until(sbuf, pos, dest.text, LITERAL("]]>")); // CDATA
+					if (!this->xtoken_char(sbuf, pos, dest.text)) return false;
+					if (dest.text.compare(0, 4, LITERAL("<!--")) == 0) return this->xtoken_until(sbuf, pos, dest.text, LITERAL("-->"));
+					return this->xtoken_until(sbuf, pos, dest.text, LITERAL(">"));
+				}
+				else if (head == '?') {
+					dest.type = token_type::other;
+					return this->xtoken_until(sbuf, pos, dest.text, LITERAL("?>"));
+				}
+				else if (head == '/') {
+					dest.type = token_type::close;
+					return this->xtoken_until(sbuf, pos, dest.text, LITERAL(">"));
+				}
+				
+				char_type quote = 0;
+				for (char_type c = head; c != '>' || quote != 0; c = dest.text.at(dest.text.size() - 1)) {
+					if (quote != 0) {
+						if (c == quote) quote = 0;
+					}
+					else if (c == '"' || c == '\'') quote = c;
+					if (!this->xtoken_char(sbuf, pos, dest.text)) return false;
+				}
+				dest.type = (dest.text.at(dest.text.size() - 2) == '/') ? token_type::empty : token_type::open;
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xtoken_char
+			/* ------------------------------------------------------------- */
+			template <class Ch, class Tr>
+			bool xtoken_char(std::basic_streambuf<Ch, Tr>* sbuf, size_type& pos, string_type& dest) {
+				typename Tr::int_type c = sbuf->sbumpc();
+				if (Tr::eq_int_type(c, Tr::eof())) return false;
+				++pos;
+				dest.push_back(Tr::to_char_type(c));
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xtoken_until
+			 *
+			 *  Reads characters until dest ends with last. The characters
+			 *  already in dest (e.g., "<!--") are not matched with last.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class Ch, class Tr>
+			bool xtoken_until(std::basic_streambuf<Ch, Tr>* sbuf, size_type& pos, string_type& dest, const char_type* last) {
+				size_type first = dest.size();
+				size_type n = Traits::length(last);
+				while (dest.size() < first + n || dest.compare(dest.size() - n, n, last) != 0) {
+					if (!this->xtoken_char(sbuf, pos, dest)) return false;
+				}
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xname
+			/* ------------------------------------------------------------- */
+			string_type xname(const string_type& tag) const {
+				size_type last = tag.find_first_of(LITERAL(" \t\r\n/>"), 1);
+				if (last == string_type::npos) last = tag.size();
+				return tag.substr(1, last - 1);
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  xread_page
 			/* ------------------------------------------------------------- */
@@ -263,41 +586,41 @@ namespace faml {
 				if (!pos) throw std::runtime_error("cannot find <w:pgSz> tag");
 				attr_ptr attr = pos->first_attribute(LITERAL("w:w"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find w:w attribute");
-				width_ = clx::lexical_cast<double>(attr->value());
+				width_ = officex::number_cast<double>(attr->value());
 				attr = pos->first_attribute(LITERAL("w:h"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find w:h attribute");
-				height_ = clx::lexical_cast<double>(attr->value());
+				height_ = officex::number_cast<double>(attr->value());
 				
 				pos = root->first_node(LITERAL("w:pgMar"));
 				if (pos) {
 					attr = pos->first_attribute(LITERAL("w:top"));
 					if (attr && attr->value_size() > 0) {
-						margin_top_ = clx::lexical_cast<double>(attr->value());
+						margin_top_ = officex::number_cast<double>(attr->value());
 					}
 					
 					attr = pos->first_attribute(LITERAL("w:right"));
 					if (attr && attr->value_size() > 0) {
-						margin_right_ = clx::lexical_cast<double>(attr->value());
+						margin_right_ = officex::number_cast<double>(attr->value());
 					}
 					
 					attr = pos->first_attribute(LITERAL("w:bottom"));
 					if (attr && attr->value_size() > 0) {
-						margin_bottom_ = clx::lexical_cast<double>(attr->value());
+						margin_bottom_ = officex::number_cast<double>(attr->value());
 					}
 					
 					attr = pos->first_attribute(LITERAL("w:left"));
 					if (attr && attr->value_size() > 0) {
-						margin_left_ = clx::lexical_cast<double>(attr->value());
+						margin_left_ = officex::number_cast<double>(attr->value());
 					}
 					
 					attr = pos->first_attribute(LITERAL("w:header"));
 					if (attr && attr->value_size() > 0) {
-						margin_header_ = clx::lexical_cast<double>(attr->value());
+						margin_header_ = officex::number_cast<double>(attr->value());
 					}
 					
 					attr = pos->first_attribute(LITERAL("w:footer"));
 					if (attr && attr->value_size() > 0) {
-						margin_footer_ = clx::lexical_cast<double>(attr->value());
+						margin_footer_ = officex::number_cast<double>(attr->value());
 					}
 				}
 				
@@ -305,19 +628,28 @@ namespace faml {
 			}
 			
 			/* ------------------------------------------------------------- */
-			//  xread_chart
+			/*
+			 *  xread_chart
+			 *
+			 *  The paragraph is parsed again whenever it is accessed, so
+			 *  the charts are read only once and kept by the reference.
+			 */
 			/* ------------------------------------------------------------- */
 			template <class Type>
 			basic_document& xread_chart(const string_type& src, Type& dest) {
-				std::basic_stringstream<CharT, Traits> ss;
-				ss << LITERAL("word/charts/") << src;
-				typename storage_type::iterator pos = in_.find(ss.str());
-				if (pos == in_.end()) throw std::runtime_error("cannot find chart file");
-				
-				chart_type ch;
-				if (theme_) ch.theme(theme_.get());
-				ch.read(*pos);
-				dest.charts().push_back(ch);
+				typename std::map<string_type, chart_type>::iterator it = charts_.find(src);
+				if (it == charts_.end()) {
+					std::basic_stringstream<CharT, Traits> ss;
+					ss << LITERAL("word/charts/") << src;
+					typename storage_type::iterator pos = in_.find(ss.str());
+					if (pos == in_.end()) throw std::runtime_error("cannot find chart file");
+					
+					chart_type ch;
+					if (theme_) ch.theme(theme_.get());
+					ch.read(*pos);
+					it = charts_.insert(std::make_pair(src, ch)).first;
+				}
+				dest.charts().push_back(it->second);
 				
 				return *this;
 			}
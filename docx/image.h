@@ -40,6 +40,7 @@
 #include "rapidxml/rapidxml.hpp"
 #include "clx/literal.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 
 namespace faml {
 	namespace docx {
@@ -117,13 +118,13 @@ namespace faml {
 				if (!pos) throw std::runtime_error("cannot find <wp:positionH> tag");
 				node_ptr child = pos->first_node(LITERAL("wp:posOffset"));
 				if (!child || child->value_size() == 0) throw std::runtime_error("cannot find <wp:posOffset> tag");
-				offset_.x(faml::officex::emu(clx::lexical_cast<double>(child->value())));
+				offset_.x(faml::officex::emu(officex::number_cast<double>(child->value())));
 				
 				pos = root->first_node(LITERAL("wp:positionV"));
 				if (!pos) throw std::runtime_error("cannot find <wp:positionV> tag");
 				child = pos->first_node(LITERAL("wp:posOffset"));
 				if (!child || child->value_size() == 0) throw std::runtime_error("cannot find <wp:posOffset> tag");
-				offset_.y(faml::officex::emu(clx::lexical_cast<double>(child->value())));
+				offset_.y(faml::officex::emu(officex::number_cast<double>(child->value())));
 				
 				position_ = 1;
 				return *this;
@@ -139,11 +140,11 @@ namespace faml {
 				
 				attr_ptr attr = pos->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find cx attribute");
-				width_ = faml::officex::emu(clx::lexical_cast<double>(attr->value()));
+				width_ = faml::officex::emu(officex::number_cast<double>(attr->value()));
 				
 				attr = pos->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find cx attribute");
-				height_ = faml::officex::emu(clx::lexical_cast<double>(attr->value()));
+				height_ = faml::officex::emu(officex::number_cast<double>(attr->value()));
 				return *this;
 			}
 			
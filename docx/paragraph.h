@@ -41,8 +41,10 @@
 #include "rapidxml/rapidxml.hpp"
 #include "clx/scanner.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
+#include "../code_convert.h"
 #include "../officex/utility.h"
 #include "../officex/unit.h"
 #include "../officex/color.h"
@@ -93,12 +95,12 @@ namespace faml {
 			basic_piece() :
 				data_(), ext_(), font_(), extf_(),
 				bg_(0xff000000), decorate_(0), scale_(100),
-				space_(0.0), tab_(0.0) {}
+				space_(0.0), tab_(0.0), utf16_(), conv_(false) {}
 			
 			basic_piece(const string_type& s) :
 				data_(s), ext_(), font_(), extf_(),
 				bg_(0xff000000), decorate_(0), scale_(100),
-				space_(0.0), tab_(0.0) {}
+				space_(0.0), tab_(0.0), utf16_(), conv_(false) {}
 			
 			virtual ~basic_piece() throw() {}
 			
@@ -115,10 +117,30 @@ namespace faml {
 			double space() const { return space_; }
 			double tab() const { return tab_; }
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  utf16
+			 *
+			 *  Returns the string data converted into UTF-16BE. The result
+			 *  is cached, so the data is converted only once even if the
+			 *  piece is measured and drawn several times.
+			 */
+			/* ------------------------------------------------------------- */
+			const string_type& utf16() const {
+				if (!conv_) {
+					utf16_ = faml::pdf::utf8_to_utf16be(data_);
+					conv_ = true;
+				}
+				return utf16_;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  Access methods (set).
 			/* ------------------------------------------------------------- */
-			void data(const string_type& cp) { data_ = cp; }
+			void data(const string_type& cp) {
+				data_ = cp;
+				conv_ = false;
+			}
 			void ext(const string_type& cp) { ext_ = cp; }
 			void font(const font_type& cp) { font_ = cp; }
 			void extf(const font_type& cp) { extf_ = cp; }
@@ -138,6 +160,8 @@ namespace faml {
 			size_type scale_;
 			double space_;
 			double tab_;
+			mutable string_type utf16_;
+			mutable bool conv_;
 		};
 		
 		/* ----------------------------------------------------------------- */
@@ -331,7 +355,7 @@ namespace faml {
 					if (child) {
 						attr_ptr attr = child->first_attribute(LITERAL("w:val"));
 						if (attr && attr->value_size() > 0) {
-							font_.size(clx::lexical_cast<double>(attr->value()) / 2.0);
+							font_.size(officex::number_cast<double>(attr->value()) / 2.0);
 						}
 					}
 					
@@ -384,7 +408,7 @@ namespace faml {
 					if (tmp) {
 						attr_ptr attr = tmp->first_attribute(LITERAL("w:val"));
 						if (attr && attr->value_size() > 0) {
-							level_ = clx::lexical_cast<size_type>(attr->value());
+							level_ = officex::number_cast<size_type>(attr->value());
 						}
 					}
 					
@@ -392,7 +416,7 @@ namespace faml {
 					if (!tmp) throw std::runtime_error("cannot find <w:numId> tag");
 					attr_ptr attr = tmp->first_attribute(LITERAL("w:val"));
 					if (!attr && attr->value_size() == 0) throw std::runtime_error("cannot find w:val");
-					size_type ref = clx::lexical_cast<size_type>(attr->value());
+					size_type ref = officex::number_cast<size_type>(attr->value());
 					typename bullet_type::const_iterator it = bu_->find(ref);
 					if (it == bu_->end()) throw std::runtime_error("cannot find target bullet list");
 					list_ = it->second.at(level_).type;
@@ -409,7 +433,7 @@ namespace faml {
 						if (string_type(child->name()) != LITERAL("w:tab")) continue;
 						attr_ptr attr = child->first_attribute(LITERAL("w:pos"));
 						if (attr && attr->value_size() > 0) {
-							tabs_.push_back(clx::lexical_cast<double>(attr->value()));
+							tabs_.push_back(officex::number_cast<double>(attr->value()));
 						}
 					}
 				}
@@ -417,13 +441,13 @@ namespace faml {
 				pos = root->first_node(LITERAL("w:ind"));
 				if (pos && bullet_.empty()) {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:firstLine"));
-					if (attr && attr->value_size() > 0) indent1st_ += clx::lexical_cast<double>(attr->value());
+					if (attr && attr->value_size() > 0) indent1st_ += officex::number_cast<double>(attr->value());
 					attr = pos->first_attribute(LITERAL("w:left"));
-					if (attr && attr->value_size() > 0) indent_ = clx::lexical_cast<double>(attr->value());
+					if (attr && attr->value_size() > 0) indent_ = officex::number_cast<double>(attr->value());
 					attr = pos->first_attribute(LITERAL("w:right"));
-					if (attr && attr->value_size() > 0) rindent_ = clx::lexical_cast<double>(attr->value());
+					if (attr && attr->value_size() > 0) rindent_ = officex::number_cast<double>(attr->value());
 					attr = pos->first_attribute(LITERAL("w:hanging"));
-					if (attr && attr->value_size() > 0) indent1st_ -= clx::lexical_cast<double>(attr->value());
+					if (attr && attr->value_size() > 0) indent1st_ -= officex::number_cast<double>(attr->value());
 				}
 				
 				// 3. baseline
@@ -432,19 +456,19 @@ namespace faml {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:line"));
 					if (attr && attr->value_size() > 0) {
 						// Todo: w:spacing ̒l̏ꍇɁCǂ̂D
-						int sp = clx::lexical_cast<int>(attr->value());
+						int sp = officex::number_cast<int>(attr->value());
 						//if (sp > 0) baseline_ = sp / 20.0 / font_.size();
 						if (sp > 0) baseline_ = sp / 20.0;
 					}
 					
 					attr = pos->first_attribute(LITERAL("w:before"));
 					if (attr && attr->value_size() > 0) {
-						tpad_ = clx::lexical_cast<double>(attr->value()) / 20.0;
+						tpad_ = officex::number_cast<double>(attr->value()) / 20.0;
 					}
 					
 					attr = pos->first_attribute(LITERAL("w:after"));
 					if (attr && attr->value_size() > 0) {
-						bpad_ = clx::lexical_cast<double>(attr->value()) / 20.0;
+						bpad_ = officex::number_cast<double>(attr->value()) / 20.0;
 					}
 				}
 				
@@ -675,7 +699,7 @@ namespace faml {
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:val"));
 					if (attr && attr->value_size()) {
-						f.size(clx::lexical_cast<double>(attr->value()) / 2.0);
+						f.size(officex::number_cast<double>(attr->value()) / 2.0);
 					}
 				}
 				
@@ -743,7 +767,7 @@ namespace faml {
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:val"));
 					if (attr && attr->value_size()) {
-						f.rgb(clx::lexical_cast<size_type>(attr->value(), std::ios::hex));
+						f.rgb(officex::number_cast<size_type>(attr->value(), std::ios::hex));
 					}
 				}
 				
@@ -751,7 +775,7 @@ namespace faml {
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:val"));
 					if (attr && attr->value_size() > 0) {
-						dest.scale(clx::lexical_cast<size_type>(attr->value()));
+						dest.scale(officex::number_cast<size_type>(attr->value()));
 					}
 				}
 				
@@ -759,7 +783,7 @@ namespace faml {
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:val"));
 					if (attr && attr->value_size() > 0) {
-						int sp = clx::lexical_cast<int>(attr->value());
+						int sp = officex::number_cast<int>(attr->value());
 						if (sp > 0) dest.space(sp);
 					}
 				}
@@ -781,10 +805,10 @@ namespace faml {
 				if (!pos) throw std::runtime_error("cannot find <wp:extent>");
 				attr_ptr attr = pos->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <wp:extent x>");
-				dest.width(clx::lexical_cast<double>(attr->value()));
+				dest.width(officex::number_cast<double>(attr->value()));
 				attr = pos->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <wp:extent y>");
-				dest.height(clx::lexical_cast<double>(attr->value()));
+				dest.height(officex::number_cast<double>(attr->value()));
 				
 				node_ptr p1 = parent->first_node(LITERAL("a:graphic"));
 				if (!p1) throw std::runtime_error("cannot find <a:graphic>");
@@ -828,12 +852,12 @@ namespace faml {
 						v.at(i) == LITERAL("width") ||
 						v.at(i) == LITERAL("height")) {
 						if (v.at(i + 1).find(LITERAL("pt")) != string_type::npos) {
-							val = clx::lexical_cast<double>(v.at(i + 1).substr(
+							val = officex::number_cast<double>(v.at(i + 1).substr(
 								0, v.at(i + 1).find(LITERAL("pt"))
 							));
 						}
 						else if (v.at(i + 1).find(LITERAL("in")) != string_type::npos) {
-							double tmp = clx::lexical_cast<double>(v.at(i + 1).substr(
+							double tmp = officex::number_cast<double>(v.at(i + 1).substr(
 								0, v.at(i + 1).find(LITERAL("in"))
 							));
 							val = faml::officex::inch(tmp);
@@ -40,6 +40,7 @@
 #include "rapidxml/rapidxml.hpp"
 #include "clx/literal.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "../officex/utility.h"
 #include "styledef.h"
 
@@ -121,12 +122,12 @@ namespace faml {
 				//attr_ptr attr = pos->first_attribute(LITERAL("w:val"));
 				attr_ptr attr = pos->first_attribute(LITERAL("w:left"));
 				if (attr && attr->value_size() > 0) {
-					dest.indent(clx::lexical_cast<double>(attr->value()));
+					dest.indent(officex::number_cast<double>(attr->value()));
 				}
 				
 				attr = pos->first_attribute(LITERAL("w:firstLine"));
 				if (attr && attr->value_size() > 0) {
-					dest.indent1st(clx::lexical_cast<double>(attr->value()));
+					dest.indent1st(officex::number_cast<double>(attr->value()));
 				}
 			}
 			
@@ -138,7 +139,7 @@ namespace faml {
 			if (pos) {
 				attr_ptr attr = pos->first_attribute(LITERAL("w:val"));
 				if (attr && attr->value_size() > 0) {
-					dest.size(clx::lexical_cast<double>(attr->value()) / 2.0);
+					dest.size(officex::number_cast<double>(attr->value()) / 2.0);
 				}
 			}
 			
@@ -158,7 +159,7 @@ namespace faml {
 			if (pos) {
 				attr_ptr attr = pos->first_attribute(LITERAL("w:val"));
 				if (attr && attr->value_size() > 0) {
-					dest.scale(clx::lexical_cast<size_t>(attr->value()));
+					dest.scale(officex::number_cast<size_t>(attr->value()));
 				}
 			}
 			
@@ -40,6 +40,7 @@
 #include "rapidxml/rapidxml.hpp"
 #include "clx/literal.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/utility.h"
 #include "clx/split.h"
 #include "../coordinate.h"
@@ -150,14 +151,14 @@ namespace faml {
 				
 				attr_ptr attr = root->first_attribute(LITERAL("o:spt"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find o:spt attribute");
-				type_ = clx::lexical_cast<size_type>(attr->value());
+				type_ = officex::number_cast<size_type>(attr->value());
 				attr = root->first_attribute(LITERAL("adj"));
 				if (attr && attr->value_size() > 0) {
 					string_type s(attr->value());
 					std::vector<string_type> v;
 					clx::split_if(s, v, clx::is_any_of(LITERAL(",")));
 					for (size_type i = 0; i < v.size(); ++i) {
-						int value = clx::lexical_cast<int>(v.at(i));
+						int value = officex::number_cast<int>(v.at(i));
 						adjust_[i] = (value > 0) ? value : 0;
 					}
 				}
@@ -174,7 +175,7 @@ namespace faml {
 				
 				attr_ptr attr = root->first_attribute(LITERAL("strokeweight"));
 				if (attr && attr->value_size() > 0) {
-					weight_ = faml::officex::emu(clx::lexical_cast<double>(attr->value()));
+					weight_ = faml::officex::emu(officex::number_cast<double>(attr->value()));
 					border_type_ = 0x001;
 					border_ = 0;
 				}
@@ -195,12 +196,12 @@ namespace faml {
 						v.at(i) == LITERAL("width") ||
 						v.at(i) == LITERAL("height")) {
 						if (v.at(i + 1).find(LITERAL("pt"))) {
-							val = clx::lexical_cast<double>(v.at(i + 1).substr(
+							val = officex::number_cast<double>(v.at(i + 1).substr(
 								0, v.at(i + 1).find(LITERAL("pt"))
 							));
 						}
 						else if (v.at(i + 1).find("in")) {
-							double tmp = clx::lexical_cast<double>(v.at(i + 1).substr(
+							double tmp = officex::number_cast<double>(v.at(i + 1).substr(
 								0, v.at(i + 1).find(LITERAL("in"))
 							));
 							val = faml::officex::inch(tmp);
@@ -39,8 +39,10 @@
 #include <string>
 #include <map>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/literal.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/utility.h"
 #include "pstyle.h"
 
@@ -78,7 +80,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				node_ptr root = doc.first_node(LITERAL("w:styles"));
 				if (!root) throw std::runtime_error("cannot find <w:styles> (root) tag");
 				
@@ -129,7 +134,7 @@ namespace faml {
 				pos = p2->first_node(LITERAL("w:sz"));
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:val"));
-					if (attr && attr->value_size()) size_ = clx::lexical_cast<double>(attr->value()) / 2.0;
+					if (attr && attr->value_size()) size_ = officex::number_cast<double>(attr->value()) / 2.0;
 				}
 				
 				return *this;
@@ -41,6 +41,7 @@
 #include "rapidxml/rapidxml.hpp"
 #include "clx/literal.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "../border.h"
 #include "paragraph.h"
 #include "bullet.h"
@@ -130,7 +131,7 @@ namespace faml {
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:w"));
 					if (attr && attr->value_size() > 0) {
-						width_ = clx::lexical_cast<double>(attr->value());
+						width_ = officex::number_cast<double>(attr->value());
 					}
 				}
 				
@@ -138,7 +139,7 @@ namespace faml {
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:fill"));
 					if (attr && attr->value_size() > 0) {
-						fill_ = clx::lexical_cast<size_type>(attr->value(), std::ios::hex) & 0x00ffffff;
+						fill_ = officex::number_cast<size_type>(attr->value(), std::ios::hex) & 0x00ffffff;
 					}
 				}
 				
@@ -231,7 +232,7 @@ namespace faml {
 						if (string_type(child->name()) != LITERAL("w:trHeight")) continue;
 						attr_ptr attr = child->first_attribute(LITERAL("w:val"));
 						if (attr && attr->value_size() > 0) {
-							hs.push_back(clx::lexical_cast<double>(attr->value()));
+							hs.push_back(officex::number_cast<double>(attr->value()));
 						}
 					}
 				}
@@ -288,7 +289,7 @@ namespace faml {
 				
 				attr = root->first_attribute(LITERAL("w:color"));
 				if (attr && attr->value_size() > 0) {
-					size_type rgb = clx::lexical_cast<size_type>(attr->value(), std::ios_base::hex);
+					size_type rgb = officex::number_cast<size_type>(attr->value(), std::ios_base::hex);
 					dest.fill(color(rgb));
 				}
 				
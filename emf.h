@@ -18,6 +18,7 @@
 #include "clx/format.h"
 #include "clx/utility.h"
 #include "page.h"
+#include "profile.h"
 #include "contents/emf.h"
 
 namespace faml {
@@ -48,6 +49,7 @@ namespace faml {
 			
 			template <class OutStream, class PDFManager>
 			bool operator()(OutStream& out, PDFManager& pm) {
+				scoped_phase<PDFManager> phase(pm, "metafile");
 				this->xproperty();
 				page_type newpage(page_);
 				this->xresources(out, pm);
@@ -40,9 +40,11 @@
 #include "clx/format.h"
 #include "clx/literal.h"
 #include "clx/hexdump.h"
+#include "clx/shared_ptr.h"
 #include "utility.h"
 #include "font_property.h"
 #include "font_instance.h"
+#include "font_subset.h"
 
 namespace faml {
 	enum {
@@ -124,15 +126,17 @@ namespace faml {
 			typedef CharT char_type;
 			typedef std::basic_string<CharT, Traits> string_type;
 			typedef basic_font_property<CharT, Traits> property_type;
+			typedef basic_font_subset<CharT, Traits> subset_type;
+			typedef clx::shared_ptr<const property_type> property_ptr;
 			
 			basic_font() :
-				index_(0), label_(), prop_(), cset_(0), dir_(0x01) {
+				index_(0), label_(), prop_(xempty()), cset_(0), dir_(0x01), subset_() {
 				label_ = makelabel(LITERAL("F"));
 			}
 			
 			basic_font(const basic_font& cp) :
 				index_(cp.index_), label_(cp.label_),
-				prop_(cp.prop_), cset_(cp.cset_), dir_(cp.dir_) {}
+				prop_(cp.prop_), cset_(cp.cset_), dir_(cp.dir_), subset_(cp.subset_) {}
 			
 			basic_font& operator=(const basic_font& cp) {
 				index_ = cp.index_;
@@ -140,33 +144,85 @@ namespace faml {
 				prop_ = cp.prop_;
 				cset_ = cp.cset_;
 				dir_ = cp.dir_;
+				subset_ = cp.subset_;
 				return *this;
 			}
 			
 			explicit basic_font(const property_type& prop, int cset, int dir = 0x01) :
-				index_(0), label_(), prop_(prop), cset_(cset), dir_(dir) {
+				index_(0), label_(), prop_(new property_type(prop)), cset_(cset), dir_(dir), subset_() {
+				label_ = makelabel(LITERAL("F"));
+			}
+			
+			explicit basic_font(const property_ptr& prop, int cset, int dir = 0x01) :
+				index_(0), label_(), prop_(prop), cset_(cset), dir_(dir), subset_() {
 				label_ = makelabel(LITERAL("F"));
 			}
 			
 			explicit basic_font(const string_type& name, int cset, int dir = 0x01) :
-				index_(0), label_(), cset_(cset), dir_(dir) {
+				index_(0), label_(), prop_(internfont(name)), cset_(cset), dir_(dir), subset_() {
 				label_ = makelabel(LITERAL("F"));
-				prop_ = getfont(name);
 			}
 			
 			explicit basic_font(const char_type* name, int cset, int dir = 0x01) :
-				index_(0), label_(), cset_(cset), dir_(dir) {
+				index_(0), label_(), prop_(internfont(name)), cset_(cset), dir_(dir), subset_() {
 				label_ = makelabel(LITERAL("F"));
-				prop_ = getfont(name);
 			}
 			
 			template <class OutStream, class PDFGenerator>
 			bool operator()(OutStream& out, PDFGenerator& pm) {
+				if (subset_) {
+					// the dictionaries are written by finish().
+					subset_->reserve(pm);
+					index_ = subset_->font();
+					return true;
+				}
+				
 				if (index_ > 0) pm.setp(index_);
 				else index_ = pm.newindex();
 				return this->xbase(out, pm);
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  embed
+			 *
+			 *  Embeds the subset of the TrueType font file (the index is
+			 *  used for the TrueType collection). The copies of the object
+			 *  share the used characters, which are recorded by use().
+			 */
+			/* ------------------------------------------------------------- */
+			void embed(const std::string& path, size_type index = 0) {
+				if (prop_->type() != 0) return;
+				subset_ = clx::shared_ptr<subset_type>(new subset_type(path, index));
+			}
+			
+			bool embedded() const { return subset_.get() != NULL; }
+			
+			void use(const string_type& s) const {
+				if (subset_) subset_->use(s);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  finish
+			 *
+			 *  Writes the dictionaries of the embedded font with the font
+			 *  file and the objects that depend on the used characters.
+			 *  It must be called after all the contents that use the font
+			 *  are written; the objects reserved by operator() are left
+			 *  unwritten otherwise. When the subset cannot be made, the
+			 *  font is written as the font which is not embedded.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFGenerator>
+			bool finish(OutStream& out, PDFGenerator& pm) {
+				if (!subset_ || subset_->font() == 0 || subset_->done()) return true;
+				if (!(*subset_)(out, pm, dir_ != faml::horizon)) return false;
+				index_ = subset_->font();
+				pm.setp(index_);
+				return this->xbase(out, pm);
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  Access methods (get).
 			/* ------------------------------------------------------------- */
@@ -174,8 +230,8 @@ namespace faml {
 			const string_type& label() const { return label_; }
 			int charset() const { return cset_; }
 			int direction() const { return dir_; }
-			const string_type& name() const { return prop_.name(); }
-			const property_type& property() const { return prop_; }
+			const string_type& name() const { return prop_->name(); }
+			const property_type& property() const { return *prop_; }
 			
 			/* ------------------------------------------------------------- */
 			//  Access methods (set).
@@ -183,17 +239,59 @@ namespace faml {
 			void index(size_type cp) { index_ = cp; }
 			void charset(int cp) { cset_ = cp; }
 			void direction(int cp) { dir_ = cp; }
-			void name(const string_type& cp) { prop_ = getfont(cp); }
-			void property(const property_type& cp) { prop_ = cp; }
+			void name(const string_type& cp) { prop_ = internfont(cp); }
+			void property(const property_type& cp) { prop_ = property_ptr(new property_type(cp)); }
+			void property(const property_ptr& cp) { prop_ = cp; }
 			
 		private:
 			typedef clx::basic_format<CharT, Traits> fmt;
 			
 			size_type index_;
 			string_type label_;
-			property_type prop_;
+			property_ptr prop_;	// shared among the copies, and never modified.
 			int cset_;
 			int dir_;
+			clx::shared_ptr<subset_type> subset_;
+			
+			/* ------------------------------------------------------------- */
+			//  xempty
+			/* ------------------------------------------------------------- */
+			static property_ptr xempty() {
+				static property_ptr dest(new property_type());
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xsubset
+			/* ------------------------------------------------------------- */
+			bool xsubset() const {
+				return subset_ && subset_->embedded();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xnewindex
+			 *
+			 *  Returns the index of the n-th object following the font
+			 *  dictionary. The objects of the embedded font are reserved
+			 *  by the subset.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class PDFManager>
+			size_type xnewindex(PDFManager& pm, size_type n) {
+				if (!subset_) return pm.newindex();
+				pm.setp(index_ + n);
+				return index_ + n;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xname
+			/* ------------------------------------------------------------- */
+			string_type xname() const {
+				string_type dest = faml::detail::hexdump(prop_->name());
+				if (this->xsubset()) dest = subset_->tag() + LITERAL("+") + dest;
+				return dest;
+			}
 			
 			/* ------------------------------------------------------------- */
 			//  xbase
@@ -201,27 +299,28 @@ namespace faml {
 			template <class OutStream, class PDFManager>
 			bool xbase(OutStream& out, PDFManager& pm) {
 				string_type scset;
-				faml::detail::csetstr(cset_, dir_, scset);
+				faml::detail::csetstr(this->xsubset() ? 0 : cset_, dir_, scset);
 				
 				out << fmt(LITERAL("%d 0 obj")) % index_ << std::endl;
 				out << LITERAL("<<") << std::endl;
 				out << LITERAL("/Type /Font") << std::endl;
-				out << LITERAL("/Subtype /Type") << prop_.type() << std::endl;
+				out << LITERAL("/Subtype /Type") << prop_->type() << std::endl;
 				out << LITERAL("/Name /") << label_ << std::endl;
-				out << LITERAL("/BaseFont /") << faml::detail::hexdump(prop_.name()) << std::endl;
+				out << LITERAL("/BaseFont /") << this->xname() << std::endl;
 				out << LITERAL("/Encoding /") << scset << std::endl;
+				if (this->xsubset()) out << fmt(LITERAL("/ToUnicode %d 0 R")) % subset_->tounicode() << std::endl;
 				
-				switch (prop_.type()) {
+				switch (prop_->type()) {
 				case 0:
 					out << fmt(LITERAL("/DescendantFonts [ %d 0 R ]")) % (index_ + 1) << std::endl;
 					break;
 				case 1:
 					out << fmt(LITERAL("/FontDescriptor %d 0 R")) % (index_ + 1) << std::endl;
 					out << LITERAL("/FirstChar 0") << std::endl;
-					out << LITERAL("/LastChar ") << prop_.widths().size() - 1 << std::endl;
+					out << LITERAL("/LastChar ") << prop_->widths().size() - 1 << std::endl;
 					out << LITERAL("/Widths [ ");
-					for (size_type i = 0; i < prop_.widths().size(); ++i) {
-						out << std::dec << prop_.widths().at(i) << LITERAL(" ");
+					for (size_type i = 0; i < prop_->widths().size(); ++i) {
+						out << std::dec << prop_->widths().at(i) << LITERAL(" ");
 					}
 					out << LITERAL(" ]") << std::endl;
 					break;
@@ -234,7 +333,7 @@ namespace faml {
 				out << LITERAL("endobj") << std::endl;
 				out << std::endl;
 				
-				if (prop_.type() == 0) return this->xcid(out, pm);
+				if (prop_->type() == 0) return this->xcid(out, pm);
 				else return this->xdescriptor(out, pm);
 			}
 			
@@ -243,21 +342,31 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager>
 			bool xcid(OutStream& out, PDFManager& pm) {
-				out << fmt(LITERAL("%d 0 obj")) % pm.newindex() << std::endl;
+				size_type index = this->xnewindex(pm, 1);
+				out << fmt(LITERAL("%d 0 obj")) % index << std::endl;
 				out << LITERAL("<<") << std::endl;
 				out << LITERAL("/Type /Font") << std::endl;
 				out << LITERAL("/Subtype /CIDFontType2") << std::endl;
-				out << LITERAL("/BaseFont /") << faml::detail::hexdump(prop_.name()) << std::endl;
-				out << fmt(LITERAL("/FontDescriptor %d 0 R")) % (pm.index() + 1) << std::endl;
-				out << LITERAL("/CIDSystemInfo << /Registry (Adobe) /Ordering (Japan1) /Supplement 2 >>") << std::endl;
+				out << LITERAL("/BaseFont /") << this->xname() << std::endl;
+				out << fmt(LITERAL("/FontDescriptor %d 0 R")) % (index + 1) << std::endl;
+				if (this->xsubset()) {
+					out << LITERAL("/CIDSystemInfo << /Registry (Adobe) /Ordering (Identity) /Supplement 0 >>") << std::endl;
+				}
+				else {
+					out << LITERAL("/CIDSystemInfo << /Registry (Adobe) /Ordering (Japan1) /Supplement 2 >>") << std::endl;
+				}
 				out << LITERAL("/DW 1000") << std::endl;
-				if (prop_.widths().empty()) {
+				if (this->xsubset()) {
+					out << fmt(LITERAL("/W %d 0 R")) % subset_->widths() << std::endl;
+					out << fmt(LITERAL("/CIDToGIDMap %d 0 R")) % subset_->cidmap() << std::endl;
+				}
+				else if (prop_->widths().empty()) {
 					out << LITERAL("/W [ 1 632 500 ]") << std::endl;
 				}
 				else {
 					out << LITERAL("/W [ ");
-					for (size_type i = 0; i < prop_.widths().size(); ++i) {
-						int w = prop_.widths().at(i);
+					for (size_type i = 0; i < prop_->widths().size(); ++i) {
+						int w = prop_->widths().at(i);
 						if (w != 1000) out << fmt(LITERAL("%d [%d] ")) % i % w;
 					}
 					out << LITERAL("]") << std::endl;
@@ -274,23 +383,24 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager>
 			bool xdescriptor(OutStream& out, PDFManager& pm) {
-				out << fmt(LITERAL("%d 0 obj")) % pm.newindex() << std::endl;
+				out << fmt(LITERAL("%d 0 obj")) % this->xnewindex(pm, 2) << std::endl;
 				out << LITERAL("<<") << std::endl;
 				out << LITERAL("/Type /FontDescriptor") << std::endl;
-				out << LITERAL("/FontName /") << faml::detail::hexdump(prop_.name()) << std::endl;
-				out << LITERAL("/Flags ") << prop_.flags() << std::endl;
+				out << LITERAL("/FontName /") << this->xname() << std::endl;
+				out << LITERAL("/Flags ") << prop_->flags() << std::endl;
 				out << fmt(LITERAL("/FontBBox [ %d %d %d %d ]")) %
-					prop_.bbox().lower_left().x() % prop_.bbox().lower_left().y() %
-					prop_.bbox().upper_right().x() % prop_.bbox().upper_right().y() << std::endl;
-				out << LITERAL("/CapHeight ") << prop_.cap_height() << std::endl;
-				out << LITERAL("/Ascent ") << prop_.ascent() << std::endl;
-				out << LITERAL("/Descent ") << prop_.descent() << std::endl;
-				out << LITERAL("/StemV ") << prop_.stemv() << std::endl;
-				out << LITERAL("/ItalicAngle ") << prop_.italic_angle() << std::endl;
+					prop_->bbox().lower_left().x() % prop_->bbox().lower_left().y() %
+					prop_->bbox().upper_right().x() % prop_->bbox().upper_right().y() << std::endl;
+				out << LITERAL("/CapHeight ") << prop_->cap_height() << std::endl;
+				out << LITERAL("/Ascent ") << prop_->ascent() << std::endl;
+				out << LITERAL("/Descent ") << prop_->descent() << std::endl;
+				out << LITERAL("/StemV ") << prop_->stemv() << std::endl;
+				out << LITERAL("/ItalicAngle ") << prop_->italic_angle() << std::endl;
 				out << LITERAL("/MissingWidth 500") << std::endl;
-				if (!prop_.panose().empty()) {
-					out << fmt(LITERAL("/Style << /Panose <%s> >>")) % prop_.panose() << std::endl;
+				if (!prop_->panose().empty()) {
+					out << fmt(LITERAL("/Style << /Panose <%s> >>")) % prop_->panose() << std::endl;
 				}
+				if (this->xsubset()) out << fmt(LITERAL("/FontFile2 %d 0 R")) % subset_->file() << std::endl;
 				out << LITERAL(">>") << std::endl;
 				out << LITERAL("endobj") << std::endl;
 				out << std::endl;
@@ -107,38 +107,89 @@ namespace faml {
 				}
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  create
+			 *
+			 *  Creates the font object of the name (or the alias). The
+			 *  fonts read from TrueType files are embedded as the subset
+			 *  of the used glyphs (see basic_font::embed()) when they are
+			 *  used with the UTF-16 charset. The property read from the
+			 *  file is shared by all the created objects, and its advances
+			 *  are read from the hmtx table, which is also the source of
+			 *  the widths (W) of the embedded font.
+			 *
+			 *  NOTE: basic_font::finish() must be called for the embedded
+			 *  font after the last contents that use it are written. The
+			 *  font dictionaries are written there, so the objects the
+			 *  font reserved are left unwritten without it.
+			 */
+			/* ------------------------------------------------------------- */
 			object_type create(const string_type& name, int cset, int dir = 0x01) {
 				string_type s = (aliases_.find(name) != aliases_.end()) ? aliases_[name] : name;
 				if (v_.find(s) == v_.end()) {
 					return object_type(name, cset, dir);
 				}
 				
+				string_type ext = v_[s].path.substr(v_[s].path.find_last_of("."));
+				clx::downcase(ext);
 				if (!v_[s].value) {
-					string_type ext = v_[s].path.substr(v_[s].path.find_last_of("."));
-					clx::downcase(ext);
 					if (ext == ".ttc") v_[s].value = read_ttc(v_[s].path, v_[s].index);
 					else if (ext == ".ttf") v_[s].value = read_ttf(v_[s].path);
 					else if (ext == ".afm") v_[s].value = read_afm(v_[s].path);
 					else return object_type(name, cset, dir);
 				}
 				
-				return object_type(*v_[s].value, cset, dir);
+				// TrueType fonts are embedded as the subset of the used glyphs.
+				object_type dest(v_[s].value, cset, dir);
+				if ((ext == ".ttc" || ext == ".ttf") && cset == charset::utf16 && this->xembeddable(v_[s])) {
+					dest.embed(v_[s].path, v_[s].index);
+				}
+				return dest;
 			}
 			
 		private:
 			typedef basic_font_property<char> property_type;
-			typedef clx::shared_ptr<property_type> property_ptr;
+			typedef clx::shared_ptr<const property_type> property_ptr;
 			
 			struct mapped_type {
 				string_type path;
 				size_type index;
 				property_ptr value;
+				int embed; // -1: not checked yet
 				
-				mapped_type() : path(), index(0), value() {}
+				mapped_type() : path(), index(0), value(), embed(-1) {}
 			};
 			
 			typedef std::map<string_type, mapped_type> font_map;
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xembeddable
+			 *
+			 *  Checks whether the subset of the font file can be made,
+			 *  and fills the advances of the property with the widths in
+			 *  the hmtx table (indexed by the UTF-16 code through cmap),
+			 *  so that the layout uses the same widths as the W array of
+			 *  the embedded font. The result is kept for the font.
+			 */
+			/* ------------------------------------------------------------- */
+			static bool xembeddable(mapped_type& x) {
+				if (x.embed >= 0) return x.embed > 0;
+				
+				x.embed = 0;
+				true_type_subset ttf;
+				if (!x.value || x.value->type() != 0 || !ttf.read(x.path, x.index)) return false;
+				
+				property_type::advance_table& v = x.value->advances();
+				v.assign(0x10000, 0);
+				for (size_type i = 0; i < v.size(); ++i) {
+					v[i] = static_cast<unsigned short>(ttf.width(ttf.glyph(static_cast<unsigned long>(i))));
+				}
+				x.embed = 1;
+				return true;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  add_ttc
 			/* ------------------------------------------------------------- */
@@ -168,6 +219,7 @@ namespace faml {
 					handlefont(tmp.c_str(),i,ttc,offsets[i]);
 					mapped_type elem;
 					elem.path = path;
+					elem.index = i;
 					elem.value = read_ttf(tmp);
 					remove(tmp.c_str());
 					if (!elem.value) continue;
@@ -254,10 +306,10 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			static property_ptr read_afm(const string_type& path) {
 				std::ifstream in(path.c_str());
-				property_ptr dest(new property_type());
-				dest->type(0);
-				dest->flags(32);
-				dest->stemv(80);
+				property_type dest;
+				dest.type(0);
+				dest.flags(32);
+				dest.stemv(80);
 				
 				string_type line;
 				while (std::getline(in, line)) {
@@ -265,17 +317,17 @@ namespace faml {
 					if (line.find(" ") == string_type::npos) continue;
 					string_type key = line.substr(0, line.find(" "));
 					string_type val = line.substr(line.find(" ") + 1);
-					if (key == "FullName") dest->name(val);
-					else if (key == "ItalicAngle") dest->italic_angle(clx::lexical_cast<int>(val));
-					else if (key == "Descender") dest->descent(clx::lexical_cast<int>(val));
+					if (key == "FullName") dest.name(val);
+					else if (key == "ItalicAngle") dest.italic_angle(clx::lexical_cast<int>(val));
+					else if (key == "Descender") dest.descent(clx::lexical_cast<int>(val));
 					else if (key == "Ascender") {
-						dest->ascent(clx::lexical_cast<int>(val));
-						dest->cap_height(clx::lexical_cast<int>(val));
+						dest.ascent(clx::lexical_cast<int>(val));
+						dest.cap_height(clx::lexical_cast<int>(val));
 					}
 					else if (key == "FontBBox") {
 						std::vector<string_type> tok;
 						clx::split(val, tok);
-						dest->bbox(square(
+						dest.bbox(square(
 							coordinate(clx::lexical_cast<double>(tok.at(0)), clx::lexical_cast<double>(tok.at(1))),
 							coordinate(clx::lexical_cast<double>(tok.at(2)), clx::lexical_cast<double>(tok.at(3)))
 						));
@@ -288,23 +340,23 @@ namespace faml {
 				
 //#ifdef FAML_DEBUG
 #if 0
-				std::cout << "name: " << dest->name() << std::endl;
-				std::cout << "ascent: " << dest->ascent() << std::endl;
-				std::cout << "descent: " << dest->descent() << std::endl;
-				std::cout << "italic angle: " << dest->italic_angle() << std::endl;
-				std::cout << "widths: " << dest->widths().size() << std::endl;
+				std::cout << "name: " << dest.name() << std::endl;
+				std::cout << "ascent: " << dest.ascent() << std::endl;
+				std::cout << "descent: " << dest.descent() << std::endl;
+				std::cout << "italic angle: " << dest.italic_angle() << std::endl;
+				std::cout << "widths: " << dest.widths().size() << std::endl;
 				//std::cout << "--" << std::endl;
-				//std::copy(dest->widths().begin(), dest->widths().end(),
+				//std::copy(dest.widths().begin(), dest.widths().end(),
 				//	std::ostream_iterator<int>(std::cout, " "));
 				//std::cout << std::endl;
 #endif
-				return dest;
+				return property_ptr(new property_type(dest));
 			}
 			
 			/* ------------------------------------------------------------- */
 			//  read_widths
 			/* ------------------------------------------------------------- */
-			static bool read_widths(istream_type& in, property_ptr& dest, size_type n) {
+			static bool read_widths(istream_type& in, property_type& dest, size_type n) {
 				for (size_type i = 0; i < n; ++i) {
 					static const string_type format("C %s ; WX %s ; N %s ; B %s ;");
 					
@@ -314,7 +366,7 @@ namespace faml {
 					int width = -1;
 					clx::scanner(line, format)(1, width);
 					if (width < 0) continue;
-					dest->width(width);
+					dest.width(width);
 				}
 				
 				return true;
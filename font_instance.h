@@ -39,6 +39,7 @@
 #include <map>
 #include "clx/literal.h"
 #include "clx/utility.h"
+#include "clx/shared_ptr.h"
 #include "font_property.h"
 
 namespace faml {
@@ -2111,6 +2112,40 @@ namespace faml {
 			std::basic_string<CharT> tmp(name);
 			return getfont(tmp);
 		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  internfont
+		 *
+		 *  Returns the shared, immutable property of the font. The
+		 *  property is copied from the font instances only at the first
+		 *  call for each name, and the names that fall back to the same
+		 *  font share one property, so copying basic_font objects costs
+		 *  a pointer instead of the width table.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <class Ch, class Tr>
+		inline clx::shared_ptr<const font_property> internfont(const std::basic_string<Ch, Tr>& name) {
+			typedef clx::shared_ptr<const font_property> property_ptr;
+			typedef std::map<std::basic_string<Ch, Tr>, property_ptr> cache_type;
+			static cache_type names;
+			static cache_type fonts;
+			
+			typename cache_type::iterator pos = names.find(name);
+			if (pos != names.end()) return pos->second;
+			
+			font_property prop = getfont(name);
+			property_ptr& dest = fonts[prop.name()];
+			if (!dest) dest = property_ptr(new font_property(prop));
+			names[name] = dest;
+			return dest;
+		}
+		
+		template <class CharT>
+		inline clx::shared_ptr<const font_property> internfont(const CharT* name) {
+			std::basic_string<CharT> tmp(name);
+			return internfont(tmp);
+		}
 	}
 }
 
@@ -37,6 +37,7 @@
 
 #include <string>
 #include <vector>
+#include "clx/shared_ptr.h"
 #include "coordinate.h"
 
 namespace faml {
@@ -72,17 +73,21 @@ namespace faml {
 			typedef CharT char_type;
 			typedef unsigned char byte_type;
 			typedef std::basic_string<CharT, Traits> string_type;
+			typedef std::vector<unsigned short> advance_table;
 			
 			basic_font_property() :
 				name_(), type_(0), flags_(0), caph_(0), ascent_(0), descent_(0),
-				stemv_(0), angle_(0), bbox_(), panose_(), widths_() {}
+				stemv_(0), angle_(0), bbox_(), panose_(), widths_(), advances_() {}
 			
 			/* ------------------------------------------------------------- */
 			//  Access methods (set).
 			/* ------------------------------------------------------------- */
 			void name(const string_type& s) { name_ = s; }
 			void name(const char_type* s) { name_ = s; }
-			void type(int value) { type_ = value; }
+			void type(int value) {
+				type_ = value;
+				advances_.reset();
+			}
 			void flags(int x) { flags_ = x; }
 			void cap_height(int caph) { caph_ = caph; }
 			void ascent(int value) { ascent_ = value; }
@@ -99,9 +104,13 @@ namespace faml {
 					widths_.push_back(*first);
 					++first;
 				}
+				advances_.reset();
 			}
 			
-			void width(int value) { widths_.push_back(value); }
+			void width(int value) {
+				widths_.push_back(value);
+				advances_.reset();
+			}
 			
 			/* ------------------------------------------------------------- */
 			//  Access methods (get).
@@ -118,6 +127,23 @@ namespace faml {
 			const string_type& panose() const { return panose_; }
 			const std::vector<int>& widths() const { return widths_; }
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  advances
+			 *
+			 *  Returns the cache of advances indexed by the 16-bit
+			 *  character code. The cache is created at the first call,
+			 *  and its entries are filled by the text helper on demand
+			 *  (see utf16::advance()). It is shared among the copies of
+			 *  the property made after that, and dropped (without any
+			 *  allocation) when the type or the widths are changed.
+			 */
+			/* ------------------------------------------------------------- */
+			advance_table& advances() const {
+				if (advances_.get() == NULL) advances_ = clx::shared_ptr<advance_table>(new advance_table());
+				return *advances_;
+			}
+			
 		private:
 			string_type name_;
 			int type_;
@@ -130,6 +156,7 @@ namespace faml {
 			square bbox_;
 			string_type panose_;
 			std::vector<int> widths_;
+			mutable clx::shared_ptr<advance_table> advances_;
 			
 		public:
 			/* ------------------------------------------------------------- */
@@ -142,14 +169,14 @@ namespace faml {
 				int x, int caph, int as, int des, int stv, int angl, const square& bb,
 				const char_type* pan) :
 				name_(s), type_(t), flags_(x), caph_(caph), ascent_(as), descent_(des),
-				stemv_(stv), angle_(angl), bbox_(bb), panose_(pan), widths_() {}
+				stemv_(stv), angle_(angl), bbox_(bb), panose_(pan), widths_(), advances_() {}
 			
 			template <class InIter>
 			explicit basic_font_property(const char_type* s, int t,
 				int x, int caph, int as, int des, int stv, int angl, const square& bb,
 				const char_type* pan, InIter first, InIter last) :
 				name_(s), type_(t), flags_(x), caph_(caph), ascent_(as), descent_(des),
-				stemv_(stv), angle_(angl), bbox_(bb), panose_(pan), widths_() {
+				stemv_(stv), angle_(angl), bbox_(bb), panose_(pan), widths_(), advances_() {
 				this->widths(first, last);
 			}
 		};
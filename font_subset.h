@@ -0,0 +1,862 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  font_subset.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_PDF_FONT_SUBSET_H
+#define FAML_PDF_FONT_SUBSET_H
+
+#include <algorithm>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "clx/literal.h"
+#include "clx/format.h"
+#include "clx/logger.h"
+#ifdef FAML_USE_ZLIB
+#include "clx/zstream.h"
+#endif
+
+namespace faml {
+	namespace pdf {
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  true_type_subset
+		 *
+		 *  The true_type_subset class reads the TrueType font (or the
+		 *  font in the TrueType collection) and makes the font program
+		 *  that contains only the specified glyphs. The glyphs are
+		 *  renumbered in the ascending order of the original glyph IDs.
+		 *  The glyph 0 (.notdef) and the components of the composite
+		 *  glyphs are always added.
+		 */
+		/* ----------------------------------------------------------------- */
+		class true_type_subset {
+		public:
+			typedef size_t size_type;
+			typedef unsigned char byte_type;
+			typedef unsigned short glyph_type;
+			typedef std::vector<byte_type> buffer_type;
+			
+			true_type_subset() :
+				data_(), tables_(), glyphs_(0), metrics_(0), upem_(1000),
+				longloca_(false), cmap_(0), format_(0) {}
+				
+			/* ------------------------------------------------------------- */
+			/*
+			 *  read
+			 *
+			 *  Reads the font file. The index is used only when the file
+			 *  is the TrueType collection (.ttc).
+			 */
+			/* ------------------------------------------------------------- */
+			bool read(const std::string& path, size_type index = 0) {
+				std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+				if (!in) return false;
+				data_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+				
+				size_type offset = 0;
+				if (this->xtag(0) == "ttcf") {
+					if (index >= this->xu32(8)) return false;
+					offset = this->xu32(12 + index * 4);
+				}
+				return this->xparse(offset);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  glyph
+			 *
+			 *  Returns the glyph ID of the Unicode character by using the
+			 *  cmap table (format 4 or 12). 0 is returned if the font does
+			 *  not have the glyph.
+			 */
+			/* ------------------------------------------------------------- */
+			glyph_type glyph(unsigned long code) const {
+				unsigned long dest = 0;
+				if (format_ == 4) dest = this->xformat4(code);
+				else if (format_ == 12) dest = this->xformat12(code);
+				return (dest < glyphs_) ? static_cast<glyph_type>(dest) : 0;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  width
+			 *
+			 *  Returns the advance width of the glyph in the 1/1000 unit
+			 *  of text space.
+			 */
+			/* ------------------------------------------------------------- */
+			int width(glyph_type gid) const {
+				size_type i = std::min(static_cast<size_type>(gid), metrics_ - 1);
+				return static_cast<int>(this->xu16(this->xoffset("hmtx") + i * 4) * 1000.0 / upem_ + 0.5);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  vertical
+			 *
+			 *  Gets the vertical forms of the glyphs (e.g., the rotated
+			 *  parentheses) from the single substitutions of the 'vert'
+			 *  and 'vrt2' features in the GSUB table. The first found
+			 *  substitution is used for each glyph. Nothing is added when
+			 *  the font does not have the GSUB table.
+			 */
+			/* ------------------------------------------------------------- */
+			void vertical(std::map<glyph_type, glyph_type>& dest) const {
+				if (tables_.find("GSUB") == tables_.end()) return;
+				size_type base = this->xoffset("GSUB");
+				size_type features = base + this->xu16(base + 6);
+				size_type lookups = base + this->xu16(base + 8);
+				
+				std::set<size_type> indices;
+				size_type n = this->xu16(features);
+				for (size_type i = 0; i < n; ++i) {
+					size_type pos = features + 2 + i * 6;
+					std::string tag = this->xtag(pos);
+					if (tag != "vert" && tag != "vrt2") continue;
+					size_type feature = features + this->xu16(pos + 4);
+					size_type m = this->xu16(feature + 2);
+					for (size_type j = 0; j < m; ++j) indices.insert(this->xu16(feature + 4 + j * 2));
+				}
+				
+				for (std::set<size_type>::const_iterator it = indices.begin(); it != indices.end(); ++it) {
+					if (*it >= this->xu16(lookups)) continue;
+					size_type lookup = lookups + this->xu16(lookups + 2 + *it * 2);
+					size_type m = this->xu16(lookup + 4);
+					for (size_type j = 0; j < m; ++j) {
+						size_type type = this->xu16(lookup);
+						size_type sub = lookup + this->xu16(lookup + 6 + j * 2);
+						if (type == 7) { // extension
+							type = this->xu16(sub + 2);
+							sub += this->xu32(sub + 4);
+						}
+						if (type == 1) this->xsingle(sub, dest);
+					}
+				}
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  subset
+			 *
+			 *  Makes the font program from the glyphs in gids. When the
+			 *  method returns, gids holds the sorted glyph IDs of the new
+			 *  font, i.e., the new ID of the glyph is the position in gids.
+			 */
+			/* ------------------------------------------------------------- */
+			bool subset(std::vector<glyph_type>& gids, buffer_type& dest) const {
+				std::set<glyph_type> used;
+				used.insert(0);
+				for (size_type i = 0; i < gids.size(); ++i) {
+					if (gids[i] < glyphs_) used.insert(gids[i]);
+				}
+				
+				std::vector<glyph_type> rest(used.begin(), used.end());
+				while (!rest.empty()) {
+					glyph_type gid = rest.back();
+					rest.pop_back();
+					std::vector<size_type> comps;
+					this->xcomponents(gid, comps);
+					for (size_type i = 0; i < comps.size(); ++i) {
+						glyph_type c = static_cast<glyph_type>(this->xu16(comps[i]));
+						if (c < glyphs_ && used.insert(c).second) rest.push_back(c);
+					}
+				}
+				gids.assign(used.begin(), used.end());
+				
+				std::map<std::string, buffer_type> v;
+				buffer_type& glyf = v["glyf"];
+				buffer_type& loca = v["loca"];
+				buffer_type& hmtx = v["hmtx"];
+				size_type hm = this->xoffset("hmtx");
+				for (size_type i = 0; i < gids.size(); ++i) {
+					glyph_type gid = gids[i];
+					xput32(loca, glyf.size());
+					
+					std::pair<size_type, size_type> g = this->xglyph(gid);
+					size_type first = glyf.size();
+					glyf.insert(glyf.end(), data_.begin() + g.first, data_.begin() + g.first + g.second);
+					std::vector<size_type> comps;
+					this->xcomponents(gid, comps);
+					for (size_type j = 0; j < comps.size(); ++j) {
+						glyph_type c = static_cast<glyph_type>(this->xu16(comps[j]));
+						size_type id = std::lower_bound(gids.begin(), gids.end(), c) - gids.begin();
+						xset16(glyf, first + comps[j] - g.first, id);
+					}
+					while (glyf.size() % 4 != 0) glyf.push_back(0);
+					
+					size_type k = std::min(static_cast<size_type>(gid), metrics_ - 1);
+					size_type lsb = (gid < metrics_) ? hm + gid * 4 + 2 : hm + metrics_ * 4 + (gid - metrics_) * 2;
+					xput16(hmtx, this->xu16(hm + k * 4));
+					xput16(hmtx, this->xu16(lsb));
+				}
+				xput32(loca, glyf.size());
+				
+				static const char* hints[] = { "cvt ", "fpgm", "prep" };
+				for (size_type i = 0; i < sizeof(hints) / sizeof(hints[0]); ++i) {
+					if (tables_.find(hints[i]) != tables_.end()) this->xcopy(hints[i], v[hints[i]]);
+				}
+				
+				this->xcopy("head", v["head"]);
+				xset32(v["head"], 8, 0);		// checkSumAdjustment
+				xset16(v["head"], 50, 1);		// indexToLocFormat (long)
+				this->xcopy("hhea", v["hhea"]);
+				xset16(v["hhea"], 34, gids.size());	// numberOfHMetrics
+				this->xcopy("maxp", v["maxp"]);
+				xset16(v["maxp"], 4, gids.size());	// numGlyphs
+				
+				xbuild(v, dest);
+				return true;
+			}
+			
+		private:
+			typedef std::pair<size_type, size_type> table_type;
+			
+			buffer_type data_;
+			std::map<std::string, table_type> tables_;
+			size_type glyphs_;
+			size_type metrics_;
+			size_type upem_;
+			bool longloca_;
+			size_type cmap_;
+			int format_;
+			
+			/* ------------------------------------------------------------- */
+			//  xparse
+			/* ------------------------------------------------------------- */
+			bool xparse(size_type offset) {
+				size_type n = this->xu16(offset + 4);
+				for (size_type i = 0; i < n; ++i) {
+					size_type pos = offset + 12 + i * 16;
+					table_type elem(this->xu32(pos + 8), this->xu32(pos + 12));
+					if (elem.first > data_.size() || elem.second > data_.size() - elem.first) return false;
+					tables_[this->xtag(pos)] = elem;
+				}
+				
+				static const char* required[] = { "head", "hhea", "maxp", "hmtx", "loca", "glyf", "cmap" };
+				for (size_type i = 0; i < sizeof(required) / sizeof(required[0]); ++i) {
+					if (tables_.find(required[i]) == tables_.end()) return false;
+				}
+				if (tables_["head"].second < 54 || tables_["hhea"].second < 36 || tables_["maxp"].second < 6) return false;
+				
+				upem_ = this->xu16(this->xoffset("head") + 18);
+				if (upem_ == 0) upem_ = 1000;
+				longloca_ = (this->xu16(this->xoffset("head") + 50) != 0);
+				glyphs_ = this->xu16(this->xoffset("maxp") + 4);
+				metrics_ = this->xu16(this->xoffset("hhea") + 34);
+				if (glyphs_ == 0 || metrics_ == 0 || metrics_ > glyphs_) return false;
+				
+				return this->xcmap();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xcmap
+			 *
+			 *  Selects the Unicode subtable of the cmap table. The format
+			 *  12 subtable (full repertoire) is preferred to the format 4
+			 *  subtable (BMP only).
+			 */
+			/* ------------------------------------------------------------- */
+			bool xcmap() {
+				size_type base = this->xoffset("cmap");
+				size_type n = this->xu16(base + 2);
+				int score = 0;
+				for (size_type i = 0; i < n; ++i) {
+					size_type pos = base + 4 + i * 8;
+					unsigned long platform = this->xu16(pos);
+					unsigned long encoding = this->xu16(pos + 2);
+					size_type sub = base + this->xu32(pos + 4);
+					int format = static_cast<int>(this->xu16(sub));
+					
+					int x = 0;
+					if (format == 12 && (platform == 0 || (platform == 3 && encoding == 10))) x = 3;
+					else if (format == 4 && platform == 3 && encoding == 1) x = 2;
+					else if (format == 4 && platform == 0) x = 1;
+					if (x > score) {
+						score = x;
+						cmap_ = sub;
+						format_ = format;
+					}
+				}
+				return score > 0;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xformat4
+			/* ------------------------------------------------------------- */
+			unsigned long xformat4(unsigned long code) const {
+				if (code > 0xffff) return 0;
+				
+				size_type segs = this->xu16(cmap_ + 6) / 2;
+				size_type ends = cmap_ + 14;
+				size_type starts = ends + segs * 2 + 2;
+				size_type deltas = starts + segs * 2;
+				size_type ranges = deltas + segs * 2;
+				
+				size_type lo = 0, hi = segs;
+				while (lo < hi) {
+					size_type mid = (lo + hi) / 2;
+					if (this->xu16(ends + mid * 2) < code) lo = mid + 1;
+					else hi = mid;
+				}
+				if (lo == segs) return 0;
+				
+				unsigned long start = this->xu16(starts + lo * 2);
+				if (code < start) return 0;
+				unsigned long delta = this->xu16(deltas + lo * 2);
+				unsigned long ro = this->xu16(ranges + lo * 2);
+				if (ro == 0) return (code + delta) & 0xffff;
+				
+				unsigned long g = this->xu16(ranges + lo * 2 + ro + (code - start) * 2);
+				return (g == 0) ? 0 : (g + delta) & 0xffff;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xformat12
+			/* ------------------------------------------------------------- */
+			unsigned long xformat12(unsigned long code) const {
+				size_type n = this->xu32(cmap_ + 12);
+				size_type lo = 0, hi = n;
+				while (lo < hi) {
+					size_type mid = (lo + hi) / 2;
+					if (this->xu32(cmap_ + 16 + mid * 12 + 4) < code) lo = mid + 1;
+					else hi = mid;
+				}
+				if (lo == n) return 0;
+				
+				size_type pos = cmap_ + 16 + lo * 12;
+				unsigned long start = this->xu32(pos);
+				if (code < start) return 0;
+				return this->xu32(pos + 8) + (code - start);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xsingle
+			 *
+			 *  Reads the single substitution subtable (format 1 or 2).
+			 */
+			/* ------------------------------------------------------------- */
+			void xsingle(size_type sub, std::map<glyph_type, glyph_type>& dest) const {
+				std::vector<glyph_type> covered;
+				this->xcoverage(sub + this->xu16(sub + 2), covered);
+				
+				size_type format = this->xu16(sub);
+				for (size_type i = 0; i < covered.size(); ++i) {
+					unsigned long g = 0;
+					if (format == 1) g = (covered[i] + this->xu16(sub + 4)) & 0xffff; // deltaGlyphID (modulo 65536)
+					else if (format == 2 && i < this->xu16(sub + 4)) g = this->xu16(sub + 6 + i * 2);
+					else continue;
+					if (g < glyphs_) dest.insert(std::make_pair(covered[i], static_cast<glyph_type>(g)));
+				}
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xcoverage
+			 *
+			 *  Gets the glyphs of the coverage table in the order of the
+			 *  coverage index.
+			 */
+			/* ------------------------------------------------------------- */
+			void xcoverage(size_type pos, std::vector<glyph_type>& dest) const {
+				size_type format = this->xu16(pos);
+				size_type n = this->xu16(pos + 2);
+				if (format == 1) {
+					for (size_type i = 0; i < n; ++i) dest.push_back(static_cast<glyph_type>(this->xu16(pos + 4 + i * 2)));
+				}
+				else if (format == 2) {
+					for (size_type i = 0; i < n; ++i) {
+						unsigned long first = this->xu16(pos + 4 + i * 6);
+						unsigned long last = this->xu16(pos + 4 + i * 6 + 2);
+						for (unsigned long g = first; g <= last && g < glyphs_; ++g) dest.push_back(static_cast<glyph_type>(g));
+					}
+				}
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xglyph
+			 *
+			 *  Returns the position and the length of the glyph data. The
+			 *  length is 0 for empty glyphs and broken loca entries.
+			 */
+			/* ------------------------------------------------------------- */
+			std::pair<size_type, size_type> xglyph(glyph_type gid) const {
+				size_type loca = this->xoffset("loca");
+				size_type first = 0, last = 0;
+				if (longloca_) {
+					first = this->xu32(loca + gid * 4);
+					last = this->xu32(loca + gid * 4 + 4);
+				}
+				else {
+					first = this->xu16(loca + gid * 2) * 2;
+					last = this->xu16(loca + gid * 2 + 2) * 2;
+				}
+				
+				const table_type& glyf = tables_.find("glyf")->second;
+				if (last <= first || last > glyf.second) return std::make_pair(glyf.first, static_cast<size_type>(0));
+				return std::make_pair(glyf.first + first, last - first);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xcomponents
+			 *
+			 *  Gets the positions of the glyph indices of the components
+			 *  when the glyph is a composite glyph.
+			 */
+			/* ------------------------------------------------------------- */
+			void xcomponents(glyph_type gid, std::vector<size_type>& dest) const {
+				std::pair<size_type, size_type> g = this->xglyph(gid);
+				if (g.second < 10 || static_cast<short>(this->xu16(g.first)) >= 0) return;
+				
+				size_type pos = g.first + 10;
+				size_type last = g.first + g.second;
+				while (pos + 4 <= last) {
+					unsigned long flags = this->xu16(pos);
+					dest.push_back(pos + 2);
+					pos += 4;
+					pos += (flags & 0x0001) ? 4 : 2;		// ARG_1_AND_2_ARE_WORDS
+					if (flags & 0x0008) pos += 2;			// WE_HAVE_A_SCALE
+					else if (flags & 0x0040) pos += 4;		// WE_HAVE_AN_X_AND_Y_SCALE
+					else if (flags & 0x0080) pos += 8;		// WE_HAVE_A_TWO_BY_TWO
+					if (!(flags & 0x0020)) break;			// MORE_COMPONENTS
+				}
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xcopy
+			/* ------------------------------------------------------------- */
+			void xcopy(const char* tag, buffer_type& dest) const {
+				const table_type& elem = tables_.find(tag)->second;
+				dest.assign(data_.begin() + elem.first, data_.begin() + elem.first + elem.second);
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xbuild
+			/* ------------------------------------------------------------- */
+			static void xbuild(const std::map<std::string, buffer_type>& v, buffer_type& dest) {
+				typedef std::map<std::string, buffer_type>::const_iterator iterator;
+				
+				size_type n = v.size();
+				size_type search = 1, selector = 0;
+				while (search * 2 <= n) {
+					search *= 2;
+					++selector;
+				}
+				
+				dest.clear();
+				xput32(dest, 0x00010000);
+				xput16(dest, n);
+				xput16(dest, search * 16);
+				xput16(dest, selector);
+				xput16(dest, (n - search) * 16);
+				
+				size_type offset = 12 + n * 16;
+				size_type head = 0;
+				for (iterator pos = v.begin(); pos != v.end(); ++pos) {
+					dest.insert(dest.end(), pos->first.begin(), pos->first.end());
+					xput32(dest, xchecksum(pos->second));
+					xput32(dest, offset);
+					xput32(dest, pos->second.size());
+					if (pos->first == "head") head = offset;
+					offset += (pos->second.size() + 3) & ~static_cast<size_type>(3);
+				}
+				
+				for (iterator pos = v.begin(); pos != v.end(); ++pos) {
+					dest.insert(dest.end(), pos->second.begin(), pos->second.end());
+					while (dest.size() % 4 != 0) dest.push_back(0);
+				}
+				xset32(dest, head + 8, 0xb1b0afbaUL - xchecksum(dest));
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xchecksum
+			/* ------------------------------------------------------------- */
+			static unsigned long xchecksum(const buffer_type& v) {
+				unsigned long dest = 0;
+				for (size_type i = 0; i < v.size(); i += 4) {
+					unsigned long x = 0;
+					for (size_type k = 0; k < 4; ++k) x = (x << 8) | ((i + k < v.size()) ? v[i + k] : 0);
+					dest = (dest + x) & 0xffffffffUL;
+				}
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  big-endian accessors (out of range bytes are read as 0)
+			/* ------------------------------------------------------------- */
+			size_type xoffset(const char* tag) const {
+				return tables_.find(tag)->second.first;
+			}
+			
+			std::string xtag(size_type pos) const {
+				std::string dest;
+				for (size_type i = pos; i < pos + 4 && i < data_.size(); ++i) dest += static_cast<char>(data_[i]);
+				return dest;
+			}
+			
+			unsigned long xu16(size_type pos) const {
+				if (pos + 2 > data_.size()) return 0;
+				return (static_cast<unsigned long>(data_[pos]) << 8) | data_[pos + 1];
+			}
+			
+			unsigned long xu32(size_type pos) const {
+				return (this->xu16(pos) << 16) | this->xu16(pos + 2);
+			}
+			
+			static void xput16(buffer_type& v, unsigned long x) {
+				v.push_back(static_cast<byte_type>((x >> 8) & 0xff));
+				v.push_back(static_cast<byte_type>(x & 0xff));
+			}
+			
+			static void xput32(buffer_type& v, unsigned long x) {
+				xput16(v, (x >> 16) & 0xffff);
+				xput16(v, x & 0xffff);
+			}
+			
+			static void xset16(buffer_type& v, size_type pos, unsigned long x) {
+				if (pos + 2 > v.size()) return;
+				v[pos] = static_cast<byte_type>((x >> 8) & 0xff);
+				v[pos + 1] = static_cast<byte_type>(x & 0xff);
+			}
+			
+			static void xset32(buffer_type& v, size_type pos, unsigned long x) {
+				xset16(v, pos, (x >> 16) & 0xffff);
+				xset16(v, pos + 2, x & 0xffff);
+			}
+		};
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_font_subset
+		 *
+		 *  The basic_font_subset class records the characters shown with
+		 *  the font, and writes the subset of the font file after all the
+		 *  contents are written. The font is used with the Identity-H
+		 *  (or Identity-V) encoding, and the CID of each character is
+		 *  the UTF-16 code, so that the contents stream can be written
+		 *  before the subset is made. Characters out of BMP (surrogate
+		 *  pairs) are not recorded, and are shown as .notdef. In
+		 *  vertical writing, the CIDs are mapped to the vertical forms
+		 *  in the GSUB table (the UniJIS-UTF16-V CMap does the same for
+		 *  the fonts which are not embedded).
+		 *
+		 *  The objects of the font (the font dictionaries, FontFile2, W,
+		 *  CIDToGIDMap and ToUnicode) are reserved by reserve() when
+		 *  the font is first used, and are written by operator() and
+		 *  basic_font::finish(). If the subset cannot be made, the font
+		 *  is written without the font file (see embedded()), and the
+		 *  objects reserved for the subset are written as null.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_font_subset {
+		public:
+			typedef size_t size_type;
+			typedef CharT char_type;
+			typedef std::basic_string<CharT, Traits> string_type;
+			typedef std::set<unsigned long> code_set;
+			
+			explicit basic_font_subset(const std::string& path, size_type index = 0) :
+				path_(path), index_(index), codes_(),
+				font_(0), file_(0), cidmap_(0), widths_(0), tounicode_(0),
+				embedded_(false), done_(false) {}
+				
+			/* ------------------------------------------------------------- */
+			/*
+			 *  use
+			 *
+			 *  Records the characters of the UTF-16BE string.
+			 */
+			/* ------------------------------------------------------------- */
+			void use(const string_type& s) {
+				for (size_type i = 0; i + 1 < s.size(); i += 2) {
+					unsigned long c = (static_cast<unsigned long>(static_cast<unsigned char>(s[i])) << 8) |
+						static_cast<unsigned char>(s[i + 1]);
+					if (c >= 0xd800 && c <= 0xdfff) continue;
+					codes_.insert(c);
+				}
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  reserve
+			 *
+			 *  Reserves the object numbers. The font dictionaries use the
+			 *  three successive numbers from font() (the Type0 font, the
+			 *  CIDFont and the font descriptor).
+			 */
+			/* ------------------------------------------------------------- */
+			template <class PDFManager>
+			void reserve(PDFManager& pm) {
+				if (font_ > 0) return;
+				font_ = pm.newindex();
+				pm.newindex();
+				pm.newindex();
+				file_ = pm.newindex();
+				cidmap_ = pm.newindex();
+				widths_ = pm.newindex();
+				tounicode_ = pm.newindex();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  operator()
+			 *
+			 *  Writes the subset and the objects that depend on it. The
+			 *  glyphs are replaced with the vertical forms if vertical
+			 *  is true. The widths (W) are the advances of the original
+			 *  glyphs in hmtx, which are also used for the layout (see
+			 *  font_factory::create()).
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager>
+			bool operator()(OutStream& out, PDFManager& pm, bool vertical = false) {
+				if (font_ == 0 || done_) return true;
+				done_ = true;
+				
+				true_type_subset ttf;
+				std::vector<unsigned short> src;	// glyphs of the codes
+				std::vector<unsigned short> dest;	// glyphs shown (vertical forms)
+				std::vector<unsigned short> gids;
+				std::vector<unsigned char> data;
+				bool status = ttf.read(path_, index_);
+				if (status) {
+					std::map<unsigned short, unsigned short> vert;
+					if (vertical) ttf.vertical(vert);
+					for (typename code_set::const_iterator pos = codes_.begin(); pos != codes_.end(); ++pos) {
+						src.push_back(ttf.glyph(*pos));
+						std::map<unsigned short, unsigned short>::const_iterator it = vert.find(src.back());
+						dest.push_back((it != vert.end()) ? it->second : src.back());
+					}
+					gids = dest;
+					status = ttf.subset(gids, data);
+				}
+				
+				if (!status) {
+					clx::logger::warn(WARNF("cannot make the subset of the font file: %s", path_.c_str()));
+					this->xput_object(out, pm, file_, LITERAL("null"));
+					this->xput_object(out, pm, cidmap_, LITERAL("null"));
+					this->xput_object(out, pm, widths_, LITERAL("null"));
+					this->xput_object(out, pm, tounicode_, LITERAL("null"));
+					return true;
+				}
+				embedded_ = true;
+				
+				// FontFile2
+				std::basic_stringstream<CharT, Traits> length;
+				length << LITERAL("/Length1 ") << data.size();
+				this->xput_stream(out, pm, file_, string_type(data.begin(), data.end()), length.str());
+					
+				// CIDToGIDMap and W
+				string_type cidmap(codes_.empty() ? 0 : (*codes_.rbegin() + 1) * 2, 0);
+				std::basic_stringstream<CharT, Traits> ss;
+				ss << LITERAL("[");
+				unsigned long prev = 0;
+				size_type i = 0;
+				for (typename code_set::const_iterator pos = codes_.begin(); pos != codes_.end(); ++pos, ++i) {
+					size_type id = std::lower_bound(gids.begin(), gids.end(), dest[i]) - gids.begin();
+					cidmap[*pos * 2] = static_cast<char_type>((id >> 8) & 0xff);
+					cidmap[*pos * 2 + 1] = static_cast<char_type>(id & 0xff);
+					
+					if (i == 0 || *pos != prev + 1) {
+						if (i > 0) ss << LITERAL(" ]");
+						ss << LITERAL(" ") << *pos << LITERAL(" [");
+					}
+					ss << LITERAL(" ") << ttf.width(src[i]);
+					prev = *pos;
+				}
+				if (i > 0) ss << LITERAL(" ]");
+				ss << LITERAL(" ]");
+				
+				this->xput_stream(out, pm, cidmap_, cidmap, string_type());
+				this->xput_object(out, pm, widths_, ss.str());
+				return this->xput_tounicode(out, pm);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  tag
+			 *
+			 *  Returns the six uppercase letters prefixed to the name of
+			 *  the subset font (e.g., ABCDEF+MS-Mincho).
+			 */
+			/* ------------------------------------------------------------- */
+			string_type tag() const {
+				string_type dest;
+				size_type n = file_;
+				for (size_type i = 0; i < 6; ++i) {
+					dest += static_cast<char_type>('A' + n % 26);
+					n /= 26;
+				}
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  Access methods (get).
+			/* ------------------------------------------------------------- */
+			const std::string& path() const { return path_; }
+			const code_set& codes() const { return codes_; }
+			bool embedded() const { return embedded_; }
+			bool done() const { return done_; }
+			size_type font() const { return font_; }
+			size_type file() const { return file_; }
+			size_type cidmap() const { return cidmap_; }
+			size_type widths() const { return widths_; }
+			size_type tounicode() const { return tounicode_; }
+			
+		private:
+			typedef clx::basic_format<CharT, Traits> fmt;
+			
+			std::string path_;
+			size_type index_;
+			code_set codes_;
+			size_type font_;
+			size_type file_;
+			size_type cidmap_;
+			size_type widths_;
+			size_type tounicode_;
+			bool embedded_;
+			bool done_;
+			
+			/* ------------------------------------------------------------- */
+			//  xput_tounicode
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager>
+			bool xput_tounicode(OutStream& out, PDFManager& pm) {
+				std::basic_stringstream<CharT, Traits> ss;
+				ss << LITERAL("/CIDInit /ProcSet findresource begin") << std::endl;
+				ss << LITERAL("12 dict begin") << std::endl;
+				ss << LITERAL("begincmap") << std::endl;
+				ss << LITERAL("/CIDSystemInfo << /Registry (Adobe) /Ordering (UCS) /Supplement 0 >> def") << std::endl;
+				ss << LITERAL("/CMapName /Adobe-Identity-UCS def") << std::endl;
+				ss << LITERAL("/CMapType 2 def") << std::endl;
+				ss << LITERAL("1 begincodespacerange") << std::endl;
+				ss << LITERAL("<0000> <FFFF>") << std::endl;
+				ss << LITERAL("endcodespacerange") << std::endl;
+				
+				// at most 100 entries are allowed in a bfchar block.
+				typename code_set::const_iterator pos = codes_.begin();
+				while (pos != codes_.end()) {
+					size_type n = std::min(static_cast<size_type>(std::distance(pos, codes_.end())), static_cast<size_type>(100));
+					ss << n << LITERAL(" beginbfchar") << std::endl;
+					for (size_type i = 0; i < n; ++i, ++pos) {
+						string_type code = xhex(*pos);
+						ss << LITERAL("<") << code << LITERAL("> <") << code << LITERAL(">") << std::endl;
+					}
+					ss << LITERAL("endbfchar") << std::endl;
+				}
+				
+				ss << LITERAL("endcmap") << std::endl;
+				ss << LITERAL("CMapName currentdict /CMap defineresource pop") << std::endl;
+				ss << LITERAL("end") << std::endl;
+				ss << LITERAL("end") << std::endl;
+				
+				return this->xput_stream(out, pm, tounicode_, ss.str(), string_type());
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xput_object
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager>
+			bool xput_object(OutStream& out, PDFManager& pm, size_type index, const string_type& value) {
+				pm.setp(index);
+				out << fmt(LITERAL("%d 0 obj")) % index << std::endl;
+				out << value << std::endl;
+				out << LITERAL("endobj") << std::endl;
+				out << std::endl;
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xput_stream
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager>
+			bool xput_stream(OutStream& out, PDFManager& pm, size_type index,
+				const string_type& s, const string_type& entries) {
+				string_type data = s;
+				string_type filter;
+#ifdef FAML_USE_ZLIB
+				std::basic_stringstream<CharT, Traits> ss;
+				filter = LITERAL("/FlateDecode");
+				{
+					clx::basic_zstream<Z_DEFAULT_COMPRESSION, CharT, Traits> z(ss);
+					z.write(s.c_str(), s.size());
+					z.finish();
+				}
+				data = ss.str();
+#endif
+				
+				pm.setp(index);
+				out << fmt(LITERAL("%d 0 obj")) % index << std::endl;
+				out << LITERAL("<<") << std::endl;
+				if (!entries.empty()) out << entries << std::endl;
+				out << fmt(LITERAL("/Length %d")) % data.size() << std::endl;
+				if (!filter.empty()) out << fmt(LITERAL("/Filter [ %s ]")) % filter << std::endl;
+				out << LITERAL(">>") << std::endl;
+				out << LITERAL("stream") << std::endl;
+				out << data;
+				out << std::endl;
+				out << LITERAL("endstream") << std::endl;
+				out << LITERAL("endobj") << std::endl;
+				out << std::endl;
+				
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xhex
+			/* ------------------------------------------------------------- */
+			static string_type xhex(unsigned long code) {
+				static const char hex[] = "0123456789ABCDEF";
+				string_type dest;
+				for (int shift = 12; shift >= 0; shift -= 4) dest += static_cast<char_type>(hex[(code >> shift) & 0x0f]);
+				return dest;
+			}
+		};
+	}
+}
+
+#endif // FAML_PDF_FONT_SUBSET_H
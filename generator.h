@@ -45,6 +45,7 @@
 #include "catalog.h"
 #include "pagelist.h"
 #include "font_factory.h"
+#include "profile.h"
 
 namespace faml {
 	namespace pdf {
@@ -64,11 +65,12 @@ namespace faml {
 			
 			typedef basic_catalog<CharT, Traits> catalog_type;
 			typedef basic_pagelist<CharT, Traits> pagelist_type;
+			typedef faml::pdf::profile profile_type;
 			
 			basic_generator(ostream_type& out = std::cout, double ver = 1.7) :
 				out_(out), index_(2),
 				version_(ver), catalog_(1), pages_(2),
-				pos_(3, 0), finish_(false) {
+				pos_(3, 0), finish_(false), fonts_(), profile_() {
 				out_ << fmt(LITERAL("%%PDF-%3.1f")) % version_ << std::endl;
 			}
 			
@@ -115,10 +117,15 @@ namespace faml {
 			
 			void finish() {
 				if (!finish_) {
+					scoped_phase<basic_generator> phase(*this, "trailer");
 					catalog_(out_, *this);
 					pages_(out_, *this);
 					this->xref();
 					out_ << LITERAL("%%EOF") << std::endl;
+					
+					// phases timed without the PDF manager (unzip, xml, ...).
+					profile_.merge(profile_type::shared());
+					profile_type::shared().clear();
 				}
 				
 				finish_ = true;
@@ -134,6 +141,20 @@ namespace faml {
 			pagelist_type& pages() { return pages_; }
 			font_factory& font() { return fonts_; }
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  profile
+			 *
+			 *  Returns the timings and counters collected while the PDF
+			 *  file is generated (see profile.h). They are collected only
+			 *  when FAML_USE_PROFILE is defined.
+			 */
+			/* ------------------------------------------------------------- */
+			profile_type& profile() { return profile_; }
+			const profile_type& profile() const { return profile_; }
+			
+			size_type tellp() { return static_cast<size_type>(out_.tellp()); }
+			
 		private:
 			typedef clx::basic_format<CharT, Traits> fmt;
 			
@@ -145,6 +166,7 @@ namespace faml {
 			std::vector<size_type> pos_;
 			bool finish_;			// Is finish() already called ?
 			font_factory fonts_;
+			profile_type profile_;	// Timings and counters
 			
 			/* ------------------------------------------------------------- */
 			/*
@@ -35,8 +35,9 @@
 #ifndef FAML_PDF_GIF_H
 #define FAML_PDF_GIF_H
 
+#include <algorithm>
+#include <cstring>
 #include <string>
-#include <deque>
 #include <vector>
 #include <iterator>
 #include <istream>
@@ -52,7 +53,16 @@
 namespace faml {
 	namespace pdf {
 		/* ----------------------------------------------------------------- */
-		//  gif_decoder
+		/*
+		 *  gif_decoder
+		 *
+		 *  The gif_decoder class decodes the LZW compressed image data.
+		 *  Each code in the string table keeps its prefix code, its last
+		 *  and first byte, and its length, so that the string of a code
+		 *  can be written backward directly into the destination buffer
+		 *  without walking the prefix chain twice. The bytes that do not
+		 *  fit in the requested row are kept and written in the next call.
+		 */
 		/* ----------------------------------------------------------------- */
 		template <
 			class CharT,
@@ -65,86 +75,93 @@ namespace faml {
 			typedef CharT char_type;
 			typedef std::basic_istream<CharT, Traits> istream_type;
 			
-			enum { nbits = 12, nmax = 4095, nempty = 4098 };
+			enum { nbits = 12, ncodes = 4096, nempty = 4098 };
 			
 			gif_decoder(istream_type& in) :
-				in_(in), depth_(0), shift_state_(0), shift_data_(0),
-				buffer_(), stack_(),
-				suffix_(static_cast<size_type>(nmax + 1), static_cast<size_type>(nempty)),
-				prefix_(static_cast<size_type>(nmax + 1), static_cast<size_type>(nempty)) {
+				in_(in), depth_(0), clear_code_(0), eof_code_(0), run_code_(0), prev_code_(nempty),
+				run_bits_(0), limit_code_(0), shift_state_(0), shift_data_(0),
+				block_size_(0), block_pos_(0), pending_(0), finished_(false) {
 				int n = 1 / sizeof(char_type);
 				in_.read(reinterpret_cast<char_type*>(&depth_), n);
-				if (in_.gcount() < n) throw std::runtime_error("wrong format");
+				if (in_.gcount() < n || depth_ < 1 || depth_ > 8) throw std::runtime_error("wrong format");
 				clear_code_ = 1 << depth_;
 				eof_code_ = clear_code_ + 1;
+				
+				for (size_type i = 0; i < clear_code_; ++i) {
+					prefix_[i] = static_cast<unsigned short>(nempty);
+					suffix_[i] = static_cast<byte_type>(i);
+					first_[i] = static_cast<byte_type>(i);
+					length_[i] = 1;
+				}
 				this->xclear();
 			}
 			
-			template <class OutIterator>
-			OutIterator operator()(OutIterator dest, size_type n) {
+			/* ------------------------------------------------------------- */
+			/*
+			 *  operator()
+			 *
+			 *  Decodes n pixels (normally, one row) to dest. When the image
+			 *  data ends before n pixels are decoded, the rest is filled
+			 *  with the first color.
+			 */
+			/* ------------------------------------------------------------- */
+			void operator()(byte_type* dest, size_type n) {
 				size_type i = 0;
-				while (!stack_.empty()) {
-					*dest = stack_.back();
-					stack_.pop_back();
-					++dest;
-					++i;
+				
+				if (pending_ > 0) {
+					size_type k = std::min(n, pending_);
+					std::memcpy(dest, stack_ + (sizeof(stack_) - pending_), k);
+					pending_ -= k;
+					i += k;
 				}
 				
 				while (i < n) {
-					size_type cur = xnext();
+					size_type cur = this->xnext();
 					if (cur == eof_code_) {
-						if (i != n - 1) throw std::runtime_error("wrong format");
-						++i;
+						std::memset(dest + i, 0, n - i);
+						finished_ = true;
+						break;
 					}
-					else if (cur == clear_code_) this->xclear();
-					else {
-						if (cur < clear_code_) {
-							*dest = cur;
-							++dest;
-							++i;
-						}
-						else {
-							size_type cur_prefix = 0;
-							
-							if (prefix_.at(cur) == nempty) {
-								if (cur == run_code_ - 2) {
-									cur_prefix = prev_code_;
-									stack_.push_back(this->xprefix(prev_code_));
-									suffix_.at(run_code_ - 2) = stack_.back();
-								}
-								else throw std::runtime_error("wrong format");
-							}
-							else cur_prefix = cur;
-							
-							size_type j = 0;
-							while (cur_prefix > clear_code_) {
-								if (j >= nempty || cur_prefix > nempty) {
-									throw std::runtime_error("wrong format");
-								}
-								stack_.push_back(suffix_.at(cur_prefix));
-								cur_prefix = prefix_.at(cur_prefix);
-								++j;
-							}
-							stack_.push_back(cur_prefix);
-							
-							while (!stack_.empty() && i < n) {
-								*dest = stack_.back();
-								stack_.pop_back();
-								++dest;
-								++i;
-							}
-						}
+					else if (cur == clear_code_) {
+						this->xclear();
+						continue;
+					}
+					
+					if (prev_code_ == nempty) {
+						if (cur >= clear_code_) throw std::runtime_error("wrong format");
+					}
+					else if (run_code_ < ncodes) {
+						if (cur > run_code_) throw std::runtime_error("wrong format");
 						
-						if (prev_code_ != nempty) {
-							prefix_.at(run_code_ - 2) = prev_code_;
-							if (cur == run_code_ - 2) suffix_.at(run_code_ - 2) = this->xprefix(prev_code_);
-							else suffix_.at(run_code_ - 2) = this->xprefix(cur);
+						// cur == run_code_ is the KwKwK case (i.e., the code is
+						// defined by this step).
+						byte_type c = (cur < run_code_) ? first_[cur] : first_[prev_code_];
+						prefix_[run_code_] = static_cast<unsigned short>(prev_code_);
+						suffix_[run_code_] = c;
+						first_[run_code_] = first_[prev_code_];
+						length_[run_code_] = length_[prev_code_] + 1;
+						++run_code_;
+						if (run_code_ >= limit_code_ && run_bits_ < nbits) {
+							limit_code_ <<= 1;
+							++run_bits_;
 						}
-						prev_code_ = cur;
+					}
+					else if (cur >= ncodes) throw std::runtime_error("wrong format");
+					prev_code_ = cur;
+					
+					size_type len = length_[cur];
+					if (len <= n - i) {
+						this->xstring(cur, dest + i + len);
+						i += len;
+					}
+					else {
+						// the string is overflowed from the current row.
+						this->xstring(cur, stack_ + sizeof(stack_));
+						std::memcpy(dest + i, stack_ + (sizeof(stack_) - len), n - i);
+						pending_ = len - (n - i);
+						i = n;
 					}
 				}
-				
-				return dest;
 			}
 			
 		private:
@@ -161,74 +178,93 @@ namespace faml {
 			size_type limit_code_;
 			
 			size_type shift_state_;
-			size_type shift_data_;
+			unsigned long shift_data_;
 			
-			std::deque<byte_type> buffer_;
-			std::deque<size_type> stack_;
-			std::deque<size_type> suffix_;
-			std::deque<size_type> prefix_;
+			byte_type block_[256];
+			size_type block_size_;
+			size_type block_pos_;
 			
+			unsigned short prefix_[ncodes];
+			byte_type suffix_[ncodes];
+			byte_type first_[ncodes];
+			unsigned short length_[ncodes];
+			byte_type stack_[ncodes];
+			size_type pending_;
+			bool finished_;
+			
+			/* ------------------------------------------------------------- */
+			//  xclear
+			/* ------------------------------------------------------------- */
 			void xclear() {
 				run_code_ = eof_code_ + 1;
 				run_bits_ = depth_ + 1;
 				limit_code_ = 1 << run_bits_;
 				prev_code_ = nempty;
-				for (size_type i = 0; i < prefix_.size(); ++i) prefix_.at(i) = nempty;
 			}
 			
-			size_type xprefix(size_type code) {
-				for (size_type i = 0; i < prefix_.size(); ++i) {
-					if (code <= clear_code_) break;
-					code = prefix_.at(code);
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xstring
+			 *
+			 *  Writes the string of the code backward, i.e., last points
+			 *  to the end of the destination range.
+			 */
+			/* ------------------------------------------------------------- */
+			void xstring(size_type code, byte_type* last) {
+				while (code >= clear_code_) {
+					*--last = suffix_[code];
+					code = prefix_[code];
 				}
-				return code;
+				*--last = static_cast<byte_type>(code);
 			}
 			
-			byte_type xnext_byte() {
-				if (buffer_.empty()) {
-					size_type size = 0;
+			/* ------------------------------------------------------------- */
+			//  xnext_byte
+			/* ------------------------------------------------------------- */
+			bool xnext_byte(byte_type& dest) {
+				if (block_pos_ == block_size_) {
+					byte_type size = 0;
 					int n = 1 / sizeof(char_type);
 					in_.read(reinterpret_cast<char_type*>(&size), n);
-					if (in_.gcount() < n || size == 0) return 0;
+					if (in_.gcount() < n || size == 0) {
+						finished_ = true;
+						return false;
+					}
 					
-					byte_type tmp[256];
 					n = static_cast<int>(size) / sizeof(char_type);
-					in_.read(reinterpret_cast<char_type*>(tmp), n);
-					if (in_.gcount() < n) return 0;
-					std::back_insert_iterator<std::deque<byte_type> > it(buffer_);
-					std::copy(tmp, tmp + size, it);
+					in_.read(reinterpret_cast<char_type*>(block_), n);
+					if (in_.gcount() < n) {
+						finished_ = true;
+						return false;
+					}
+					block_size_ = size;
+					block_pos_ = 0;
 				}
 				
-				byte_type dest = buffer_.front();
-				buffer_.pop_front();
-				return dest;
+				dest = block_[block_pos_++];
+				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xnext
+			 *
+			 *  Returns the next code. When the image data is exhausted,
+			 *  the end of information code is returned.
+			 */
+			/* ------------------------------------------------------------- */
 			size_type xnext() {
-				static const int mask[] = {
-					0x0000, 0x0001, 0x0003, 0x0007,
-					0x000f, 0x001f, 0x003f, 0x007f,
-					0x00ff, 0x01ff, 0x03ff, 0x07ff,
-					0x0fff
-				};
-				
-				size_type code = nempty;
-				
+				if (finished_) return eof_code_;
 				while (shift_state_ < run_bits_) {
-					byte_type c = xnext_byte();
+					byte_type c = 0;
+					if (!this->xnext_byte(c)) return eof_code_;
 					shift_data_ |= static_cast<unsigned long>(c) << shift_state_;
 					shift_state_ += 8;
 				}
 				
-				code = shift_data_ & mask[run_bits_];
+				size_type code = shift_data_ & ((1UL << run_bits_) - 1);
 				shift_data_ >>= run_bits_;
 				shift_state_ -= run_bits_;
-				
-				if (++run_code_ > limit_code_ && run_bits_ < nbits) {
-					limit_code_ <<= 1;
-					++run_bits_;
-				}
-				
 				return code;
 			}
 		};
@@ -430,29 +466,26 @@ namespace faml {
 				static const int start[] = {0, 4, 2, 1};
 				static const int step[] = {8, 8, 4, 2};
 				
+				if (width_ == 0 || height_ == 0) return false;
+				
 				try {
 					clx::zstream z(out);
 					decoder dec(in_);
 					if (interlace_) {
-						std::vector<string_type> buf(height_, string_type());
+						std::vector<byte_type> buf(width_ * height_);
 						for (size_type i = 0; i < 4; ++i) {
-							size_type row = start[i];
-							while (row < height_) {
-								string_type tmp;
-								std::insert_iterator<string_type> pos(tmp, tmp.end());
-								dec(pos, width_);
-								buf.at(row) = tmp;
-								row += step[i];
+							for (size_type row = start[i]; row < height_; row += step[i]) {
+								dec(&buf[row * width_], width_);
 							}
 						}
-						
-						for (size_type i = 0; i < buf.size(); ++i) {
-							z.write(buf.at(i).c_str(), buf.at(i).size());
-						}
+						z.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
 					}
 					else {
-						std::ostream_iterator<char_type> pos(z);
-						for (size_type row = 0; row < height_; ++row) pos = dec(pos, width_);
+						std::vector<byte_type> buf(width_);
+						for (size_type row = 0; row < height_; ++row) {
+							dec(&buf[0], width_);
+							z.write(reinterpret_cast<const char*>(&buf[0]), buf.size());
+						}
 					}
 				}
 				catch (std::runtime_error&) {
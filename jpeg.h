@@ -39,11 +39,22 @@
 #include <iterator>
 #include <istream>
 #include <sstream>
+#include <vector>
 #include "image.h"
 #include "utility.h"
+#include "resample.h"
 #include "clx/literal.h"
 #include "clx/format.h"
 #include "clx/lexical_cast.h"
+#ifdef FAML_USE_LIBJPEG
+#include <cstdio>
+#include <cstdlib>
+#include <csetjmp>
+#include <jpeglib.h>
+#ifndef FAML_JPEG_QUALITY
+#define FAML_JPEG_QUALITY 85
+#endif
+#endif
 
 namespace faml {
 	namespace pdf {
@@ -64,20 +75,53 @@ namespace faml {
 			
 			jpeg_resource(const jpeg_resource& cp) :
 				in_(cp.in_), index_(cp.index_), label_(cp.label()),
-				size_(cp.size_), width_(cp.width_), height_(cp.height_), rgb_(cp.rgb_) {}
+				size_(cp.size_), width_(cp.width_), height_(cp.height_), rgb_(cp.rgb_),
+				dpi_(cp.dpi_), pw_(cp.pw_), ph_(cp.ph_),
+				ow_(cp.ow_), oh_(cp.oh_), data_(cp.data_) {}
 			
 			jpeg_resource(istream_type& in) :
 				in_(in), index_(0), label_(string_type()),
-				size_(0), width_(0), height_(0), rgb_(true) {
+				size_(0), width_(0), height_(0), rgb_(true),
+				dpi_(0.0), pw_(0.0), ph_(0.0), ow_(0), oh_(0), data_() {
 				label_ = makelabel(LITERAL("Im"));
 			}
 			
 			template <class OutStream, class PDFManager>
 			bool operator()(OutStream& out, PDFManager& pm) {
 				if (in_.bad() || !this->xproperty(in_)) return false;
+				
+				ow_ = width_;
+				oh_ = height_;
+				data_.clear();
+#ifdef FAML_USE_LIBJPEG
+				std::pair<size_type, size_type> sz = resample_size(width_, height_, pw_, ph_, dpi_);
+				if (rgb_ && (sz.first != width_ || sz.second != height_)) {
+					if (!this->xrecompress(sz.first, sz.second) || data_.size() >= size_) {
+						ow_ = width_;
+						oh_ = height_;
+						data_.clear();
+					}
+				}
+#endif
 				return this->xobject(out, pm);
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  downsample
+			 *
+			 *  Sets the size (in points) at which the image is placed.
+			 *  The DCT data is passed through as is unless the library is
+			 *  compiled with FAML_USE_LIBJPEG, in which case the image whose
+			 *  resolution exceeds dpi is decoded, shrunk and re-encoded.
+			 */
+			/* ------------------------------------------------------------- */
+			void downsample(double dpi, double width, double height) {
+				dpi_ = dpi;
+				pw_ = width;
+				ph_ = height;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  Access methods (get).
 			/* ------------------------------------------------------------- */
@@ -87,6 +131,11 @@ namespace faml {
 			size_type width() const { return width_; }
 			size_type height() const { return height_; }
 			
+			/* ------------------------------------------------------------- */
+			//  Access methods (set).
+			/* ------------------------------------------------------------- */
+			void label(const string_type& cp) { label_ = cp; }
+			
 		private:
 			typedef clx::basic_format<CharT, Traits> fmt;
 			
@@ -97,6 +146,12 @@ namespace faml {
 			size_type width_;
 			size_type height_;
 			bool rgb_;
+			double dpi_;
+			double pw_;
+			double ph_;
+			size_type ow_; // width of the written image
+			size_type oh_; // height of the written image
+			std::vector<byte_type> data_; // re-encoded DCT data (if any)
 			
 			/* ------------------------------------------------------------- */
 			//  xobject
@@ -110,8 +165,8 @@ namespace faml {
 				out << LITERAL("/Type /XObject") << std::endl;
 				out << LITERAL("/Subtype /Image") << std::endl;
 				out << LITERAL("/Name /") << label_ << std::endl;
-				out << LITERAL("/Width ") << width_ << std::endl;
-				out << LITERAL("/Height ") << height_ << std::endl;
+				out << LITERAL("/Width ") << ow_ << std::endl;
+				out << LITERAL("/Height ") << oh_ << std::endl;
 				out << LITERAL("/BitsPerComponent 8") << std::endl;
 				out << LITERAL("/Filter [ /DCTDecode ]") << std::endl;
 				if (rgb_) out << LITERAL("/ColorSpace /DeviceRGB") << std::endl;
@@ -119,11 +174,19 @@ namespace faml {
 					out << LITERAL("/ColorSpace /DeviceCMYK") << std::endl;
 					out << LITERAL("/Decode[1 0 1 0 1 0 1 0]") << std::endl;
 				}
-				out << LITERAL("/Length ") << size_ << std::endl;
-				out << LITERAL(">>") << std::endl;
-				out << LITERAL("stream") << std::endl;
-				in_.seekg(0);
-				out << in_.rdbuf();
+				if (!data_.empty()) {
+					out << LITERAL("/Length ") << data_.size() << std::endl;
+					out << LITERAL(">>") << std::endl;
+					out << LITERAL("stream") << std::endl;
+					out.write(reinterpret_cast<const char_type*>(&data_[0]), data_.size());
+				}
+				else {
+					out << LITERAL("/Length ") << size_ << std::endl;
+					out << LITERAL(">>") << std::endl;
+					out << LITERAL("stream") << std::endl;
+					in_.seekg(0);
+					out << in_.rdbuf();
+				}
 				out << std::endl;
 				out << LITERAL("endstream") << std::endl;
 				out << LITERAL("endobj") << std::endl;
@@ -132,6 +195,165 @@ namespace faml {
 				return true;
 			}
 			
+#ifdef FAML_USE_LIBJPEG
+			/* ------------------------------------------------------------- */
+			//  xerror
+			/* ------------------------------------------------------------- */
+			struct xerror {
+				struct jpeg_error_mgr pub;
+				std::jmp_buf jump;
+				unsigned char* buffer;	// destination of the encoder, see xencode()
+				unsigned long size;
+				
+				xerror() : buffer(NULL), size(0) {}
+				
+				static void exit(j_common_ptr cinfo) {
+					xerror* err = reinterpret_cast<xerror*>(cinfo->err);
+					std::longjmp(err->jump, 1);
+				}
+				
+				static void message(j_common_ptr) {}
+			};
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xrecompress
+			 *
+			 *  Decodes the source image with the smallest DCT scaling that
+			 *  keeps it larger than (w x h), shrinks it to (w x h) with the
+			 *  box filter and re-encodes it to data_.
+			 */
+			/* ------------------------------------------------------------- */
+			bool xrecompress(size_type w, size_type h) {
+				std::vector<byte_type> src(size_);
+				in_.seekg(0);
+				in_.read(reinterpret_cast<char_type*>(&src[0]), size_);
+				if (in_.gcount() != static_cast<std::streamsize>(size_)) {
+					in_.clear();
+					return false;
+				}
+				
+				std::vector<byte_type> raster;
+				size_type sw = 0, sh = 0;
+				if (!this->xdecode(src, w, h, raster, sw, sh)) return false;
+				
+				std::vector<byte_type> dest;
+				dest.reserve(w * h * 3);
+				basic_pixels pixels(dest);
+				basic_resampler<basic_pixels> rs(pixels, sw, sh, w, h, 3);
+				rs.write(reinterpret_cast<const char*>(&raster[0]), raster.size());
+				rs.finish();
+				std::vector<byte_type>().swap(raster);
+				
+				if (!this->xencode(dest, w, h)) return false;
+				ow_ = w;
+				oh_ = h;
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  basic_pixels
+			/* ------------------------------------------------------------- */
+			class basic_pixels {
+			public:
+				typedef char char_type;
+				
+				explicit basic_pixels(std::vector<byte_type>& v) : v_(v) {}
+				
+				basic_pixels& write(const char_type* s, std::streamsize n) {
+					const byte_type* p = reinterpret_cast<const byte_type*>(s);
+					v_.insert(v_.end(), p, p + n);
+					return *this;
+				}
+				
+			private:
+				std::vector<byte_type>& v_;
+			};
+			
+			/* ------------------------------------------------------------- */
+			//  xdecode
+			/* ------------------------------------------------------------- */
+			bool xdecode(std::vector<byte_type>& src, size_type w, size_type h,
+				std::vector<byte_type>& dest, size_type& sw, size_type& sh) {
+				struct jpeg_decompress_struct cinfo;
+				xerror err;
+				cinfo.err = jpeg_std_error(&err.pub);
+				err.pub.error_exit = xerror::exit;
+				err.pub.output_message = xerror::message;
+				if (setjmp(err.jump)) {
+					jpeg_destroy_decompress(&cinfo);
+					return false;
+				}
+				
+				jpeg_create_decompress(&cinfo);
+				jpeg_mem_src(&cinfo, &src[0], static_cast<unsigned long>(src.size()));
+				if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+					jpeg_destroy_decompress(&cinfo);
+					return false;
+				}
+				
+				cinfo.out_color_space = JCS_RGB;
+				cinfo.scale_num = 1;
+				cinfo.scale_denom = 1;
+				while (cinfo.scale_denom < 8 &&
+					width_ / (cinfo.scale_denom * 2) >= w &&
+					height_ / (cinfo.scale_denom * 2) >= h) {
+					cinfo.scale_denom *= 2;
+				}
+				
+				jpeg_start_decompress(&cinfo);
+				sw = cinfo.output_width;
+				sh = cinfo.output_height;
+				dest.resize(sw * sh * 3);
+				while (cinfo.output_scanline < cinfo.output_height) {
+					JSAMPROW row = &dest[cinfo.output_scanline * sw * 3];
+					jpeg_read_scanlines(&cinfo, &row, 1);
+				}
+				jpeg_finish_decompress(&cinfo);
+				jpeg_destroy_decompress(&cinfo);
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xencode
+			/* ------------------------------------------------------------- */
+			bool xencode(std::vector<byte_type>& src, size_type w, size_type h) {
+				// The buffer is kept in the error manager instead of a local
+				// variable, since it is changed after setjmp() and read in the
+				// longjmp() branch.
+				struct jpeg_compress_struct cinfo;
+				xerror err;
+				cinfo.err = jpeg_std_error(&err.pub);
+				err.pub.error_exit = xerror::exit;
+				err.pub.output_message = xerror::message;
+				if (setjmp(err.jump)) {
+					jpeg_destroy_compress(&cinfo);
+					if (err.buffer) std::free(err.buffer);
+					return false;
+				}
+				
+				jpeg_create_compress(&cinfo);
+				jpeg_mem_dest(&cinfo, &err.buffer, &err.size);
+				cinfo.image_width = static_cast<JDIMENSION>(w);
+				cinfo.image_height = static_cast<JDIMENSION>(h);
+				cinfo.input_components = 3;
+				cinfo.in_color_space = JCS_RGB;
+				jpeg_set_defaults(&cinfo);
+				jpeg_set_quality(&cinfo, FAML_JPEG_QUALITY, TRUE);
+				jpeg_start_compress(&cinfo, TRUE);
+				while (cinfo.next_scanline < cinfo.image_height) {
+					JSAMPROW row = &src[cinfo.next_scanline * w * 3];
+					jpeg_write_scanlines(&cinfo, &row, 1);
+				}
+				jpeg_finish_compress(&cinfo);
+				jpeg_destroy_compress(&cinfo);
+				
+				data_.assign(err.buffer, err.buffer + err.size);
+				std::free(err.buffer);
+				return true;
+			}
+#endif // FAML_USE_LIBJPEG
+			
 			/* ------------------------------------------------------------- */
 			//  xproperty
 			/* ------------------------------------------------------------- */
@@ -0,0 +1,664 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  officex/archive.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_OFFICEX_ARCHIVE_H
+#define FAML_OFFICEX_ARCHIVE_H
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "clx/shared_ptr.h"
+#include "../profile.h"
+
+namespace faml {
+	namespace officex {
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_archive_buffer
+		 *
+		 *  The stream buffer holds the inflated data of an archive member.
+		 *  Only the input (and seek) operations are supported.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_archive_buffer : public std::basic_streambuf<CharT, Traits> {
+		public:
+			typedef CharT char_type;
+			typedef typename Traits::pos_type pos_type;
+			typedef typename Traits::off_type off_type;
+			typedef std::vector<CharT> container;
+			
+			basic_archive_buffer() : std::basic_streambuf<CharT, Traits>(), v_() {}
+			
+			virtual ~basic_archive_buffer() {}
+			
+			container& data() { return v_; }
+			
+			void reset() {
+				char_type* p = v_.empty() ? NULL : &v_.at(0);
+				this->setg(p, p, p + v_.size());
+			}
+			
+		protected:
+			virtual pos_type seekoff(off_type off, std::ios_base::seekdir way,
+				std::ios_base::openmode which = std::ios_base::in) {
+				if ((which & std::ios_base::in) == 0) return pos_type(off_type(-1));
+				
+				off_type pos = 0;
+				if (way == std::ios_base::beg) pos = off;
+				else if (way == std::ios_base::cur) pos = (this->gptr() - this->eback()) + off;
+				else pos = (this->egptr() - this->eback()) + off;
+				return this->seekpos(pos_type(pos), which);
+			}
+			
+			virtual pos_type seekpos(pos_type sp,
+				std::ios_base::openmode which = std::ios_base::in) {
+				off_type pos = off_type(sp);
+				if ((which & std::ios_base::in) == 0 || pos < 0 ||
+					pos > this->egptr() - this->eback()) {
+					return pos_type(off_type(-1));
+				}
+				this->setg(this->eback(), this->eback() + pos, this->egptr());
+				return sp;
+			}
+			
+		private:
+			container v_;
+		};
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_archive_stream
+		 *
+		 *  The input stream of an archive member. The class provides the
+		 *  same interface as clx::basic_unzip_stream (i.e., the stream
+		 *  itself and the path() method).
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_archive_stream : public std::basic_istream<CharT, Traits> {
+		public:
+			typedef CharT char_type;
+			typedef std::basic_string<CharT, Traits> string_type;
+			typedef basic_archive_buffer<CharT, Traits> streambuf_type;
+			
+			explicit basic_archive_stream(const string_type& path) :
+				std::basic_istream<CharT, Traits>(NULL), sbuf_(), path_(path) {
+				this->init(&sbuf_);
+			}
+			
+			virtual ~basic_archive_stream() {}
+			
+			const string_type& path() const { return path_; }
+			streambuf_type* rdbuf() { return &sbuf_; }
+			
+		private:
+			streambuf_type sbuf_;
+			string_type path_;
+		};
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_archive
+		 *
+		 *  The basic_archive class is a read-only ZIP reader which works
+		 *  on a contiguous byte sequence. The byte sequence can be given
+		 *  as a file path, an input stream, a file descriptor, or a memory
+		 *  buffer. When the memory buffer is given, the class does not
+		 *  copy it, so the buffer must be alive while the archive (and
+		 *  copies of it) is used.
+		 *
+		 *  Copying the archive is cheap: copies share the same byte
+		 *  sequence and the central directory.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_archive {
+		public:
+			typedef size_t size_type;
+			typedef CharT char_type;
+			typedef std::basic_string<CharT, Traits> string_type;
+			typedef std::basic_istream<CharT, Traits> istream_type;
+			typedef basic_archive_stream<CharT, Traits> value_type;
+			
+		private:
+			struct entry_type {
+				string_type path;
+				size_type offset;	// offset of the local file header
+				size_type csize;	// compressed size
+				size_type usize;	// uncompressed size
+				unsigned int method;
+				
+				entry_type() : path(), offset(0), csize(0), usize(0), method(0) {}
+			};
+			
+			struct data_type {
+				std::vector<char_type> buffer;	// owned bytes (if any)
+				const unsigned char* p;
+				size_type n;
+				std::vector<entry_type> entries;
+				std::map<string_type, size_type> index;
+				
+				data_type() : buffer(), p(NULL), n(0), entries(), index() {}
+			};
+			typedef clx::shared_ptr<data_type> data_ptr;
+			
+		public:
+			/* ------------------------------------------------------------- */
+			//  iterator
+			/* ------------------------------------------------------------- */
+			class iterator {
+			public:
+				typedef std::forward_iterator_tag iterator_category;
+				typedef basic_archive_stream<CharT, Traits> value_type;
+				typedef std::ptrdiff_t difference_type;
+				typedef value_type* pointer;
+				typedef value_type& reference;
+				
+				iterator() : data_(), pos_(0), cur_() {}
+				
+				iterator(const data_ptr& data, size_type pos) :
+					data_(data), pos_(pos), cur_() {}
+					
+				reference operator*() const { return *this->xget(); }
+				pointer operator->() const { return this->xget(); }
+				
+				iterator& operator++() {
+					++pos_;
+					cur_.reset();
+					return *this;
+				}
+				
+				iterator operator++(int) {
+					iterator tmp = *this;
+					++(*this);
+					return tmp;
+				}
+				
+				bool operator==(const iterator& x) const {
+					return data_ == x.data_ && pos_ == x.pos_;
+				}
+				
+				bool operator!=(const iterator& x) const {
+					return !(*this == x);
+				}
+				
+			private:
+				typedef clx::shared_ptr<value_type> stream_ptr;
+				
+				data_ptr data_;
+				size_type pos_;
+				mutable stream_ptr cur_;
+				
+				/* --------------------------------------------------------- */
+				/*
+				 *  xget
+				 *
+				 *  Inflates the member when it is first dereferenced.
+				 */
+				/* --------------------------------------------------------- */
+				value_type* xget() const {
+					if (!cur_) {
+						const entry_type& e = data_->entries.at(pos_);
+						cur_ = stream_ptr(new value_type(e.path));
+						basic_archive::xinflate(*data_, e, cur_->rdbuf()->data());
+						cur_->rdbuf()->reset();
+					}
+					return cur_.get();
+				}
+			};
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  reader
+			 *
+			 *  The input stream which inflates an archive member while it
+			 *  is read, so that only a window (64KB) of the member is kept
+			 *  in memory. Seeking forward inflates (and discards) the data
+			 *  up to the position, and seeking backward restarts inflating
+			 *  from the beginning of the member. Stored members are read
+			 *  from the archive directly.
+			 */
+			/* ------------------------------------------------------------- */
+			class reader : public std::basic_istream<CharT, Traits> {
+			public:
+				reader() : std::basic_istream<CharT, Traits>(NULL), sbuf_(), path_() {
+					this->init(&sbuf_);
+				}
+				
+				virtual ~reader() {}
+				
+				bool open(const basic_archive& ar, const string_type& path) {
+					this->clear();
+					if (!ar.data_) return false;
+					typename std::map<string_type, size_type>::const_iterator pos = ar.data_->index.find(path);
+					if (pos == ar.data_->index.end()) return false;
+					sbuf_.open(ar.data_, ar.data_->entries.at(pos->second));
+					path_ = path;
+					return true;
+				}
+				
+				bool is_open() const { return sbuf_.is_open(); }
+				const string_type& path() const { return path_; }
+				
+			private:
+				/* --------------------------------------------------------- */
+				//  buffer
+				/* --------------------------------------------------------- */
+				class buffer : public std::basic_streambuf<CharT, Traits> {
+				public:
+					typedef typename Traits::int_type int_type;
+					typedef typename Traits::pos_type pos_type;
+					typedef typename Traits::off_type off_type;
+					
+					buffer() :
+						std::basic_streambuf<CharT, Traits>(),
+						data_(), src_(NULL), csize_(0), usize_(0), method_(0),
+						z_(), init_(false), window_(65536), first_(0) {}
+					
+					virtual ~buffer() { this->xend(); }
+					
+					void open(const data_ptr& data, const entry_type& e) {
+						this->xend();
+						src_ = data->p + basic_archive::xmember(*data, e);
+						data_ = data;
+						csize_ = e.csize;
+						usize_ = e.usize;
+						method_ = e.method;
+						if (method_ == 0 && csize_ != usize_) throw std::runtime_error("broken archive member");
+						else if (method_ != 0 && method_ != Z_DEFLATED) {
+							throw std::runtime_error("unsupported compression method");
+						}
+						this->xrewind(0);
+					}
+					
+					bool is_open() const { return static_cast<bool>(data_); }
+					
+				protected:
+					virtual int_type underflow() {
+						if (this->gptr() < this->egptr()) return Traits::to_int_type(*this->gptr());
+						first_ += this->egptr() - this->eback();
+						if (this->xfill() == 0) return Traits::eof();
+						return Traits::to_int_type(*this->gptr());
+					}
+					
+					virtual pos_type seekoff(off_type off, std::ios_base::seekdir way,
+						std::ios_base::openmode which = std::ios_base::in) {
+						off_type pos = off;
+						if (way == std::ios_base::cur) pos += first_ + (this->gptr() - this->eback());
+						else if (way == std::ios_base::end) pos += usize_;
+						return this->seekpos(pos_type(pos), which);
+					}
+					
+					virtual pos_type seekpos(pos_type sp,
+						std::ios_base::openmode which = std::ios_base::in) {
+						off_type pos = off_type(sp);
+						if ((which & std::ios_base::in) == 0 || !data_ ||
+							pos < 0 || static_cast<size_type>(pos) > usize_) {
+							return pos_type(off_type(-1));
+						}
+						
+						size_type n = static_cast<size_type>(pos);
+						size_type last = first_ + (this->egptr() - this->eback());
+						if (n < first_ || (method_ == 0 && n > last)) this->xrewind(n);
+						while (n > first_ + (this->egptr() - this->eback()) ||
+							(n == first_ + (this->egptr() - this->eback()) && n < usize_)) {
+							first_ += this->egptr() - this->eback();
+							if (this->xfill() == 0) return pos_type(off_type(-1));
+						}
+						this->setg(this->eback(), this->eback() + (n - first_), this->egptr());
+						return sp;
+					}
+					
+				private:
+					data_ptr data_;
+					const unsigned char* src_;
+					size_type csize_;
+					size_type usize_;
+					unsigned int method_;
+					z_stream z_;
+					bool init_;
+					std::vector<char_type> window_;
+					size_type first_; // position of the window in the member
+					
+					/* ----------------------------------------------------- */
+					/*
+					 *  xrewind
+					 *
+					 *  Moves the (empty) window to pos. The deflated member
+					 *  can only be restarted from the beginning.
+					 */
+					/* ----------------------------------------------------- */
+					void xrewind(size_type pos) {
+						char_type* p = &window_.at(0);
+						this->setg(p, p, p);
+						if (method_ == 0) {
+							first_ = pos;
+							return;
+						}
+						
+						first_ = 0;
+						if (!init_) {
+							std::memset(&z_, 0, sizeof(z_));
+							if (inflateInit2(&z_, -MAX_WBITS) != Z_OK) throw std::runtime_error("inflateInit2 failed");
+							init_ = true;
+						}
+						else inflateReset(&z_);
+						z_.next_in = const_cast<Bytef*>(src_);
+						z_.avail_in = static_cast<uInt>(csize_);
+					}
+					
+					/* ----------------------------------------------------- */
+					/*
+					 *  xfill
+					 *
+					 *  Fills the window with the data following first_ and
+					 *  returns the number of characters.
+					 */
+					/* ----------------------------------------------------- */
+					size_type xfill() {
+						faml::pdf::scoped_timer timer("unzip");
+						char_type* p = &window_.at(0);
+						size_type n = 0;
+						if (method_ == 0) {
+							n = std::min(window_.size(), usize_ - std::min(first_, usize_));
+							if (n > 0) std::memcpy(p, src_ + first_, n);
+						}
+						else {
+							z_.next_out = reinterpret_cast<Bytef*>(p);
+							z_.avail_out = static_cast<uInt>(window_.size());
+							while (z_.avail_out == window_.size()) {
+								int status = inflate(&z_, Z_NO_FLUSH);
+								if (status == Z_STREAM_END) break;
+								if (status != Z_OK) throw std::runtime_error("cannot inflate archive member");
+							}
+							n = window_.size() - z_.avail_out;
+						}
+						this->setg(p, p, p + n);
+						return n;
+					}
+					
+					void xend() {
+						if (init_) inflateEnd(&z_);
+						init_ = false;
+					}
+					
+					// non-copyable
+					buffer(const buffer&);
+					buffer& operator=(const buffer&);
+				};
+				
+				buffer sbuf_;
+				string_type path_;
+			};
+			
+			/* ------------------------------------------------------------- */
+			//  constructor
+			/* ------------------------------------------------------------- */
+			basic_archive() : data_() {}
+			
+			explicit basic_archive(const string_type& path) : data_() {
+				this->open(path);
+			}
+			
+			explicit basic_archive(istream_type& in) : data_() {
+				this->open(in);
+			}
+			
+			basic_archive(const char_type* data, size_type n) : data_() {
+				this->open(data, n);
+			}
+			
+			explicit basic_archive(int fd) : data_() {
+				this->open(fd);
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  open
+			/* ------------------------------------------------------------- */
+			bool open(const string_type& path) {
+				std::basic_ifstream<CharT, Traits> fs(path.c_str(), std::ios_base::in | std::ios_base::binary);
+				if (!fs.is_open()) return false;
+				return this->open(fs);
+			}
+			
+			bool open(istream_type& in) {
+				data_ptr tmp(new data_type());
+				std::vector<char_type>& v = tmp->buffer;
+				char_type buf[65536];
+				while (in.read(buf, sizeof(buf)) || in.gcount() > 0) {
+					v.insert(v.end(), buf, buf + in.gcount());
+				}
+				return this->xassign(tmp);
+			}
+			
+			bool open(const char_type* data, size_type n) {
+				data_ptr tmp(new data_type());
+				tmp->p = reinterpret_cast<const unsigned char*>(data);
+				tmp->n = n;
+				return this->xopen(tmp);
+			}
+			
+			bool open(int fd) {
+				if (fd < 0) return false;
+				
+				data_ptr tmp(new data_type());
+				std::vector<char_type>& v = tmp->buffer;
+				char_type buf[65536];
+				while (1) {
+#ifdef _WIN32
+					int n = ::_read(fd, buf, sizeof(buf));
+#else
+					ssize_t n = ::read(fd, buf, sizeof(buf));
+#endif
+					if (n < 0) return false;
+					if (n == 0) break;
+					v.insert(v.end(), buf, buf + n);
+				}
+				return this->xassign(tmp);
+			}
+			
+			void close() { data_.reset(); }
+			
+			/* ------------------------------------------------------------- */
+			//  Access methods (get).
+			/* ------------------------------------------------------------- */
+			bool is_open() const { return static_cast<bool>(data_); }
+			bool empty() const { return !data_ || data_->entries.empty(); }
+			size_type size() const { return data_ ? data_->entries.size() : 0; }
+			
+			iterator begin() { return iterator(data_, 0); }
+			iterator end() { return iterator(data_, this->size()); }
+			
+			iterator find(const string_type& path) {
+				if (!data_) return this->end();
+				typename std::map<string_type, size_type>::const_iterator pos = data_->index.find(path);
+				if (pos == data_->index.end()) return this->end();
+				return iterator(data_, pos->second);
+			}
+			
+		private:
+			enum {
+				local_header = 0x04034b50,
+				central_header = 0x02014b50,
+				end_of_central = 0x06054b50
+			};
+			
+			data_ptr data_;
+			
+			/* ------------------------------------------------------------- */
+			//  xassign
+			/* ------------------------------------------------------------- */
+			bool xassign(data_ptr& tmp) {
+				if (tmp->buffer.empty()) return false;
+				tmp->p = reinterpret_cast<const unsigned char*>(&tmp->buffer.at(0));
+				tmp->n = tmp->buffer.size();
+				return this->xopen(tmp);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xopen
+			 *
+			 *  Reads the central directory. The end of central directory
+			 *  record is searched backward from the end of the data
+			 *  because it may be followed by an archive comment.
+			 */
+			/* ------------------------------------------------------------- */
+			bool xopen(data_ptr& tmp) {
+				data_.reset();
+				const unsigned char* p = tmp->p;
+				size_type n = tmp->n;
+				if (p == NULL || n < 22) return false;
+				
+				size_type last = (n > 22 + 65535) ? n - 22 - 65535 : 0;
+				size_type eocd = n - 22;
+				while (xget32(p + eocd) != end_of_central) {
+					if (eocd == last) return false;
+					--eocd;
+				}
+				
+				size_type count = xget16(p + eocd + 10);
+				size_type offset = xget32(p + eocd + 16);
+				
+				tmp->entries.reserve(count);
+				for (size_type i = 0; i < count; ++i) {
+					if (offset + 46 > n || xget32(p + offset) != central_header) return false;
+					
+					entry_type elem;
+					elem.method = xget16(p + offset + 10);
+					elem.csize = xget32(p + offset + 20);
+					elem.usize = xget32(p + offset + 24);
+					size_type name = xget16(p + offset + 28);
+					size_type extra = xget16(p + offset + 30);
+					size_type comment = xget16(p + offset + 32);
+					elem.offset = xget32(p + offset + 42);
+					if (offset + 46 + name > n) return false;
+					
+					const char_type* s = reinterpret_cast<const char_type*>(p + offset + 46);
+					elem.path.assign(s, s + name);
+					tmp->index[elem.path] = tmp->entries.size();
+					tmp->entries.push_back(elem);
+					
+					offset += 46 + name + extra + comment;
+				}
+				
+				data_ = tmp;
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xinflate
+			/* ------------------------------------------------------------- */
+			static void xinflate(const data_type& data, const entry_type& e, std::vector<char_type>& dest) {
+				faml::pdf::scoped_timer timer("unzip");
+				const unsigned char* p = data.p;
+				size_type first = xmember(data, e);
+				dest.resize(e.usize);
+				if (e.usize == 0) return;
+				
+				if (e.method == 0) { // stored
+					if (e.csize != e.usize) throw std::runtime_error("broken archive member");
+					std::memcpy(&dest.at(0), p + first, e.usize);
+					return;
+				}
+				else if (e.method != Z_DEFLATED) throw std::runtime_error("unsupported compression method");
+				
+				z_stream z;
+				std::memset(&z, 0, sizeof(z));
+				if (inflateInit2(&z, -MAX_WBITS) != Z_OK) throw std::runtime_error("inflateInit2 failed");
+				z.next_in = const_cast<Bytef*>(p + first);
+				z.avail_in = static_cast<uInt>(e.csize);
+				z.next_out = reinterpret_cast<Bytef*>(&dest.at(0));
+				z.avail_out = static_cast<uInt>(e.usize);
+				int status = inflate(&z, Z_FINISH);
+				inflateEnd(&z);
+				if (status != Z_STREAM_END) throw std::runtime_error("cannot inflate archive member");
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xmember
+			 *
+			 *  Returns the offset of the (compressed) member data, i.e.,
+			 *  the position just after the local file header.
+			 */
+			/* ------------------------------------------------------------- */
+			static size_type xmember(const data_type& data, const entry_type& e) {
+				const unsigned char* p = data.p;
+				if (e.offset + 30 > data.n || xget32(p + e.offset) != local_header) {
+					throw std::runtime_error("broken local file header");
+				}
+				
+				size_type first = e.offset + 30 + xget16(p + e.offset + 26) + xget16(p + e.offset + 28);
+				if (first + e.csize > data.n) throw std::runtime_error("broken archive member");
+				return first;
+			}
+			
+			static size_type xget16(const unsigned char* p) {
+				return static_cast<size_type>(p[0]) | (static_cast<size_type>(p[1]) << 8);
+			}
+			
+			static size_type xget32(const unsigned char* p) {
+				return xget16(p) | (xget16(p + 2) << 16);
+			}
+		};
+		
+		typedef basic_archive<char> archive;
+	}
+}
+
+#endif // FAML_OFFICEX_ARCHIVE_H
@@ -40,6 +40,7 @@
 #include "rapidxml/rapidxml.hpp"
 #include "clx/literal.h"
 #include "clx/lexical_cast.h"
+#include "number.h"
 #include "clx/case_conv.h"
 
 namespace faml {
@@ -662,24 +663,24 @@ namespace faml {
 			if (pos) {
 				attr_ptr attr = pos->first_attribute(LITERAL("val"));
 				if (attr && attr->value_size() > 0) {
-					rgb = clx::lexical_cast<size_t>(attr->value(), std::ios::hex);
+					rgb = officex::number_cast<size_t>(attr->value(), std::ios::hex);
 				}
 			}
 			else if ((pos = root->first_node(LITERAL("a:srgbClr"))) != NULL) {
 				double r = 0.0, g = 0.0, b = 0.0;
 				attr_ptr attr = pos->first_attribute(LITERAL("r"));
 				if (attr && attr->value_size() > 0) {
-					r = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+					r = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 				}
 				
 				attr = pos->first_attribute(LITERAL("g"));
 				if (attr && attr->value_size() > 0) {
-					g = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+					g = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 				}
 				
 				attr = pos->first_attribute(LITERAL("b"));
 				if (attr && attr->value_size() > 0) {
-					b = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+					b = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 				}
 				
 				rgb = convrgb(r, g, b);
@@ -687,7 +688,7 @@ namespace faml {
 			else if ((pos = root->first_node(LITERAL("a:sysClr"))) != NULL) {
 				attr_ptr attr = pos->first_attribute(LITERAL("lastClr"));
 				if (attr && attr->value_size() > 0) {
-					rgb = clx::lexical_cast<size_t>(attr->value(), std::ios::hex);
+					rgb = officex::number_cast<size_t>(attr->value(), std::ios::hex);
 				}
 			}
 			
@@ -696,7 +697,7 @@ namespace faml {
 			if (opt) {
 				attr_ptr attr = opt->first_attribute(LITERAL("val"));
 				if (attr && attr->value_size() > 0) {
-					double percent = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+					double percent = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 					rgb = endark(rgb, percent);
 				}
 			}
@@ -766,10 +767,10 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							percent = officex::number_cast<size_t>(tmp) / 100.0;
 						}
 						else{
-							percent = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+							percent = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 						}
 						rgb = enred(rgb, percent);
 					}
@@ -783,7 +784,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = enredMod(rgb, percent);
 						}
 					}
@@ -798,10 +799,10 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							percent = officex::number_cast<size_t>(tmp) / 100.0;
 						}
 						else{
-							percent = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+							percent = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 						}
 						rgb = enredOff(rgb, percent);
 					}
@@ -816,10 +817,10 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							percent = officex::number_cast<size_t>(tmp) / 100.0;
 						}
 						else{
-							percent = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+							percent = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 						}
 						rgb = engreen(rgb, percent);
 					}
@@ -833,7 +834,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = engreenMod(rgb, percent);
 						}
 					}
@@ -848,10 +849,10 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							percent = officex::number_cast<size_t>(tmp) / 100.0;
 						}
 						else{
-							percent = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+							percent = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 						}
 						rgb = engreenOff(rgb, percent);
 					}
@@ -866,10 +867,10 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							percent = officex::number_cast<size_t>(tmp) / 100.0;
 						}
 						else{
-							percent = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+							percent = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 						}
 						rgb = enblue(rgb, percent);
 					}
@@ -883,7 +884,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = enblueMod(rgb, percent);
 						}
 					}
@@ -898,10 +899,10 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							percent = officex::number_cast<size_t>(tmp) / 100.0;
 						}
 						else{
-							percent = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+							percent = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 						}
 						rgb = enblueOff(rgb, percent);
 					}
@@ -934,10 +935,10 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							percent = officex::number_cast<size_t>(tmp) / 100.0;
 						}
 						else{
-							percent = clx::lexical_cast<size_t>(attr->value()) / 1000.0 / 100.0;
+							percent = officex::number_cast<size_t>(attr->value()) / 1000.0 / 100.0;
 						}
 						rgb = endark(rgb, percent);
 					}
@@ -948,7 +949,7 @@ namespace faml {
 				if (opt) {
 					attr = opt->first_attribute(LITERAL("val"));
 					if (attr && attr->value_size() > 0) {
-						rgb = enhue(rgb, clx::lexical_cast<size_t>(attr->value()));
+						rgb = enhue(rgb, officex::number_cast<size_t>(attr->value()));
 					}
 				}
 				
@@ -960,7 +961,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = enhueMod(rgb, percent);
 						}
 					}
@@ -971,7 +972,7 @@ namespace faml {
 				if (opt) {
 					attr = opt->first_attribute(LITERAL("val"));
 					if (attr && attr->value_size() > 0) {
-						rgb = enhueOff(rgb, clx::lexical_cast<size_t>(attr->value()));
+						rgb = enhueOff(rgb, officex::number_cast<size_t>(attr->value()));
 					}
 				}
 				
@@ -983,7 +984,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = enlum(rgb, percent);
 						}
 					}
@@ -997,7 +998,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = enlumMod(rgb, percent);
 						}
 					}
@@ -1011,7 +1012,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = enlumOff(rgb, percent);
 						}
 					}
@@ -1025,7 +1026,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = ensat(rgb, percent);
 						}
 					}
@@ -1039,7 +1040,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = ensatMod(rgb, percent);
 						}
 					}
@@ -1053,7 +1054,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = ensatOff(rgb, percent);
 						}
 					}
@@ -1067,7 +1068,7 @@ namespace faml {
 						std::string tmp(attr->value());
 						if (tmp.find("%") != std::string::npos){
 							tmp = tmp.erase(tmp.length() - 1);
-							double percent = clx::lexical_cast<size_t>(tmp) / 100.0;
+							double percent = officex::number_cast<size_t>(tmp) / 100.0;
 							rgb = entint(rgb, percent);
 						}
 					}
@@ -35,23 +35,33 @@
 #ifndef FAML_OFFICEX_CUSTOM_SHAPE_H
 #define FAML_OFFICEX_CUSTOM_SHAPE_H
 
+#include <cmath>
 #include <stdexcept>
 #include <string>
+#include <vector>
 #include "rapidxml/rapidxml.hpp"
 #include "clx/lexical_cast.h"
+#include "number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
 #include "../coordinate.h"
 #include "color.h"
+#include "guide.h"
 #include "theme.h"
 #include "txbox.h"
+#include "utility.h"
 
 namespace faml {
 	namespace officex {
 		using faml::pdf::coordinate;
 		
 		/* ----------------------------------------------------------------- */
-		//  basic_shape_path
+		/*
+		 *  basic_shape_path
+		 *
+		 *  The basic_shape_path class represents a drawing command whose
+		 *  points are normalized by the width and height of the path.
+		 */
 		/* ----------------------------------------------------------------- */
 		template <
 			class CharT,
@@ -68,44 +78,10 @@ namespace faml {
 			
 			enum { move = 0, line, curve, close };
 			
-			basic_shape_path() : command_(), v_() {}
-			
-			template <class XMLNode>
-			basic_shape_path(XMLNode* root, double maxw, double maxh) :
-				command_(), v_() {
-				this->read(root, maxw, maxh);
-			}
+			explicit basic_shape_path(size_type command = move) : command_(command), v_() {}
 			
 			virtual ~basic_shape_path() throw() {}
 			
-			template <class XMLNode>
-			basic_shape_path& read(XMLNode* root, double maxw, double maxh) {
-				if (!root) throw std::runtime_error("cannot find shape path tag");
-				
-				string_type name = string_type(root->name());
-				if (name == LITERAL("a:moveTo")) command_ = move;
-				else if (name == LITERAL("a:lnTo")) command_ = line;
-				else if (name == LITERAL("a:cubicBezTo")) command_ = curve;
-				else if (name == LITERAL("a:close")) command_ = close;
-				else throw std::runtime_error("undefined drawing command");
-				
-				for (node_ptr child = root->first_node(); child; child = child->next_sibling()) {
-					if (string_type(child->name()) != LITERAL("a:pt")) continue;
-					attr_ptr attr = child->first_attribute(LITERAL("x"));
-					if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find x attribute");
-					double x = clx::lexical_cast<double>(attr->value()) / maxw;
-					
-					attr = child->first_attribute(LITERAL("y"));
-					if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find x attribute");
-					double y = clx::lexical_cast<double>(attr->value()) / maxh;
-					
-					coordinate elem(x, y);
-					v_.push_back(elem);
-				}
-				
-				return *this;
-			}
-			
 			/* ------------------------------------------------------------- */
 			//  Access methods (get).
 			/* ------------------------------------------------------------- */
@@ -117,16 +93,27 @@ namespace faml {
 			const_iterator begin() const { return v_.begin(); }
 			const_iterator end() const { return v_.end(); }
 			
-		private:
-			typedef rapidxml::xml_node<CharT>* node_ptr;
-			typedef rapidxml::xml_attribute<CharT>* attr_ptr;
+			/* ------------------------------------------------------------- */
+			//  Access methods (set).
+			/* ------------------------------------------------------------- */
+			void push_back(const value_type& cp) { v_.push_back(cp); }
 			
+		private:
 			size_type command_;
 			container v_;
 		};
 		
 		/* ----------------------------------------------------------------- */
-		//  basic_shape_path_container
+		/*
+		 *  basic_shape_path_container
+		 *
+		 *  The basic_shape_path_container class compiles an <a:path>
+		 *  element. The points of the commands may refer to the shape
+		 *  guides, so the commands are kept with the compiled arguments
+		 *  and are converted into the normalized points by resolve().
+		 *  The arcTo and quadBezTo commands are converted into cubic
+		 *  Bezier curves at that time.
+		 */
 		/* ----------------------------------------------------------------- */
 		template <
 			class CharT,
@@ -140,45 +127,120 @@ namespace faml {
 			typedef basic_shape_path<CharT, Traits> value_type;
 			typedef std::vector<value_type> container;
 			typedef typename container::const_iterator const_iterator;
+			typedef basic_guide_list<CharT, Traits> guide_type;
 			
-			basic_shape_path_container() : v_(), fill_(true) {}
+			basic_shape_path_container() :
+				v_(), code_(), fill_(true), stroke_(true), w_(0.0), h_(0.0) {}
 			
 			template <class XMLNode>
 			basic_shape_path_container(XMLNode* root) :
-				v_(), fill_(false) {
+				v_(), code_(), fill_(false), stroke_(true), w_(0.0), h_(0.0) {
 				this->read(root);
 			}
 			
 			virtual ~basic_shape_path_container() throw() {}
 			
+			/* ------------------------------------------------------------- */
+			//  read
+			/* ------------------------------------------------------------- */
 			template <class XMLNode>
 			basic_shape_path_container& read(XMLNode* root) {
+				guide_type gd;
+				this->read(root, gd);
+				std::vector<double> values;
+				return this->resolve(gd, values, 21600.0, 21600.0);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  read
+			 *
+			 *  Compiles the <a:path> element with the guides gd. The
+			 *  points are available after resolve() is called.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class XMLNode>
+			basic_shape_path_container& read(XMLNode* root, const guide_type& gd) {
 				if (!root) throw std::runtime_error("cannot find <a:path> tag");
 				
-				double w = 21600.0;
-				double h = 21600.0;
 				attr_ptr attr = root->first_attribute(LITERAL("w"));
 				if (attr && attr->value_size() > 0) {
-					w = clx::lexical_cast<double>(attr->value());
+					w_ = officex::number_cast<double>(attr->value());
 				}
 				
 				attr = root->first_attribute(LITERAL("h"));
 				if (attr && attr->value_size() > 0) {
-					h = clx::lexical_cast<double>(attr->value());
+					h_ = officex::number_cast<double>(attr->value());
 				}
 				
 				attr = root->first_attribute(LITERAL("fill"));
 				if (attr && attr->value_size() > 0 && string_type(attr->value()) == LITERAL("none")) fill_ = false;
 				
+				attr = root->first_attribute(LITERAL("stroke"));
+				if (attr && attr->value_size() > 0) {
+					string_type tmp(attr->value());
+					if (tmp == LITERAL("0") || tmp == LITERAL("false")) stroke_ = false;
+				}
+				
 				for (node_ptr child = root->first_node(); child; child = child->next_sibling()) {
-					value_type elem;
-					elem.read(child, w, h);
-					if (!((elem.command() == 2 && elem.size() == 3) ||
-						  (elem.command() == 3 && elem.size() == 0) ||
-						  (elem.size() == 1))) {
-						throw std::runtime_error("unexpected number of parameters");
+					code_.push_back(this->xcompile(child, gd));
+				}
+				
+				return *this;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  resolve
+			 *
+			 *  Evaluates the compiled commands with the guide values that
+			 *  have been evaluated by gd.eval() for the shape of (w x h).
+			 */
+			/* ------------------------------------------------------------- */
+			basic_shape_path_container& resolve(const guide_type& gd, const std::vector<double>& values,
+				double w, double h) {
+				v_.clear();
+				double pw = (w_ > 0.0) ? w_ : w;
+				double ph = (h_ > 0.0) ? h_ : h;
+				if (pw <= 0.0) pw = 21600.0;
+				if (ph <= 0.0) ph = 21600.0;
+				
+				coordinate cur(0.0, 0.0);
+				coordinate first(0.0, 0.0);
+				for (size_type i = 0; i < code_.size(); ++i) {
+					const code_type& c = code_[i];
+					std::vector<double> args(c.args.size());
+					for (size_type j = 0; j < c.args.size(); ++j) args[j] = gd.value(c.args[j], w, h, values);
+					
+					switch (c.command) {
+					case arc:
+						cur = this->xarc(cur, args[0], args[1], args[2], args[3], pw, ph);
+						break;
+					case quad:
+					{
+						value_type elem(value_type::curve);
+						elem.push_back(xnormalize(cur.x() + (args[0] - cur.x()) * 2.0 / 3.0,
+							cur.y() + (args[1] - cur.y()) * 2.0 / 3.0, pw, ph));
+						elem.push_back(xnormalize(args[2] + (args[0] - args[2]) * 2.0 / 3.0,
+							args[3] + (args[1] - args[3]) * 2.0 / 3.0, pw, ph));
+						elem.push_back(xnormalize(args[2], args[3], pw, ph));
+						v_.push_back(elem);
+						cur = coordinate(args[2], args[3]);
+						break;
+					}
+					default:
+					{
+						value_type elem(c.command);
+						for (size_type j = 0; j + 1 < args.size(); j += 2) {
+							elem.push_back(xnormalize(args[j], args[j + 1], pw, ph));
+							cur = coordinate(args[j], args[j + 1]);
+						}
+						if (c.command == value_type::move) first = cur;
+						else if (c.command == value_type::close) cur = first;
+						v_.push_back(elem);
+						break;
+					}
 					}
-					v_.push_back(elem);
 				}
 				
 				return *this;
@@ -194,13 +256,121 @@ namespace faml {
 			const_iterator begin() const { return v_.begin(); }
 			const_iterator end() const { return v_.end(); }
 			bool is_fill() const { return fill_; }
+			bool is_stroke() const { return stroke_; }
 			
 		private:
 			typedef rapidxml::xml_node<CharT>* node_ptr;
 			typedef rapidxml::xml_attribute<CharT>* attr_ptr;
+			typedef typename guide_type::operand_type operand_type;
+			
+			enum { arc = 4, quad };
+			
+			struct code_type {
+				size_type command;
+				std::vector<operand_type> args;
+			};
 			
 			container v_;
+			std::vector<code_type> code_;
 			bool fill_;
+			bool stroke_;
+			double w_;
+			double h_;
+			
+			/* ------------------------------------------------------------- */
+			//  xcompile
+			/* ------------------------------------------------------------- */
+			code_type xcompile(node_ptr root, const guide_type& gd) {
+				code_type dest;
+				size_type n = 1;
+				string_type name = localname(string_type(root->name()));
+				if (name == LITERAL("moveTo")) dest.command = value_type::move;
+				else if (name == LITERAL("lnTo")) dest.command = value_type::line;
+				else if (name == LITERAL("cubicBezTo")) { dest.command = value_type::curve; n = 3; }
+				else if (name == LITERAL("quadBezTo")) { dest.command = quad; n = 2; }
+				else if (name == LITERAL("close")) { dest.command = value_type::close; n = 0; }
+				else if (name == LITERAL("arcTo")) {
+					dest.command = arc;
+					dest.args.push_back(this->xcompile_attr(root, LITERAL("wR"), gd));
+					dest.args.push_back(this->xcompile_attr(root, LITERAL("hR"), gd));
+					dest.args.push_back(this->xcompile_attr(root, LITERAL("stAng"), gd));
+					dest.args.push_back(this->xcompile_attr(root, LITERAL("swAng"), gd));
+					return dest;
+				}
+				else throw std::runtime_error("undefined drawing command");
+				
+				for (node_ptr child = root->first_node(); child; child = child->next_sibling()) {
+					if (localname(string_type(child->name())) != LITERAL("pt")) continue;
+					dest.args.push_back(this->xcompile_attr(child, LITERAL("x"), gd));
+					dest.args.push_back(this->xcompile_attr(child, LITERAL("y"), gd));
+				}
+				
+				if (dest.args.size() != n * 2) throw std::runtime_error("unexpected number of parameters");
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xcompile_attr
+			/* ------------------------------------------------------------- */
+			operand_type xcompile_attr(node_ptr root, const char_type* name, const guide_type& gd) {
+				attr_ptr attr = root->first_attribute(name);
+				if (!attr || attr->value_size() == 0) {
+					throw std::runtime_error("cannot find the attribute of the drawing command");
+				}
+				return gd.compile(string_type(attr->value()));
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xarc
+			 *
+			 *  Converts the arcTo command into cubic Bezier curves (each
+			 *  curve draws 90 degrees at most), and returns the end point
+			 *  of the arc.
+			 */
+			/* ------------------------------------------------------------- */
+			coordinate xarc(const coordinate& cur, double wr, double hr,
+				double st, double sw, double pw, double ph) {
+				static const double pi = 3.14159265358979323846;
+				static const double unit = pi / 10800000.0;
+				if (wr <= 0.0 || hr <= 0.0 || sw == 0.0) return cur;
+				
+				// angles of the ellipse are converted into parametric ones.
+				double a0 = std::atan2(wr * std::sin(st * unit), hr * std::cos(st * unit));
+				double a1 = std::atan2(wr * std::sin((st + sw) * unit), hr * std::cos((st + sw) * unit));
+				double da = a1 - a0;
+				if (std::fabs(sw * unit) >= 2.0 * pi) da = sw * unit;
+				else if (sw > 0.0 && da <= 0.0) da += 2.0 * pi;
+				else if (sw < 0.0 && da >= 0.0) da -= 2.0 * pi;
+				
+				double cx = cur.x() - wr * std::cos(a0);
+				double cy = cur.y() - hr * std::sin(a0);
+				size_type n = static_cast<size_type>(std::ceil(std::fabs(da) / (pi / 2.0) - 1e-9));
+				if (n == 0) n = 1;
+				double d = da / n;
+				double k = 4.0 / 3.0 * std::tan(d / 4.0);
+				
+				for (size_type i = 0; i < n; ++i) {
+					double s = a0 + d * i;
+					double e = s + d;
+					value_type elem(value_type::curve);
+					elem.push_back(xnormalize(cx + wr * (std::cos(s) - k * std::sin(s)),
+						cy + hr * (std::sin(s) + k * std::cos(s)), pw, ph));
+					elem.push_back(xnormalize(cx + wr * (std::cos(e) + k * std::sin(e)),
+						cy + hr * (std::sin(e) - k * std::cos(e)), pw, ph));
+					elem.push_back(xnormalize(cx + wr * std::cos(e), cy + hr * std::sin(e), pw, ph));
+					v_.push_back(elem);
+				}
+				
+				return coordinate(cx + wr * std::cos(a0 + da), cy + hr * std::sin(a0 + da));
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xnormalize
+			/* ------------------------------------------------------------- */
+			static coordinate xnormalize(double x, double y, double pw, double ph) {
+				return coordinate(x / pw, y / ph);
+			}
 		};
 	}
 }
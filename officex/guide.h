@@ -0,0 +1,390 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  officex/guide.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_OFFICEX_GUIDE_H
+#define FAML_OFFICEX_GUIDE_H
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "rapidxml/rapidxml.hpp"
+#include "clx/lexical_cast.h"
+#include "number.h"
+#include "clx/literal.h"
+#include "utility.h"
+
+namespace faml {
+	namespace officex {
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_guide_list
+		 *
+		 *  The basic_guide_list class compiles the shape guides of the
+		 *  DrawingML geometry (<a:avLst> and <a:gdLst>) into the list of
+		 *  instructions. Each argument of the formula is resolved into
+		 *  the constant, the built-in variable (w, h, ss, wd2, ...), or
+		 *  the index of the preceding guide when compiling, so that the
+		 *  evaluation does not look up any names.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_guide_list {
+		public:
+			typedef size_t size_type;
+			typedef CharT char_type;
+			typedef std::basic_string<CharT, Traits> string_type;
+			typedef std::map<size_type, int> adjust_map;
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  operand_type
+			 *
+			 *  The value of the operand is value (constant), w / value,
+			 *  h / value, ss / value, ls / value, or the result of the
+			 *  value-th guide.
+			 */
+			/* ------------------------------------------------------------- */
+			struct operand_type {
+				int type;
+				double value;
+			};
+			
+			enum { constant = 0, width, height, shortside, longside, guide };
+			
+			basic_guide_list() : v_(), names_() {}
+			
+			virtual ~basic_guide_list() throw() {}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  read
+			 *
+			 *  Compiles the guides in <a:avLst> and <a:gdLst>. The guides
+			 *  in avLst are compiled first, and are replaced with the
+			 *  adjust values of the shape when evaluating.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class XMLNode>
+			basic_guide_list& read(XMLNode* av, XMLNode* gd) {
+				if (av) this->xread(av, true);
+				if (gd) this->xread(gd, false);
+				return *this;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  compile
+			 *
+			 *  Resolves the argument (the number or the name of the guide)
+			 *  of the formula or the path command.
+			 */
+			/* ------------------------------------------------------------- */
+			operand_type compile(const string_type& s) const {
+				operand_type dest;
+				dest.type = constant;
+				dest.value = 0.0;
+				if (s.empty()) throw std::runtime_error("empty guide argument");
+				
+				if (s.find_first_not_of(LITERAL("+-0123456789.")) == string_type::npos) {
+					dest.value = xnumber(s);
+					return dest;
+				}
+				
+				typename std::map<string_type, size_type>::const_iterator pos = names_.find(s);
+				if (pos != names_.end()) {
+					dest.type = guide;
+					dest.value = static_cast<double>(pos->second);
+					return dest;
+				}
+				
+				if (s == LITERAL("w") || s == LITERAL("r")) return xmake(width, 1.0);
+				if (s == LITERAL("h") || s == LITERAL("b")) return xmake(height, 1.0);
+				if (s == LITERAL("ss")) return xmake(shortside, 1.0);
+				if (s == LITERAL("ls")) return xmake(longside, 1.0);
+				if (s == LITERAL("hc")) return xmake(width, 2.0);
+				if (s == LITERAL("vc")) return xmake(height, 2.0);
+				if (s == LITERAL("l") || s == LITERAL("t")) return dest;
+				if (s == LITERAL("cd2")) return xmake(constant, 10800000.0);
+				if (s == LITERAL("cd4")) return xmake(constant, 5400000.0);
+				if (s == LITERAL("cd8")) return xmake(constant, 2700000.0);
+				if (s == LITERAL("3cd4")) return xmake(constant, 16200000.0);
+				if (s == LITERAL("3cd8")) return xmake(constant, 8100000.0);
+				if (s == LITERAL("5cd8")) return xmake(constant, 13500000.0);
+				if (s == LITERAL("7cd8")) return xmake(constant, 18900000.0);
+				if (s.compare(0, 3, LITERAL("ssd")) == 0) return xmake(shortside, xdivisor(s.substr(3)));
+				if (s.compare(0, 2, LITERAL("wd")) == 0) return xmake(width, xdivisor(s.substr(2)));
+				if (s.compare(0, 2, LITERAL("hd")) == 0) return xmake(height, xdivisor(s.substr(2)));
+				
+				throw std::runtime_error("undefined guide name");
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  eval
+			 *
+			 *  Evaluates all guides for the shape of (w x h). The results
+			 *  are stored in dest in the compiled order.
+			 */
+			/* ------------------------------------------------------------- */
+			void eval(double w, double h, const adjust_map& adj, std::vector<double>& dest) const {
+				dest.resize(v_.size());
+				for (size_type i = 0; i < v_.size(); ++i) {
+					const instruction& c = v_[i];
+					typename adjust_map::const_iterator pos;
+					if (c.adjust != size_type(-1) && (pos = adj.find(c.adjust)) != adj.end()) {
+						dest[i] = static_cast<double>(pos->second);
+						continue;
+					}
+					
+					double x = this->value(c.args[0], w, h, dest);
+					double y = (c.op >= binary) ? this->value(c.args[1], w, h, dest) : 0.0;
+					double z = (c.op >= ternary) ? this->value(c.args[2], w, h, dest) : 0.0;
+					dest[i] = xeval(c.op, x, y, z);
+				}
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  value
+			/* ------------------------------------------------------------- */
+			double value(const operand_type& x, double w, double h, const std::vector<double>& gd) const {
+				switch (x.type) {
+				case width:
+					return w / x.value;
+				case height:
+					return h / x.value;
+				case shortside:
+					return std::min(w, h) / x.value;
+				case longside:
+					return std::max(w, h) / x.value;
+				case guide:
+					return gd.at(static_cast<size_type>(x.value));
+				default:
+					break;
+				}
+				return x.value;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  Access methods (get).
+			/* ------------------------------------------------------------- */
+			bool empty() const { return v_.empty(); }
+			size_type size() const { return v_.size(); }
+			
+		private:
+			typedef rapidxml::xml_node<CharT>* node_ptr;
+			typedef rapidxml::xml_attribute<CharT>* attr_ptr;
+			
+			enum {
+				val = 0, absolute, sqrt_, // unary
+				binary, max_, min_, sin_, cos_, tan_, at2, // binary
+				ternary, muldiv, addsub, adddiv, ifelse, cat2, sat2, mod, pin // ternary
+			};
+			
+			struct instruction {
+				int op;
+				operand_type args[3];
+				size_type adjust; // index of the adjust value, or -1
+			};
+			
+			std::vector<instruction> v_;
+			std::map<string_type, size_type> names_;
+			
+			/* ------------------------------------------------------------- */
+			//  xread
+			/* ------------------------------------------------------------- */
+			template <class XMLNode>
+			void xread(XMLNode* root, bool av) {
+				for (node_ptr child = root->first_node(); child; child = child->next_sibling()) {
+					if (localname(string_type(child->name())) != LITERAL("gd")) continue;
+					attr_ptr name = child->first_attribute(LITERAL("name"));
+					attr_ptr fmla = child->first_attribute(LITERAL("fmla"));
+					if (!name || name->value_size() == 0 || !fmla) {
+						throw std::runtime_error("cannot find name/fmla attribute");
+					}
+					
+					std::vector<string_type> tokens;
+					this->xsplit(string_type(fmla->value()), tokens);
+					if (tokens.empty()) throw std::runtime_error("empty guide formula");
+					
+					instruction elem;
+					elem.op = xopcode(tokens[0]);
+					elem.adjust = size_type(-1);
+					size_type n = (elem.op >= ternary) ? 3 : ((elem.op >= binary) ? 2 : 1);
+					if (tokens.size() < n + 1) throw std::runtime_error("unexpected number of guide arguments");
+					for (size_type i = 0; i < 3; ++i) {
+						elem.args[i].type = constant;
+						elem.args[i].value = 0.0;
+						if (i < n) elem.args[i] = this->compile(tokens[i + 1]);
+					}
+					
+					string_type s(name->value());
+					if (av && s.compare(0, 3, LITERAL("adj")) == 0) {
+						// the same index as basic_shape::xread_adjust.
+						if (s.size() == 3) elem.adjust = 0;
+						else if (s.find_first_not_of(LITERAL("0123456789"), 3) == string_type::npos) {
+							elem.adjust = static_cast<size_type>(xnumber(s.substr(3))) - 1;
+						}
+					}
+					
+					names_[s] = v_.size();
+					v_.push_back(elem);
+				}
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xsplit
+			/* ------------------------------------------------------------- */
+			void xsplit(const string_type& s, std::vector<string_type>& dest) const {
+				size_type first = s.find_first_not_of(LITERAL(" \t"));
+				while (first != string_type::npos) {
+					size_type last = s.find_first_of(LITERAL(" \t"), first);
+					if (last == string_type::npos) last = s.size();
+					dest.push_back(s.substr(first, last - first));
+					first = s.find_first_not_of(LITERAL(" \t"), last);
+				}
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xopcode
+			/* ------------------------------------------------------------- */
+			static int xopcode(const string_type& s) {
+				if (s == LITERAL("val")) return val;
+				if (s == LITERAL("*/")) return muldiv;
+				if (s == LITERAL("+-")) return addsub;
+				if (s == LITERAL("+/")) return adddiv;
+				if (s == LITERAL("?:")) return ifelse;
+				if (s == LITERAL("abs")) return absolute;
+				if (s == LITERAL("sqrt")) return sqrt_;
+				if (s == LITERAL("max")) return max_;
+				if (s == LITERAL("min")) return min_;
+				if (s == LITERAL("sin")) return sin_;
+				if (s == LITERAL("cos")) return cos_;
+				if (s == LITERAL("tan")) return tan_;
+				if (s == LITERAL("at2")) return at2;
+				if (s == LITERAL("cat2")) return cat2;
+				if (s == LITERAL("sat2")) return sat2;
+				if (s == LITERAL("mod")) return mod;
+				if (s == LITERAL("pin")) return pin;
+				throw std::runtime_error("undefined guide formula");
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xeval
+			 *
+			 *  Angles are represented in 60,000ths of a degree.
+			 */
+			/* ------------------------------------------------------------- */
+			static double xeval(int op, double x, double y, double z) {
+				static const double unit = 3.14159265358979323846 / 10800000.0;
+				switch (op) {
+				case absolute:
+					return std::fabs(x);
+				case sqrt_:
+					return (x > 0.0) ? std::sqrt(x) : 0.0;
+				case max_:
+					return std::max(x, y);
+				case min_:
+					return std::min(x, y);
+				case sin_:
+					return x * std::sin(y * unit);
+				case cos_:
+					return x * std::cos(y * unit);
+				case tan_:
+					return x * std::tan(y * unit);
+				case at2:
+					return std::atan2(y, x) / unit;
+				case muldiv:
+					return (z != 0.0) ? x * y / z : 0.0;
+				case addsub:
+					return x + y - z;
+				case adddiv:
+					return (z != 0.0) ? (x + y) / z : 0.0;
+				case ifelse:
+					return (x > 0.0) ? y : z;
+				case cat2:
+					return x * std::cos(std::atan2(z, y));
+				case sat2:
+					return x * std::sin(std::atan2(z, y));
+				case mod:
+					return std::sqrt(x * x + y * y + z * z);
+				case pin:
+					return (y < x) ? x : ((y > z) ? z : y);
+				default:
+					break;
+				}
+				return x;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xmake
+			/* ------------------------------------------------------------- */
+			static operand_type xmake(int type, double value) {
+				operand_type dest;
+				dest.type = type;
+				dest.value = value;
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xdivisor
+			/* ------------------------------------------------------------- */
+			static double xdivisor(const string_type& s) {
+				double dest = xnumber(s);
+				if (dest <= 0.0) throw std::runtime_error("undefined guide name");
+				return dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xnumber
+			/* ------------------------------------------------------------- */
+			static double xnumber(const string_type& s) {
+				try {
+					return officex::number_cast<double>(s);
+				}
+				catch (clx::bad_lexical_cast&) {
+					throw std::runtime_error("unexpected guide argument");
+				}
+			}
+		};
+	}
+}
+
+#endif // FAML_OFFICEX_GUIDE_H
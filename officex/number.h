@@ -0,0 +1,138 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  officex/number.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_OFFICEX_NUMBER_H
+#define FAML_OFFICEX_NUMBER_H
+
+#include <cmath>
+#include <ios>
+#include <limits>
+#include <string>
+#include "clx/lexical_cast.h"
+
+namespace faml {
+	namespace officex {
+		namespace detail {
+			/* ------------------------------------------------------------- */
+			/*
+			 *  scan_number
+			 *
+			 *  Parses the plain decimal (or hexadecimal) number in [s,
+			 *  s + n) without streams and locales. The function returns
+			 *  false if the string has any other form (exponent, spaces,
+			 *  too many digits, ...), so that the caller can fall back
+			 *  to clx::lexical_cast.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class CharT>
+			inline bool scan_number(const CharT* s, size_t n, bool hex, bool sign, double& dest) {
+				if (n == 0) return false;
+				
+				size_t i = 0;
+				bool minus = false;
+				if (!hex && (s[0] == '-' || s[0] == '+')) {
+					if (s[0] == '-') {
+						if (!sign) return false;
+						minus = true;
+					}
+					++i;
+				}
+				if (i == n) return false;
+				
+				double value = 0.0;
+				size_t digits = 0;
+				for (; i < n; ++i, ++digits) {
+					int c = static_cast<int>(s[i]);
+					int d = -1;
+					if (c >= '0' && c <= '9') d = c - '0';
+					else if (hex && c >= 'a' && c <= 'f') d = c - 'a' + 10;
+					else if (hex && c >= 'A' && c <= 'F') d = c - 'A' + 10;
+					else break;
+					value = value * (hex ? 16.0 : 10.0) + d;
+				}
+				
+				if (i < n && !hex && s[i] == '.') {
+					double scale = 1.0;
+					for (++i; i < n && s[i] >= '0' && s[i] <= '9'; ++i, ++digits) {
+						value = value * 10.0 + (s[i] - '0');
+						scale *= 10.0;
+					}
+					value /= scale;
+				}
+				
+				// 15 digits are exactly represented by double.
+				if (i != n || digits == 0 || digits > 15) return false;
+				dest = minus ? -value : value;
+				return true;
+			}
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  number_cast
+		 *
+		 *  Converts the attribute value to the number in the same way
+		 *  as clx::lexical_cast. Most attributes of OOXML (EMU, twips,
+		 *  indices, RGB values, ...) are plain numbers, which are parsed
+		 *  directly without creating any stream. The other forms are
+		 *  passed to clx::lexical_cast, so the results and exceptions
+		 *  are the same as before.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <class Type, class CharT>
+		inline Type number_cast(const CharT* s, std::ios_base::fmtflags base = std::ios_base::dec) {
+			bool hex = (base & std::ios_base::hex) != 0;
+			size_t n = std::char_traits<CharT>::length(s);
+			double dest = 0.0;
+			typedef std::numeric_limits<Type> limits;
+			if (detail::scan_number(s, n, hex, limits::is_signed, dest)) {
+				if (!limits::is_integer) return static_cast<Type>(dest);
+				if (dest == std::floor(dest) &&
+					dest >= static_cast<double>(limits::min()) && dest <= static_cast<double>(limits::max())) {
+					return static_cast<Type>(dest);
+				}
+			}
+			
+			if (hex) return clx::lexical_cast<Type>(s, base);
+			return clx::lexical_cast<Type>(s);
+		}
+		
+		template <class Type, class Ch, class Tr>
+		inline Type number_cast(const std::basic_string<Ch, Tr>& s, std::ios_base::fmtflags base = std::ios_base::dec) {
+			return number_cast<Type>(s.c_str(), base);
+		}
+	}
+}
+
+#endif // FAML_OFFICEX_NUMBER_H
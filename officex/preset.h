@@ -0,0 +1,200 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  officex/preset.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_OFFICEX_PRESET_H
+#define FAML_OFFICEX_PRESET_H
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
+#include "clx/literal.h"
+#include "clx/utility.h"
+#include "custom_shape.h"
+#include "guide.h"
+#include "utility.h"
+
+namespace faml {
+	namespace officex {
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_preset_geometry
+		 *
+		 *  The basic_preset_geometry class reads the definitions of the
+		 *  preset shapes (presetShapeDefinitions.xml in ECMA-376) and
+		 *  compiles the guides and paths of each preset once. The paths
+		 *  evaluated for a shape are cached with the key of (preset,
+		 *  adjust values, width, height), since the same shape is often
+		 *  drawn many times in a document.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_preset_geometry {
+		public:
+			typedef size_t size_type;
+			typedef CharT char_type;
+			typedef std::basic_string<CharT, Traits> string_type;
+			typedef basic_guide_list<CharT, Traits> guide_type;
+			typedef basic_shape_path_container<CharT, Traits> path_subcontainer;
+			typedef std::vector<path_subcontainer> path_container;
+			typedef std::map<size_type, int> adjust_map;
+			
+			basic_preset_geometry() : v_(), cache_(), limit_(1024) {}
+			
+			template <class Ch, class Tr>
+			explicit basic_preset_geometry(std::basic_istream<Ch, Tr>& in) :
+				v_(), cache_(), limit_(1024) {
+				this->read(in);
+			}
+			
+			virtual ~basic_preset_geometry() throw() {}
+			
+			/* ------------------------------------------------------------- */
+			//  read
+			/* ------------------------------------------------------------- */
+			template <class Ch, class Tr>
+			basic_preset_geometry& read(std::basic_istream<Ch, Tr>& in) {
+				std::vector<char_type> s;
+				clx::read(in, s);
+				s.push_back(0); // make null terminated string.
+				
+				rapidxml::xml_document<char> doc;
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
+				node_ptr root = doc.first_node(LITERAL("presetShapeDefinitions"));
+				if (!root) throw std::runtime_error("cannot find <presetShapeDefinitions> tag");
+				
+				for (node_ptr child = root->first_node(); child; child = child->next_sibling()) {
+					preset_type& elem = v_[string_type(child->name())];
+					elem = preset_type();
+					elem.guides.read(this->xfind(child, LITERAL("avLst")), this->xfind(child, LITERAL("gdLst")));
+					node_ptr parent = this->xfind(child, LITERAL("pathLst"));
+					if (!parent) continue;
+					for (node_ptr pos = parent->first_node(); pos; pos = pos->next_sibling()) {
+						if (localname(string_type(pos->name())) != LITERAL("path")) continue;
+						path_subcontainer path;
+						path.read(pos, elem.guides);
+						elem.paths.push_back(path);
+					}
+				}
+				cache_.clear();
+				
+				return *this;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  find
+			 *
+			 *  Returns the paths of the preset evaluated for the shape of
+			 *  (w x h), or NULL if the preset is not defined. The pointer
+			 *  is valid until the next call of find().
+			 */
+			/* ------------------------------------------------------------- */
+			const path_container* find(const string_type& name, const adjust_map& adj, double w, double h) {
+				typename container::const_iterator pos = v_.find(name);
+				if (pos == v_.end()) return NULL;
+				
+				key_type key(name, std::vector<double>());
+				key.second.reserve(adj.size() * 2 + 2);
+				key.second.push_back(w);
+				key.second.push_back(h);
+				for (typename adjust_map::const_iterator it = adj.begin(); it != adj.end(); ++it) {
+					key.second.push_back(static_cast<double>(it->first));
+					key.second.push_back(static_cast<double>(it->second));
+				}
+				
+				typename cache_map::iterator found = cache_.find(key);
+				if (found != cache_.end()) return &found->second;
+				if (cache_.size() >= limit_) cache_.clear();
+				
+				path_container& dest = cache_[key];
+				std::vector<double> values;
+				pos->second.guides.eval(w, h, adj, values);
+				dest = pos->second.paths;
+				for (size_type i = 0; i < dest.size(); ++i) dest[i].resolve(pos->second.guides, values, w, h);
+				return &dest;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  Access methods (get).
+			/* ------------------------------------------------------------- */
+			bool empty() const { return v_.empty(); }
+			size_type size() const { return v_.size(); }
+			bool has(const string_type& name) const { return v_.find(name) != v_.end(); }
+			
+			/* ------------------------------------------------------------- */
+			//  Access methods (set).
+			/* ------------------------------------------------------------- */
+			void limit(size_type n) { limit_ = n; }
+			void clear() { cache_.clear(); }
+			
+		private:
+			typedef rapidxml::xml_node<CharT>* node_ptr;
+			
+			struct preset_type {
+				guide_type guides;
+				path_container paths;
+			};
+			
+			typedef std::map<string_type, preset_type> container;
+			typedef std::pair<string_type, std::vector<double> > key_type;
+			typedef std::map<key_type, path_container> cache_map;
+			
+			container v_;
+			cache_map cache_;
+			size_type limit_;
+			
+			/* ------------------------------------------------------------- */
+			//  xfind
+			/* ------------------------------------------------------------- */
+			node_ptr xfind(node_ptr root, const string_type& name) const {
+				for (node_ptr child = root->first_node(); child; child = child->next_sibling()) {
+					if (localname(string_type(child->name())) == name) return child;
+				}
+				return NULL;
+			}
+		};
+	}
+}
+
+#endif // FAML_OFFICEX_PRESET_H
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/utility.h"
 #include "clx/literal.h"
 
@@ -22,7 +23,10 @@ namespace faml {
 			
 			//rapidxml::xml_document<Ch> doc; // <- ??? compile error!!
 			rapidxml::xml_document<char> doc;
-			doc.parse<0>(reinterpret_cast<Ch*>(&s.at(0)));
+			{
+				faml::pdf::scoped_timer timer("xml");
+				doc.parse<0>(reinterpret_cast<Ch*>(&s.at(0)));
+			}
 			
 			node_ptr root = doc.first_node(LITERAL("Relationships"));
 			if (!root) throw std::runtime_error("cannot find <Relationships> tag");
@@ -40,6 +40,7 @@
 #include <string>
 #include "rapidxml/rapidxml.hpp"
 #include "clx/lexical_cast.h"
+#include "number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
 #include "../coordinate.h"
@@ -197,10 +198,10 @@ namespace faml {
 				std::string tmp(cp);
 				if (tmp.find("%") != std::string::npos){
 					tmp = tmp.erase(tmp.length() - 1);
-					alpha_ = clx::lexical_cast<size_t>(tmp) / 100.0;
+					alpha_ = officex::number_cast<size_t>(tmp) / 100.0;
 				}
 				else{
-					alpha_ = clx::lexical_cast<size_t>(tmp) / 1000.0 / 100.0;
+					alpha_ = officex::number_cast<size_t>(tmp) / 1000.0 / 100.0;
 				}
 			}
 			
@@ -267,7 +268,7 @@ namespace faml {
 				attr_ptr attr = pos->first_attribute(LITERAL("idx"));
 				if (attr && attr->value_size() > 0) {
 					try {
-						idx = clx::lexical_cast<int>(attr->value());
+						idx = officex::number_cast<int>(attr->value());
 					}
 					catch (clx::bad_lexical_cast&) {
 						clx::logger::warn(DEBUGF("%s: failed to lexical_cast", attr->value()));
@@ -357,7 +358,7 @@ namespace faml {
 					
 					attr_ptr attr = pos->first_attribute(LITERAL("w"));
 					if (attr && attr->value_size() > 0) {
-						weight_ = emu(clx::lexical_cast<double>(attr->value()));
+						weight_ = emu(officex::number_cast<double>(attr->value()));
 					}
 					
 					child = pos->first_node(LITERAL("a:prstDash"));
@@ -401,7 +402,7 @@ namespace faml {
 					double dis = -1.0;
 					attr_ptr attr = pos->first_attribute(LITERAL("dist"));
 					if (attr && attr->value_size() > 0) {
-						dis = clx::lexical_cast<double>(attr->value()) / 21600.0;
+						dis = officex::number_cast<double>(attr->value()) / 21600.0;
 					}
 					if (dis < 0.0) dis = 2.0;
 					elem.distance(dis);
@@ -409,7 +410,7 @@ namespace faml {
 					double dir = 0.0;
 					attr = pos->first_attribute(LITERAL("dir"));
 					if (attr && attr->value_size() > 0) {
-						dir = deg60k(clx::lexical_cast<double>(attr->value()));
+						dir = deg60k(officex::number_cast<double>(attr->value()));
 					}
 					if (dir > 360.0) dir = 0.0;
 					elem.direction(dir);
@@ -433,10 +434,17 @@ namespace faml {
 				node_ptr parent = root->first_node(LITERAL("a:pathLst"));
 				if (!parent) return *this;
 				
+				// the guides are evaluated at the size of <a:xfrm>.
+				typename path_subcontainer::guide_type gd;
+				gd.read(root->first_node(LITERAL("a:avLst")), root->first_node(LITERAL("a:gdLst")));
+				std::vector<double> values;
+				gd.eval(width_, height_, adjust_, values);
+				
 				for (node_ptr child = parent->first_node(); child; child = child->next_sibling()) {
 					if (string_type(child->name()) != LITERAL("a:path")) continue;
 					path_subcontainer elem;
-					elem.read(child);
+					elem.read(child, gd);
+					elem.resolve(gd, values, width_, height_);
 					paths_.push_back(elem);
 				}
 				return *this;
@@ -451,7 +459,7 @@ namespace faml {
 				// 1. angle
 				attr_ptr attr = root->first_attribute("rot");
 				if (attr && attr->value_size() > 0) {
-					double val = clx::lexical_cast<double>(attr->value());
+					double val = officex::number_cast<double>(attr->value());
 					angle_ = deg60k(val);
 					if (angle_ < 0.0) angle_ += 360.0;
 				}
@@ -467,9 +475,9 @@ namespace faml {
 				node_ptr pos = root->first_node(LITERAL("a:off"));
 				if (pos) {
 					attr = pos->first_attribute(LITERAL("x"));
-					if (attr && attr->value_size() > 0) x = clx::lexical_cast<double>(attr->value());
+					if (attr && attr->value_size() > 0) x = officex::number_cast<double>(attr->value());
 					attr = pos->first_attribute(LITERAL("y"));
-					if (attr && attr->value_size() > 0) y = clx::lexical_cast<double>(attr->value());
+					if (attr && attr->value_size() > 0) y = officex::number_cast<double>(attr->value());
 					if (x > 0 || y > 0) this->origin(coordinate(x, y));
 				}
 				
@@ -479,10 +487,10 @@ namespace faml {
 				pos = root->first_node(LITERAL("a:ext"));
 				if (pos) {
 					attr = pos->first_attribute(LITERAL("cx"));
-					if (attr && attr->value_size() > 0) w = clx::lexical_cast<double>(attr->value());
+					if (attr && attr->value_size() > 0) w = officex::number_cast<double>(attr->value());
 					if (w > 0) this->width(w);
 					attr = pos->first_attribute(LITERAL("cy"));
-					if (attr && attr->value_size() > 0) h = clx::lexical_cast<double>(attr->value());
+					if (attr && attr->value_size() > 0) h = officex::number_cast<double>(attr->value());
 					if (h > 0) this->height(h);
 				}
 				
@@ -539,14 +547,14 @@ namespace faml {
 							if (string_type(attr->value()).compare(0, 3, LITERAL("adj")) != 0) continue;
 							else if (attr->value_size() > 3) {
 								string_type tmp(&attr->value()[3]);
-								idx = clx::lexical_cast<size_type>(tmp) - 1;
+								idx = officex::number_cast<size_type>(tmp) - 1;
 							}
 						}
 						
 						attr = child->first_attribute(LITERAL("fmla"));
 						if (attr && attr->value_size() > 4) {
 							string_type tmp(&attr->value()[4]);
-							int dest = clx::lexical_cast<int>(tmp);
+							int dest = officex::number_cast<int>(tmp);
 							adjust_[idx] = dest;
 						}
 					}
@@ -578,7 +586,7 @@ namespace faml {
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("ang"));
 					if (attr && attr->value_size() > 0) {
-						dir_ = deg60k(clx::lexical_cast<double>(attr->value()));
+						dir_ = deg60k(officex::number_cast<double>(attr->value()));
 						if (dir_ > 360.0) dir_ = 0.0; // error?
 					}
 				}
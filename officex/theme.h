@@ -39,6 +39,7 @@
 #include <string>
 #include <vector>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/lexical_cast.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
@@ -134,7 +135,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				node_ptr tmp = doc.first_node(LITERAL("a:theme"));
 				if (!tmp) throw std::runtime_error("cannot find <a:theme> (root) tag");
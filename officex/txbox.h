@@ -40,8 +40,10 @@
 #include <vector>
 #include "rapidxml/rapidxml.hpp"
 #include "clx/lexical_cast.h"
+#include "number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
+#include "../code_convert.h"
 #include "color.h"
 #include "font.h"
 #include "theme.h"
@@ -73,10 +75,12 @@ namespace faml {
 				underline = 0x04, strike = 0x08, hyperlink = 0x10 };
 			
 			basic_piece() :
-				data_(), font_(), decorate_(0), scale_(100), baseline_(0), ascii_(false) {}
+				data_(), font_(), decorate_(0), scale_(100), baseline_(0), ascii_(false),
+				utf16_(), conv_(false) {}
 			
 			basic_piece(const string_type& s) :
-				data_(s), font_(), decorate_(0), scale_(100), baseline_(0), ascii_(false) {}
+				data_(s), font_(), decorate_(0), scale_(100), baseline_(0), ascii_(false),
+				utf16_(), conv_(false) {}
 			
 			virtual ~basic_piece() throw() {}
 			
@@ -90,10 +94,29 @@ namespace faml {
 			int baseline() const { return baseline_; }
 			bool ascii() const { return ascii_; }
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  utf16
+			 *
+			 *  Returns the UTF-16BE representation of the data. It is
+			 *  converted at the first call and kept in the piece.
+			 */
+			/* ------------------------------------------------------------- */
+			const string_type& utf16() const {
+				if (!conv_) {
+					utf16_ = faml::pdf::utf8_to_utf16be(data_);
+					conv_ = true;
+				}
+				return utf16_;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  Access methods (set).
 			/* ------------------------------------------------------------- */
-			void data(const string_type& cp) { data_ = cp; }
+			void data(const string_type& cp) {
+				data_ = cp;
+				conv_ = false;
+			}
 			void font(const font_type& cp) { font_ = cp; }
 			void decorate(size_type cp) { decorate_ = cp; }
 			void scale(size_type cp) { scale_ = cp; }
@@ -107,6 +130,8 @@ namespace faml {
 			size_type scale_;
 			int baseline_;
 			bool ascii_;
+			mutable string_type utf16_;
+			mutable bool conv_;
 		};
 		
 		/* ----------------------------------------------------------------- */
@@ -226,7 +251,7 @@ namespace faml {
 			basic_paragraph& xassign(XMLNode* root) {
 				if (root) {
 					attr_ptr attr = root->first_attribute(LITERAL("lvl"));
-					if (attr && attr->value_size() > 0) level_ = clx::lexical_cast<size_type>(attr->value());
+					if (attr && attr->value_size() > 0) level_ = officex::number_cast<size_type>(attr->value());
 				}
 				
 				if (level_ >= style_.size()) return *this;
@@ -255,7 +280,7 @@ namespace faml {
 				if (string_type(root->name()) == LITERAL("a:endParaRPr")) {
 					attr_ptr attr = root->first_attribute(LITERAL("sz"));
 					if (attr && attr->value_size() > 0) {
-						f.size(clx::lexical_cast<double>(attr->value()) / 100.0);
+						f.size(officex::number_cast<double>(attr->value()) / 100.0);
 					}
 					
 					if (v_.empty()) {
@@ -311,12 +336,12 @@ namespace faml {
 						attr = pos->first_attribute(LITERAL("sz"));
 						if (!attr) attr = pos->first_attribute(LITERAL("szCs"));
 						if (attr && attr->value_size() > 0) {
-							f.size(clx::lexical_cast<double>(attr->value()) / 100.0);
-							//font_.size(clx::lexical_cast<double>(attr->value()) / 100.0);
+							f.size(officex::number_cast<double>(attr->value()) / 100.0);
+							//font_.size(officex::number_cast<double>(attr->value()) / 100.0);
 						}
 						
 						attr = pos->first_attribute(LITERAL("baseline"));
-						if (attr && attr->value_size() > 0) elem.baseline(clx::lexical_cast<int>(attr->value()));
+						if (attr && attr->value_size() > 0) elem.baseline(officex::number_cast<int>(attr->value()));
 						attr = pos->first_attribute(LITERAL("b"));
 						if (attr) deco |= 0x01;
 						attr = pos->first_attribute(LITERAL("i"));
@@ -388,13 +413,13 @@ namespace faml {
 					// indent
 					attr = root->first_attribute(LITERAL("indent"));
 					if (attr && attr->value_size() > 0) {
-						double tmp = clx::lexical_cast<double>(attr->value());
+						double tmp = officex::number_cast<double>(attr->value());
 						if (tmp > 0.0) indent_ = tmp;
 					}
 					
 					// default tab size
 					attr = root->first_attribute(LITERAL("defTabSz"));
-					if (attr && attr->value_size() > 0) tab_ = clx::lexical_cast<double>(attr->value());
+					if (attr && attr->value_size() > 0) tab_ = officex::number_cast<double>(attr->value());
 					
 					// baseline
 					node_ptr pos = root->first_node(LITERAL("a:lnSpc"));
@@ -403,7 +428,7 @@ namespace faml {
 						attr = pos->first_attribute(LITERAL("val"));
 						if (attr && attr->value_size() > 0) {
 							try {
-								int per = clx::lexical_cast<int>(attr->value());
+								int per = officex::number_cast<int>(attr->value());
 								baseline_ = 1.0 + per / (1000.0 * 100.0);
 							}
 							catch (clx::bad_lexical_cast& e) {
@@ -419,7 +444,7 @@ namespace faml {
 						attr = pos->first_attribute(LITERAL("val"));
 						if (attr && attr->value_size() > 0) {
 							try {
-								int per = clx::lexical_cast<int>(attr->value());
+								int per = officex::number_cast<int>(attr->value());
 								before_ = per / (1000.0 * 100.0);
 							}
 							catch (clx::bad_lexical_cast& e) {
@@ -435,7 +460,7 @@ namespace faml {
 						attr = pos->first_attribute(LITERAL("val"));
 						if (attr && attr->value_size() > 0) {
 							try {
-								int per = clx::lexical_cast<int>(attr->value());
+								int per = officex::number_cast<int>(attr->value());
 								after_ = per / (1000.0 * 100.0);
 							}
 							catch (clx::bad_lexical_cast& e) {
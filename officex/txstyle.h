@@ -39,6 +39,7 @@
 #include "rapidxml/rapidxml.hpp"
 #include "clx/literal.h"
 #include "clx/lexical_cast.h"
+#include "number.h"
 #include "color.h"
 #include "utility.h"
 #include "font.h"
@@ -100,7 +101,7 @@ namespace faml {
 				
 				// 1. left margin
 				attr_ptr attr = root->first_attribute(LITERAL("marL"));
-				if (attr && attr->value_size() > 0) indent_ = clx::lexical_cast<double>(attr->value());
+				if (attr && attr->value_size() > 0) indent_ = officex::number_cast<double>(attr->value());
 				
 				// 2. align
 				attr = root->first_attribute(LITERAL("algn"));
@@ -110,7 +111,7 @@ namespace faml {
 				node_ptr pos = root->first_node(LITERAL("a:defRPr"));
 				if (pos) {
 					attr = pos->first_attribute(LITERAL("sz"));
-					if (attr && attr->value_size() > 0) font_.size(clx::lexical_cast<double>(attr->value()) / 100.0);
+					if (attr && attr->value_size() > 0) font_.size(officex::number_cast<double>(attr->value()) / 100.0);
 					
 					size_type c = 0;
 					if (pos->first_node(LITERAL("a:solidFill"))) {
@@ -185,7 +186,7 @@ namespace faml {
 				if (pos) {
 					attr = pos->first_attribute(LITERAL("val"));
 					if (attr && attr->value_size() > 0) {
-						busize_ = clx::lexical_cast<double>(attr->value()) / 1000.0 / 100.0;
+						busize_ = officex::number_cast<double>(attr->value()) / 1000.0 / 100.0;
 					}
 				}
 				
@@ -151,6 +151,21 @@ namespace faml {
 			std::basic_string<CharT> tmp(s);
 			return getvalign(tmp);
 		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  localname
+		 *
+		 *  Returns the tag name without the namespace prefix (e.g.,
+		 *  "a:moveTo" -> "moveTo").
+		 */
+		/* ----------------------------------------------------------------- */
+		template <class Ch, class Tr>
+		inline std::basic_string<Ch, Tr> localname(const std::basic_string<Ch, Tr>& s) {
+			typename std::basic_string<Ch, Tr>::size_type pos = s.find(LITERAL(":"));
+			if (pos == std::basic_string<Ch, Tr>::npos) return s;
+			return s.substr(pos + 1);
+		}
 	}
 }
 
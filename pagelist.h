@@ -90,6 +90,7 @@ namespace faml {
 			}
 			
 			size_type index() const { return index_; }
+			size_type size() const { return kids_.size(); }
 			
 		private:
 			typedef clx::basic_format<CharT, Traits> fmt;
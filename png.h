@@ -43,6 +43,7 @@
 #include <sstream>
 #include "image.h"
 #include "utility.h"
+#include "resample.h"
 #include <clx/mpl/bitmask.h>
 #include "clx/literal.h"
 #include "clx/format.h"
@@ -80,11 +81,13 @@ namespace faml {
 			
 			png_resource(const png_resource& cp) :
 				in_(cp.in_), index_(cp.index_), label_(cp.label()),
-				size_(cp.size_), width_(cp.width_), height_(cp.height_), colors_(cp.colors_) {}
+				size_(cp.size_), width_(cp.width_), height_(cp.height_), colors_(cp.colors_),
+				dpi_(cp.dpi_), pw_(cp.pw_), ph_(cp.ph_), ow_(cp.ow_), oh_(cp.oh_) {}
 			
 			png_resource(istream_type& in) :
 				in_(in), index_(0), label_(),
-				size_(0), width_(0), height_(0), colors_() {
+				size_(0), width_(0), height_(0), colors_(),
+				dpi_(0.0), pw_(0.0), ph_(0.0), ow_(0), oh_(0) {
 				label_ = makelabel(LITERAL("Im"));
 			}
 			
@@ -92,10 +95,32 @@ namespace faml {
 			bool operator()(OutStream& out, PDFManager& pm) {
 				if (in_.bad()) throw std::runtime_error("cannot find input file");
 				this->xproperty(in_);
+				
+				// Indexed colors cannot be averaged, so palette images are kept.
+				std::pair<size_type, size_type> sz(width_, height_);
+				if (colors_.empty()) sz = resample_size(width_, height_, pw_, ph_, dpi_);
+				ow_ = sz.first;
+				oh_ = sz.second;
+				
 				this->xobject(out, pm);
 				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  downsample
+			 *
+			 *  Shrinks the image so that its resolution does not exceed
+			 *  dpi when it is placed at (width x height) points. The
+			 *  method must be called before the resource is written.
+			 */
+			/* ------------------------------------------------------------- */
+			void downsample(double dpi, double width, double height) {
+				dpi_ = dpi;
+				pw_ = width;
+				ph_ = height;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  Access methods (get).
 			/* ------------------------------------------------------------- */
@@ -105,6 +130,11 @@ namespace faml {
 			size_type width() const { return width_; }
 			size_type height() const { return height_; }
 			
+			/* ------------------------------------------------------------- */
+			//  Access methods (set).
+			/* ------------------------------------------------------------- */
+			void label(const string_type& cp) { label_ = cp; }
+			
 		private:
 			typedef clx::basic_format<CharT, Traits> fmt;
 			typedef std::vector<byte_type> byte_array;
@@ -117,6 +147,11 @@ namespace faml {
 			size_type height_;
 			std::vector<size_type> colors_;
 			std::vector<byte_type> alphas_;
+			double dpi_;
+			double pw_;
+			double ph_;
+			size_type ow_; // width of the written image
+			size_type oh_; // height of the written image
 			
 			byte_type type_;
 			byte_type depth_;
@@ -136,8 +171,8 @@ namespace faml {
 				out << LITERAL("/Type /XObject") << std::endl;
 				out << LITERAL("/Subtype /Image") << std::endl;
 				out << LITERAL("/Name /") << label_ << std::endl;
-				out << LITERAL("/Width ") << width_ << std::endl;
-				out << LITERAL("/Height ") << height_ << std::endl;
+				out << LITERAL("/Width ") << ow_ << std::endl;
+				out << LITERAL("/Height ") << oh_ << std::endl;
 				out << LITERAL("/BitsPerComponent 8") << std::endl;
 				out << LITERAL("/Filter [ /FlateDecode ]") << std::endl;
 				if (colors_.empty()) out << LITERAL("/ColorSpace /DeviceRGB") << std::endl;
@@ -216,15 +251,30 @@ namespace faml {
 				std::cout << "size: " << data.size() << std::endl;
 				clx::basic_ivstream<CharT, Traits> vs(data);
 				
+				bool status = true;
+				if (ow_ == width_ && oh_ == height_) status = this->xrows(ozf, vs);
+				else {
+					basic_resampler<zstream> rs(ozf, width_, height_, ow_, oh_, 3);
+					status = this->xrows(rs, vs);
+					rs.finish();
+				}
+				ozf.finish();
+				return status;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xrows
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			bool xrows(OutStream& out, istream_type& in) {
 				size_type bpp = this->xbpp(type_, depth_);
 				size_type size = (depth_ * width_ * this->xbytes(type_) + 7) / 8;
 				byte_array prev, line;
 				for (size_type i = 0; i < height_; ++i) {
-					if (!this->xdecode(vs, line, size, bpp, prev)) return false;
-					this->xwrite(ozf, line);
+					if (!this->xdecode(in, line, size, bpp, prev)) return false;
+					this->xwrite(out, line);
 					prev.assign(line.begin(), line.end());
 				}
-				ozf.finish();
 				return true;
 			}
 			
@@ -577,12 +627,14 @@ namespace faml {
 				in_(cp.in_), index_(cp.index_), label_(cp.label()),
 				size_(cp.size_), width_(cp.width_), width_prev_(cp.width_prev_),
 				height_(cp.height_), height_prev_(cp.height_prev_),
-				colors_(cp.colors_), alphas_(cp.alphas_) {}
+				colors_(cp.colors_), alphas_(cp.alphas_),
+				dpi_(cp.dpi_), pw_(cp.pw_), ph_(cp.ph_), ow_(cp.ow_), oh_(cp.oh_) {}
 			
 			alpha_png_resource(istream_type& in) :
 				in_(in), index_(0), label_(),
 				size_(0), width_(0), width_prev_(0),
-				height_(0), height_prev_(0), colors_(), alphas_() {
+				height_(0), height_prev_(0), colors_(), alphas_(),
+				dpi_(0.0), pw_(0.0), ph_(0.0), ow_(0), oh_(0) {
 				label_ = makelabel(LITERAL("Im"));
 			}
 			
@@ -590,10 +642,29 @@ namespace faml {
 			bool operator()(OutStream& out, PDFManager& pm) {
 				if (in_.bad()) throw std::runtime_error("cannot find input file");
 				this->xproperty(in_);
+				
+				// Only the opaque true color images are resampled, because
+				// the alpha images are padded to 2^n * 2^n (see xproperty).
+				std::pair<size_type, size_type> sz(width_, height_);
+				if (colors_.empty() && !(type_ & 0x04)) {
+					sz = resample_size(width_, height_, pw_, ph_, dpi_);
+				}
+				ow_ = sz.first;
+				oh_ = sz.second;
+				
 				this->xobject(out, pm);
 				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			//  downsample
+			/* ------------------------------------------------------------- */
+			void downsample(double dpi, double width, double height) {
+				dpi_ = dpi;
+				pw_ = width;
+				ph_ = height;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  Access methods (get).
 			/* ------------------------------------------------------------- */
@@ -628,6 +699,11 @@ namespace faml {
 			//std::string alpha_string_;
 			std::vector<char_type> alpha_string_;
 			size_type pic_len_;
+			double dpi_;
+			double pw_;
+			double ph_;
+			size_type ow_; // width of the written image
+			size_type oh_; // height of the written image
 			
 			/* ------------------------------------------------------------- */
 			//  xobject
@@ -641,8 +717,8 @@ namespace faml {
 				out << LITERAL("/Type /XObject") << std::endl;
 				out << LITERAL("/Subtype /Image") << std::endl;
 				out << LITERAL("/Name /") << label_ << std::endl;
-				out << LITERAL("/Width ") << width_ << std::endl;
-				out << LITERAL("/Height ") << height_ << std::endl;
+				out << LITERAL("/Width ") << ow_ << std::endl;
+				out << LITERAL("/Height ") << oh_ << std::endl;
 				//out << LITERAL("/Width ") << pic_len_ << std::endl;
 				//out << LITERAL("/Height ") << pic_len_ << std::endl;
 				//if ((type_ & 0x02) && (type_ & 0x04)) {
@@ -794,17 +870,16 @@ namespace faml {
 				if (!this->xgetdata(in, data)) return false;
 				clx::basic_ivstream<CharT, Traits> vs(data);
 				
-				size_type bpp = this->xbpp(type_, depth_);
-				size_type size = (depth_ * width_prev_ * this->xbytes(type_) + 7) / 8;
-				byte_array prev, line;
-				for (size_type i = 0; i < height_prev_; ++i) {
-					if (!this->xdecode(vs, line, size, bpp, prev)) return false;
-					this->xwrite(ozf, line);
-					prev.assign(line.begin(), line.end());
-					//out << std::endl;
-					//if (type_ & 0x04) alpha_string_ += "\n";
+				if (ow_ != width_ || oh_ != height_) {
+					basic_resampler<zstream> rs(ozf, width_, height_, ow_, oh_, 3);
+					bool status = this->xrows(rs, vs);
+					rs.finish();
+					ozf.finish();
+					return status;
 				}
 				
+				if (!this->xrows(ozf, vs)) return false;
+				
 				// Alpha pading
 				//if (type_ & 0x04) {
 				if ((type_ & 0x02) && (type_ & 0x04)) {
@@ -834,6 +909,22 @@ namespace faml {
 				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			//  xrows
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			bool xrows(OutStream& out, istream_type& in) {
+				size_type bpp = this->xbpp(type_, depth_);
+				size_type size = (depth_ * width_prev_ * this->xbytes(type_) + 7) / 8;
+				byte_array prev, line;
+				for (size_type i = 0; i < height_prev_; ++i) {
+					if (!this->xdecode(in, line, size, bpp, prev)) return false;
+					this->xwrite(out, line);
+					prev.assign(line.begin(), line.end());
+				}
+				return true;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  xbytes
 			/* ------------------------------------------------------------- */
@@ -30,9 +30,13 @@
 #include "font.h"
 #include "font_instance.h"
 #include "text_helper.h"
+#include "resample.h"
+#include "profile.h"
+#include "shape_cache.h"
 
 #include "contents/shape_factory.h"
 #include "contents/custom_shape.h"
+#include "officex/preset.h"
 #include "contents/wmf.h"
 #include "contents/barchart.h"
 #include "contents/bar3dchart_box.h"
@@ -49,6 +53,7 @@
 #include "contents/scatterchart.h"
 #include "contents/table.h"
 #include "text_contents.h"
+#include "text_state.h"
 #include "image_contents.h"
 
 #include "pptx/document.h"
@@ -78,27 +83,77 @@ namespace faml {
 			typedef basic_font<CharT, Traits> font_object;
 			typedef std::map<string_type, font_object> font_map;
 			
+			typedef faml::pptx::basic_document<CharT, Traits> doc_type;
+			typedef faml::officex::basic_preset_geometry<CharT, Traits> preset_type;
+			typedef typename doc_type::storage_type storage_type;
+			
 			basic_pptx(const string_type& path, font_factory& ff) :
-				ff_(ff), doc_(path), in_(), pp_(slide::width, slide::height), f_(),
-				baseline_(1.2), wordsp_(0.0) {
-				this->xinit(path);
+				ff_(ff), doc_(storage_type(path)), in_(), pp_(slide::width, slide::height), f_(),
+				baseline_(1.2), wordsp_(0.0), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  constructor
+			 *
+			 *  The following constructors read the pptx data from the
+			 *  input stream, the memory buffer, or the file descriptor
+			 *  without creating any temporary file. The memory buffer is
+			 *  not copied, so it must be alive until the conversion is
+			 *  finished.
+			 */
+			/* ------------------------------------------------------------- */
+			basic_pptx(std::basic_istream<CharT, Traits>& in, font_factory& ff) :
+				ff_(ff), doc_(storage_type(in)), in_(), pp_(slide::width, slide::height), f_(),
+				baseline_(1.2), wordsp_(0.0), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			basic_pptx(const char_type* data, size_type n, font_factory& ff) :
+				ff_(ff), doc_(storage_type(data, n)), in_(), pp_(slide::width, slide::height), f_(),
+				baseline_(1.2), wordsp_(0.0), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			basic_pptx(int fd, font_factory& ff) :
+				ff_(ff), doc_(storage_type(fd)), in_(), pp_(slide::width, slide::height), f_(),
+				baseline_(1.2), wordsp_(0.0), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
 			}
 			
 			template <class OutStream, class PDFManager>
 			bool operator()(OutStream& out, PDFManager& pm) {
 				// currently implementation
-				for (typename font_map::iterator pos = f_.begin(); pos != f_.end(); ++pos) {
-					(pos->second)(out, pm);
+				{
+					scoped_phase<PDFManager> phase(pm, "font");
+					for (typename font_map::iterator pos = f_.begin(); pos != f_.end(); ++pos) {
+						(pos->second)(out, pm);
+					}
+				}
+				
+				place_.clear();
+				if (dpi_ > 0.0) {
+					place_.add(doc_.master().bgimage(), pp_.width(), pp_.height());
+					for (size_type i = 0; i < doc_.size(); ++i) {
+						this->xplacement(doc_.at(i).layout());
+						this->xplacement(doc_.at(i));
+					}
+					doc_.release();
 				}
 				
 				for (size_type i = 0; i < doc_.size(); ++i) {
+					scoped_page<PDFManager> timer(pm);
 					cur_.page = i;
 					clx::logger::debug(DEBUGF("[SLIDE] %d", i));
 					page_object newpage(pp_);
 					
-					this->xobjects(out, pm, doc_.master().bgimage());
-					this->xobjects(out, pm, doc_.at(i).layout());
-					this->xobjects(out, pm, doc_.at(i));
+					{
+						scoped_phase<PDFManager> phase(pm, "image");
+						this->xobjects(out, pm, doc_.master().bgimage());
+						this->xobjects(out, pm, doc_.at(i).layout());
+						this->xobjects(out, pm, doc_.at(i));
+					}
 					
 					int idx = 0;
 					idx = this->xcontents(out, pm, doc_.at(i));
@@ -107,20 +162,73 @@ namespace faml {
 					
 					if (!cur_.holder.empty()) this->xdelayed_objects(out, pm);
 					if (!cur_.fonts.empty()) this->xput_font_objects(out, pm);
+					if (!dibs_.empty() && !dibs_(out, pm, cur_.objs)) {
+						throw std::runtime_error("error is occured in metafile bitmap resource.");
+					}
+					if (!shapes_.empty() && !shapes_(out, pm, cur_.objs)) {
+						throw std::runtime_error("error is occured in shape resource.");
+					}
 					idx = this->xresources(out, pm);
 					if (idx < 0) throw std::runtime_error("something was happened in the contents object");
 					newpage.resources(idx);
 					
 					if (!newpage(out, pm)) return false;
+					doc_.release(); // slides are parsed on demand, see basic_document::at().
+				}
+				
+				// subsets of the embedded fonts are made from the used glyphs.
+				{
+					scoped_phase<PDFManager> phase(pm, "font");
+					for (typename font_map::iterator pos = f_.begin(); pos != f_.end(); ++pos) {
+						if (!(pos->second).finish(out, pm)) {
+							throw std::runtime_error("error is occured in font file resource.");
+						}
+					}
 				}
 				
 				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  dpi
+			 *
+			 *  Sets the maximum resolution of the embedded images. Images
+			 *  whose resolution at the placed size exceeds the value are
+			 *  downsampled. The value 0 (default) disables downsampling.
+			 */
+			/* ------------------------------------------------------------- */
+			void dpi(double value) { dpi_ = value; }
+			double dpi() const { return dpi_; }
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  resolution
+			 *
+			 *  Sets the resolution (dpi) of the device the pages are
+			 *  rendered on. Dense series of line, area and scatter charts
+			 *  are decimated at the resolution, so the drawn points differ
+			 *  by at most one device pixel. The value 0 (default) draws
+			 *  all points.
+			 */
+			/* ------------------------------------------------------------- */
+			void resolution(double value) { res_ = value; }
+			double resolution() const { return res_; }
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  presets
+			 *
+			 *  Sets the preset geometry read from presetShapeDefinitions.xml.
+			 *  Preset shapes that contents/ does not implement are drawn
+			 *  with the definitions. The object must be alive until the
+			 *  conversion is finished.
+			 */
+			/* ------------------------------------------------------------- */
+			void presets(preset_type& cp) { presets_ = &cp; }
+			
 		private:
 			typedef clx::basic_format<CharT, Traits> fmt;
-			typedef clx::basic_unzip<CharT, Traits> storage_type;
-			typedef faml::pptx::basic_document<CharT, Traits> doc_type;
 			typedef basic_font_property<CharT, Traits> font_property;
 			typedef basic_holder<CharT, Traits> holder_type;
 			typedef basic_shading<CharT, Traits> shading_type;
@@ -129,6 +237,7 @@ namespace faml {
 			
 			// contents
 			typedef basic_text_contents<CharT, Traits> text_contents;
+			typedef basic_text_state<CharT, Traits> text_state;
 			typedef basic_image_contents<CharT, Traits> image_contents;
 			typedef contents::basic_table<CharT, Traits> table_contents;
 			typedef contents::basic_shape<CharT, Traits> shape_contents;
@@ -142,6 +251,10 @@ namespace faml {
 			font_map f_;
 			double baseline_;
 			double wordsp_;
+			double dpi_;
+			double res_;
+			preset_type* presets_;
+			basic_placement<CharT, Traits> place_;
 			
 			
 			/* ------------------------------------------------------------- */
@@ -160,6 +273,8 @@ namespace faml {
 					width(0.0), worigin(0.0), height(0.0), horigin(0.0) {}
 			};
 			std::map<string_type, xobj_type> objs_;
+			basic_dib_cache<CharT, Traits> dibs_; // bitmaps in metafiles
+			basic_shape_cache<CharT, Traits> shapes_; // shapes and chart markers painted repeatedly
 			
 			/* ------------------------------------------------------------- */
 			/*
@@ -188,18 +303,19 @@ namespace faml {
 				std::deque<xobj_type> shadings;
 				std::deque<xobj_type> alphas;
 				holder_type holder;
+				text_state* ts;				// state of the content stream being written
 				
 				current_status() :
 					x(0), y(0), width(0), height(0),
 					hpad(0.0), vpad(0.0), page(0), max_font_size(0.0),
-					fused(), fonts(), labels(), pieces(), objs(), shadings(), alphas(), holder() {}
+					fused(), fonts(), labels(), pieces(), objs(), shadings(), alphas(), holder(), ts(NULL) {}
 			};
 			current_status cur_;
 			
 			/* ------------------------------------------------------------- */
 			//  xinit
 			/* ------------------------------------------------------------- */
-			void xinit(const string_type& path) {
+			void xinit() {
 				//string_type latin(LITERAL(PPTX_DEFAULT_LATIN));
 				//string_type japan(LITERAL(PPTX_DEFAULT_JAPAN));
 				string_type mono(LITERAL(PPTX_DEFAULT_MONO));
@@ -221,7 +337,8 @@ namespace faml {
 				cur_.hpad = 3.7;
 				cur_.vpad = 3.7;
 				
-				if (!in_.open(path)) throw std::runtime_error("cannot find pptx file");
+				in_ = doc_.storage();
+				if (!in_.is_open()) throw std::runtime_error("cannot find pptx file");
 			}
 			
 			/* ------------------------------------------------------------- */
@@ -234,6 +351,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager>
 			int xresources(OutStream& out, PDFManager& pm) {
+				scoped_phase<PDFManager> phase(pm, "resource");
 				int index = static_cast<int>(pm.newindex());
 				
 				string_type proc = LITERAL("/PDF /Text");
@@ -298,6 +416,21 @@ namespace faml {
 				return index;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xplacement
+			 *
+			 *  Collects the largest size at which each image is placed
+			 *  (the size is used to determine the resolution of images).
+			 */
+			/* ------------------------------------------------------------- */
+			template <class Source>
+			void xplacement(const Source& src) {
+				for (size_type i = 0; i < src.size(); ++i) {
+					place_.add(src.at(i).reference(), emu(src.at(i).width()), emu(src.at(i).height()));
+				}
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  xobjects
 			/* ------------------------------------------------------------- */
@@ -317,8 +450,11 @@ namespace faml {
 				
 				xobj_type elem;
 				elem.path = pos->path();
+				double pw = 0.0, ph = 0.0;
+				place_.find(ref, pw, ph);
 				if (ext == LITERAL(".jpeg") || ext == LITERAL(".jpg")) {
 					jpeg_resource<CharT, Traits> jpeg(vs);
+					jpeg.downsample(dpi_, pw, ph);
 					if (!jpeg(out, pm)) throw std::runtime_error("error is occured in jpeg resource.");
 					elem.index = jpeg.index();
 					elem.label = jpeg.label();
@@ -326,6 +462,7 @@ namespace faml {
 				else if (ext == LITERAL(".png")) {
 #if 1
 					alpha_png_resource<CharT, Traits> png(vs);
+					png.downsample(dpi_, pw, ph);
 					if (!png(out, pm)) throw std::runtime_error("error is occured in png resource.");
 					elem.index = png.index();
 					elem.label = png.label();
@@ -335,6 +472,7 @@ namespace faml {
 					elem.horigin = png.horigin();
 #else
 					png_resource<CharT, Traits> png(vs);
+					png.downsample(dpi_, pw, ph);
 					if (!png(out, pm)) throw std::runtime_error("error is occured in png resource.");
 					elem.index = png.index();
 					elem.label = png.label();
@@ -385,6 +523,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager>
 			bool xput_font_objects(OutStream& out, PDFManager& pm) {
+				scoped_phase<PDFManager> phase(pm, "font");
 				for (typename font_map::iterator pos = cur_.fonts.begin();
 					pos != cur_.fonts.end(); ++pos) {
 					(pos->second)(out, pm);
@@ -404,6 +543,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager, class SlideT>
 			int xcontents(OutStream& out, PDFManager& pm, const SlideT& src) {
+				scoped_phase<PDFManager> phase(pm, "contents");
 				//cur_.fused.clear();
 				std::basic_stringstream<CharT, Traits> ss;
 				string_type filter;
@@ -456,6 +596,13 @@ namespace faml {
 					else {
 						sh = contents::makeshape(src.at(i).name(),
 							coordinate(cur_.x, cur_.y - cur_.height), cur_.width, cur_.height);
+						const paths_type* paths = NULL;
+						if (!sh && presets_ &&
+							(paths = presets_->find(src.at(i).name(), src.at(i).adjusts(), cur_.width, cur_.height))) {
+							sh = shape_ptr(new contents::basic_custom_shape<paths_type>(
+								coordinate(cur_.x, cur_.y - cur_.height), cur_.width, cur_.height));
+							dynamic_cast<contents::basic_custom_shape<paths_type>* >(sh.get())->paths(*paths);
+						}
 					}
 					if (!sh) continue;
 					
@@ -514,7 +661,8 @@ namespace faml {
 						pos != src.at(i).effects().end(); ++pos) {
 						sh->effect(pos->first, pos->second);
 					}
-					(*sh)(out);
+					cur_.ts->end(out);
+					shapes_.put(out, *sh);
 					
 					// put object
 					if (!ref.empty()) {
@@ -555,6 +703,13 @@ namespace faml {
 					else {
 						sh = contents::makeshape(src.at(i).name(),
 							coordinate(cur_.x, cur_.y - cur_.height), cur_.width, cur_.height);
+						const paths_type* paths = NULL;
+						if (!sh && presets_ &&
+							(paths = presets_->find(src.at(i).name(), src.at(i).adjusts(), cur_.width, cur_.height))) {
+							sh = shape_ptr(new contents::basic_custom_shape<paths_type>(
+								coordinate(cur_.x, cur_.y - cur_.height), cur_.width, cur_.height));
+							dynamic_cast<contents::basic_custom_shape<paths_type>* >(sh.get())->paths(*paths);
+						}
 					}
 					if (!sh) continue;
 					
@@ -626,7 +781,8 @@ namespace faml {
 						sh->effect(pos->first, pos->second);
 					}
 					
-					(*sh)(out);
+					cur_.ts->end(out);
+					shapes_.put(out, *sh);
 					
 					// put object
 					if (!ref.empty()) {
@@ -652,6 +808,9 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class SlideT>
 			bool xputstream(OutStream& out, const SlideT& src) {
+				text_state ts;
+				cur_.ts = &ts;
+				
 				//this->xputmaster(out);
 				this->xput_background(out, src);
 				
@@ -661,6 +820,8 @@ namespace faml {
 				// put table
 				for (size_type i = 0; i < src.tbls().size(); ++i) this->xput_table(out, src.tbls().at(i));
 				
+				ts.end(out);
+				cur_.ts = NULL;
 				return true;
 			}
 			
@@ -688,18 +849,23 @@ namespace faml {
 				case 2:
 				{
 					contents::linechart<chart_type> ch(coordinate(x, y - h), w, h);
+					ch.marks(shapes_);
+					ch.resolution(res_ / 72.0);
 					this->xputchart_exec(out, src, pos, ch);
 					break;
 				}
 				case 4:
 				{
 					contents::areachart<chart_type> ch(coordinate(x, y - h), w, h);
+					ch.resolution(res_ / 72.0);
 					this->xputchart_exec(out, src, pos, ch);
 					break;
 				}
 				case 5:
 				{
 					contents::scatterchart<chart_type> ch(coordinate(x, y - h), w, h);
+					ch.marks(shapes_);
+					ch.resolution(res_ / 72.0);
 					this->xputchart_exec(out, src, pos, ch);
 					break;
 				}
@@ -781,7 +947,9 @@ namespace faml {
 				
 				ch.data(src.charts().at(pos));
 				if (doc_.theme()) ch.palette(doc_.theme()->palette().data());
+				cur_.ts->end(out);
 				ch(out);
+				cur_.ts->invalidate();
 				
 				return true;
 			}
@@ -812,6 +980,9 @@ namespace faml {
 				table_contents tbl;
 				tbl.origin() = coordinate(ox, oy);
 				std::basic_stringstream<CharT, Traits> ss; // stored text.
+				text_state ts; // state of ss, which is written after the table.
+				text_state* prev = cur_.ts;
+				cur_.ts = &ts;
 				
 				cur_.x = ox;
 				cur_.y = oy;
@@ -851,8 +1022,12 @@ namespace faml {
 				cur_.width = width;
 				
 				// finalize
+				ts.end(ss);
+				cur_.ts = prev;
+				cur_.ts->end(out);
 				tbl(out);
 				out << ss.str();
+				*cur_.ts = ts;
 				return true;
 			}
 			
@@ -861,6 +1036,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class ShapeT>
 			bool xputimage(OutStream& out, const ShapeT& sh) {
+				cur_.ts->end(out);
 				if (objs_.find(sh.reference()) != objs_.end()) {
 					const xobj_type& ref = objs_[sh.reference()];
 #if 1
@@ -892,9 +1068,8 @@ namespace faml {
 					if (pos == in_.end()) throw std::runtime_error("cannot find image file");
 					std::vector<char_type> s;
 					clx::read(*pos, s);
-					clx::basic_ivstream<CharT, Traits> vs(s);
-					
-					contents::basic_wmf<CharT, Traits> wmf(vs);
+					if (s.empty()) throw std::runtime_error("empty metafile");
+					contents::basic_wmf<CharT, Traits> wmf(&s[0], s.size());
 					try {
 						wmf.read_header();
 					}
@@ -904,16 +1079,17 @@ namespace faml {
 					wmf.height(cur_.height);
 					wmf.font1st(f_[PPTX_DEFAULT_LATIN]);
 					wmf.font2nd(f_[PPTX_DEFAULT_JAPAN]);
+					wmf.images(dibs_);
 					wmf(out);
+					cur_.ts->invalidate();
 				}
 				else if (ext == LITERAL(".emf")) {
 					typename storage_type::iterator pos = in_.find(sh.reference());
 					if (pos == in_.end()) throw std::runtime_error("cannot find image file");
 					std::vector<char_type> s;
 					clx::read(*pos, s);
-					clx::basic_ivstream<CharT, Traits> vs(s);
-					
-					contents::basic_emf<CharT, Traits> emf(vs);
+					if (s.empty()) throw std::runtime_error("empty metafile");
+					contents::basic_emf<CharT, Traits> emf(&s[0], s.size());
 					try {
 						emf.read_header();
 					}
@@ -922,6 +1098,7 @@ namespace faml {
 					emf.width(cur_.width);
 					emf.height(cur_.height);
 					emf(out);
+					cur_.ts->invalidate();
 				}
 				
 				return true;
@@ -953,11 +1130,7 @@ namespace faml {
 				size_type dest = 0;
 				string_type s;
 				for (size_type j = 0; j < p.size(); ++j) {
-					if (!p.at(j).data().empty()) {
-						std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(p.at(j).data());
-						//s += win32conv(tmp.begin(), tmp.end());
-						s += to_narrow(tmp.begin(), tmp.end());
-					}
+					if (!p.at(j).data().empty()) s += p.at(j).utf16();
 					
 					if (s.size() >= 2 && s.at(s.size() - 2) == 0x00 &&
 						(s.at(s.size() - 1) == 0x0a || s.at(s.size() - 1) == 0x0d || s.at(s.size() - 1) == 0x0c)) {
@@ -976,12 +1149,13 @@ namespace faml {
 							//double width = cur_.width - 2.0 * 2;
 							double width = cur_.width - cur_.hpad * 2;
 							int limit = static_cast<int>(width / size * 1000);
-							int result = 0;
-							if (is_ascii(it, s.end(), charset::utf16)) {
-								result = h.getline(it, s.end(), std::inserter(line, line.end()), limit);
-							}
-							else result = hj.getline(it, s.end(), std::inserter(line, line.end()), limit);
-							this->xadjust_tail(it, s.end(), line, limit - result);
+							size_type result = 0, lw = 0;
+							typename string_type::iterator next = is_ascii(it, s.end(), charset::utf16)
+								? h.breakline(it, s.end(), limit, result, lw)
+								: hj.breakline(it, s.end(), limit, result, lw);
+							line.assign(it, next);
+							it = next;
+							this->xadjust_tail(it, s.end(), line, limit - static_cast<int>(result));
 							++dest;
 							if (it == s.end()) break;
 						}
@@ -1003,12 +1177,13 @@ namespace faml {
 						//double width = cur_.width - 2.0 * 2;
 						double width = cur_.width - cur_.hpad * 2;
 						int limit = static_cast<int>(width / size * 1000);
-						int result = 0;
-						if (is_ascii(it, s.end(), charset::utf16)) {
-							result = h.getline(it, s.end(), std::inserter(line, line.end()), limit, false);
-						}
-						else result = hj.getline(it, s.end(), std::inserter(line, line.end()), limit, false);
-						this->xadjust_tail(it, s.end(), line, limit - result);
+						size_type result = 0, lw = 0;
+						typename string_type::iterator next = is_ascii(it, s.end(), charset::utf16)
+							? h.breakline(it, s.end(), limit, result, lw, false)
+							: hj.breakline(it, s.end(), limit, result, lw, false);
+						line.assign(it, next);
+						it = next;
+						this->xadjust_tail(it, s.end(), line, limit - static_cast<int>(result));
 						++dest;
 						if (it == s.end()) break;
 					}
@@ -1069,10 +1244,7 @@ namespace faml {
 						}
 						else if (!p.bullet().empty()) {
 							double size = p.font().size() * PPTX_FONT_SCALE;
-							std::basic_string<wchar_t> tmp;
-							tmp = babel::utf8_to_unicode(p.bullet());
-							//string_type s = win32conv(tmp.begin(), tmp.end());
-							string_type s = to_narrow(tmp.begin(), tmp.end());
+							string_type s = utf8_to_utf16be(p.bullet());
 							
 							text_helper h(f_[PPTX_DEFAULT_JAPAN].property(), charset::utf16);
 							double n = h.width(s.begin(), s.end()) / 1000.0;
@@ -1147,9 +1319,7 @@ namespace faml {
 						}
 						else if (!p.bullet().empty()) {
 							double size = p.font().size() * PPTX_FONT_SCALE;
-							std::basic_string<wchar_t> tmp;
-							tmp = babel::utf8_to_unicode(p.bullet());
-							string_type s = to_narrow(tmp.begin(), tmp.end());
+							string_type s = utf8_to_utf16be(p.bullet());
 							
 							text_helper h(f_[PPTX_DEFAULT_MONO].property(), charset::utf16);
 							double n = h.width(s.begin(), s.end()) / 1000.0;
@@ -1172,6 +1342,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class Source>
 			bool xput_text_piece(OutStream& out, const Source& src, size_type pos, double ox) {
+				scoped_timer timer("text");
 				double size = src.at(pos).font().size() * PPTX_FONT_SCALE;
 				double vpos = cur_.max_font_size * PPTX_FONT_SCALE - size;
 				double baseline = baseline_;
@@ -1210,8 +1381,7 @@ namespace faml {
 				clx::logger::debug(DEBUGF("UseFont: %s -> %s (%f pt)",
 					name.c_str(), f_[name].property().name().c_str(), src.at(pos).font().size()));
 				
-				std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(s);
-				s = to_narrow(tmp.begin(), tmp.end());
+				s = utf8_to_utf16be(s);
 				typename string_type::iterator it = s.begin();
 				
 				while (1) {
@@ -1226,13 +1396,22 @@ namespace faml {
 						width = cur_.width - (cur_.x - ox) - cur_.hpad;
 						limit = static_cast<int>(width / size * 1000);
 					}
-					int result = h.getline(it, s.end(), std::inserter(line, line.end()), limit, false);
+					size_type u = 0, lw = 0;
+					typename string_type::iterator next = h.breakline(it, s.end(), limit, u, lw, false);
+					line.assign(it, next);
+					it = next;
+					
+					int result = static_cast<int>(u);
 					clx::logger::trace(TRACEF("limit: %d, result: %d", limit, result));
 					
-					if (it != s.end()) this->xadjust_tail(it, s.end(), line, limit - result);
+					if (it != s.end()) {
+						size_type prev = line.size();
+						this->xadjust_tail(it, s.end(), line, limit - result);
+						if (line.size() > prev) lw += h.width(line.begin() + prev, line.end());
+					}
 					else if (line.empty()) break;
 
-					double n = h.width(line.begin(), line.end()) / 1000.0;
+					double n = lw / 1000.0;
 					//double sp = width - n * size;
 					size_type rgb = src.at(pos).font().rgb();
 					if (rgb > 0x00ffffff) rgb = 0;
@@ -1254,6 +1433,7 @@ namespace faml {
 					size_type rise = (src.at(pos).baseline() != 0) ? size * 0.7 * 0.2 : size * 0.2;
 					text_contents txt(line, coordinate(cur_.x, cur_.y - vpos + rise), f_[name]);
 					//text_contents txt(line, coordinate(cur_.x, cur_.y + vpos), f_[name]);
+					txt.state(*cur_.ts);
 					txt.font_size(size);
 					txt.font_color(color(rgb));
 					txt.decorate(deco);
@@ -1303,11 +1483,9 @@ namespace faml {
 				if (!src.empty() && src.at(0).font().size() != src.font().size()) {
 					size = src.at(0).font().size() * PPTX_FONT_SCALE;
 				}
-				std::basic_string<wchar_t> tmp;
-				if (!src.bullet().empty()) tmp = babel::utf8_to_unicode(src.bullet());
-				else tmp = bu[src.level()];
-				//string_type s = win32conv(tmp.begin(), tmp.end());
-				string_type s = to_narrow(tmp.begin(), tmp.end());
+				string_type s = (!src.bullet().empty())
+					? utf8_to_utf16be(src.bullet())
+					: to_narrow(bu + src.level(), bu + src.level() + 1);
 				
 				text_helper h(f_[PPTX_DEFAULT_MONO].property(), charset::utf16);
 				double n = h.width(s.begin(), s.end()) / 1000.0;
@@ -1332,6 +1510,7 @@ namespace faml {
 				size_type rise = size * src.busize() * 0.2;
 				text_contents txt(s, coordinate(x, y + rise), f_[PPTX_DEFAULT_MONO]);
 				//text_contents txt(s, coordinate(x, y), f_[PPTX_DEFAULT_MONO]);
+				txt.state(*cur_.ts);
 				txt.font_size(size * src.busize());
 				txt.decorate(deco);
 				txt.font_color(color(rgb));
@@ -1346,6 +1525,7 @@ namespace faml {
 			template <class OutStream, class SlideT>
 			bool xput_background(OutStream& out, const SlideT& src) {
 				string_type sh;
+				cur_.ts->end(out);
 				if (!src.rgbs().empty()) {
 					out << LITERAL("q") << std::endl;
 					if (src.rgbs().size() > 1) {
@@ -1494,16 +1674,14 @@ namespace faml {
 					text_helper h(f_[latin].property(), charset::utf16);
 					text_helper hj(f_[japan].property(), charset::utf16);
 					
-					string_type s = src.at(i).data();
+					string_type s = src.at(i).utf16();
 					bool newline = false;
-					if (!s.empty() && (*s.rbegin() == 0x0a || *s.rbegin() == 0x0c || *s.rbegin() == 0x0d)) {
-						utf8::chomp(s);
+					while (s.size() >= 2 && s.at(s.size() - 2) == 0x00 &&
+						(s.at(s.size() - 1) == 0x0a || s.at(s.size() - 1) == 0x0d || s.at(s.size() - 1) == 0x0c)) {
+						s.erase(s.size() - 2);
 						newline = true;
 					}
 					
-					std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(s);
-					s = to_narrow(tmp.begin(), tmp.end());
-					
 					double w = (is_ascii(s.begin(), s.end(), charset::utf16))
 						? h.width(s.begin(), s.end())
 						: hj.width(s.begin(), s.end());
@@ -35,16 +35,22 @@
 #ifndef FAML_PPTX_DOCUMENT_H
 #define FAML_PPTX_DOCUMENT_H
 
+#include <map>
+#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
-#include "clx/unzip.h"
 #include "clx/literal.h"
+#include "clx/utility.h"
 #include "clx/shared_ptr.h"
 #include "clx/case_conv.h"
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
+#include "../officex/archive.h"
 #include "../officex/reference.h"
 #include "../officex/theme.h"
 #include "../officex/unit.h"
+#include "../officex/number.h"
 #include "../xlsx/chart.h"
 #include "slide.h"
 #include "master.h"
@@ -58,15 +64,16 @@ namespace faml {
 		>
 		class basic_document {
 		public:
-			typedef clx::basic_unzip<CharT, Traits> storage_type;
+			typedef faml::officex::basic_archive<CharT, Traits> storage_type;
 			typedef size_t size_type;
 			typedef CharT char_type;
 			typedef std::basic_string<CharT, Traits> string_type;
 			typedef basic_slide<CharT, Traits> value_type;
-			typedef std::vector<value_type> container;
-			typedef typename container::iterator iterator;
-			typedef typename container::const_iterator const_iterator;
+			typedef clx::shared_ptr<value_type> value_ptr;
 			typedef basic_master<CharT, Traits> master_type;
+			typedef clx::shared_ptr<master_type> master_ptr;
+			typedef basic_layout<CharT, Traits> layout_type;
+			typedef clx::shared_ptr<layout_type> layout_ptr;
 			typedef faml::officex::basic_txstyle<CharT, Traits> txstyle;
 			typedef std::vector<txstyle> txstyle_container;
 			
@@ -77,14 +84,26 @@ namespace faml {
 			typedef clx::shared_ptr<theme_type> theme_ptr;
 			
 			explicit basic_document(const string_type& path) :
-				v_(), width_(720.0), height_(540.0), in_(), theme_() {
+				size_(0), cur_(), pos_(0), width_(720.0), height_(540.0), in_(),
+				master_(), masters_(), layouts_(), theme_() {
 				this->read(path);
 			}
 			
+			explicit basic_document(const storage_type& in) :
+				size_(0), cur_(), pos_(0), width_(720.0), height_(540.0), in_(),
+				master_(), masters_(), layouts_(), theme_() {
+				this->read(in);
+			}
+			
 			virtual ~basic_document() throw() {}
 			
 			basic_document& read(const string_type& path) {
-				if (!in_.open(path)) throw std::runtime_error("cannot find input file");
+				return this->read(storage_type(path));
+			}
+			
+			basic_document& read(const storage_type& in) {
+				if (!in.is_open()) throw std::runtime_error("cannot find input file");
+				in_ = in;
 				
 				// 1. theme1.xml
 				typename storage_type::iterator pos = in_.find(LITERAL("ppt/theme/theme1.xml"));
@@ -95,87 +114,97 @@ namespace faml {
 				if (pos != in_.end()) this->xread_property(*pos);
 				
 				// 2. master slide.
-				pos = in_.find(LITERAL("ppt/slideMasters/slideMaster1.xml"));
-				if (pos == in_.end()) throw std::runtime_error("cannot find slideMaster1.xml");
-				master_.read(*pos, *this);
+				if (in_.find(LITERAL("ppt/slideMasters/slideMaster1.xml")) == in_.end()) {
+					throw std::runtime_error("cannot find slideMaster1.xml");
+				}
+				master_ = this->getmaster(LITERAL("ppt/slideMasters/slideMaster1.xml"));
 				
-				// 3. slides.
-				pos = in_.find(LITERAL("ppt/slides/_rels/slide1.xml.rels"));
-				for (int i = 1; pos != in_.end(); ++i) {
-					// parse reference.
-					std::map<string_type, string_type> ref;
-					faml::officex::read_reference(*pos, ref);
-					if (ref.size() < 1) throw std::runtime_error("cannof find slideLayout reference");
-					
-					// parse style.
-					string_type layout;
-					typedef typename std::map<string_type, string_type>::iterator iter;
-					for (iter it = ref.begin(); it != ref.end(); ++it) {
-						if (it->second.compare(0, 11, LITERAL("slideLayout")) == 0) {
-							layout = it->second;
-							break;
-						}
-					}
-					
+				// 3. slides (parsed on demand by at()).
+				size_ = 0;
+				cur_ = value_ptr();
+				while (true) {
 					std::stringstream ss;
-					ss << LITERAL("ppt/slideLayouts/") << layout;
-					pos = in_.find(ss.str());
-					layout_type st;
-					st.read(*pos, *this);
-					
-					// parse main data.
-					ss.str(LITERAL(""));
-					ss << LITERAL("ppt/slides/slide") << i << LITERAL(".xml");
-					pos = in_.find(ss.str());
-					if (pos == in_.end()) break;
-					value_type elem;
-					if (theme_) elem.theme(theme_.get());
-					elem.master(master_);
-					elem.layout(st);
-					elem.read(*pos);
-					
-					for (typename value_type::iterator it = elem.begin(); it != elem.end(); ++it) {
-						if (!it->reference().empty()) {
-							if (ref.find(it->reference()) == ref.end()) {
-								throw std::runtime_error("cannot find reference");
-							}
-							
-							string_type tmp = ref[it->reference()];
-							if (tmp.compare(0, 5, LITERAL("chart")) == 0) {
-								it->reference(tmp);
-								this->xread_chart(tmp, elem, theme_);
-								continue;
-							}
-							
-							ss.str(LITERAL(""));
-							ss << LITERAL("ppt/media/") << ref[it->reference()];
-							it->reference(ss.str());
-						}
-					}
-					v_.push_back(elem);
+					ss << LITERAL("ppt/slides/_rels/slide") << size_ + 1 << LITERAL(".xml.rels");
+					if (in_.find(ss.str()) == in_.end()) break;
 					
 					ss.str(LITERAL(""));
-					ss << LITERAL("ppt/slides/_rels/slide") << i + 1 << LITERAL(".xml.rels");
-					pos = in_.find(ss.str());
+					ss << LITERAL("ppt/slides/slide") << size_ + 1 << LITERAL(".xml");
+					if (in_.find(ss.str()) == in_.end()) break;
+					++size_;
 				}
 				
 				return *this;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  at
+			 *
+			 *  Returns the slide at pos. Slides are parsed on demand,
+			 *  and only the last requested slide is kept in memory, so
+			 *  the memory usage does not depend on the number of slides.
+			 *  The reference is invalidated by the next call of at() with
+			 *  the other position or release().
+			 */
+			/* ------------------------------------------------------------- */
+			const value_type& at(size_type pos) {
+				if (pos >= size_) throw std::out_of_range("slide index is out of range");
+				if (!cur_ || pos_ != pos) {
+					cur_ = value_ptr(); // release the previous slide first.
+					cur_ = this->xread_slide(pos);
+					pos_ = pos;
+				}
+				return *cur_;
+			}
+			
+			const value_type& operator[](size_type pos) { return this->at(pos); }
+			
+			/* ------------------------------------------------------------- */
+			//  release
+			/* ------------------------------------------------------------- */
+			void release() { cur_ = value_ptr(); }
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  getmaster, getlayout
+			 *
+			 *  Return the master (or layout) of the specified path. Each
+			 *  of them is parsed only once, and shared by the layouts and
+			 *  the slides that refer to it.
+			 */
+			/* ------------------------------------------------------------- */
+			master_ptr getmaster(const string_type& path) {
+				typename std::map<string_type, master_ptr>::iterator it = masters_.find(path);
+				if (it != masters_.end()) return it->second;
+				
+				typename storage_type::iterator pos = in_.find(path);
+				if (pos == in_.end()) throw std::runtime_error("cannot find master");
+				master_ptr dest(new master_type());
+				dest->read(*pos, *this);
+				masters_[path] = dest;
+				return dest;
+			}
+			
+			layout_ptr getlayout(const string_type& path) {
+				typename std::map<string_type, layout_ptr>::iterator it = layouts_.find(path);
+				if (it != layouts_.end()) return it->second;
+				
+				typename storage_type::iterator pos = in_.find(path);
+				if (pos == in_.end()) throw std::runtime_error("cannot find slideLayout");
+				layout_ptr dest(new layout_type());
+				dest->read(*pos, *this);
+				layouts_[path] = dest;
+				return dest;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  Access methods (get).
 			/* ------------------------------------------------------------- */
 			double width() const { return width_; }
 			double height() const { return height_; }
-			bool empty() const { return v_.empty(); }
-			size_type size() const { return v_.size(); }
-			const value_type& at(size_type pos) const { return v_.at(pos); }
-			const value_type& operator[](size_type pos) const { return v_[pos]; }
-			const_iterator begin() const { return v_.begin(); }
-			const_iterator end() const { return v_.end(); }
-			iterator begin() { return v_.begin(); }
-			iterator end() { return v_.end(); }
-			const master_type& master() const { return master_; }
+			bool empty() const { return size_ == 0; }
+			size_type size() const { return size_; }
+			const master_type& master() const { return *master_; }
 			theme_ptr& theme() { return theme_; }
 			const theme_ptr& theme() const { return theme_; }
 			storage_type& storage() { return in_; }
@@ -183,19 +212,83 @@ namespace faml {
 			txstyle_container& text_style() { return default_; }
 			
 		private:
-			typedef basic_layout<CharT, Traits> layout_type;
 			typedef rapidxml::xml_node<CharT>* node_ptr;
 			typedef rapidxml::xml_attribute<CharT>* attr_ptr;
 			typedef faml::xlsx::basic_chart<CharT, Traits> chart_type;
 			
-			container v_;
+			size_type size_;
+			value_ptr cur_;		// the slide returned by at()
+			size_type pos_;
 			double width_;
 			double height_;
 			storage_type in_;
-			master_type master_;
+			master_ptr master_;
+			std::map<string_type, master_ptr> masters_;
+			std::map<string_type, layout_ptr> layouts_;
 			theme_ptr theme_;
 			txstyle_container default_;
 			
+			/* ------------------------------------------------------------- */
+			//  xread_slide
+			/* ------------------------------------------------------------- */
+			value_ptr xread_slide(size_type n) {
+				// parse reference.
+				std::stringstream ss;
+				ss << LITERAL("ppt/slides/_rels/slide") << n + 1 << LITERAL(".xml.rels");
+				typename storage_type::iterator pos = in_.find(ss.str());
+				if (pos == in_.end()) throw std::runtime_error("cannot find slide reference");
+				
+				std::map<string_type, string_type> ref;
+				faml::officex::read_reference(*pos, ref);
+				if (ref.size() < 1) throw std::runtime_error("cannof find slideLayout reference");
+				
+				// parse style.
+				string_type layout;
+				typedef typename std::map<string_type, string_type>::iterator iter;
+				for (iter it = ref.begin(); it != ref.end(); ++it) {
+					if (it->second.compare(0, 11, LITERAL("slideLayout")) == 0) {
+						layout = it->second;
+						break;
+					}
+				}
+				
+				ss.str(LITERAL(""));
+				ss << LITERAL("ppt/slideLayouts/") << layout;
+				layout_ptr st = this->getlayout(ss.str());
+				
+				// parse main data.
+				ss.str(LITERAL(""));
+				ss << LITERAL("ppt/slides/slide") << n + 1 << LITERAL(".xml");
+				pos = in_.find(ss.str());
+				if (pos == in_.end()) throw std::runtime_error("cannot find slide");
+				value_ptr elem(new value_type());
+				if (theme_) elem->theme(theme_.get());
+				elem->master(master_);
+				elem->layout(st);
+				elem->read(*pos);
+				
+				for (typename value_type::iterator it = elem->begin(); it != elem->end(); ++it) {
+					if (!it->reference().empty()) {
+						if (ref.find(it->reference()) == ref.end()) {
+							throw std::runtime_error("cannot find reference");
+						}
+						
+						string_type tmp = ref[it->reference()];
+						if (tmp.compare(0, 5, LITERAL("chart")) == 0) {
+							it->reference(tmp);
+							this->xread_chart(tmp, *elem, theme_);
+							continue;
+						}
+						
+						ss.str(LITERAL(""));
+						ss << LITERAL("ppt/media/") << ref[it->reference()];
+						it->reference(ss.str());
+					}
+				}
+				
+				return elem;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  xread_chart
 			/* ------------------------------------------------------------- */
@@ -225,7 +318,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				node_ptr root = doc.first_node(LITERAL("p:presentation"));
 				if (!root) throw std::runtime_error("cannot find <p:presentation>");
@@ -233,12 +329,12 @@ namespace faml {
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("cx"));
 					if (attr && attr->value_size() > 0) {
-						width_ = faml::officex::emu(clx::lexical_cast<double>(attr->value()));
+						width_ = faml::officex::emu(officex::number_cast<double>(attr->value()));
 					}
 					
 					attr = pos->first_attribute(LITERAL("cy"));
 					if (attr && attr->value_size() > 0) {
-						height_ = faml::officex::emu(clx::lexical_cast<double>(attr->value()));
+						height_ = faml::officex::emu(officex::number_cast<double>(attr->value()));
 					}
 				}
 				
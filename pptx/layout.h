@@ -39,10 +39,13 @@
 #include <string>
 #include <map>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/literal.h"
+#include "clx/shared_ptr.h"
 #include "clx/utility.h"
 #include "../officex/shape.h"
 #include "../officex/reference.h"
+#include "../officex/number.h"
 #include "master.h"
 
 namespace faml {
@@ -69,11 +72,11 @@ namespace faml {
 			typedef std::map<size_type, txstyle_container> txstyle_map;
 			typedef std::map<string_type, string_type> color_map;
 			
-			basic_layout() : path_(), v_(), master_(), sh_(), tx_() {}
+			basic_layout() : path_(), v_(), master_(new master_type()), sh_(), tx_() {}
 			
 			template <class InStream, class DocManager>
 			basic_layout(InStream& in, DocManager& dm) :
-				path_(), v_(), sh_(), tx_() {
+				path_(), v_(), master_(), sh_(), tx_() {
 				this->read(in, dm);
 			}
 			
@@ -90,7 +93,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				node_ptr root = doc.first_node(LITERAL("p:sldLayout"));
 				if (!root) throw std::runtime_error("cannot find <p:sldLayout>");
@@ -116,23 +122,23 @@ namespace faml {
 			const_iterator end() const { return v_.end(); }
 			const shstyle_map& shstyles() const { return sh_; }
 			const txstyle_map& txstyles() const { return tx_; }
-			const color_map& clrmap() const { return master_.clrmap(); }
+			const color_map& clrmap() const { return master_->clrmap(); }
 			
 			/* ------------------------------------------------------------- */
 			//  Access methods (get).
 			/* ------------------------------------------------------------- */
 			shstyle_map& shstyles() { return sh_; }
 			txstyle_map& txstyles() { return tx_; }
-			color_map& clrmap() { return master_.clrmap(); }
 			
 		private:
 			typedef rapidxml::xml_node<CharT>* node_ptr;
 			typedef rapidxml::xml_attribute<CharT>* attr_ptr;
 			typedef basic_master<CharT, Traits> master_type;
+			typedef clx::shared_ptr<master_type> master_ptr;
 			
 			string_type path_;
 			container v_;
-			master_type master_;
+			master_ptr master_; // shared with the document
 			shstyle_map sh_;
 			txstyle_map tx_;
 			
@@ -174,7 +180,7 @@ namespace faml {
 					else {
 						size_type idx = 0;
 						attr_ptr attr = pos->first_attribute(LITERAL("idx"));
-						if (attr && attr->value_size() > 0) idx = clx::lexical_cast<size_type>(attr->value());
+						if (attr && attr->value_size() > 0) idx = officex::number_cast<size_type>(attr->value());
 						this->xread_shstyle(child, idx, dm);
 						this->xread_txstyle(child->first_node(LITERAL("p:txBody")), idx, dm);
 					}
@@ -226,41 +232,41 @@ namespace faml {
 				if (!tmp) throw std::runtime_error("cannot find <a:off>");
 				attr_ptr attr = tmp->first_attribute(LITERAL("x"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:off x>");
-				double x = clx::lexical_cast<double>(attr->value());
+				double x = officex::number_cast<double>(attr->value());
 				attr = tmp->first_attribute(LITERAL("y"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:off y>");
-				double y = clx::lexical_cast<double>(attr->value());
+				double y = officex::number_cast<double>(attr->value());
 				
 				// <a:ext>
 				tmp = pos->first_node(LITERAL("a:ext"));
 				if (!tmp) throw std::runtime_error("cannot find <a:ext>");
 				attr = tmp->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:ext cx>");
-				double cx = clx::lexical_cast<double>(attr->value());
+				double cx = officex::number_cast<double>(attr->value());
 				attr = tmp->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:ext cy>");
-				double cy = clx::lexical_cast<double>(attr->value());
+				double cy = officex::number_cast<double>(attr->value());
 				
 				// <a:chOff>
 				tmp = pos->first_node(LITERAL("a:chOff"));
 				if (!tmp) throw std::runtime_error("cannot find <a:chOff>");
 				attr = tmp->first_attribute(LITERAL("x"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chOff x>");
-				double chx = clx::lexical_cast<double>(attr->value());
+				double chx = officex::number_cast<double>(attr->value());
 				attr = tmp->first_attribute(LITERAL("y"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chOff y>");
-				double chy = clx::lexical_cast<double>(attr->value());
+				double chy = officex::number_cast<double>(attr->value());
 				
 				// <a:chExt>
 				tmp = pos->first_node(LITERAL("a:chExt"));
 				if (!tmp) throw std::runtime_error("cannot find <a:chExt>");
 				attr = tmp->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chExt cx>");
-				double chcx = clx::lexical_cast<double>(attr->value());
+				double chcx = officex::number_cast<double>(attr->value());
 				if (chcx <= 0.0) chcx = 1;
 				attr = tmp->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chExt cy>");
-				double chcy = clx::lexical_cast<double>(attr->value());
+				double chcy = officex::number_cast<double>(attr->value());
 				if (chcy <= 0.0) chcy = 1;
 				
 				this->xread_shape_tree(root, dm, ref);
@@ -290,7 +296,7 @@ namespace faml {
 			basic_layout& xread_shape(XMLNode* root, DocManager& dm, Container& ref) {
 				if (!root) throw std::runtime_error("cannot find <p:sp>");
 				
-				value_type elem(master_.clrmap());
+				value_type elem(master_->clrmap());
 				if (dm.theme()) elem.theme(dm.theme().get());
 				elem.read(root, LITERAL("p"));
 				if (!elem.reference().empty()) {
@@ -313,8 +319,8 @@ namespace faml {
 				if (!root) throw std::runtime_error("cannot find <p:sp>");
 				
 				shstyle_type elem;
-				typename shstyle_map::const_iterator it = master_.shapes().find(idx);
-				if (it != master_.shapes().end()) {
+				typename shstyle_map::const_iterator it = master_->shapes().find(idx);
+				if (it != master_->shapes().end()) {
 					elem = it->second;
 					elem.texts().clear();
 				}
@@ -336,9 +342,9 @@ namespace faml {
 				if (!pos || !pos->first_node()) return *this;
 				
 				const txstyle_container* base = NULL;
-				if (idx == 0) base = &master_.title_style();
-				else if (idx == 1) base = &master_.body_style();
-				else base = &master_.other_style();
+				if (idx == 0) base = &master_->title_style();
+				else if (idx == 1) base = &master_->body_style();
+				else base = &master_->other_style();
 				
 				txstyle_container v;
 				size_type i = 0;
@@ -382,11 +388,7 @@ namespace faml {
 				
 				ss.str(LITERAL(""));
 				ss << LITERAL("ppt/slideMasters/") << m;
-				
-				pos = dm.storage().find(ss.str());
-				if (pos == dm.storage().end()) throw std::runtime_error("cannot find master");
-				
-				master_.read(*pos, dm);
+				master_ = dm.getmaster(ss.str());
 				return *this;
 			}
 			
@@ -398,12 +400,12 @@ namespace faml {
 				size_type assign = 1;
 				attr_ptr attr = root->first_attribute(LITERAL("showMasterSp"));
 				if (attr && attr->value_size() > 0) {
-					assign = clx::lexical_cast<size_type>(attr->value());
+					assign = officex::number_cast<size_type>(attr->value());
 				}
 				if (assign == 0) return *this;
 				
-				if (!master_.empty()) {
-					v_.assign(master_.begin(), master_.end());
+				if (!master_->empty()) {
+					v_.assign(master_->begin(), master_->end());
 				}
 				
 				return *this;
@@ -40,12 +40,14 @@
 #include <vector>
 #include <map>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
 #include "../officex/unit.h"
 #include "../officex/color.h"
 #include "../officex/shape.h"
 #include "../officex/txstyle.h"
+#include "../officex/number.h"
 
 namespace faml {
 	namespace pptx {
@@ -94,7 +96,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				node_ptr root = doc.first_node(LITERAL("p:sldMaster"));
 				if (!root) throw std::runtime_error("cannot find <p:sldMaster> (root) tag");
@@ -176,7 +181,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				node_ptr root = doc.first_node(LITERAL("p:presentation"));
 				if (!root) return *this;
@@ -299,7 +307,7 @@ namespace faml {
 				if (!pos) return *this;
 				attr_ptr attr = pos->first_attribute(LITERAL("ang"));
 				if (attr && attr->value_size() > 0) {
-					angle_ = faml::officex::deg60k(clx::lexical_cast<double>(attr->value()));
+					angle_ = faml::officex::deg60k(officex::number_cast<double>(attr->value()));
 				}
 				
 				return *this;
@@ -346,7 +354,7 @@ namespace faml {
 					else {
 						size_type idx = 0;
 						attr_ptr attr = pos->first_attribute(LITERAL("idx"));
-						if (attr && attr->value_size() > 0) idx = clx::lexical_cast<size_type>(attr->value());
+						if (attr && attr->value_size() > 0) idx = officex::number_cast<size_type>(attr->value());
 						
 						shape_type elem(clr_);
 						//elem.background(this->rgb());
@@ -404,41 +412,41 @@ namespace faml {
 				if (!tmp) throw std::runtime_error("cannot find <a:off>");
 				attr_ptr attr = tmp->first_attribute(LITERAL("x"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:off x>");
-				double x = clx::lexical_cast<double>(attr->value());
+				double x = officex::number_cast<double>(attr->value());
 				attr = tmp->first_attribute(LITERAL("y"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:off y>");
-				double y = clx::lexical_cast<double>(attr->value());
+				double y = officex::number_cast<double>(attr->value());
 				
 				// <a:ext>
 				tmp = pos->first_node(LITERAL("a:ext"));
 				if (!tmp) throw std::runtime_error("cannot find <a:ext>");
 				attr = tmp->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:ext cx>");
-				double cx = clx::lexical_cast<double>(attr->value());
+				double cx = officex::number_cast<double>(attr->value());
 				attr = tmp->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:ext cy>");
-				double cy = clx::lexical_cast<double>(attr->value());
+				double cy = officex::number_cast<double>(attr->value());
 				
 				// <a:chOff>
 				tmp = pos->first_node(LITERAL("a:chOff"));
 				if (!tmp) throw std::runtime_error("cannot find <a:chOff>");
 				attr = tmp->first_attribute(LITERAL("x"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chOff x>");
-				double chx = clx::lexical_cast<double>(attr->value());
+				double chx = officex::number_cast<double>(attr->value());
 				attr = tmp->first_attribute(LITERAL("y"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chOff y>");
-				double chy = clx::lexical_cast<double>(attr->value());
+				double chy = officex::number_cast<double>(attr->value());
 				
 				// <a:chExt>
 				tmp = pos->first_node(LITERAL("a:chExt"));
 				if (!tmp) throw std::runtime_error("cannot find <a:chExt>");
 				attr = tmp->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chExt cx>");
-				double chcx = clx::lexical_cast<double>(attr->value());
+				double chcx = officex::number_cast<double>(attr->value());
 				if (chcx <= 0.0) chcx = 1;
 				attr = tmp->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chExt cy>");
-				double chcy = clx::lexical_cast<double>(attr->value());
+				double chcy = officex::number_cast<double>(attr->value());
 				if (chcy <= 0.0) chcy = 1;
 				
 				this->xread_shape_tree(root, dm, ref);
@@ -39,8 +39,11 @@
 #include <string>
 #include <vector>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/literal.h"
+#include "clx/shared_ptr.h"
 #include "clx/utility.h"
 #include "../officex/shape.h"
 #include "../xlsx/chart.h"
@@ -69,6 +72,8 @@ namespace faml {
 			typedef faml::officex::basic_theme<CharT, Traits> theme_type;
 			typedef basic_layout<CharT, Traits> layout_type;
 			typedef basic_master<CharT, Traits> master_type;
+			typedef clx::shared_ptr<layout_type> layout_ptr;
+			typedef clx::shared_ptr<master_type> master_ptr;
 			
 			typedef basic_table<CharT, Traits> table_type;
 			typedef std::vector<table_type> table_container;
@@ -77,11 +82,13 @@ namespace faml {
 			typedef std::vector<chart_type> chart_container;
 			
 			basic_slide() :
-				v_(), background_(), bgimage_(), theme_(NULL), layout_() {}
+				v_(), background_(), bgimage_(), theme_(NULL),
+				master_(new master_type()), layout_(new layout_type()) {}
 			
 			template <class Ch, class Tr>
 			basic_slide(std::basic_istream<Ch, Tr>& in) :
-				v_(), background_(), bgimage_(), theme_(NULL), layout_() {
+				v_(), background_(), bgimage_(), theme_(NULL),
+				master_(new master_type()), layout_(new layout_type()) {
 				this->read(in);
 			}
 			
@@ -95,19 +102,22 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				node_ptr root = doc.first_node(LITERAL("p:sld"));
 				if (!root) throw std::runtime_error("cannot find <p:sld> (root) tag");
 				node_ptr parent = root->first_node("p:cSld");
 				if (!parent) throw std::runtime_error("cannot find <p:cSld> tag");
 				
-				bgimage_ = master_.bgimage();
+				bgimage_ = master_->bgimage();
 				node_ptr pos = parent->first_node(LITERAL("p:bg"));
 				if (pos) this->xread_background(pos);
 				else {
-					background_ = master_.rgbs();
-					angle_ = master_.angle();
+					background_ = master_->rgbs();
+					angle_ = master_->angle();
 				}
 				
 				this->xread_drawing(parent->first_node("p:spTree"));
@@ -131,8 +141,7 @@ namespace faml {
 			iterator begin() { return v_.begin(); }
 			iterator end() { return v_.end(); }
 			
-			const layout_type& layout() const { return layout_; }
-			layout_type& layout() { return layout_; }
+			const layout_type& layout() const { return *layout_; }
 			const table_container& tbls() const { return table_; }
 			table_container& tbls() { return table_; }
 			const chart_container& charts() const { return chart_; }
@@ -142,8 +151,17 @@ namespace faml {
 			//  Access methods (set).
 			/* ------------------------------------------------------------- */
 			void theme(const theme_type* cp) { theme_ = cp; }
-			void master(const master_type& cp) { master_ = cp; }
-			void layout(const layout_type& cp) { layout_ = cp; }
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  master, layout
+			 *
+			 *  The master and the layout are shared by the slides, and
+			 *  they are never modified through the slide.
+			 */
+			/* ------------------------------------------------------------- */
+			void master(const master_ptr& cp) { master_ = cp; }
+			void layout(const layout_ptr& cp) { layout_ = cp; }
 			
 		private:
 			typedef rapidxml::xml_node<CharT>* node_ptr;
@@ -157,8 +175,8 @@ namespace faml {
 			double angle_;
 			
 			const theme_type* theme_;
-			master_type master_;
-			layout_type layout_;
+			master_ptr master_;
+			layout_ptr layout_;
 			
 			/* ------------------------------------------------------------- */
 			//  xread_background
@@ -206,7 +224,7 @@ namespace faml {
 				if (!pos) return *this;
 				attr_ptr attr = pos->first_attribute(LITERAL("ang"));
 				if (attr && attr->value_size() > 0) {
-					angle_ = faml::officex::deg60k(clx::lexical_cast<double>(attr->value()));
+					angle_ = faml::officex::deg60k(officex::number_cast<double>(attr->value()));
 				}
 				
 				return *this;
@@ -234,12 +252,11 @@ namespace faml {
 				value_type elem(this->layout().clrmap());
 				size_type idx = this->xassign_style(root, elem);
 				size_type type = this->xgettype(root);
-				if (layout_.txstyles().find(idx) != layout_.txstyles().end()) {
-					elem.style(layout_.txstyles()[idx]);
-				}
-				else if (type == 1) elem.style(master_.title_style());
-				else if (type == 2) elem.style(master_.body_style());
-				else elem.style(master_.other_style());
+				typename layout_type::txstyle_map::const_iterator style = layout_->txstyles().find(idx);
+				if (style != layout_->txstyles().end()) elem.style(style->second);
+				else if (type == 1) elem.style(master_->title_style());
+				else if (type == 2) elem.style(master_->body_style());
+				else elem.style(master_->other_style());
 				if (theme_) elem.theme(theme_);
 				//elem.background(master_.rgb());
 				elem.read(root, LITERAL("p"));
@@ -292,41 +309,41 @@ namespace faml {
 				if (!tmp) throw std::runtime_error("cannot find <a:off>");
 				attr_ptr attr = tmp->first_attribute(LITERAL("x"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:off x>");
-				double x = clx::lexical_cast<double>(attr->value());
+				double x = officex::number_cast<double>(attr->value());
 				attr = tmp->first_attribute(LITERAL("y"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:off y>");
-				double y = clx::lexical_cast<double>(attr->value());
+				double y = officex::number_cast<double>(attr->value());
 				
 				// <a:ext>
 				tmp = pos->first_node(LITERAL("a:ext"));
 				if (!tmp) throw std::runtime_error("cannot find <a:ext>");
 				attr = tmp->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:ext cx>");
-				double cx = clx::lexical_cast<double>(attr->value());
+				double cx = officex::number_cast<double>(attr->value());
 				attr = tmp->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:ext cy>");
-				double cy = clx::lexical_cast<double>(attr->value());
+				double cy = officex::number_cast<double>(attr->value());
 				
 				// <a:chOff>
 				tmp = pos->first_node(LITERAL("a:chOff"));
 				if (!tmp) throw std::runtime_error("cannot find <a:chOff>");
 				attr = tmp->first_attribute(LITERAL("x"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chOff x>");
-				double chx = clx::lexical_cast<double>(attr->value());
+				double chx = officex::number_cast<double>(attr->value());
 				attr = tmp->first_attribute(LITERAL("y"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chOff y>");
-				double chy = clx::lexical_cast<double>(attr->value());
+				double chy = officex::number_cast<double>(attr->value());
 				
 				// <a:chExt>
 				tmp = pos->first_node(LITERAL("a:chExt"));
 				if (!tmp) throw std::runtime_error("cannot find <a:chExt>");
 				attr = tmp->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chExt cx>");
-				double chcx = clx::lexical_cast<double>(attr->value());
+				double chcx = officex::number_cast<double>(attr->value());
 				if (chcx <= 0.0) chcx = 1;
 				attr = tmp->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <a:chExt cy>");
-				double chcy = clx::lexical_cast<double>(attr->value());
+				double chcy = officex::number_cast<double>(attr->value());
 				if (chcy <= 0.0) chcy = 1;
 				
 				this->xread_drawing(root);
@@ -357,7 +374,7 @@ namespace faml {
 				if (!root) return *this;
 				
 				table_type elem;
-				elem.background(master_.rgb());
+				elem.background(master_->rgb());
 				elem.read(root);
 				table_.push_back(elem);
 				
@@ -372,7 +389,7 @@ namespace faml {
 				if (!root) return *this;
 				
 				value_type elem(this->layout().clrmap());
-				elem.background(master_.rgb());
+				elem.background(master_->rgb());
 				
 				node_ptr parent = root->first_node(LITERAL("p:xfrm"));
 				if (!parent) return *this;
@@ -380,20 +397,20 @@ namespace faml {
 				if (!pos) return *this;
 				attr_ptr attr = pos->first_attribute(LITERAL("x"));
 				if (!attr || attr->value_size() == 0) return *this;
-				double x = clx::lexical_cast<double>(attr->value());
+				double x = officex::number_cast<double>(attr->value());
 				attr = pos->first_attribute(LITERAL("y"));
 				if (!attr || attr->value_size() == 0) return *this;
-				double y = clx::lexical_cast<double>(attr->value());
+				double y = officex::number_cast<double>(attr->value());
 				elem.origin(coordinate(x, y));
 				
 				pos = parent->first_node(LITERAL("a:ext"));
 				if (!pos) return *this;
 				attr = pos->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) return *this;
-				elem.width(clx::lexical_cast<double>(attr->value()));
+				elem.width(officex::number_cast<double>(attr->value()));
 				attr = pos->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) return *this;
-				elem.height(clx::lexical_cast<double>(attr->value()));
+				elem.height(officex::number_cast<double>(attr->value()));
 				
 				node_ptr p1 = root->first_node(LITERAL("a:graphic"));
 				if (!p1) return *this;
@@ -425,10 +442,10 @@ namespace faml {
 				node_ptr pos = p2->first_node(LITERAL("p:ph"));
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("idx"));
-					if (attr && attr->value_size() > 0) idx = clx::lexical_cast<size_type>(attr->value());
+					if (attr && attr->value_size() > 0) idx = officex::number_cast<size_type>(attr->value());
 					typename layout_type::shstyle_map::const_iterator it;
-					it = layout_.shstyles().find(idx);
-					if (it != layout_.shstyles().end()) {
+					it = layout_->shstyles().find(idx);
+					if (it != layout_->shstyles().end()) {
 						dest = it->second;
 						dest.texts().clear();
 					}
@@ -457,7 +474,7 @@ namespace faml {
 				size_type idx = 0;
 				size_type dest = 0;
 				attr_ptr attr = pos->first_attribute(LITERAL("idx"));
-				if (attr && attr->value_size() > 0) idx = clx::lexical_cast<size_type>(attr->value());
+				if (attr && attr->value_size() > 0) idx = officex::number_cast<size_type>(attr->value());
 				if (idx == 0) dest = 1;
 				else if (idx == 1) dest = 2;
 				
@@ -41,6 +41,7 @@
 #include "rapidxml/rapidxml.hpp"
 #include "clx/literal.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "../officex/txbox.h"
 #include "../officex/color.h"
 #include "../officex/utility.h"
@@ -142,7 +143,7 @@ namespace faml {
 				if (pos) {
 					attr_ptr attr = pos->first_attribute(LITERAL("w:w"));
 					if (attr && attr->value_size() > 0) {
-						width_ = clx::lexical_cast<double>(attr->value());
+						width_ = officex::number_cast<double>(attr->value());
 					}
 				}
 				*/
@@ -158,25 +159,25 @@ namespace faml {
 				node_ptr pos_l = root->first_node(LITERAL("a:lnL"));
 				if (pos_l) {
 					attr_ptr attr_l = pos_l->first_attribute(LITERAL("w"));
-					if (attr_l && attr_l->value_size() > 0) weight_left_ = clx::lexical_cast<double>(attr_l->value());
+					if (attr_l && attr_l->value_size() > 0) weight_left_ = officex::number_cast<double>(attr_l->value());
 				}
 				
 				node_ptr pos_r = root->first_node(LITERAL("a:lnR"));
 				if (pos_r) {
 					attr_ptr attr_r = pos_r->first_attribute(LITERAL("w"));
-					if (attr_r && attr_r->value_size() > 0) weight_right_ = clx::lexical_cast<double>(attr_r->value());
+					if (attr_r && attr_r->value_size() > 0) weight_right_ = officex::number_cast<double>(attr_r->value());
 				}
 				
 				node_ptr pos_t = root->first_node(LITERAL("a:lnT"));
 				if (pos_t) {
 					attr_ptr attr_t = pos_t->first_attribute(LITERAL("w"));
-					if (attr_t && attr_t->value_size() > 0) weight_top_ = clx::lexical_cast<double>(attr_t->value());
+					if (attr_t && attr_t->value_size() > 0) weight_top_ = officex::number_cast<double>(attr_t->value());
 				}
 				
 				node_ptr pos_b = root->first_node(LITERAL("a:lnB"));
 				if (pos_b) {
 					attr_ptr attr_b = pos_b->first_attribute(LITERAL("w"));
-					if (attr_b && attr_b->value_size() > 0) weight_bottom_ = clx::lexical_cast<double>(attr_b->value());
+					if (attr_b && attr_b->value_size() > 0) weight_bottom_ = officex::number_cast<double>(attr_b->value());
 				}
 				
 				return *this;
@@ -228,7 +229,7 @@ namespace faml {
 					if (string_type(child->name()) != LITERAL("a:gridCol")) continue;
 					attr_ptr attr = child->first_attribute(LITERAL("w"));
 					if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find w attribute");
-					widths.push_back(clx::lexical_cast<double>(attr->value()));
+					widths.push_back(officex::number_cast<double>(attr->value()));
 				}
 				
 				for (node_ptr child = p3->first_node(); child; child = child->next_sibling()) {
@@ -279,11 +280,11 @@ namespace faml {
 				
 				attr_ptr attr = pos->first_attribute(LITERAL("x"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find x attribute");
-				double x = clx::lexical_cast<double>(attr->value());
+				double x = officex::number_cast<double>(attr->value());
 				
 				attr = pos->first_attribute(LITERAL("y"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find y attribute");
-				double y = clx::lexical_cast<double>(attr->value());
+				double y = officex::number_cast<double>(attr->value());
 				origin_ = coordinate(x, y);
 				
 				pos = root->first_node(LITERAL("a:ext"));
@@ -291,11 +292,11 @@ namespace faml {
 				
 				attr = pos->first_attribute(LITERAL("cx"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find cx attribute");
-				width_ = clx::lexical_cast<double>(attr->value());
+				width_ = officex::number_cast<double>(attr->value());
 				
 				attr = pos->first_attribute(LITERAL("cy"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find cy attribute");
-				height_ = clx::lexical_cast<double>(attr->value());
+				height_ = officex::number_cast<double>(attr->value());
 				
 				return *this;
 			}
@@ -317,7 +318,7 @@ namespace faml {
 				}
 				
 				attr_ptr attr = root->first_attribute(LITERAL("h"));
-				if (attr && attr->value_size() > 0) dest.first = clx::lexical_cast<double>(attr->value());
+				if (attr && attr->value_size() > 0) dest.first = officex::number_cast<double>(attr->value());
 				
 				size_type i = 0;
 				for (node_ptr child = root->first_node(); child; child = child->next_sibling()) {
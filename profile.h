@@ -0,0 +1,321 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  profile.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_PDF_PROFILE_H
+#define FAML_PDF_PROFILE_H
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <sys/time.h>
+#endif
+
+namespace faml {
+	namespace pdf {
+		/* ----------------------------------------------------------------- */
+		//  wall_clock
+		/* ----------------------------------------------------------------- */
+		inline double wall_clock() {
+#ifdef _WIN32
+			// std::clock() returns the wall clock time on Windows.
+			return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#else
+			struct timeval tv;
+			gettimeofday(&tv, NULL);
+			return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) / 1000000.0;
+#endif
+		}
+		
+#ifdef FAML_USE_PROFILE
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  profile
+		 *
+		 *  The profile class collects the elapsed (wall clock) time, the
+		 *  number of written objects, and the written bytes of each phase
+		 *  (fonts, images, page contents, ...) and the elapsed time of
+		 *  each page. basic_generator keeps an instance, and the values
+		 *  are available after finish(). When FAML_USE_PROFILE is not
+		 *  defined, the class and the scoped timers below are empty.
+		 *
+		 *  The phases that run without the PDF manager (unzip, XML
+		 *  parsing, text layout) are added to shared(), and
+		 *  basic_generator moves them to its own profile in finish().
+		 *  The text layout ("text") is timed once per text piece (or
+		 *  cell), not per measurement, to keep the timer off the hot
+		 *  path. A converter that fails before finish() leaves its
+		 *  phases in shared(), so clear it when a new job starts.
+		 */
+		/* ----------------------------------------------------------------- */
+		class profile {
+		public:
+			typedef size_t size_type;
+			
+			struct phase_type {
+				double seconds;
+				size_type calls;
+				size_type objects;
+				size_type bytes;
+				
+				phase_type() : seconds(0.0), calls(0), objects(0), bytes(0) {}
+			};
+			
+			typedef std::map<std::string, phase_type> phase_map;
+			
+			profile() : phases_(), pages_() {}
+			
+			void add(const char* name, double seconds, size_type objects, size_type bytes) {
+				phase_type& elem = phases_[name];
+				elem.seconds += seconds;
+				elem.calls += 1;
+				elem.objects += objects;
+				elem.bytes += bytes;
+			}
+			
+			void page(double seconds) { pages_.push_back(seconds); }
+			
+			void merge(const profile& src) {
+				for (phase_map::const_iterator pos = src.phases_.begin(); pos != src.phases_.end(); ++pos) {
+					phase_type& elem = phases_[pos->first];
+					elem.seconds += pos->second.seconds;
+					elem.calls += pos->second.calls;
+					elem.objects += pos->second.objects;
+					elem.bytes += pos->second.bytes;
+				}
+				pages_.insert(pages_.end(), src.pages_.begin(), src.pages_.end());
+			}
+			
+			void clear() {
+				phases_.clear();
+				pages_.clear();
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  Access methods (get).
+			/* ------------------------------------------------------------- */
+			const phase_map& phases() const { return phases_; }
+			const std::vector<double>& pages() const { return pages_; }
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  json
+			 *
+			 *  Writes the collected values as the JSON object, e.g.,
+			 *  {"phases":{"font":{"seconds":0.01,"calls":1,...}},
+			 *  "pages":[0.02,0.01]}.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			OutStream& json(OutStream& out) const {
+				out << "{\"phases\":{";
+				for (phase_map::const_iterator pos = phases_.begin(); pos != phases_.end(); ++pos) {
+					if (pos != phases_.begin()) out << ",";
+					out << "\"" << pos->first << "\":{"
+						<< "\"seconds\":" << pos->second.seconds << ","
+						<< "\"calls\":" << pos->second.calls << ","
+						<< "\"objects\":" << pos->second.objects << ","
+						<< "\"bytes\":" << pos->second.bytes << "}";
+				}
+				out << "},\"pages\":[";
+				for (size_type i = 0; i < pages_.size(); ++i) {
+					if (i > 0) out << ",";
+					out << pages_.at(i);
+				}
+				out << "]}";
+				return out;
+			}
+			
+			static double now() { return wall_clock(); }
+			
+			static profile& shared() {
+				static profile dest;
+				return dest;
+			}
+			
+		private:
+			phase_map phases_;
+			std::vector<double> pages_;
+		};
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  scoped_phase
+		 *
+		 *  Adds the elapsed time, the objects and the bytes written to
+		 *  the PDF manager (basic_generator) while the instance lives to
+		 *  the specified phase.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <class PDFManager>
+		class scoped_phase {
+		public:
+			typedef size_t size_type;
+			
+			scoped_phase(PDFManager& pm, const char* name) :
+				pm_(pm), name_(name), start_(profile::now()),
+				index_(pm.index()), pos_(pm.tellp()) {}
+				
+			~scoped_phase() {
+				pm_.profile().add(name_, profile::now() - start_,
+					pm_.index() - index_, pm_.tellp() - pos_);
+			}
+			
+		private:
+			PDFManager& pm_;
+			const char* name_;
+			double start_;
+			size_type index_;
+			size_type pos_;
+			
+			scoped_phase(const scoped_phase&);
+			scoped_phase& operator=(const scoped_phase&);
+		};
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  scoped_timer
+		 *
+		 *  Adds the elapsed time while the instance lives to the phase
+		 *  of profile::shared(). It is used where no PDF manager is
+		 *  available (e.g., in the constructors of the document readers).
+		 */
+		/* ----------------------------------------------------------------- */
+		class scoped_timer {
+		public:
+			explicit scoped_timer(const char* name) :
+				name_(name), start_(profile::now()) {}
+			
+			~scoped_timer() {
+				profile::shared().add(name_, profile::now() - start_, 0, 0);
+			}
+			
+		private:
+			const char* name_;
+			double start_;
+			
+			scoped_timer(const scoped_timer&);
+			scoped_timer& operator=(const scoped_timer&);
+		};
+		
+		/* ----------------------------------------------------------------- */
+		//  scoped_page
+		/* ----------------------------------------------------------------- */
+		template <class PDFManager>
+		class scoped_page {
+		public:
+			explicit scoped_page(PDFManager& pm) :
+				pm_(pm), start_(profile::now()) {}
+				
+			~scoped_page() {
+				pm_.profile().page(profile::now() - start_);
+			}
+			
+		private:
+			PDFManager& pm_;
+			double start_;
+			
+			scoped_page(const scoped_page&);
+			scoped_page& operator=(const scoped_page&);
+		};
+#else
+		/* ----------------------------------------------------------------- */
+		//  profile (disabled)
+		/* ----------------------------------------------------------------- */
+		class profile {
+		public:
+			typedef size_t size_type;
+			
+			struct phase_type {
+				double seconds;
+				size_type calls;
+				size_type objects;
+				size_type bytes;
+				
+				phase_type() : seconds(0.0), calls(0), objects(0), bytes(0) {}
+			};
+			
+			typedef std::map<std::string, phase_type> phase_map;
+			
+			void add(const char*, double, size_type, size_type) {}
+			void page(double) {}
+			void merge(const profile&) {}
+			void clear() {}
+			
+			const phase_map& phases() const {
+				static const phase_map empty;
+				return empty;
+			}
+			
+			const std::vector<double>& pages() const {
+				static const std::vector<double> empty;
+				return empty;
+			}
+			
+			template <class OutStream>
+			OutStream& json(OutStream& out) const {
+				out << "{\"phases\":{},\"pages\":[]}";
+				return out;
+			}
+			
+			static double now() { return 0.0; }
+			
+			static profile& shared() {
+				static profile dest;
+				return dest;
+			}
+		};
+		
+		template <class PDFManager>
+		class scoped_phase {
+		public:
+			scoped_phase(PDFManager&, const char*) {}
+		};
+		
+		class scoped_timer {
+		public:
+			explicit scoped_timer(const char*) {}
+		};
+		
+		template <class PDFManager>
+		class scoped_page {
+		public:
+			explicit scoped_page(PDFManager&) {}
+		};
+#endif // FAML_USE_PROFILE
+	}
+}
+
+#endif // FAML_PDF_PROFILE_H
@@ -0,0 +1,238 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  resample.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_PDF_RESAMPLE_H
+#define FAML_PDF_RESAMPLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <ios>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace faml {
+	namespace pdf {
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  resample_size
+		 *
+		 *  Returns the pixel size of the image whose resolution does not
+		 *  exceed dpi when the image (width x height pixels) is placed
+		 *  at (pw x ph) points. The aspect ratio is kept, and the image
+		 *  is never enlarged.
+		 */
+		/* ----------------------------------------------------------------- */
+		inline std::pair<size_t, size_t> resample_size(size_t width, size_t height,
+			double pw, double ph, double dpi) {
+			std::pair<size_t, size_t> dest(width, height);
+			if (dpi <= 0.0 || pw <= 0.0 || ph <= 0.0 || width == 0 || height == 0) return dest;
+			
+			double sx = pw / 72.0 * dpi / width;
+			double sy = ph / 72.0 * dpi / height;
+			double s = std::max(sx, sy);
+			if (s >= 1.0) return dest;
+			
+			dest.first = std::max(static_cast<size_t>(std::ceil(width * s)), static_cast<size_t>(1));
+			dest.second = std::max(static_cast<size_t>(std::ceil(height * s)), static_cast<size_t>(1));
+			return dest;
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_placement
+		 *
+		 *  The basic_placement class keeps the largest size (in points)
+		 *  at which each image is placed in the document, so that the
+		 *  image can be resampled for the most demanding placement.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_placement {
+		public:
+			typedef std::basic_string<CharT, Traits> string_type;
+			typedef std::pair<double, double> size_type;
+			typedef std::map<string_type, size_type> container;
+			typedef typename container::const_iterator const_iterator;
+			
+			basic_placement() : v_() {}
+			
+			void add(const string_type& ref, double width, double height) {
+				if (ref.empty()) return;
+				size_type& elem = v_[ref];
+				elem.first = std::max(elem.first, width);
+				elem.second = std::max(elem.second, height);
+			}
+			
+			bool find(const string_type& ref, double& width, double& height) const {
+				const_iterator pos = v_.find(ref);
+				if (pos == v_.end()) return false;
+				width = pos->second.first;
+				height = pos->second.second;
+				return true;
+			}
+			
+			bool empty() const { return v_.empty(); }
+			void clear() { v_.clear(); }
+			
+		private:
+			container v_;
+		};
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_resampler
+		 *
+		 *  The basic_resampler class shrinks the interleaved 8-bit raster
+		 *  with the box (area-average) filter. Source rows are written
+		 *  to the class in the same way as to the output stream (i.e.,
+		 *  by write() and operator<<), and each resampled row is written
+		 *  to the target stream as soon as it is completed. So, only one
+		 *  source row and one row of accumulators are kept in memory.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <class OutStream>
+		class basic_resampler {
+		public:
+			typedef size_t size_type;
+			typedef typename OutStream::char_type char_type;
+			typedef unsigned char byte_type;
+			
+			basic_resampler(OutStream& out, size_type sw, size_type sh,
+				size_type dw, size_type dh, size_type channels) :
+				out_(out), sw_(sw), sh_(sh), dw_(dw), dh_(dh), ch_(channels),
+				y_(0), row_(0), first_(0), line_(), acc_(dw * channels, 0), xmap_(dw + 1, 0), dest_(dw * channels) {
+				line_.reserve(sw * channels);
+				for (size_type i = 0; i <= dw_; ++i) xmap_[i] = i * sw_ / dw_;
+			}
+			
+			basic_resampler& write(const char_type* s, std::streamsize n) {
+				const byte_type* p = reinterpret_cast<const byte_type*>(s);
+				size_type rest = static_cast<size_type>(n);
+				while (rest > 0) {
+					size_type k = std::min(rest, sw_ * ch_ - line_.size());
+					line_.insert(line_.end(), p, p + k);
+					p += k;
+					rest -= k;
+					if (line_.size() == sw_ * ch_) {
+						this->xaccumulate(&line_[0]);
+						line_.clear();
+					}
+				}
+				return *this;
+			}
+			
+			basic_resampler& operator<<(char_type c) {
+				return this->write(&c, 1);
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  finish
+			 *
+			 *  Flushes the partially accumulated row (if any) and pads the
+			 *  missing rows when the source has fewer rows than expected.
+			 */
+			/* ------------------------------------------------------------- */
+			void finish() {
+				if (y_ > first_) this->xflush(y_ - first_);
+				while (row_ < dh_) {
+					std::fill(dest_.begin(), dest_.end(), 0);
+					out_.write(reinterpret_cast<const char_type*>(&dest_[0]), dest_.size());
+					++row_;
+				}
+			}
+			
+		private:
+			OutStream& out_;
+			size_type sw_;
+			size_type sh_;
+			size_type dw_;
+			size_type dh_;
+			size_type ch_;
+			size_type y_;		// current source row
+			size_type row_;		// current destination row
+			size_type first_;	// first source row of the current destination row
+			std::vector<byte_type> line_;
+			std::vector<unsigned int> acc_;
+			std::vector<size_type> xmap_;
+			std::vector<byte_type> dest_;
+			
+			/* ------------------------------------------------------------- */
+			//  xaccumulate
+			/* ------------------------------------------------------------- */
+			void xaccumulate(const byte_type* src) {
+				if (row_ >= dh_) return;
+				
+				unsigned int* acc = &acc_[0];
+				for (size_type i = 0; i < dw_; ++i) {
+					const byte_type* p = src + xmap_[i] * ch_;
+					const byte_type* last = src + xmap_[i + 1] * ch_;
+					for (; p < last; p += ch_) {
+						for (size_type c = 0; c < ch_; ++c) acc[c] += p[c];
+					}
+					acc += ch_;
+				}
+				++y_;
+				
+				size_type last = (row_ + 1) * sh_ / dh_;
+				if (y_ >= last) this->xflush(y_ - first_);
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xflush
+			/* ------------------------------------------------------------- */
+			void xflush(size_type rows) {
+				for (size_type i = 0; i < dw_; ++i) {
+					unsigned int n = static_cast<unsigned int>((xmap_[i + 1] - xmap_[i]) * rows);
+					if (n == 0) n = 1;
+					for (size_type c = 0; c < ch_; ++c) {
+						size_type k = i * ch_ + c;
+						dest_[k] = static_cast<byte_type>((acc_[k] + n / 2) / n);
+					}
+				}
+				out_.write(reinterpret_cast<const char_type*>(&dest_[0]), dest_.size());
+				std::fill(acc_.begin(), acc_.end(), 0);
+				first_ = y_;
+				++row_;
+			}
+		};
+	}
+}
+
+#endif // FAML_PDF_RESAMPLE_H
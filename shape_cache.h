@@ -0,0 +1,266 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  shape_cache.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_PDF_SHAPE_CACHE_H
+#define FAML_PDF_SHAPE_CACHE_H
+
+#include <algorithm>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "utility.h"
+#include "coordinate.h"
+#include "clx/literal.h"
+#include "clx/format.h"
+#ifdef FAML_USE_ZLIB
+#include "clx/zstream.h"
+#endif
+
+namespace faml {
+	namespace pdf {
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_shape_cache
+		 *
+		 *  The basic_shape_cache class paints the shapes that differ only
+		 *  by the position (e.g., boxes of flowcharts and org charts) by
+		 *  the same Form XObject. Each shape is rendered at the origin,
+		 *  and the digest of the rendered drawing (which reflects the
+		 *  type, size, adjusts, border, fill and effects) is used as the
+		 *  key. The first occurrence is written inline, and the
+		 *  following ones are painted by the Do operator. The drawing
+		 *  itself is kept only from the second occurrence until the
+		 *  form is written, and the entries seen only once are dropped
+		 *  when the cache grows beyond max_entries.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_shape_cache {
+		public:
+			typedef size_t size_type;
+			typedef CharT char_type;
+			typedef std::basic_string<CharT, Traits> string_type;
+			typedef std::basic_ostream<CharT, Traits> ostream_type;
+			
+			basic_shape_cache() : v_(), used_(), limit_(max_entries) {}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  put
+			 *
+			 *  Renders the shape and writes it to out. The origin of the
+			 *  shape is kept as is after rendering (some shapes such as
+			 *  arrows move the origin for the following text box).
+			 *  Drawings that refer to the named resources (shadings and
+			 *  alpha values are registered per page) or that are too
+			 *  small to share are always written inline.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class Shape>
+			bool put(OutStream& out, Shape& sh) {
+				coordinate o = sh.origin();
+				sh.origin(coordinate(0.0, 0.0));
+				std::basic_ostringstream<CharT, Traits> ss;
+				bool status = sh(ss);
+				coordinate d = sh.origin();
+				sh.origin(coordinate(o.x() + d.x(), o.y() + d.y()));
+				
+				this->paint(out, ss.str(), o);
+				return status;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  paint
+			 *
+			 *  Writes the drawing that is already rendered at the origin
+			 *  to the position o. It is used for the drawings that are
+			 *  repeated many times (e.g., markers of the charts) so that
+			 *  the caller can render them only once.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			void paint(OutStream& out, const string_type& s, const coordinate& o) {
+				static const size_type min_size = 128;
+				if (s.empty()) return;
+				
+				out << LITERAL("q") << std::endl;
+				out << fmt(LITERAL("1 0 0 1 %f %f cm")) % o.x() % o.y() << std::endl;
+				if (s.size() < min_size || s.find(LITERAL("/")) != string_type::npos) out << s;
+				else {
+					digest key(s.begin(), s.end());
+					iterator pos = v_.find(key);
+					if (pos == v_.end()) {
+						if (v_.size() >= limit_) this->xshrink();
+						pos = v_.insert(std::make_pair(key, form_type())).first;
+					}
+					form_type& elem = pos->second;
+					if (++elem.count == 1) out << s;
+					else {
+						if (elem.label.empty()) elem.label = makelabel(string_type(LITERAL("Fm")));
+						if (elem.index == 0 && elem.data.empty()) elem.data = s;
+						if (!elem.used) {
+							elem.used = true;
+							used_.push_back(pos);
+						}
+						out << fmt(LITERAL("/%s Do")) % elem.label << std::endl;
+					}
+				}
+				out << LITERAL("Q") << std::endl;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  operator()
+			 *
+			 *  Writes the Form XObjects painted in the current page (each
+			 *  form is written only once in the document), and adds the
+			 *  references to dest.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager, class Container>
+			bool operator()(OutStream& out, PDFManager& pm, Container& dest) {
+				for (size_type i = 0; i < used_.size(); ++i) {
+					form_type& elem = used_.at(i)->second;
+					if (elem.index == 0) {
+						if (!this->xput_form(out, pm, elem.data, elem)) return false;
+						string_type().swap(elem.data);
+					}
+					elem.used = false;
+					
+					typename Container::value_type obj;
+					obj.index = elem.index;
+					obj.label = elem.label;
+					dest.push_back(obj);
+				}
+				used_.clear();
+				return true;
+			}
+			
+			bool empty() const { return used_.empty(); }
+			size_type size() const { return v_.size(); }
+			
+		private:
+			typedef clx::basic_format<CharT, Traits> fmt;
+			
+			// the number of entries at which the ones seen only once are dropped
+			enum { max_entries = 4096 };
+			
+			struct form_type {
+				int index;			// 0: the object is not written yet
+				string_type label;
+				string_type data;	// the drawing until the object is written
+				size_type count;	// occurrences in the document
+				bool used;			// painted by the form in the current page
+				
+				form_type() : index(0), label(), data(), count(0), used(false) {}
+			};
+			
+			typedef std::map<digest, form_type> container;
+			typedef typename container::iterator iterator;
+			
+			container v_;
+			std::vector<iterator> used_;
+			size_type limit_;
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xshrink
+			 *
+			 *  Drops the entries seen only once. They are never in used_
+			 *  (a form is used from the second occurrence), so the
+			 *  iterators kept there remain valid. The limit is raised
+			 *  when most entries are shared, so that the cache is not
+			 *  scanned at every insertion.
+			 */
+			/* ------------------------------------------------------------- */
+			void xshrink() {
+				for (iterator pos = v_.begin(); pos != v_.end();) {
+					if (pos->second.count == 1) v_.erase(pos++);
+					else ++pos;
+				}
+				limit_ = std::max(static_cast<size_type>(max_entries), v_.size() * 2);
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  xput_form
+			/* ------------------------------------------------------------- */
+			template <class OutStream, class PDFManager>
+			bool xput_form(OutStream& out, PDFManager& pm, const string_type& s, form_type& elem) {
+				// the largest page size allowed in PDF, since shapes may be
+				// drawn outside their bounds (e.g., shadows and callouts).
+				static const double limit = 14400.0;
+				
+				string_type data = s;
+				string_type filter;
+#ifdef FAML_USE_ZLIB
+				std::basic_stringstream<CharT, Traits> ss;
+				filter = LITERAL("/FlateDecode");
+				{
+					clx::basic_zstream<Z_DEFAULT_COMPRESSION, CharT, Traits> z(ss);
+					z.write(s.c_str(), s.size());
+					z.finish();
+				}
+				data = ss.str();
+#endif
+				
+				elem.index = static_cast<int>(pm.newindex());
+				out << fmt(LITERAL("%d 0 obj")) % elem.index << std::endl;
+				out << LITERAL("<<") << std::endl;
+				out << LITERAL("/Type /XObject") << std::endl;
+				out << LITERAL("/Subtype /Form") << std::endl;
+				out << fmt(LITERAL("/BBox [ %f %f %f %f ]")) % (-limit) % (-limit) % limit % limit << std::endl;
+				out << LITERAL("/Resources << /ProcSet [ /PDF ] >>") << std::endl;
+				out << fmt(LITERAL("/Length %d")) % data.size() << std::endl;
+				if (!filter.empty()) out << fmt(LITERAL("/Filter [ %s ]")) % filter << std::endl;
+				out << LITERAL(">>") << std::endl;
+				out << LITERAL("stream") << std::endl;
+				out << data;
+				out << std::endl;
+				out << LITERAL("endstream") << std::endl;
+				out << LITERAL("endobj") << std::endl;
+				out << std::endl;
+				
+				return true;
+			}
+		};
+	}
+}
+
+#endif // FAML_PDF_SHAPE_CACHE_H
@@ -0,0 +1,263 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  test/breakline.cpp
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  breakline
+ *
+ *  Tests utf16::breakline() and text_helper::breakline() (text_helper.h).
+ *  The lines are checked with the line breaking rules, and compared
+ *  with the previous getline() (the reference below) on random text.
+ *
+ *    g++ -I.. -I<clx> breakline.cpp -o breakline && ./breakline
+ */
+/* ------------------------------------------------------------------------- */
+#include <cstdlib>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "text_helper.h"
+
+typedef faml::pdf::basic_font_property<char> property_type;
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  reference
+ *
+ *  The getline() before breakline() was introduced. Returns the width
+ *  of the line, and first is moved to the end of the line.
+ */
+/* ------------------------------------------------------------------------- */
+size_t reference(std::string::const_iterator& first, std::string::const_iterator last,
+	size_t limit, bool wrap, const property_type& info) {
+	namespace utf16 = faml::pdf::utf16;
+	std::string::const_iterator pbeg = first;
+	std::string::const_iterator pback = first;
+	size_t m = 0, n = 0;
+	while (first != last && n <= limit) {
+		word_type wc = utf16::getc(first, last);
+		size_t l = utf16::getw(wc, info);
+		if (n + m + l > limit) {
+			if (utf16::is_tail(wc)) {
+				pbeg = first;
+				pback = first;
+			}
+			else if (utf16::is_rpunct(wc) || (wrap && utf16::is_alnum(wc))) first = pbeg;
+			else {
+				first = pback;
+				pbeg = pback;
+			}
+			break;
+		}
+		
+		m += l;
+		pback = first;
+		
+		if (!utf16::is_lpunct(wc) && (!wrap || !utf16::is_alnum(wc))) {
+			n += m;
+			m = 0;
+			pbeg = pback;
+		}
+		if (utf16::is_break(wc)) break;
+	}
+	
+	if (first == last && pbeg != pback) n += m;
+	return n;
+}
+
+/* ------------------------------------------------------------------------- */
+//  u16 (the UTF-16 string of the code list terminated by 0)
+/* ------------------------------------------------------------------------- */
+std::string u16(const unsigned short* codes) {
+	std::string dest;
+	for (; *codes != 0; ++codes) {
+		dest += static_cast<char>((*codes >> 8) & 0xff);
+		dest += static_cast<char>(*codes & 0xff);
+	}
+	return dest;
+}
+
+std::string u16(const char* s) {
+	std::vector<unsigned short> v(s, s + std::char_traits<char>::length(s));
+	v.push_back(0);
+	return u16(&v[0]);
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  line
+ *
+ *  Breaks the first line of s, and returns the number of characters
+ *  in the line. used and width are the values given by breakline().
+ */
+/* ------------------------------------------------------------------------- */
+size_t line(const std::string& s, size_t limit, bool wrap, const property_type& info,
+	size_t& used, size_t& width) {
+	std::string::const_iterator pos = faml::pdf::utf16::breakline(s.begin(), s.end(), limit, wrap, info, used, width);
+	return (pos - s.begin()) / 2;
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_rules
+ *
+ *  The ASCII characters are 500 wide, and the others are 1000.
+ */
+/* ------------------------------------------------------------------------- */
+void test_rules(const property_type& info) {
+	size_t used = 0, width = 0;
+	
+	// : breaks at the limit.
+	static const unsigned short kana[] = { 0x3042, 0x3044, 0x3046, 0x3048, 0x304a, 0 };
+	FAML_CHECK(line(u16(kana), 2500, true, info, used, width) == 2 && used == 2000 && width == 2000);
+	FAML_CHECK(line(u16(kana), 10000, true, info, used, width) == 5 && used == 5000 && width == 5000);
+	FAML_CHECK(line(u16(kana), 0, true, info, used, width) == 0 && used == 0 && width == 0);
+	
+	// B: the full stop hangs over the limit, and is not in used.
+	static const unsigned short tail[] = { 0x3042, 0x3044, 0x3002, 0x3046, 0 };
+	FAML_CHECK(line(u16(tail), 2000, true, info, used, width) == 3 && used == 2000 && width == 3000);
+	
+	// u: the opening bracket stays with the preceding text.
+	static const unsigned short lpunct[] = { 0x3042, 0x300c, 0x3044, 0 };
+	FAML_CHECK(line(u16(lpunct), 2000, true, info, used, width) == 2 && used == 1000 && width == 2000);
+	
+	// b: the small kana does not start the line.
+	static const unsigned short rpunct[] = { 0x3042, 0x3044, 0x30c3, 0 };
+	FAML_CHECK(line(u16(rpunct), 2000, true, info, used, width) == 2 && used == 2000 && width == 2000);
+	
+	// words are wrapped at the space, or broken when wrap is false.
+	FAML_CHECK(line(u16("ab cd"), 2000, true, info, used, width) == 3 && used == 1500 && width == 1500);
+	FAML_CHECK(line(u16("ab cd"), 2000, false, info, used, width) == 4 && used == 2000 && width == 2000);
+	FAML_CHECK(line(u16("abcdef"), 2000, true, info, used, width) == 0 && used == 0 && width == 0);
+	
+	// the line ends at LF, and LF is in the line.
+	FAML_CHECK(line(u16("ab\ncd"), 10000, true, info, used, width) == 3 && used == 1500 && width == 1500);
+	
+	// the last word is in the line at the end of the text.
+	FAML_CHECK(line(u16("ab cd"), 10000, true, info, used, width) == 5 && used == 2500 && width == 2500);
+	
+	// the odd byte at the end is an error.
+	std::string bad = u16("ab") + 'c';
+	bool error = false;
+	try {
+		line(bad, 10000, true, info, used, width);
+	}
+	catch (std::runtime_error&) {
+		error = true;
+	}
+	FAML_CHECK(error);
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_random
+ *
+ *  Compares breakline() and getline() with the reference on random
+ *  text of the characters of every class.
+ */
+/* ------------------------------------------------------------------------- */
+void test_random(const property_type& info) {
+	static const unsigned short alphabet[] = {
+		'a', 'Z', '0', ' ', '\n', '(', ')', '.', ',', '-', '{', 0x00a0,
+		0x3000, 0x3042, 0x30a2, 0x4e00, 0x3001, 0x3002, 0x300c, 0x300d,
+		0x30c3, 0x30fc, 0xff08, 0xff09, 0x2026
+	};
+	static const size_t n = sizeof(alphabet) / sizeof(alphabet[0]);
+	
+	std::srand(37);
+	for (int k = 0; k < 2000; ++k) {
+		std::vector<unsigned short> codes;
+		size_t size = std::rand() % 40;
+		for (size_t i = 0; i < size; ++i) codes.push_back(alphabet[std::rand() % n]);
+		codes.push_back(0);
+		const std::string s = u16(&codes[0]);
+		size_t limit = std::rand() % 8000;
+		bool wrap = (k % 2) == 0;
+		
+		std::string::const_iterator first = s.begin();
+		while (first != s.end()) {
+			std::string::const_iterator expected = first;
+			size_t n0 = reference(expected, s.end(), limit, wrap, info);
+			
+			size_t used = 0, width = 0;
+			std::string::const_iterator pos = faml::pdf::utf16::breakline(first, s.end(), limit, wrap, info, used, width);
+			FAML_CHECK(pos == expected);
+			FAML_CHECK(used == n0);
+			FAML_CHECK(width == faml::pdf::utf16::width(first, pos, info));
+			
+			std::string dest;
+			std::string::const_iterator it = first;
+			FAML_CHECK(faml::pdf::utf16::getline(it, s.end(), std::back_inserter(dest), limit, wrap, info) == n0);
+			FAML_CHECK(it == expected && dest == std::string(first, expected));
+			
+			if (pos == first) break; // the character wider than limit
+			first = pos;
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+//  test_helper
+/* ------------------------------------------------------------------------- */
+void test_helper(const property_type& info) {
+	size_t used = 0, width = 0;
+	
+	faml::pdf::text_helper utf16(info, faml::pdf::charset::utf16);
+	const std::string s = u16("ab cd.");
+	std::string::const_iterator pos = utf16.breakline(s.begin(), s.end(), 2000, used, width);
+	FAML_CHECK(pos - s.begin() == 6 && used == 1500 && width == 1500);
+	
+	// the MBCS charsets are broken by getline().
+	faml::pdf::text_helper win(info, faml::pdf::charset::win);
+	const std::string t("ab cd.");
+	pos = win.breakline(t.begin(), t.end(), 2000, used, width);
+	std::string::const_iterator it = t.begin();
+	std::string dest;
+	size_t n = win.getline(it, t.end(), std::back_inserter(dest), 2000);
+	FAML_CHECK(pos == it && used == n && width == win.width(t.begin(), pos));
+}
+
+int main() {
+	property_type info;
+	info.type(1);
+	std::vector<int> widths(0x80, 500);
+	info.widths(widths.begin(), widths.end());
+	
+	test_rules(info);
+	test_random(info);
+	test_helper(info);
+	return FAML_CHECK_RESULT();
+}
@@ -0,0 +1,72 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  test/check.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_TEST_CHECK_H
+#define FAML_TEST_CHECK_H
+
+#include <iostream>
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  FAML_CHECK
+ *
+ *  The minimal check used by the test programs in this directory. The
+ *  failed condition is printed with the line, and the program returns
+ *  the number of the failures from main() by FAML_CHECK_RESULT().
+ *  Each test program is built alone, e.g.:
+ *
+ *    g++ -I.. -I<clx> number_cast.cpp -o number_cast && ./number_cast
+ */
+/* ------------------------------------------------------------------------- */
+namespace faml {
+	namespace test {
+		inline int& failures() {
+			static int n = 0;
+			return n;
+		}
+		
+		inline void check(bool status, const char* expr, const char* file, int line) {
+			if (status) return;
+			std::cerr << file << ":" << line << ": check failed: " << expr << std::endl;
+			++failures();
+		}
+	}
+}
+
+#define FAML_CHECK(expr) faml::test::check(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
+
+#define FAML_CHECK_RESULT() \
+	(std::cout << ((faml::test::failures() == 0) ? "OK" : "FAILED") << std::endl, faml::test::failures())
+
+#endif // FAML_TEST_CHECK_H
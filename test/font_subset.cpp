@@ -0,0 +1,516 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  test/font_subset.cpp
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  font_subset
+ *
+ *  Tests the TrueType subsetter (font_subset.h) and the embedded font
+ *  (font.h) with a small font built in memory: the cmap lookup, the
+ *  hmtx widths, the loca/glyf round trip with a composite glyph, the
+ *  vertical forms in GSUB, and the fallback to the font which is not
+ *  embedded. The path of a real TrueType font may be given to make
+ *  its subset as well:
+ *
+ *    g++ -I.. -I<clx> font_subset.cpp -o font_subset && ./font_subset [font.ttf]
+ */
+/* ------------------------------------------------------------------------- */
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "check.h"
+
+// the streams are written as they are, so that they can be read here.
+#undef FAML_USE_ZLIB
+
+#include "font.h"
+#include "font_subset.h"
+
+typedef std::vector<unsigned char> buffer_type;
+typedef std::map<std::string, buffer_type> table_map;
+
+/* ------------------------------------------------------------------------- */
+//  big-endian helpers
+/* ------------------------------------------------------------------------- */
+void put16(buffer_type& v, unsigned long x) {
+	v.push_back(static_cast<unsigned char>((x >> 8) & 0xff));
+	v.push_back(static_cast<unsigned char>(x & 0xff));
+}
+
+void put32(buffer_type& v, unsigned long x) {
+	put16(v, (x >> 16) & 0xffff);
+	put16(v, x & 0xffff);
+}
+
+unsigned long get16(const buffer_type& v, size_t pos) {
+	return (pos + 2 > v.size()) ? 0 : (static_cast<unsigned long>(v[pos]) << 8) | v[pos + 1];
+}
+
+unsigned long get32(const buffer_type& v, size_t pos) {
+	return (get16(v, pos) << 16) | get16(v, pos + 2);
+}
+
+void set16(buffer_type& v, size_t pos, unsigned long x) {
+	v[pos] = static_cast<unsigned char>((x >> 8) & 0xff);
+	v[pos + 1] = static_cast<unsigned char>(x & 0xff);
+}
+
+/* ------------------------------------------------------------------------- */
+//  checksum (the sum of the big-endian 32-bit words)
+/* ------------------------------------------------------------------------- */
+unsigned long checksum(const buffer_type& v, size_t first, size_t n) {
+	unsigned long dest = 0;
+	for (size_t i = 0; i < n; i += 4) {
+		unsigned long x = 0;
+		for (size_t k = 0; k < 4; ++k) x = (x << 8) | ((i + k < n) ? v[first + i + k] : 0);
+		dest = (dest + x) & 0xffffffffUL;
+	}
+	return dest;
+}
+
+/* ------------------------------------------------------------------------- */
+//  tables (reads the table directory)
+/* ------------------------------------------------------------------------- */
+table_map tables(const buffer_type& v) {
+	table_map dest;
+	size_t n = get16(v, 4);
+	for (size_t i = 0; i < n; ++i) {
+		size_t pos = 12 + i * 16;
+		std::string tag(v.begin() + pos, v.begin() + pos + 4);
+		size_t first = get32(v, pos + 8);
+		size_t size = get32(v, pos + 12);
+		if (first + size > v.size()) continue;
+		dest[tag].assign(v.begin() + first, v.begin() + first + size);
+		FAML_CHECK(checksum(v, first, size) == get32(v, pos + 4) || tag == "head");
+	}
+	return dest;
+}
+
+/* ------------------------------------------------------------------------- */
+//  glyph (returns the glyph data by using loca)
+/* ------------------------------------------------------------------------- */
+buffer_type glyph(table_map& t, size_t gid) {
+	bool longloca = get16(t["head"], 50) != 0;
+	size_t first = longloca ? get32(t["loca"], gid * 4) : get16(t["loca"], gid * 2) * 2;
+	size_t last = longloca ? get32(t["loca"], gid * 4 + 4) : get16(t["loca"], gid * 2 + 2) * 2;
+	if (last <= first || last > t["glyf"].size()) return buffer_type();
+	return buffer_type(t["glyf"].begin() + first, t["glyf"].begin() + last);
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  make_font
+ *
+ *  Builds the font of 7 glyphs (unitsPerEm = 2048, short loca):
+ *    0: .notdef (empty), 1: 'A', 2: 'B', 3: 'C' (composite of 'B'),
+ *    4: U+3001, 5: the vertical form of 4 (by GSUB 'vert'),
+ *    6: unused.
+ *  The glyphs 5 and 6 use the last advance of hmtx.
+ */
+/* ------------------------------------------------------------------------- */
+buffer_type make_font() {
+	table_map t;
+	
+	// glyf and loca (short)
+	std::vector<buffer_type> glyphs(7);
+	for (size_t i = 1; i < glyphs.size(); ++i) {
+		if (i == 3) continue;
+		put16(glyphs[i], 1);							// numberOfContours
+		for (size_t k = 0; k < 4; ++k) put16(glyphs[i], i * 100 + k);	// bbox
+		put16(glyphs[i], 0);							// endPtsOfContours
+		put16(glyphs[i], 0);							// instructionLength
+		glyphs[i].push_back(0x01);						// flags
+		glyphs[i].push_back(static_cast<unsigned char>(i));	// (the glyph is identified by this byte)
+	}
+	put16(glyphs[3], 0xffff);							// composite
+	for (size_t k = 0; k < 4; ++k) put16(glyphs[3], 0);
+	put16(glyphs[3], 0x0000);							// flags (byte args, no more components)
+	put16(glyphs[3], 2);								// glyphIndex
+	glyphs[3].push_back(0);
+	glyphs[3].push_back(0);
+	
+	for (size_t i = 0; i < glyphs.size(); ++i) {
+		put16(t["loca"], t["glyf"].size() / 2);
+		t["glyf"].insert(t["glyf"].end(), glyphs[i].begin(), glyphs[i].end());
+	}
+	put16(t["loca"], t["glyf"].size() / 2);
+	
+	// hmtx (5 long metrics, and 2 left side bearings)
+	static const unsigned long advances[] = { 1024, 1229, 1331, 1434, 2048 };
+	for (size_t i = 0; i < 5; ++i) {
+		put16(t["hmtx"], advances[i]);
+		put16(t["hmtx"], i);
+	}
+	put16(t["hmtx"], 5);
+	put16(t["hmtx"], 6);
+	
+	// head, hhea, maxp
+	buffer_type& head = t["head"];
+	put32(head, 0x00010000);
+	put32(head, 0x00010000);
+	put32(head, 0);										// checkSumAdjustment
+	put32(head, 0x5f0f3cf5);
+	put16(head, 0);
+	put16(head, 2048);									// unitsPerEm
+	while (head.size() < 54) head.push_back(0);			// indexToLocFormat = 0 (short)
+	t["hhea"].assign(36, 0);
+	put32(t["hhea"], 0);
+	set16(t["hhea"], 0, 1);
+	set16(t["hhea"], 34, 5);							// numberOfHMetrics
+	t["hhea"].resize(36);
+	put32(t["maxp"], 0x00005000);
+	put16(t["maxp"], glyphs.size());
+	
+	// cmap (format 4): 'A'-'C' -> 1-3, U+3001 -> 4
+	buffer_type& cmap = t["cmap"];
+	put16(cmap, 0);
+	put16(cmap, 1);
+	put16(cmap, 3);
+	put16(cmap, 1);
+	put32(cmap, 12);
+	static const unsigned long starts[] = { 0x41, 0x3001, 0xffff };
+	static const unsigned long ends[] = { 0x43, 0x3001, 0xffff };
+	static const long deltas[] = { 1 - 0x41, 4 - 0x3001, 1 };
+	put16(cmap, 4);
+	put16(cmap, 16 + 3 * 8);
+	put16(cmap, 0);
+	put16(cmap, 3 * 2);
+	put16(cmap, 4);
+	put16(cmap, 1);
+	put16(cmap, 2);
+	for (size_t i = 0; i < 3; ++i) put16(cmap, ends[i]);
+	put16(cmap, 0);
+	for (size_t i = 0; i < 3; ++i) put16(cmap, starts[i]);
+	for (size_t i = 0; i < 3; ++i) put16(cmap, static_cast<unsigned long>(deltas[i]) & 0xffff);
+	for (size_t i = 0; i < 3; ++i) put16(cmap, 0);
+	
+	// GSUB: 'vert' -> lookup 0 (single substitution, format 2): 4 -> 5
+	buffer_type& gsub = t["GSUB"];
+	put32(gsub, 0x00010000);
+	put16(gsub, 10);									// ScriptList
+	put16(gsub, 12);									// FeatureList
+	put16(gsub, 26);									// LookupList
+	put16(gsub, 0);										// (no scripts)
+	put16(gsub, 1);										// FeatureList
+	gsub.insert(gsub.end(), "vert", "vert" + 4);
+	put16(gsub, 8);
+	put16(gsub, 0);										// Feature
+	put16(gsub, 1);
+	put16(gsub, 0);
+	put16(gsub, 1);										// LookupList
+	put16(gsub, 4);
+	put16(gsub, 1);										// Lookup
+	put16(gsub, 0);
+	put16(gsub, 1);
+	put16(gsub, 8);
+	put16(gsub, 2);										// SingleSubstFormat2
+	put16(gsub, 8);
+	put16(gsub, 1);
+	put16(gsub, 5);
+	put16(gsub, 1);										// Coverage
+	put16(gsub, 1);
+	put16(gsub, 4);
+	
+	// table directory
+	buffer_type dest;
+	put32(dest, 0x00010000);
+	put16(dest, t.size());
+	put16(dest, 0);
+	put16(dest, 0);
+	put16(dest, 0);
+	size_t offset = 12 + t.size() * 16;
+	for (table_map::iterator pos = t.begin(); pos != t.end(); ++pos) {
+		dest.insert(dest.end(), pos->first.begin(), pos->first.end());
+		put32(dest, checksum(pos->second, 0, pos->second.size()));
+		put32(dest, offset);
+		put32(dest, pos->second.size());
+		offset += (pos->second.size() + 3) & ~static_cast<size_t>(3);
+	}
+	for (table_map::iterator pos = t.begin(); pos != t.end(); ++pos) {
+		dest.insert(dest.end(), pos->second.begin(), pos->second.end());
+		while (dest.size() % 4 != 0) dest.push_back(0);
+	}
+	return dest;
+}
+
+/* ------------------------------------------------------------------------- */
+//  write_file
+/* ------------------------------------------------------------------------- */
+void write_file(const std::string& path, const buffer_type& v) {
+	std::ofstream out(path.c_str(), std::ios::out | std::ios::binary);
+	out.write(reinterpret_cast<const char*>(&v[0]), v.size());
+}
+
+/* ------------------------------------------------------------------------- */
+//  stream (returns the data of the stream object)
+/* ------------------------------------------------------------------------- */
+buffer_type stream(const std::string& s, size_t index) {
+	std::ostringstream head;
+	head << index << " 0 obj";
+	size_t first = s.find("stream\n", s.find(head.str())) + 7;
+	size_t last = s.find("\nendstream", first);
+	if (first < 7 || last == std::string::npos) return buffer_type();
+	return buffer_type(s.begin() + first, s.begin() + last);
+}
+
+/* ------------------------------------------------------------------------- */
+//  pdf_manager (the object numbers and offsets only)
+/* ------------------------------------------------------------------------- */
+class pdf_manager {
+public:
+	pdf_manager(std::ostream& out) : out_(out), pos_(1, 0) {}
+	
+	size_t newindex() {
+		pos_.push_back(static_cast<size_t>(out_.tellp()));
+		return pos_.size() - 1;
+	}
+	
+	void setp(size_t index) { pos_.at(index) = static_cast<size_t>(out_.tellp()); }
+	size_t index() const { return pos_.size() - 1; }
+	
+	// every object is written at the offset given to it.
+	bool written(const std::string& s) const {
+		for (size_t i = 1; i < pos_.size(); ++i) {
+			std::ostringstream head;
+			head << i << " 0 obj";
+			if (s.compare(pos_[i], head.str().size(), head.str()) != 0) return false;
+		}
+		return true;
+	}
+
+private:
+	std::ostream& out_;
+	std::vector<size_t> pos_;
+};
+
+/* ------------------------------------------------------------------------- */
+//  test_read
+/* ------------------------------------------------------------------------- */
+void test_read(const std::string& path) {
+	faml::pdf::true_type_subset ttf;
+	FAML_CHECK(ttf.read(path));
+	FAML_CHECK(ttf.glyph(0x41) == 1);
+	FAML_CHECK(ttf.glyph(0x43) == 3);
+	FAML_CHECK(ttf.glyph(0x3001) == 4);
+	FAML_CHECK(ttf.glyph(0x44) == 0);
+	FAML_CHECK(ttf.glyph(0x10000) == 0);
+	FAML_CHECK(ttf.width(0) == 500);
+	FAML_CHECK(ttf.width(1) == 600);
+	FAML_CHECK(ttf.width(4) == 1000);
+	FAML_CHECK(ttf.width(6) == 1000);
+	
+	std::map<unsigned short, unsigned short> vert;
+	ttf.vertical(vert);
+	FAML_CHECK(vert.size() == 1 && vert[4] == 5);
+	
+	FAML_CHECK(!ttf.read(path + ".none"));
+}
+
+/* ------------------------------------------------------------------------- */
+//  test_subset
+/* ------------------------------------------------------------------------- */
+void test_subset(const std::string& path) {
+	faml::pdf::true_type_subset ttf;
+	ttf.read(path);
+	
+	std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+	buffer_type src((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	table_map orig = tables(src);
+	
+	// 'C' pulls in its component 'B', and .notdef is always kept.
+	std::vector<unsigned short> gids;
+	gids.push_back(ttf.glyph(0x43));
+	gids.push_back(5);
+	buffer_type data;
+	FAML_CHECK(ttf.subset(gids, data));
+	FAML_CHECK(gids.size() == 4 && gids[0] == 0 && gids[1] == 2 && gids[2] == 3 && gids[3] == 5);
+	
+	table_map t = tables(data);
+	FAML_CHECK(checksum(data, 0, data.size()) == 0xb1b0afbaUL);
+	FAML_CHECK(get16(t["maxp"], 4) == gids.size());
+	FAML_CHECK(get16(t["hhea"], 34) == gids.size());
+	FAML_CHECK(get16(t["head"], 50) == 1);
+	FAML_CHECK(t["loca"].size() == (gids.size() + 1) * 4);
+	FAML_CHECK(t.find("cmap") == t.end());
+	
+	// the simple glyphs are copied as they are.
+	FAML_CHECK(glyph(t, 0).empty());
+	FAML_CHECK(glyph(t, 1) == glyph(orig, 2));
+	FAML_CHECK(glyph(t, 3) == glyph(orig, 5));
+	
+	// the component of the composite glyph is renumbered (2 -> 1).
+	buffer_type c = glyph(t, 2);
+	buffer_type oc = glyph(orig, 3);
+	FAML_CHECK(c.size() == oc.size() && get16(c, 12) == 1 && get16(oc, 12) == 2);
+	
+	// hmtx keeps the advances and the left side bearings.
+	FAML_CHECK(get16(t["hmtx"], 1 * 4) == 1331 && get16(t["hmtx"], 1 * 4 + 2) == 2);
+	FAML_CHECK(get16(t["hmtx"], 3 * 4) == 2048 && get16(t["hmtx"], 3 * 4 + 2) == 5);
+}
+
+/* ------------------------------------------------------------------------- */
+//  test_font
+/* ------------------------------------------------------------------------- */
+void test_font(const std::string& path, int dir) {
+	typedef faml::pdf::basic_font<char> font_type;
+	faml::pdf::font_property prop;
+	prop.name("Test");
+	prop.type(0);
+	
+	font_type f(prop, faml::pdf::charset::utf16, dir);
+	f.embed(path);
+	font_type cp(f);
+	
+	std::ostringstream out;
+	pdf_manager pm(out);
+	FAML_CHECK(f(out, pm));
+	FAML_CHECK(out.str().empty()); // written by finish()
+	FAML_CHECK(f.index() == 1);
+	cp.use(std::string("\x00" "A" "\x30\x01", 4));
+	FAML_CHECK(cp.finish(out, pm));
+	FAML_CHECK(f.finish(out, pm)); // the copies share the subset.
+	
+	std::string s = out.str();
+	FAML_CHECK(pm.written(s));
+	FAML_CHECK(s.find("/Encoding /Identity-" + std::string(dir == faml::horizon ? "H" : "V")) != std::string::npos);
+	FAML_CHECK(s.find("/FontFile2 4 0 R") != std::string::npos);
+	FAML_CHECK(s.find("/CIDToGIDMap 5 0 R") != std::string::npos);
+	FAML_CHECK(s.find("/DescendantFonts [ 2 0 R ]") != std::string::npos);
+	FAML_CHECK(s.find("/FontDescriptor 3 0 R") != std::string::npos);
+	
+	// W has the advances of the original glyphs (also in vertical writing).
+	FAML_CHECK(s.find("[ 65 [ 600 ] 12289 [ 1000 ] ]") != std::string::npos);
+	
+	// CIDToGIDMap: U+3001 is the glyph 4, or its vertical form 5 in Identity-V.
+	std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+	buffer_type src((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	table_map orig = tables(src);
+	table_map t = tables(stream(s, 4));
+	buffer_type cidmap = stream(s, 5);
+	FAML_CHECK(cidmap.size() == (0x3001 + 1) * 2); // up to the last code used
+	FAML_CHECK(glyph(t, get16(cidmap, 0x41 * 2)) == glyph(orig, 1));
+	FAML_CHECK(glyph(t, get16(cidmap, 0x3001 * 2)) == glyph(orig, (dir == faml::horizon) ? 4 : 5));
+	FAML_CHECK(get16(cidmap, 0x42 * 2) == 0);
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_fallback
+ *
+ *  The font whose subset cannot be made is written as the font which
+ *  is not embedded (UniJIS-UTF16 with Adobe-Japan1).
+ */
+/* ------------------------------------------------------------------------- */
+void test_fallback(const std::string& path) {
+	faml::pdf::font_property prop;
+	prop.name("Test");
+	prop.type(0);
+	faml::pdf::basic_font<char> f(prop, faml::pdf::charset::utf16, faml::vertical);
+	f.embed(path + ".none");
+	
+	std::ostringstream out;
+	pdf_manager pm(out);
+	FAML_CHECK(f(out, pm));
+	f.use(std::string("\x00" "A", 2));
+	FAML_CHECK(f.finish(out, pm));
+	
+	std::string s = out.str();
+	FAML_CHECK(pm.written(s));
+	FAML_CHECK(s.find("/Encoding /UniJIS-UTF16-V") != std::string::npos);
+	FAML_CHECK(s.find("(Japan1)") != std::string::npos);
+	FAML_CHECK(s.find("/FontFile2") == std::string::npos);
+	FAML_CHECK(s.find("/ToUnicode") == std::string::npos);
+	FAML_CHECK(s.find("+") == std::string::npos); // no subset tag
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_file
+ *
+ *  Makes the subset of the real font, and checks that each glyph is
+ *  copied from the original font through cmap and loca.
+ */
+/* ------------------------------------------------------------------------- */
+void test_file(const std::string& path) {
+	faml::pdf::true_type_subset ttf;
+	if (!ttf.read(path)) {
+		std::cerr << "cannot read the font file: " << path << std::endl;
+		FAML_CHECK(false);
+		return;
+	}
+	
+	std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+	buffer_type src((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	table_map orig = tables(src);
+	
+	const std::string text("Hello, World! 0123456789");
+	std::vector<unsigned short> gids;
+	for (size_t i = 0; i < text.size(); ++i) gids.push_back(ttf.glyph(static_cast<unsigned char>(text[i])));
+	std::vector<unsigned short> used(gids);
+	buffer_type data;
+	FAML_CHECK(ttf.subset(gids, data));
+	
+	table_map t = tables(data);
+	FAML_CHECK(checksum(data, 0, data.size()) == 0xb1b0afbaUL);
+	FAML_CHECK(get16(t["maxp"], 4) == gids.size());
+	for (size_t i = 0; i < used.size(); ++i) {
+		size_t id = std::lower_bound(gids.begin(), gids.end(), used[i]) - gids.begin();
+		FAML_CHECK(id < gids.size() && gids[id] == used[i]);
+		buffer_type g = glyph(t, id);
+		buffer_type og = glyph(orig, used[i]);
+		FAML_CHECK(g.size() >= og.size() && g.size() < og.size() + 4);
+		if (!og.empty() && static_cast<short>(get16(og, 0)) >= 0) {
+			FAML_CHECK(std::equal(og.begin(), og.end(), g.begin()));
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	std::string path("font_subset_test.ttf");
+	write_file(path, make_font());
+	
+	test_read(path);
+	test_subset(path);
+	test_font(path, faml::horizon);
+	test_font(path, faml::vertical);
+	test_fallback(path);
+	for (int i = 1; i < argc; ++i) test_file(argv[i]);
+	
+	std::remove(path.c_str());
+	return FAML_CHECK_RESULT();
+}
@@ -0,0 +1,257 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  test/guide.cpp
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  guide
+ *
+ *  Tests officex::basic_guide_list (officex/guide.h): the built-in
+ *  variables, each formula of the shape guides, the references to
+ *  the preceding guides, the adjust values, and the errors.
+ *
+ *    g++ -I.. -I<clx> -I<rapidxml> guide.cpp -o guide && ./guide
+ */
+/* ------------------------------------------------------------------------- */
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "check.h"
+#include "officex/guide.h"
+
+typedef faml::officex::basic_guide_list<char> guide_list;
+
+/* ------------------------------------------------------------------------- */
+//  near
+/* ------------------------------------------------------------------------- */
+bool near(double x, double y) {
+	return std::fabs(x - y) < 1e-6 * std::max(1.0, std::fabs(y));
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  eval
+ *
+ *  Compiles <a:avLst> and <a:gdLst> in the xml, and evaluates them for
+ *  the shape of (w x h).
+ */
+/* ------------------------------------------------------------------------- */
+std::vector<double> eval(const std::string& xml, double w, double h,
+	const guide_list::adjust_map& adj = guide_list::adjust_map()) {
+	std::vector<char> s(xml.begin(), xml.end());
+	s.push_back(0);
+	rapidxml::xml_document<char> doc;
+	doc.parse<0>(&s[0]);
+	
+	rapidxml::xml_node<char>* root = doc.first_node();
+	guide_list gd;
+	gd.read(root->first_node("a:avLst"), root->first_node("a:gdLst"));
+	
+	std::vector<double> dest;
+	gd.eval(w, h, adj, dest);
+	return dest;
+}
+
+/* ------------------------------------------------------------------------- */
+//  gdlst (a:gdLst of one guide)
+/* ------------------------------------------------------------------------- */
+std::string gdlst(const std::string& fmla) {
+	return "<a:custGeom><a:gdLst><a:gd name=\"x\" fmla=\"" + fmla + "\"/></a:gdLst></a:custGeom>";
+}
+
+/* ------------------------------------------------------------------------- */
+//  one (evaluates one formula for the shape of 800 x 200)
+/* ------------------------------------------------------------------------- */
+double one(const std::string& fmla) {
+	std::vector<double> v = eval(gdlst(fmla), 800.0, 200.0);
+	return v.empty() ? -1.0 : v[0];
+}
+
+/* ------------------------------------------------------------------------- */
+//  throws
+/* ------------------------------------------------------------------------- */
+bool throws(const std::string& xml) {
+	try {
+		eval(xml, 800.0, 200.0);
+	}
+	catch (std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+/* ------------------------------------------------------------------------- */
+//  test_builtin
+/* ------------------------------------------------------------------------- */
+void test_builtin() {
+	FAML_CHECK(near(one("val w"), 800.0));
+	FAML_CHECK(near(one("val r"), 800.0));
+	FAML_CHECK(near(one("val h"), 200.0));
+	FAML_CHECK(near(one("val b"), 200.0));
+	FAML_CHECK(near(one("val l"), 0.0));
+	FAML_CHECK(near(one("val t"), 0.0));
+	FAML_CHECK(near(one("val hc"), 400.0));
+	FAML_CHECK(near(one("val vc"), 100.0));
+	FAML_CHECK(near(one("val ss"), 200.0));
+	FAML_CHECK(near(one("val ls"), 800.0));
+	FAML_CHECK(near(one("val wd2"), 400.0));
+	FAML_CHECK(near(one("val wd10"), 80.0));
+	FAML_CHECK(near(one("val hd4"), 50.0));
+	FAML_CHECK(near(one("val ssd8"), 25.0));
+	FAML_CHECK(near(one("val cd2"), 10800000.0));
+	FAML_CHECK(near(one("val cd4"), 5400000.0));
+	FAML_CHECK(near(one("val 3cd4"), 16200000.0));
+	FAML_CHECK(near(one("val 7cd8"), 18900000.0));
+	FAML_CHECK(near(one("val -12.5"), -12.5));
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_formula
+ *
+ *  Each formula of ECMA-376 20.1.9.11 (angles in 60,000ths of a
+ *  degree).
+ */
+/* ------------------------------------------------------------------------- */
+void test_formula() {
+	FAML_CHECK(near(one("*/ w 3 4"), 600.0));
+	FAML_CHECK(near(one("*/ w 3 0"), 0.0));
+	FAML_CHECK(near(one("+- w h 50"), 950.0));
+	FAML_CHECK(near(one("+/ w h 2"), 500.0));
+	FAML_CHECK(near(one("?: 1 w h"), 800.0));
+	FAML_CHECK(near(one("?: 0 w h"), 200.0));
+	FAML_CHECK(near(one("?: -1 w h"), 200.0));
+	FAML_CHECK(near(one("abs -7"), 7.0));
+	FAML_CHECK(near(one("sqrt 144"), 12.0));
+	FAML_CHECK(near(one("max w h"), 800.0));
+	FAML_CHECK(near(one("min w h"), 200.0));
+	FAML_CHECK(near(one("sin 100 cd4"), 100.0));
+	FAML_CHECK(near(one("sin 100 1800000"), 50.0));
+	FAML_CHECK(near(one("cos 100 cd2"), -100.0));
+	FAML_CHECK(near(one("tan 100 2700000"), 100.0));
+	FAML_CHECK(near(one("at2 100 100"), 2700000.0));
+	FAML_CHECK(near(one("at2 0 5"), 5400000.0));
+	FAML_CHECK(near(one("at2 -1 0"), 10800000.0));
+	FAML_CHECK(near(one("cat2 100 3 4"), 60.0));
+	FAML_CHECK(near(one("sat2 100 3 4"), 80.0));
+	FAML_CHECK(near(one("mod 2 3 6"), 7.0));
+	FAML_CHECK(near(one("pin 0 -5 100"), 0.0));
+	FAML_CHECK(near(one("pin 0 50 100"), 50.0));
+	FAML_CHECK(near(one("pin 0 150 100"), 100.0));
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_preset
+ *
+ *  The guides of the roundRect preset, with and without the adjust
+ *  value of the shape.
+ */
+/* ------------------------------------------------------------------------- */
+void test_preset() {
+	const std::string xml =
+		"<roundRect>"
+		"<a:avLst><a:gd name=\"adj\" fmla=\"val 16667\"/></a:avLst>"
+		"<a:gdLst>"
+		"<a:gd name=\"a\" fmla=\"pin 0 adj 50000\"/>"
+		"<a:gd name=\"x1\" fmla=\"*/ ss a 100000\"/>"
+		"<a:gd name=\"x2\" fmla=\"+- r 0 x1\"/>"
+		"<a:gd name=\"y2\" fmla=\"+- b 0 x1\"/>"
+		"<a:gd name=\"il\" fmla=\"*/ x1 29289 100000\"/>"
+		"<a:gd name=\"ir\" fmla=\"+- r 0 il\"/>"
+		"</a:gdLst>"
+		"</roundRect>";
+		
+	std::vector<double> v = eval(xml, 1000.0, 600.0);
+	FAML_CHECK(v.size() == 7);
+	FAML_CHECK(near(v[0], 16667.0));
+	FAML_CHECK(near(v[1], 16667.0));
+	FAML_CHECK(near(v[2], 100.002));
+	FAML_CHECK(near(v[3], 899.998));
+	FAML_CHECK(near(v[4], 499.998));
+	FAML_CHECK(near(v[5], 100.002 * 0.29289));
+	FAML_CHECK(near(v[6], 1000.0 - 100.002 * 0.29289));
+	
+	// the adjust value of the shape replaces the default, and is pinned.
+	guide_list::adjust_map adj;
+	adj[0] = 25000;
+	v = eval(xml, 1000.0, 600.0, adj);
+	FAML_CHECK(near(v[0], 25000.0));
+	FAML_CHECK(near(v[2], 150.0));
+	FAML_CHECK(near(v[3], 850.0));
+	adj[0] = 90000;
+	v = eval(xml, 1000.0, 600.0, adj);
+	FAML_CHECK(near(v[1], 50000.0));
+	FAML_CHECK(near(v[2], 300.0));
+	FAML_CHECK(near(v[4], 300.0));
+	
+	// adj1, adj2, ... are the adjust values of the index 0, 1, ...
+	const std::string xml2 =
+		"<a:custGeom>"
+		"<a:avLst><a:gd name=\"adj1\" fmla=\"val 10\"/><a:gd name=\"adj2\" fmla=\"val 20\"/></a:avLst>"
+		"<a:gdLst><a:gd name=\"s\" fmla=\"+- adj1 adj2 0\"/></a:gdLst>"
+		"</a:custGeom>";
+	adj.clear();
+	adj[1] = 5;
+	v = eval(xml2, 100.0, 100.0, adj);
+	FAML_CHECK(v.size() == 3 && near(v[0], 10.0) && near(v[1], 5.0) && near(v[2], 15.0));
+}
+
+/* ------------------------------------------------------------------------- */
+//  test_error
+/* ------------------------------------------------------------------------- */
+void test_error() {
+	FAML_CHECK(throws(gdlst("val undefined")));
+	FAML_CHECK(throws(gdlst("val x"))); // refers itself
+	FAML_CHECK(throws(gdlst("foo w")));
+	FAML_CHECK(throws(gdlst("*/ w 2")));
+	FAML_CHECK(throws(gdlst("")));
+	FAML_CHECK(throws(gdlst("val wd0")));
+	FAML_CHECK(throws("<a:custGeom><a:gdLst><a:gd name=\"x\"/></a:gdLst></a:custGeom>"));
+	
+	// a guide refers only to the preceding guides.
+	FAML_CHECK(throws(
+		"<a:custGeom><a:gdLst>"
+		"<a:gd name=\"x\" fmla=\"val y\"/><a:gd name=\"y\" fmla=\"val 1\"/>"
+		"</a:gdLst></a:custGeom>"));
+}
+
+int main() {
+	test_builtin();
+	test_formula();
+	test_preset();
+	test_error();
+	return FAML_CHECK_RESULT();
+}
@@ -0,0 +1,153 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  test/number_cast.cpp
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  number_cast
+ *
+ *  Tests officex::number_cast (officex/number.h). The plain numbers
+ *  are parsed directly, and the other forms must give the same
+ *  results (or exceptions) as clx::lexical_cast.
+ *
+ *    g++ -I.. -I<clx> number_cast.cpp -o number_cast && ./number_cast
+ */
+/* ------------------------------------------------------------------------- */
+#include <string>
+#include "check.h"
+#include "officex/number.h"
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  same
+ *
+ *  Returns true if number_cast and clx::lexical_cast give the same
+ *  value, or both throw an exception.
+ */
+/* ------------------------------------------------------------------------- */
+template <class Type>
+bool same(const std::string& s, std::ios_base::fmtflags base = std::ios_base::dec) {
+	bool error1 = false, error2 = false;
+	Type x = Type(), y = Type();
+	try {
+		x = faml::officex::number_cast<Type>(s, base);
+	}
+	catch (std::exception&) {
+		error1 = true;
+	}
+	
+	try {
+		if (base & std::ios_base::hex) y = clx::lexical_cast<Type>(s, base);
+		else y = clx::lexical_cast<Type>(s);
+	}
+	catch (std::exception&) {
+		error2 = true;
+	}
+	
+	if (error1 || error2) return error1 == error2;
+	return x == y;
+}
+
+/* ------------------------------------------------------------------------- */
+//  test_plain
+/* ------------------------------------------------------------------------- */
+void test_plain() {
+	using faml::officex::number_cast;
+	
+	FAML_CHECK(number_cast<int>("0") == 0);
+	FAML_CHECK(number_cast<int>("12700") == 12700);
+	FAML_CHECK(number_cast<int>("-914400") == -914400);
+	FAML_CHECK(number_cast<int>("+5") == 5);
+	FAML_CHECK(number_cast<long>(std::string("9144000")) == 9144000L);
+	FAML_CHECK(number_cast<size_t>("4294967295") == 4294967295UL);
+	FAML_CHECK(number_cast<double>("0.5") == 0.5);
+	FAML_CHECK(number_cast<double>("-12.25") == -12.25);
+	FAML_CHECK(number_cast<double>("3.") == 3.0);
+	FAML_CHECK(number_cast<double>(".75") == 0.75);
+	FAML_CHECK(number_cast<int>("FF8000", std::ios_base::hex) == 0xff8000);
+	FAML_CHECK(number_cast<int>("00ff80", std::ios_base::hex) == 0x00ff80);
+	FAML_CHECK(number_cast<int>(L"1440") == 1440);
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_fallback
+ *
+ *  The forms which scan_number does not accept are passed to
+ *  clx::lexical_cast.
+ */
+/* ------------------------------------------------------------------------- */
+void test_fallback() {
+	FAML_CHECK(same<double>("1e3"));
+	FAML_CHECK(same<double>("-2.5E-2"));
+	FAML_CHECK(same<double>("1234567890123456789"));
+	FAML_CHECK(same<int>("1.5"));
+	FAML_CHECK(same<int>("3000000000"));
+	FAML_CHECK(same<unsigned int>("-1"));
+	FAML_CHECK(same<short>("40000"));
+	FAML_CHECK(same<int>(" 12"));
+	FAML_CHECK(same<int>("12pt"));
+	FAML_CHECK(same<int>("abc"));
+	FAML_CHECK(same<int>(""));
+	FAML_CHECK(same<int>("-"));
+	FAML_CHECK(same<double>("."));
+	FAML_CHECK(same<int>("-FF", std::ios_base::hex));
+	FAML_CHECK(same<int>("GG", std::ios_base::hex));
+}
+
+/* ------------------------------------------------------------------------- */
+//  test_range
+/* ------------------------------------------------------------------------- */
+void test_range() {
+	static const char* values[] = {
+		"0", "1", "-1", "7", "100", "-100", "32767", "-32768", "65535",
+		"2147483647", "-2147483648", "0.1", "0.125", "123.456", "-0.001",
+		"999999999999999", "000123", "-0"
+	};
+	
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+		FAML_CHECK(same<int>(values[i]));
+		FAML_CHECK(same<long>(values[i]));
+		FAML_CHECK(same<double>(values[i]));
+		FAML_CHECK(same<short>(values[i]));
+		FAML_CHECK(same<unsigned short>(values[i]));
+	}
+}
+
+int main() {
+	test_plain();
+	test_fallback();
+	test_range();
+	return FAML_CHECK_RESULT();
+}
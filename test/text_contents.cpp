@@ -0,0 +1,225 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  test/text_contents.cpp
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  text_contents
+ *
+ *  Tests the text writer (text_contents.h) with the state shared in a
+ *  content stream (text_state.h): the text object is kept open across
+ *  the pieces, the pieces are moved by Td, the same-font pieces on a
+ *  line are written as one string (or one TJ array with the gap), and
+ *  the operators in effect are not written again.
+ *
+ *    g++ -I.. -I<clx> text_contents.cpp -o text_contents && ./text_contents
+ */
+/* ------------------------------------------------------------------------- */
+#include <sstream>
+#include <string>
+#include "check.h"
+#include "font.h"
+#include "text_contents.h"
+
+typedef faml::pdf::basic_font<char> font_type;
+typedef faml::pdf::basic_text_contents<char> text_contents;
+typedef text_contents::state_type state_type;
+
+/* ------------------------------------------------------------------------- */
+//  bytes: the string literal including the NUL bytes.
+/* ------------------------------------------------------------------------- */
+template <size_t N>
+std::string bytes(const char (&s)[N]) {
+	return std::string(s, N - 1);
+}
+
+/* ------------------------------------------------------------------------- */
+//  count
+/* ------------------------------------------------------------------------- */
+size_t count(const std::string& s, const std::string& key) {
+	size_t n = 0;
+	for (size_t pos = s.find(key); pos != std::string::npos; pos = s.find(key, pos + key.size())) ++n;
+	return n;
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  piece
+ *
+ *  Writes s at (x, y) through the state, and returns the x of the
+ *  following piece.
+ */
+/* ------------------------------------------------------------------------- */
+double piece(std::ostream& out, state_type& ts, const std::string& s, double x, double y,
+	const font_type& latin, const font_type& japan, size_t deco = 0, double space = 0.0) {
+	text_contents txt(s, faml::pdf::coordinate(x, y), latin, japan);
+	txt.state(ts);
+	txt.font_size(10.0);
+	txt.decorate(deco);
+	txt.space(space);
+	txt(out);
+	
+	bool ascii = faml::pdf::is_ascii(s.begin(), s.end(), faml::pdf::charset::utf16);
+	faml::pdf::text_helper h((ascii ? latin : japan).property(), faml::pdf::charset::utf16);
+	return x + h.width(s.begin(), s.end()) / 1000.0 * 10.0 + space;
+}
+
+/* ------------------------------------------------------------------------- */
+//  test_line
+/* ------------------------------------------------------------------------- */
+void test_line(const font_type& latin, const font_type& japan) {
+	const std::string ab = bytes("\0A\0B"), cd = bytes("\0C\0D"), ja = bytes("\x30\x42\x30\x44");
+	std::ostringstream out;
+	state_type ts;
+	
+	double x = piece(out, ts, ab, 10.0, 700.0, latin, japan);
+	x = piece(out, ts, cd, x, 700.0, latin, japan);
+	x = piece(out, ts, ja, x, 700.0, latin, japan);
+	x = piece(out, ts, ab, x + 5.0, 700.0, latin, japan);
+	piece(out, ts, cd, 10.0, 680.0, latin, japan);
+	ts.end(out);
+	
+	const std::string s = out.str();
+	FAML_CHECK(count(s, "BT") == 1 && count(s, "ET") == 1);
+	FAML_CHECK(count(s, " Tm") == 0);
+	FAML_CHECK(count(s, " Td") == 4);
+	FAML_CHECK(count(s, "/F") == 3);	// latin, japan, latin
+	FAML_CHECK(count(s, " Tc") == 1);
+	FAML_CHECK(count(s, " rg") == 1 && count(s, " RG") == 1);
+	FAML_CHECK(s.find(bytes("(\0A\0B\0C\0D) Tj")) != std::string::npos);
+	FAML_CHECK(s.find(bytes("(\0A\0B) Tj")) != std::string::npos);
+	FAML_CHECK(s.find(bytes("(\0C\0D) Tj")) != std::string::npos);
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_gap
+ *
+ *  A gap between the pieces becomes the adjustment in the TJ array,
+ *  and the change of Tc ends the array.
+ */
+/* ------------------------------------------------------------------------- */
+void test_gap(const font_type& latin, const font_type& japan) {
+	const std::string ab = bytes("\0A\0B"), cd = bytes("\0C\0D");
+	std::ostringstream out;
+	state_type ts;
+	
+	double x = piece(out, ts, ab, 10.0, 700.0, latin, japan);
+	x = piece(out, ts, cd, x + 2.0, 700.0, latin, japan);
+	piece(out, ts, ab, x, 700.0, latin, japan, 0, 1.0);
+	ts.end(out);
+	
+	const std::string s = out.str();
+	FAML_CHECK(s.find(bytes("[(\0A\0B)-200 (\0C\0D)] TJ")) != std::string::npos);
+	FAML_CHECK(count(s, " Tc") == 2);
+	FAML_CHECK(count(s, " Td") == 2);
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_decoration
+ *
+ *  The underline ends the text object once, and the next piece opens
+ *  a new one with the line width of the text again.
+ */
+/* ------------------------------------------------------------------------- */
+void test_decoration(const font_type& latin, const font_type& japan) {
+	const std::string ab = bytes("\0A\0B");
+	std::ostringstream out;
+	state_type ts;
+	
+	double x = piece(out, ts, ab, 10.0, 700.0, latin, japan, text_contents::underline);
+	piece(out, ts, ab, x, 700.0, latin, japan);
+	ts.end(out);
+	
+	const std::string s = out.str();
+	FAML_CHECK(count(s, "BT") == 2 && count(s, "ET") == 2);
+	FAML_CHECK(count(s, "1 w") == 2 && count(s, "0.5 w") == 1);
+	FAML_CHECK(count(s, "/F") == 1);	// Tf is kept across BT/ET
+	
+	// without the shared state, each text is one text object.
+	std::ostringstream own;
+	text_contents txt(ab, faml::pdf::coordinate(10.0, 700.0), latin, japan);
+	txt.decorate(text_contents::underline);
+	txt(own);
+	FAML_CHECK(count(own.str(), "BT") == 1 && count(own.str(), "ET") == 1);
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  test_state
+ *
+ *  q/Q restore the operators, and Td is relative to the line matrix
+ *  (including the skew of the italic).
+ */
+/* ------------------------------------------------------------------------- */
+void test_state() {
+	std::ostringstream out;
+	state_type ts;
+	
+	FAML_CHECK(ts(out, state_type::width, "1 w"));
+	FAML_CHECK(!ts(out, state_type::width, "1 w"));
+	ts.save(out);
+	FAML_CHECK(!ts(out, state_type::width, "1 w"));
+	FAML_CHECK(ts(out, state_type::width, "2 w"));
+	ts.restore(out);
+	FAML_CHECK(!ts(out, state_type::width, "1 w"));
+	
+	ts.invalidate();
+	FAML_CHECK(ts(out, state_type::width, "1 w"));
+	
+	std::ostringstream text;
+	ts.begin(text);
+	ts.matrix(text, 1.0, 0.0, 0.25, 1.0, 10.0, 700.0);
+	ts.matrix(text, 1.0, 0.0, 0.25, 1.0, 10.0, 680.0);
+	ts.end(text);
+	FAML_CHECK(text.str() == "BT\n1 0 0.25 1 10 700 Tm\n5 -20 Td\nET\n");
+}
+
+int main() {
+	faml::pdf::font_property latin_prop;
+	latin_prop.name("Latin");
+	latin_prop.type(0);
+	faml::pdf::font_property japan_prop;
+	japan_prop.name("Japan");
+	japan_prop.type(0);
+	font_type latin(latin_prop, faml::pdf::charset::utf16);
+	font_type japan(japan_prop, faml::pdf::charset::utf16);
+	
+	test_line(latin, japan);
+	test_gap(latin, japan);
+	test_decoration(latin, japan);
+	test_state();
+	return FAML_CHECK_RESULT();
+}
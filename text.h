@@ -40,6 +40,7 @@
 #include <iterator>
 #include <istream>
 #include <sstream>
+#include <vector>
 #include "page.h"
 #include "font.h"
 #include "color.h"
@@ -56,7 +57,14 @@
 namespace faml {
 	namespace pdf {
 		/* ----------------------------------------------------------------- */
-		//  basic_text
+		/*
+		 *  basic_text
+		 *
+		 *  The basic_text class converts the plain text to PDF. The input
+		 *  is read into a window of buffer_size characters, and each page
+		 *  is written as soon as it is filled. Memory usage therefore does
+		 *  not depend on the size of the input (e.g., large log files).
+		 */
 		/* ----------------------------------------------------------------- */
 		template <
 			class CharT,
@@ -71,13 +79,15 @@ namespace faml {
 			typedef std::basic_istream<CharT, Traits> istream_type;
 			typedef basic_font<CharT, Traits> font_type;
 			
+			enum { buffer_size = 65536 };
+			
 			basic_text(istream_type& in, font_type& f) :
 				in_(in), font_(&f), fontj_(NULL), size_(12.0),
-				space_(12.0 * 0.25), color_(), page_() {}
+				space_(12.0 * 0.25), color_(), page_(), buf_(), pos_(0) {}
 				
 			basic_text(istream_type& in, font_type& f, font_type& fj) :
 				in_(in), font_(&f), fontj_(&fj), size_(12.0),
-				space_(12.0 * 0.25), color_(), page_() {}
+				space_(12.0 * 0.25), color_(), page_(), buf_(), pos_(0) {}
 			
 			template <class OutStream, class PDFManager>
 			bool operator()(OutStream& out, PDFManager& pm) {
@@ -87,31 +97,23 @@ namespace faml {
 					if (!(*fontj_)(out, pm)) return false;
 				}
 				
-#if 0 // Note: streambuf_iterator  iterator ߂Ȃ̂ŁC肠ǂݍށD
-				std::istreambuf_iterator<char_type> first(in_);
-				std::istreambuf_iterator<char_type> last;
-#else
-				
-				std::vector<char_type> v;
-				char_type data[65536];
-				do {
-					in_.read(data, 65536);
-					v.insert(v.end(), data, data + in_.gcount());
-				} while (in_.gcount() > 0);
-				typename std::vector<char_type>::iterator first = v.begin();
-				typename std::vector<char_type>::iterator last = v.end();
-#endif
-				
-				while (first != last) {
+				buf_.clear();
+				pos_ = 0;
+				while (this->xfill()) {
 					page_type newpage(page_);
 					cur_.x = page_.margin().left();
 					cur_.y = page_.height() - page_.margin().top();
 					if (!this->xresources(out, pm)) return false;
 					newpage.resources(pm.index());
-					if (!this->xcontents(out, pm, first, last)) return false;
+					if (!this->xcontents(out, pm)) return false;
 					newpage.contents(pm.index());
 					if (!newpage(out, pm)) return false;
+					if (pos_ == 0 && !buf_.empty()) return false; // no line fits in the page.
 				}
+				buf_.clear();
+				
+				if (!font_->finish(out, pm)) return false;
+				if (fontj_ && !fontj_->finish(out, pm)) return false;
 				
 				return true;
 			}
@@ -139,6 +141,8 @@ namespace faml {
 			double space_;
 			color color_;
 			page_property page_;
+			std::vector<char_type> buf_;	// window of the input
+			size_type pos_;					// consumed characters in buf_
 			
 			/* ------------------------------------------------------------- */
 			/*
@@ -178,20 +182,43 @@ namespace faml {
 				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xfill
+			 *
+			 *  Discards the consumed characters and fills the window from
+			 *  the input stream. Returns false if no character is left.
+			 */
+			/* ------------------------------------------------------------- */
+			bool xfill() {
+				if (pos_ > 0) {
+					buf_.erase(buf_.begin(), buf_.begin() + pos_);
+					pos_ = 0;
+				}
+				
+				while (buf_.size() < static_cast<size_type>(buffer_size) && in_.good()) {
+					size_type n = buf_.size();
+					buf_.resize(buffer_size);
+					in_.read(&buf_[n], buffer_size - n);
+					buf_.resize(n + static_cast<size_type>(in_.gcount()));
+				}
+				return !buf_.empty();
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  xcontents
 			/* ------------------------------------------------------------- */
-			template <class OutStream, class PDFManager, class InIter>
-			bool xcontents(OutStream& out, PDFManager& pm, InIter& first, InIter last) {
+			template <class OutStream, class PDFManager>
+			bool xcontents(OutStream& out, PDFManager& pm) {
 				std::basic_stringstream<char> ss;
 				string_type filter;
 #ifdef FAML_USE_ZLIB
 				filter = LITERAL("/FlateDecode");
 				clx::basic_zstream<Z_DEFAULT_COMPRESSION, char> z(ss);
-				this->xmakestream(z, pm, first, last);
+				this->xmakestream(z, pm);
 				z.finish();
 #else
-				this->xmakestream(ss, pm, first, last);
+				this->xmakestream(ss, pm);
 #endif
 				size_type index = pm.newindex();
 				out << fmt(LITERAL("%d 0 obj")) % index << std::endl;
@@ -210,31 +237,60 @@ namespace faml {
 			}
 			
 			/* ------------------------------------------------------------- */
-			//  xmakestream
+			/*
+			 *  xmakestream
+			 *
+			 *  Lays out the lines of a page. The window is refilled when
+			 *  fewer than half of it remain, so that a line is never split
+			 *  at the end of the window unless it is longer than that.
+			 */
 			/* ------------------------------------------------------------- */
-			template <class OutStream, class PDFManager, class InIter>
-			bool xmakestream(OutStream& out, PDFManager& pm, InIter& first, InIter last) {
+			template <class OutStream, class PDFManager>
+			bool xmakestream(OutStream& out, PDFManager& pm) {
+				typedef typename std::vector<char_type>::iterator iterator;
+				
 				out << LITERAL("BT") << std::endl;
 				text_helper helper(font_->property(), font_->charset());
+				typename text_contents::state_type ts;
 				while (cur_.y - space_ > page_.margin().bottom()) {
+					if (buf_.size() - pos_ < static_cast<size_type>(buffer_size / 2)) this->xfill();
+					
 					double width = page_.width() - cur_.x - page_.margin().right();
 					int limit = static_cast<int>(width / size_ * 1000);
 					string_type line;
-					//int used = helper.getline(first, last, std::inserter(line, line.end()), limit);
-					helper.getline(first, last, std::inserter(line, line.end()), limit);
+					iterator first, last;
+					while (true) {
+						first = buf_.begin() + pos_;
+						last = buf_.end();
+						line.clear();
+						//int used = helper.getline(first, last, std::inserter(line, line.end()), limit);
+						helper.getline(first, last, std::inserter(line, line.end()), limit);
+						
+						// The line reached the end of the window: the window is
+						// refilled from the head of the line, and the line is
+						// laid out again.
+						if (first != last || !in_.good() || pos_ == 0) break;
+						this->xfill();
+					}
+					pos_ = first - buf_.begin();
 					if (line.empty()) break;
 					char_type c = line.at(line.size() - 1);
 					bool newline = false;
-					if (first == last) newline = true;
-					else if (line.size() == 1 || (static_cast<int>(line.at(line.size() - 2)) & 0xff) < 0x81) {
+					if (line.size() == 1 || (static_cast<int>(line.at(line.size() - 2)) & 0xff) < 0x81) {
 						if (line.at(line.size() - 1) == 0x0a || line.at(line.size() - 1) == 0x0d) {
 							newline = true;
 							chomp(line, font_->charset());
 						}
 					}
 					
+					// The end of the window is the end of the line only when
+					// the input is exhausted (a line longer than the window
+					// is continued to the next line).
+					if (!newline && first == last && !in_.good()) newline = true;
+					
 					if (!line.empty()) {
 						text_contents txt(line, coordinate(cur_.x, cur_.y), *font_, false);
+						txt.state(ts);
 						if (fontj_) txt.font2nd(*fontj_);
 						txt.font_size(size_);
 						//double sp = (limit - used) / 1000.0 * size_;
@@ -244,6 +300,7 @@ namespace faml {
 					cur_.y -= (size_ + space_);
 					if (c == 0x0c) break;
 				}
+				ts.flush(out);
 				out << LITERAL("ET");
 				
 				return true;
@@ -35,14 +35,16 @@
 #ifndef FAML_PDF_TEXT_CONTENTS_H
 #define FAML_PDF_TEXT_CONTENTS_H
 
+#include <cmath>
 #include <string>
 #include "coordinate.h"
 #include "color.h"
 #include "font.h"
 #include "text_helper.h"
+#include "text_state.h"
+#include "utility.h"
 #include "clx/format.h"
 #include "clx/literal.h"
-#include "clx/hexdump.h"
 #include "clx/unit.h"
 
 namespace faml {
@@ -60,6 +62,7 @@ namespace faml {
 			typedef CharT char_type;
 			typedef std::basic_string<CharT, Traits> string_type;
 			typedef basic_font<CharT, Traits> font_type;
+			typedef basic_text_state<CharT, Traits> state_type;
 			
 			enum {
 				none		= 0x0000,
@@ -80,24 +83,27 @@ namespace faml {
 				const font_type& f, bool entag = true) :
 				s_(s), ext_(), origin_(origin), font_(&f), fontj_(NULL),
 				size_(12.0), extsz_(6.0), color_(), bg_(), space_(0.0), decorate_(0), scale_(100),
-				baseline_(0.0), weight_(0.6), angle_(0.3), rot_(0), flip_(0), tag_(entag) {}
+				baseline_(0.0), weight_(0.6), angle_(0.3), rot_(0), flip_(0), tag_(entag),
+				state_(NULL), own_() {}
 			
 			explicit basic_text_contents(const string_type s, const coordinate& origin,
 				const font_type& f, const font_type& fj, bool entag = true) :
 				s_(s), ext_(), origin_(origin), font_(&f), fontj_(&fj),
 				size_(12.0), extsz_(6.0), color_(), bg_(), space_(0.0), decorate_(0), scale_(100),
-				baseline_(0.0), weight_(0.25), angle_(0.3), rot_(0), flip_(0), tag_(entag) {}
+				baseline_(0.0), weight_(0.25), angle_(0.3), rot_(0), flip_(0), tag_(entag),
+				state_(NULL), own_() {}
 			
 			template <class OutStream>
 			bool operator()(OutStream& out) {
+				if (state_ == NULL) own_.reset();
+				if (!tag_) xstate().open();
 				if (fontj_ == NULL) return this->xsimple_output(out);
 				else return this->xalternative_output(out);
 			}
 			
 			template <class OutStream, class PDFManager>
 			bool operator()(OutStream& out, PDFManager& pm) {
-				if (fontj_ == NULL) return this->xsimple_output(out);
-				else return this->xalternative_output(out);
+				return (*this)(out);
 			}
 			
 			/* ------------------------------------------------------------- */
@@ -123,6 +129,20 @@ namespace faml {
 			
 			void flip(size_type cp) { flip_ = cp; }
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  state
+			 *
+			 *  Shares the text state with the other text_contents and
+			 *  shapes written to the same stream. By default, the state is
+			 *  only kept during one operator() call. When shared, the text
+			 *  object is left open (entag) or the last strings are left
+			 *  pending (without entag, i.e., the owner writes BT/ET), and
+			 *  the owner must call end() or flush() before writing others.
+			 */
+			/* ------------------------------------------------------------- */
+			void state(state_type& cp) { state_ = &cp; }
+			
 		private:
 			typedef clx::basic_format<CharT, Traits> fmt;
 			
@@ -144,6 +164,10 @@ namespace faml {
 			double rot_;
 			size_type flip_;
 			bool tag_;
+			state_type* state_;
+			state_type own_;
+			
+			state_type& xstate() { return (state_ != NULL) ? *state_ : own_; }
 			
 			template <class OutStream>
 			bool xsimple_output(OutStream& out) {
@@ -163,51 +187,51 @@ namespace faml {
 					this->xput_highlight(out, x0, y1 + baseline_, w, y0 - y1 + baseline_);
 				}
 				
-				if (tag_) out << LITERAL("BT") << std::endl;
-				out << fmt(LITERAL("/%s %d Tf")) % font_->label() % size_ << std::endl;
-				out << fmt(LITERAL("%f Tc")) % sp << std::endl;
-				out << fmt(LITERAL("%d Tz")) % scale_ << std::endl;
-				out << fmt(LITERAL("%f Ts")) % baseline_ << std::endl;
+				xstate().begin(out);
+				this->xput_font(out, *font_, size_);
+				this->xput_space(out, sp);
+				xstate()(out, state_type::scale, (fmt(LITERAL("%d Tz")) % scale_).str());
+				xstate()(out, state_type::rise, (fmt(LITERAL("%f Ts")) % baseline_).str());
 				this->xput_rendering(out);
 				if ((decorate_ & emboss)) {
-					out << LITERAL("0.8 0.8 0.8 rg") << std::endl;
-					out << LITERAL("0.8 0.8 0.8 RG") << std::endl;
+					xstate()(out, state_type::fill, LITERAL("0.8 0.8 0.8 rg"));
+					xstate()(out, state_type::stroke, LITERAL("0.8 0.8 0.8 RG"));
 				}
 				else {
-					out << fmt(LITERAL("%f %f %f rg")) % color_.red() % color_.green() % color_.blue() << std::endl;
-					out << fmt(LITERAL("%f %f %f RG")) % color_.red() % color_.green() % color_.blue() << std::endl;
+					this->xput_fill(out, color_);
+					this->xput_stroke(out, color_);
 				}
+				string_type s;
+				if (font_->property().type() == 1) s = strip(s_, font_->charset());
+				else s = s_;
+				font_->use(s);
+				double used = helper.width(s_.begin(), s_.end()) / 1000.0;
+				double th = scale_ / 100.0;
 				if (rot_ > 0.0 || flip_) {
 					double cosx = std::cos(rot_);
 					double sinx = std::sin(rot_);
 					double fliph = (flip_ & 0x01) ? -1 : 1;
 					double flipv = (flip_ & 0x02) ? -1 : 1;
-					out << fmt(LITERAL("%f %f %f %f %f %f Tm"))
-						% (fliph * cosx) % (fliph * sinx)
-						% (flipv * -sinx) % (flipv * cosx)
+					xstate().matrix(out,
+						fliph * cosx, fliph * sinx, flipv * -sinx, flipv * cosx,
 #if 1
-						% origin_.x() % (origin_.y() - size_)
+						origin_.x(), origin_.y() - size_
 #else
-						% origin_.x() % origin_.y()
+						origin_.x(), origin_.y()
 #endif
-					<< std::endl;
+					);
+					xstate().show(out, s);
 				}
 				else {
 					double angle = (decorate_ & italic) ? angle_ : 0.0;
-					out << fmt(LITERAL("1 0 %f 1 %f %f Tm"))
 #if 1
-						% angle % origin_.x() % (origin_.y() - size_)
+					double y = origin_.y() - size_;
 #else
-						% angle % origin_.x() % origin_.y()
+					double y = origin_.y();
 #endif
-					<< std::endl;
+					xstate().show(out, 1.0, 0.0, angle, 1.0, origin_.x(), y, s,
+						(used * size_ + sp * n) * th, size_ * th / 1000.0);
 				}
-				out << LITERAL("<");
-				string_type s;
-				if (font_->property().type() == 1) s = strip(s_, font_->charset());
-				else s = s_;
-				out << clx::hexdump(s) << LITERAL("> Tj") << std::endl;
-				double used = helper.width(s_.begin(), s_.end()) / 1000.0;
 				x += used * size_ + space_;
 				if ((decorate_ & underline)) {
 					//this->xput_line(out, origin_.x() - delta, origin_.y() - size_ * 1.1, x - origin_.x() + delta);
@@ -236,7 +260,11 @@ namespace faml {
 					}
 				}
 				
-				if (tag_) out << LITERAL("ET") << std::endl;
+				if (!tag_) xstate().begin(out);
+				if (state_ == NULL) {
+					if (tag_) xstate().end(out);
+					else xstate().flush(out);
+				}
 				
 				return true;
 			}
@@ -264,7 +292,7 @@ namespace faml {
 					this->xput_highlight(out, x0, y1, w, y0 - y1);
 				}
 				
-				if (tag_) out << LITERAL("BT") << std::endl;
+				xstate().begin(out);
 				
 				if ((decorate_ & ruby) && !ext_.empty()) {
 					y = origin_.y() - extsz_ * 0.9;
@@ -279,16 +307,16 @@ namespace faml {
 					size_type sn = h.count(ext_.begin(), ext_.end());
 					double ssp = std::max((w - sw) / (sn + 1), 0.0);
 					
-					if (ascii) out << fmt(LITERAL("/%s %d Tf")) % font_->label() % extsz_ << std::endl;
-					else out << fmt(LITERAL("/%s %d Tf")) % fontj_->label() % extsz_ << std::endl;
-					out << fmt(LITERAL("%f Tc")) % ssp << std::endl;
-					out << fmt(LITERAL("%f %f %f rg")) % color_.red() % color_.green() % color_.blue() << std::endl;
-					out << fmt(LITERAL("1 0 0 1 %f %f Tm")) % (origin_.x() + ssp) % y << std::endl;
-					out << LITERAL("<");
-					out << clx::hexdump(ext_) << LITERAL("> Tj") << std::endl;
+					this->xput_font(out, ascii ? *font_ : *fontj_, extsz_);
+					this->xput_space(out, ssp);
+					this->xput_fill(out, color_);
+					xstate().matrix(out, 1.0, 0.0, 0.0, 1.0, origin_.x() + ssp, y);
+					(ascii ? font_ : fontj_)->use(ext_);
+					xstate().show(out, ext_);
 					y -= size_ * 0.9;
 				}
 				
+				double th = scale_ / 100.0;
 				while (pos != s_.end()) {
 					string_type token = ascii
 						? h.substr(pos, s_.end(), ascii)
@@ -296,38 +324,41 @@ namespace faml {
 					double used = is_ascii(token.begin(), token.end(), font_->charset())
 						? h.width(token.begin(), token.end()) / 1000.0
 						: hj.width(token.begin(), token.end()) / 1000.0;
-					if (ascii) out << fmt(LITERAL("/%s %d Tf")) % font_->label() % size_ << std::endl;
-					else out << fmt(LITERAL("/%s %d Tf")) % fontj_->label() % size_ << std::endl;
-					out << fmt(LITERAL("%f Tc")) % sp << std::endl;
-					out << fmt(LITERAL("%d Tz")) % scale_ << std::endl;
+					double advance = used * size_ + sp * h.count(token.begin(), token.end());
+					
+					if (ascii && font_->property().type() == 1) token = strip(token, font_->charset());
+					const font_type* f = ascii ? font_ : fontj_;
+					f->use(token);
+					
+					this->xput_font(out, *f, size_);
+					this->xput_space(out, sp);
+					xstate()(out, state_type::scale, (fmt(LITERAL("%d Tz")) % scale_).str());
 					this->xput_rendering(out);
-					out << fmt(LITERAL("%f %f %f rg")) % color_.red() % color_.green() % color_.blue() << std::endl;
-					out << fmt(LITERAL("%f %f %f RG")) % color_.red() % color_.green() % color_.blue() << std::endl;
+					this->xput_fill(out, color_);
+					this->xput_stroke(out, color_);
 					if (rot_ > 0.0) {
 						double cosx = std::cos(rot_);
 						double sinx = std::sin(rot_);
-						out << fmt(LITERAL("%f %f %f %f %f %f Tm"))
-							% cosx % sinx % (-sinx) % cosx % x % y
-						<< std::endl;
+						xstate().matrix(out, cosx, sinx, -sinx, cosx, x, y);
+						xstate().show(out, token);
 					}
 					else {
+						// Tokens are placed by the unscaled advance, so the gap
+						// cancels the Tz scaling of the previous token.
 						double angle = (decorate_ & italic) ? angle_ : 0.0;
-						out << fmt(LITERAL("1 0 %f 1 %f %f Tm")) % angle % x % y << std::endl;
+						xstate().show(out, 1.0, 0.0, angle, 1.0, x, y, token,
+							advance * th, size_ * th / 1000.0);
 					}
-					out << LITERAL("<");
-					if (ascii && font_->property().type() == 1) out << clx::hexdump(strip(token, font_->charset()));
-					else out << clx::hexdump(token);
-					out << LITERAL("> Tj") << std::endl;
 					
-					x += used * size_ + sp * h.count(token.begin(), token.end());
+					x += advance;
 					ascii = !ascii;
 				}
 				
 				if ((decorate_ & overlap) && !ext_.empty()) {
-					out << fmt(LITERAL("/%s %d Tf")) % fontj_->label() % size_ << std::endl;
-					out << fmt(LITERAL("1 0 0 1 %f %f Tm")) % origin_.x() % y << std::endl;
-					out << LITERAL("<");
-					out << clx::hexdump(ext_) << LITERAL("> Tj") << std::endl;
+					this->xput_font(out, *fontj_, size_);
+					xstate().matrix(out, 1.0, 0.0, 0.0, 1.0, origin_.x(), y);
+					fontj_->use(ext_);
+					xstate().show(out, ext_);
 				}
 				
 				if ((decorate_ & underline)) {
@@ -355,58 +386,89 @@ namespace faml {
 					}
 				}
 				
-				if (tag_) out << LITERAL("ET") << std::endl;
+				if (!tag_) xstate().begin(out);
+				if (state_ == NULL) {
+					if (tag_) xstate().end(out);
+					else xstate().flush(out);
+				}
 				
 				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xput_font, xput_space, xput_fill, xput_stroke
+			 *
+			 *  Write the state operators through the text state, which
+			 *  skips the ones that set the value already in effect.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			bool xput_font(OutStream& out, const font_type& f, double size) {
+				return xstate()(out, state_type::font, (fmt(LITERAL("/%s %d Tf")) % f.label() % size).str());
+			}
+			
+			template <class OutStream>
+			bool xput_space(OutStream& out, double sp) {
+				return xstate()(out, state_type::space, (fmt(LITERAL("%f Tc")) % sp).str());
+			}
+			
+			template <class OutStream>
+			bool xput_fill(OutStream& out, const color& c) {
+				return xstate()(out, state_type::fill,
+					(fmt(LITERAL("%f %f %f rg")) % c.red() % c.green() % c.blue()).str());
+			}
+			
+			template <class OutStream>
+			bool xput_stroke(OutStream& out, const color& c) {
+				return xstate()(out, state_type::stroke,
+					(fmt(LITERAL("%f %f %f RG")) % c.red() % c.green() % c.blue()).str());
+			}
+			
 			template <class OutStream>
 			bool xput_rendering(OutStream& out) {
 				if ((decorate_ & bold)) {
-					out << LITERAL("2 Tr") << std::endl;
-					out << fmt(LITERAL("%f w")) % weight_ << std::endl;
+					xstate()(out, state_type::rendering, LITERAL("2 Tr"));
+					xstate()(out, state_type::width, (fmt(LITERAL("%f w")) % weight_).str());
 				}
 				else if ((decorate_ & emboss)) {
-					out << LITERAL("1 Tr") << std::endl;
-					out << LITERAL("1 w") << std::endl;
+					xstate()(out, state_type::rendering, LITERAL("1 Tr"));
+					xstate()(out, state_type::width, LITERAL("1 w"));
 				}
 				else {
-					out << LITERAL("0 Tr") << std::endl;
-					out << LITERAL("1 w") << std::endl;
+					xstate()(out, state_type::rendering, LITERAL("0 Tr"));
+					xstate()(out, state_type::width, LITERAL("1 w"));
 				}
 				return true;
 			}
 			
 			template <class OutStream>
 			bool xput_line(OutStream& out, double x, double y, double width) {
-				out << LITERAL("ET") << std::endl;
-				out << fmt(LITERAL("%f %f %f RG")) % color_.red() % color_.green() % color_.blue() << std::endl;
-				out << fmt(LITERAL("%f w")) % (size_ / 20.0) << std::endl;
+				xstate().end(out);
+				this->xput_stroke(out, color_);
+				xstate()(out, state_type::width, (fmt(LITERAL("%f w")) % (size_ / 20.0)).str());
 				out << fmt(LITERAL("%f %f m")) % x % y << std::endl;
 				out << fmt(LITERAL("%f %f l")) % (x + width) % y << std::endl;
 				out << LITERAL("s") << std::endl;
-				if (!tag_) out << LITERAL("BT") << std::endl;
 				return true;
 			}
 			
 			template <class OutStream>
 			bool xput_box(OutStream& out, double x, double y, double w, double h) {
-				out << LITERAL("ET") << std::endl;
-				out << fmt(LITERAL("%f %f %f RG")) % color_.red() % color_.green() % color_.blue() << std::endl;
-				out << fmt(LITERAL("%f w")) % (size_ / 20.0) << std::endl;
+				xstate().end(out);
+				this->xput_stroke(out, color_);
+				xstate()(out, state_type::width, (fmt(LITERAL("%f w")) % (size_ / 20.0)).str());
 				out << fmt(LITERAL("%f %f %f %f re")) % x % y % w % h << std::endl;
 				out << LITERAL("s") << std::endl;
-				if (!tag_) out << LITERAL("BT") << std::endl;
 				return true;
 			}
 			
 			template <class OutStream>
 			bool xput_highlight(OutStream& out, double x, double y, double w, double h) {
-				if (!tag_) out << LITERAL("ET") << std::endl;
-				out << fmt(LITERAL("%f %f %f rg")) % bg_.red() % bg_.green() % bg_.blue() << std::endl;
+				xstate().end(out);
+				this->xput_fill(out, bg_);
 				out << fmt(LITERAL("%f %f %f %f re")) % x % y % w % h << std::endl;
 				out << LITERAL("f") << std::endl;
-				if (!tag_) out << LITERAL("BT") << std::endl;
 				return true;
 			}
 		};
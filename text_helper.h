@@ -35,6 +35,7 @@
 #ifndef FAML_PDF_TEXT_HELPER_H
 #define FAML_PDF_TEXT_HELPER_H
 
+#include <iterator>
 #include <string>
 #include <stdexcept>
 #include "font_property.h"
@@ -197,6 +198,29 @@ namespace faml {
 				return 0;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  breakline
+			 *
+			 *  Returns the end of the line that fits in limit without
+			 *  copying the characters. used is the value returned by
+			 *  getline(), and width is the width of the whole line, so
+			 *  that the caller need not measure the line again.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class InIter>
+			InIter breakline(InIter first, InIter last, size_type limit,
+				size_type& used, size_type& width, bool wrap = true) {
+				if (cset_ == charset::utf16) {
+					return utf16::breakline(first, last, limit, wrap, prop_, used, width);
+				}
+				
+				string_type tmp;
+				used = this->getline(first, last, std::back_inserter(tmp), limit, wrap);
+				width = this->width(tmp.begin(), tmp.end());
+				return first;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  substr
 			/* ------------------------------------------------------------- */
@@ -37,6 +37,7 @@
 
 #include <cctype>
 #include <deque>
+#include <vector>
 #include "code_convert.h"
 #include "utf16.h"
 #include "utility.h"
@@ -45,34 +46,26 @@ namespace faml {
 	namespace pdf {
 		namespace utf16 {
 			/* ------------------------------------------------------------- */
-			//  is_alnum
-			/* ------------------------------------------------------------- */
-			bool is_alnum(word_type c) {
-				if (c >= 0x007f) return false;
-				return std::isalnum(static_cast<char>(c)) != 0;
-			}
-			
-			/* ------------------------------------------------------------- */
-			//  is_space
-			/* ------------------------------------------------------------- */
-			bool is_space(word_type c) {
-				if (c == 0x0020 || c == 0x00a0 || c == 0x3000) return true;
-				return false;
-			}
-			
-			/* ------------------------------------------------------------- */
-			//  is_break
+			/*
+			 *  char_classes
+			 *
+			 *  Returns the table of line breaking classes indexed by the
+			 *  16-bit character code. The table is built at the first
+			 *  call from the code lists below, so that each is_xxx()
+			 *  function is a single lookup instead of a linear search.
+			 */
 			/* ------------------------------------------------------------- */
-			bool is_break(word_type c) {
-				if (c == 0x000c || c == 0x000a) return true;
-				return false;
-			}
+			enum {
+				alnum_class		= 0x01,
+				space_class		= 0x02,
+				break_class		= 0x04,
+				lpunct_class	= 0x08,
+				tail_class		= 0x10,
+				rpunct_class	= 0x20
+			};
 			
-			/* ------------------------------------------------------------- */
-			//  is_lpunct
-			/* ------------------------------------------------------------- */
-			bool is_lpunct(word_type c) {
-				static const word_type codes[] = {
+			inline const unsigned char* char_classes() {
+				static const word_type lpuncts[] = {
 					0xff5f,		// double parentheses
 					0x003c,		// <
 					0xff1c,		// 
@@ -97,17 +90,7 @@ namespace faml {
 					0x00ab		// 
 				};
 				
-				for (size_t i = 0; i < sizeof(codes) / sizeof(word_type); ++i) {
-					if (c == codes[i]) return true;
-				}
-				return false;
-			}
-			
-			/* ------------------------------------------------------------- */
-			//  is_tail
-			/* ------------------------------------------------------------- */
-			bool is_tail(word_type c) {
-				static const word_type codes[] = {
+				static const word_type tails[] = {
 					0xff61,		// 
 					0x3002,		// B
 					0xff64,		// 
@@ -141,19 +124,7 @@ namespace faml {
 					0x003b		// ;
 				};
 				
-				if (is_space(c) || is_break(c)) return true;
-				for (size_t i = 0; i < sizeof(codes) / sizeof(word_type); ++i) {
-					if (c == codes[i]) return true;
-				}
-				
-				return false;
-			}
-			
-			/* ------------------------------------------------------------- */
-			//  is_rpunct
-			/* ------------------------------------------------------------- */
-			bool is_rpunct(word_type c) {
-				static const word_type codes[] = {
+				static const word_type rpuncts[] = {
 					0x003e,		// >
 					0xff1e,		// 
 					0xff60,		// doble closed parentheses
@@ -213,12 +184,66 @@ namespace faml {
 					0x308e		// 
 				};
 				
-				if (is_space(c) || is_break(c)) return true;
-				for (size_t i = 0; i < sizeof(codes) / sizeof(word_type); ++i) {
-					if (c == codes[i]) return true;
+				static std::vector<unsigned char> v;
+				if (!v.empty()) return &v[0];
+				
+				std::vector<unsigned char> tmp(0x10000, 0);
+				for (int c = 0; c < 0x007f; ++c) {
+					if (std::isalnum(c) != 0) tmp[c] |= alnum_class;
 				}
+				tmp[0x0020] |= space_class;
+				tmp[0x00a0] |= space_class;
+				tmp[0x3000] |= space_class;
+				tmp[0x000a] |= break_class;
+				tmp[0x000c] |= break_class;
+				for (size_t i = 0; i < sizeof(lpuncts) / sizeof(word_type); ++i) tmp[lpuncts[i]] |= lpunct_class;
+				for (size_t i = 0; i < sizeof(tails) / sizeof(word_type); ++i) tmp[tails[i]] |= tail_class;
+				for (size_t i = 0; i < sizeof(rpuncts) / sizeof(word_type); ++i) tmp[rpuncts[i]] |= rpunct_class;
 				
-				return false;
+				v.swap(tmp);
+				return &v[0];
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  is_alnum
+			/* ------------------------------------------------------------- */
+			inline bool is_alnum(word_type c) {
+				return (char_classes()[c] & alnum_class) != 0;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  is_space
+			/* ------------------------------------------------------------- */
+			inline bool is_space(word_type c) {
+				return (char_classes()[c] & space_class) != 0;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  is_break
+			/* ------------------------------------------------------------- */
+			inline bool is_break(word_type c) {
+				return (char_classes()[c] & break_class) != 0;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  is_lpunct
+			/* ------------------------------------------------------------- */
+			inline bool is_lpunct(word_type c) {
+				return (char_classes()[c] & lpunct_class) != 0;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  is_tail
+			/* ------------------------------------------------------------- */
+			inline bool is_tail(word_type c) {
+				return (char_classes()[c] & (tail_class | space_class | break_class)) != 0;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  is_rpunct
+			/* ------------------------------------------------------------- */
+			inline bool is_rpunct(word_type c) {
+				return (char_classes()[c] & (rpunct_class | space_class | break_class)) != 0;
 			}
 			
 			/* ------------------------------------------------------------- */
@@ -253,11 +278,55 @@ namespace faml {
 				return n;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  advances
+			 *
+			 *  Returns the cache of the advance of every 16-bit character
+			 *  code for the specified font. The cache is kept in the font
+			 *  property, and each entry is calculated at the first lookup
+			 *  (see advance()), so that the width of a character is got
+			 *  without searching the CID map more than once.
+			 */
+			/* ------------------------------------------------------------- */
+			enum { unknown_advance = 0xffff };
+			
+			template <class Property>
+			unsigned short* advances(const Property& info) {
+				typename Property::advance_table& dest = info.advances();
+				if (dest.empty()) dest.assign(0x10000, static_cast<unsigned short>(unknown_advance));
+				return &dest[0];
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  advance
+			/* ------------------------------------------------------------- */
+			template <class Property>
+			size_t advance(unsigned short* table, word_type code, const Property& info) {
+				if (table[code] != unknown_advance) return table[code];
+				
+				size_t n = 1000;
+				if (info.type() == 1) {
+					if (code <= 0x007f) {
+						if (static_cast<size_t>(code) < info.widths().size()) n = info.widths().at(code);
+						else n = 500;
+					}
+				}
+				else { // Type0 tHg
+					int cid = to_cid(code);
+					if (cid > 0 && static_cast<size_t>(cid) < info.widths().size()) n = info.widths().at(cid);
+					else if (is_half(cid)) n = 500;
+				}
+				table[code] = static_cast<unsigned short>(n);
+				return n;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  width
 			/* ------------------------------------------------------------- */
 			template <class InIter, class Property>
 			size_t width(InIter first, InIter last, const Property& info) {
+				unsigned short* table = advances(info);
 				size_t n = 0;
 				while (first != last) {
 					byte_type c = static_cast<byte_type>(*first);
@@ -265,21 +334,7 @@ namespace faml {
 					if (first == last) break;
 					byte_type c2 = static_cast<byte_type>(*first);
 					++first;
-					
-					int code = (static_cast<int>(c) << 8) | static_cast<int>(c2);
-					if (info.type() == 1) {
-						if (code <= 0x007f) {
-							if (static_cast<size_t>(code) < info.widths().size()) n += info.widths().at(code);
-							else n += 500;
-						}
-						else n += 1000;
-					}
-					else { // Type0 tHg
-						code = to_cid(code);
-						if (code > 0 && static_cast<size_t>(code) < info.widths().size()) n += info.widths().at(code);
-						else if (is_half(code)) n += 500;
-						else n += 1000;
-					}
+					n += advance(table, static_cast<word_type>((c << 8) | c2), info);
 				}
 				return n;
 			}
@@ -305,51 +360,45 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class Property>
 			size_t getw(int code, const Property& info) {
-				size_t dest = 0;
-				if (info.type() == 1) {
-					if (code <= 0x007f) {
-						if (static_cast<size_t>(code) < info.widths().size()) {
-							dest = info.widths().at(code);
-						}
-						else dest = 500;
-					}
-					else dest = 1000;
-				}
-				else { // Type0 tHg
-					code = to_cid(code);
-					if (code > 0 && static_cast<size_t>(code) < info.widths().size()) {
-						dest = info.widths().at(code);
-					}
-					else if (is_half(code)) dest = 500;
-					else dest = 1000;
-				}
-				
-				return dest;
+				return advance(advances(info), static_cast<word_type>(code & 0xffff), info);
 			}
 			
 			/* ------------------------------------------------------------- */
-			//  getline
+			/*
+			 *  breakline
+			 *
+			 *  Finds the end of the line that fits in limit (1/1000 em)
+			 *  and returns it without copying the characters. The width
+			 *  of the line is stored to width, and used is the same value
+			 *  as the one returned by getline(), i.e., the width without
+			 *  the trailing characters that are pushed into the line by
+			 *  the line breaking rules.
+			 */
 			/* ------------------------------------------------------------- */
-			template <class InIter, class OutIter, class Property>
-			size_t getline(InIter& first, InIter last, OutIter out,
-				size_t limit, bool wrap, const Property& info) {
+			template <class InIter, class Property>
+			InIter breakline(InIter first, InIter last, size_t limit, bool wrap,
+				const Property& info, size_t& used, size_t& width) {
+				unsigned short* table = advances(info);
+				const unsigned char* classes = char_classes();
 				InIter pbeg = first;
 				InIter pback = first;
-				size_t m = 0, n = 0;
+				size_t m = 0, n = 0, extra = 0;
 				while (first != last && n <= limit) {
 					word_type wc = getc(first, last);
 					if (wc == word_type(-1)) throw std::runtime_error("bad character code");
 					
-					size_t l = getw(static_cast<int>(wc), info);
+					unsigned char cls = classes[wc];
+					size_t l = advance(table, wc, info);
 					if (n + m + l > limit) {
-						if (is_tail(wc)) {
-							out = std::copy(pbeg, first, out);
+						if ((cls & (tail_class | space_class | break_class))) {
+							extra = m + l;
 							pbeg = first;
 							pback = first;
 						}
-						else if (is_rpunct(wc) || (wrap && is_alnum(wc))) first = pbeg;
+						else if ((cls & (rpunct_class | space_class | break_class)) ||
+							(wrap && (cls & alnum_class))) first = pbeg;
 						else {
-							out = std::copy(pbeg, pback, out);
+							extra = m;
 							first = pback;
 							pbeg = pback;
 						}
@@ -359,21 +408,32 @@ namespace faml {
 					m += l;
 					pback = first;
 					
-					if (!is_lpunct(wc) && (!wrap || !is_alnum(wc))) {
-						out = std::copy(pbeg, pback, out);
+					if (!(cls & lpunct_class) && (!wrap || !(cls & alnum_class))) {
 						n += m;
 						m = 0;
 						pbeg = pback;
 					}
-					if (is_break(wc)) break;
+					if ((cls & break_class)) break;
 				}
 				
-				if (first == last && pbeg != pback) {
-					out = std::copy(pbeg, pback, out);
-					n += m;
-				}
+				if (first == last && pbeg != pback) n += m;
 				
-				return n;
+				used = n;
+				width = n + extra;
+				return first;
+			}
+			
+			/* ------------------------------------------------------------- */
+			//  getline
+			/* ------------------------------------------------------------- */
+			template <class InIter, class OutIter, class Property>
+			size_t getline(InIter& first, InIter last, OutIter out,
+				size_t limit, bool wrap, const Property& info) {
+				size_t used = 0, width = 0;
+				InIter pos = breakline(first, last, limit, wrap, info, used, width);
+				std::copy(first, pos, out);
+				first = pos;
+				return used;
 			}
 		}
 	}
@@ -0,0 +1,307 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  text_state.h
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+#ifndef FAML_PDF_TEXT_STATE_H
+#define FAML_PDF_TEXT_STATE_H
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+#include "utility.h"
+#include "clx/format.h"
+#include "clx/literal.h"
+
+namespace faml {
+	namespace pdf {
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  basic_text_state
+		 *
+		 *  The basic_text_state class tracks the graphics state of a
+		 *  content stream written by the text and shape writers:
+		 *  the state operators (Tf, Tc, Tz, Ts, Tr, w, d, rg, RG) last
+		 *  written, whether a text object (BT/ET) is open, and the text
+		 *  line matrix. The writers skip the operators that set a value
+		 *  already in effect, keep one text object open across the
+		 *  consecutive texts, position the texts by the relative Td
+		 *  instead of Tm where possible, and write the consecutive
+		 *  strings of the same state on a baseline as one TJ array.
+		 *
+		 *  The state is only valid while nobody else writes to the
+		 *  stream: call end() before writing anything else, and
+		 *  invalidate() if the other writer may change the state
+		 *  without enclosing it in q/Q.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <
+			class CharT,
+			class Traits = std::char_traits<CharT>
+		>
+		class basic_text_state {
+		public:
+			typedef size_t size_type;
+			typedef CharT char_type;
+			typedef std::basic_string<CharT, Traits> string_type;
+			
+			enum { font = 0, space, scale, rise, rendering, width, dash, fill, stroke, last };
+			
+			basic_text_state() :
+				open_(false), runs_(), x_(0.0), y_(0.0), unit_(0.0), stack_() {
+				this->reset();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  reset
+			 *
+			 *  Forgets everything, i.e., the state of a new content
+			 *  stream. Pending strings are discarded.
+			 */
+			/* ------------------------------------------------------------- */
+			void reset() {
+				this->invalidate();
+				runs_.clear();
+				stack_.clear();
+				open_ = false;
+				this->xidentity();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  invalidate
+			 *
+			 *  Forgets the state operators, so that the next ones are
+			 *  written even if they set the same value. Call this after
+			 *  the other writers that may change the state.
+			 */
+			/* ------------------------------------------------------------- */
+			void invalidate() {
+				for (size_type i = 0; i < static_cast<size_type>(last); ++i) v_[i].clear();
+			}
+			
+			bool is_open() const { return open_; }
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  operator()
+			 *
+			 *  Writes the operator s unless it is the one last written
+			 *  for the same state. Returns true if s is written.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			bool operator()(OutStream& out, size_type which, const string_type& s) {
+				if (v_[which] == s) return false;
+				this->flush(out);
+				out << s << std::endl;
+				v_[which] = s;
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  begin, end, open
+			 *
+			 *  begin() writes BT unless a text object is open, and end()
+			 *  writes the pending strings and ET if a text object is
+			 *  open. open() tells that the caller has written BT.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			bool begin(OutStream& out) {
+				if (open_) return false;
+				out << LITERAL("BT") << std::endl;
+				this->open();
+				return true;
+			}
+			
+			template <class OutStream>
+			bool end(OutStream& out) {
+				this->flush(out);
+				if (!open_) return false;
+				out << LITERAL("ET") << std::endl;
+				open_ = false;
+				return true;
+			}
+			
+			void open() {
+				if (open_) return;
+				open_ = true;
+				this->xidentity();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  save, restore
+			 *
+			 *  Write q/Q (ending the text object, where they are not
+			 *  allowed) and save/restore the state operators with them.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			bool save(OutStream& out) {
+				this->end(out);
+				out << LITERAL("q") << std::endl;
+				stack_.push_back(std::vector<string_type>(v_, v_ + last));
+				return true;
+			}
+			
+			template <class OutStream>
+			bool restore(OutStream& out) {
+				this->end(out);
+				out << LITERAL("Q") << std::endl;
+				if (stack_.empty()) this->invalidate();
+				else {
+					std::copy(stack_.back().begin(), stack_.back().end(), v_);
+					stack_.pop_back();
+				}
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  matrix
+			 *
+			 *  Sets the text matrix to [a b c d e f]. If only the
+			 *  translation differs from the current line matrix and the
+			 *  matrix has no scaling, the relative Td is written instead
+			 *  of Tm, i.e., (e, f) = (tx + ty * c + e0, ty + f0).
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			bool matrix(OutStream& out, double a, double b, double c, double d, double e, double f) {
+				this->flush(out);
+				if (a == 1.0 && b == 0.0 && d == 1.0 && a == m_[0] && b == m_[1] && c == m_[2] && d == m_[3]) {
+					double ty = f - m_[5];
+					double tx = e - m_[4] - ty * c;
+					out << fmt(LITERAL("%f %f Td")) % tx % ty << std::endl;
+				}
+				else {
+					out << fmt(LITERAL("%f %f %f %f %f %f Tm")) % a % b % c % d % e % f << std::endl;
+				}
+				m_[0] = a; m_[1] = b; m_[2] = c; m_[3] = d; m_[4] = e; m_[5] = f;
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  show
+			 *
+			 *  Shows the string s at (x, y). (a, b, c, d) is the first four
+			 *  elements of the text matrix, advance is the width of s in
+			 *  the user space (including Tc and Tz), and unit is the user
+			 *  space width of the TJ adjustment 1 (font size * Tz / 1000).
+			 *  If the pending strings end on the same baseline with the
+			 *  same matrix and unit, s is appended to them with the
+			 *  adjustment of the gap instead of moving the text matrix
+			 *  (or to the last string if there is no gap).
+			 *  The second form shows s at the matrix set by matrix().
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			bool show(OutStream& out, double a, double b, double c, double d,
+				double x, double y, const string_type& s, double advance, double unit) {
+				if (!runs_.empty() && unit > 0.0 && unit == unit_ &&
+					a == m_[0] && b == m_[1] && c == m_[2] && d == m_[3] && std::abs(y - y_) < 0.001) {
+					double adjust = (x_ - x) / unit;
+					if (std::abs(adjust) < 0.01) runs_.back().second += s;
+					else runs_.push_back(run_type(adjust, s));
+				}
+				else {
+					this->matrix(out, a, b, c, d, x, y);
+					runs_.push_back(run_type(0.0, s));
+					y_ = y;
+					unit_ = unit;
+				}
+				x_ = x + advance;
+				return true;
+			}
+			
+			template <class OutStream>
+			bool show(OutStream& out, const string_type& s) {
+				this->flush(out);
+				runs_.push_back(run_type(0.0, s));
+				unit_ = 0.0;
+				return true;
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  flush
+			 *
+			 *  Writes the pending strings with the Tj operator (one string)
+			 *  or the TJ array (two or more strings with the position
+			 *  adjustments), and clears them.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class OutStream>
+			bool flush(OutStream& out) {
+				if (runs_.empty()) return true;
+				if (runs_.size() == 1) out << pdf_string(runs_.front().second) << LITERAL(" Tj") << std::endl;
+				else {
+					out << LITERAL("[");
+					for (size_type i = 0; i < runs_.size(); ++i) {
+						if (i > 0) out << fmt(LITERAL("%f ")) % runs_.at(i).first;
+						out << pdf_string(runs_.at(i).second);
+					}
+					out << LITERAL("] TJ") << std::endl;
+				}
+				runs_.clear();
+				return true;
+			}
+			
+		private:
+			typedef clx::basic_format<CharT, Traits> fmt;
+			typedef std::pair<double, string_type> run_type;
+			
+			string_type v_[last];
+			bool open_;
+			double m_[6];
+			std::vector<run_type> runs_;
+			double x_;
+			double y_;
+			double unit_;
+			std::vector<std::vector<string_type> > stack_;
+			
+			void xidentity() {
+				m_[0] = 1.0; m_[1] = 0.0; m_[2] = 0.0;
+				m_[3] = 1.0; m_[4] = 0.0; m_[5] = 0.0;
+			}
+		};
+	}
+}
+
+#endif // FAML_PDF_TEXT_STATE_H
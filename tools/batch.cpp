@@ -0,0 +1,175 @@
+/* ------------------------------------------------------------------------- */
+/*
+ *  tools/batch.cpp
+ *
+ *  Copyright (c) 2009, Four and More, Inc. All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *    - Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    - Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *    - No names of its contributors may be used to endorse or promote
+ *      products derived from this software without specific prior written
+ *      permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ *  TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  Last-modified: Mon 19 Oct 2026 10:00:00 JST
+ */
+/* ------------------------------------------------------------------------- */
+
+/* ------------------------------------------------------------------------- */
+/*
+ *  batch
+ *
+ *  The command line tool of basic_batch. Usage:
+ *
+ *    batch [-j workers] [-d dpi] [-r dpi] [-v version] [-f font] ... [file ...]
+ *
+ *  Each file (docx, pptx, or xlsx) is converted to the PDF file of the
+ *  same name. If no file is specified, the paths are read from stdin
+ *  (one path per line), e.g., "find . -name '*.docx' | batch -j 8".
+ *  -j is the number of the jobs run at once, which must be a positive
+ *  integer and is limited to the number of the online processors.
+ *  -d is the maximum resolution of the images, -r is the resolution
+ *  of the device at which the charts are decimated, and -f registers
+ *  the TrueType/AFM font file to the shared font factory.
+ *  The result of each job is written to stdout as one tab separated
+ *  line: status, input, output, pages, bytes, seconds, and message.
+ *  The exit status is 1 if any job failed. Build it from this
+ *  directory, e.g.:
+ *
+ *    g++ -O2 -DFAML_USE_ZLIB -I.. -I<clx> batch.cpp -o batch -lz
+ */
+/* ------------------------------------------------------------------------- */
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "batch.h"
+
+namespace {
+	typedef faml::pdf::batch batch_type;
+	typedef batch_type::result_type result_type;
+	
+	/* --------------------------------------------------------------------- */
+	/*
+	 *  report_iterator
+	 *
+	 *  Writes each result as soon as the job is finished, so that the
+	 *  progress of the long running batch can be watched.
+	 */
+	/* --------------------------------------------------------------------- */
+	class report_iterator : public std::iterator<std::output_iterator_tag, void, void, void, void> {
+	public:
+		report_iterator(std::ostream& out, size_t& failed) :
+			out_(&out), failed_(&failed) {}
+			
+		report_iterator& operator=(const result_type& r) {
+			if (!r.success) ++(*failed_);
+			*out_ << (r.success ? "ok" : "error")
+				<< '\t' << r.input << '\t' << r.output
+				<< '\t' << r.pages << '\t' << r.bytes
+				<< '\t' << r.seconds << '\t' << r.message << std::endl;
+			return *this;
+		}
+		
+		report_iterator& operator*() { return *this; }
+		report_iterator& operator++() { return *this; }
+		report_iterator& operator++(int) { return *this; }
+		
+	private:
+		std::ostream* out_;
+		size_t* failed_;
+	};
+	
+	/* --------------------------------------------------------------------- */
+	//  usage
+	/* --------------------------------------------------------------------- */
+	int usage(const char* name) {
+		std::cerr << "usage: " << name
+			<< " [-j workers] [-d dpi] [-r dpi] [-v version] [-f font] ... [file ...]" << std::endl;
+		return 2;
+	}
+	
+	/* --------------------------------------------------------------------- */
+	/*
+	 *  parse_workers
+	 *
+	 *  Converts the argument of -j. Returns false unless the whole
+	 *  argument is a positive integer. The number is limited to the
+	 *  number of the online processors, since each worker is a process.
+	 */
+	/* --------------------------------------------------------------------- */
+	bool parse_workers(const char* s, size_t& dest) {
+		char* last = NULL;
+		errno = 0;
+		long n = std::strtol(s, &last, 10);
+		if (last == s || *last != '\0' || errno == ERANGE || n <= 0) return false;
+		
+		long limit = ::sysconf(_SC_NPROCESSORS_ONLN);
+		if (limit <= 0) limit = 1;
+		dest = static_cast<size_t>(std::min(n, limit));
+		return true;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	batch_type conv;
+	std::vector<std::string> files;
+	
+	try {
+		for (int i = 1; i < argc; ++i) {
+			std::string opt(argv[i]);
+			if (opt == "-j" || opt == "-d" || opt == "-r" || opt == "-v" || opt == "-f") {
+				if (++i >= argc) return usage(argv[0]);
+				if (opt == "-j") {
+					size_t n = 0;
+					if (!parse_workers(argv[i], n)) return usage(argv[0]);
+					conv.workers(n);
+				}
+				else if (opt == "-d") conv.dpi(std::atof(argv[i]));
+				else if (opt == "-r") conv.resolution(std::atof(argv[i]));
+				else if (opt == "-v") conv.version(std::atof(argv[i]));
+				else conv.font().add(argv[i]);
+			}
+			else if (opt == "--") {
+				files.insert(files.end(), argv + i + 1, argv + argc);
+				break;
+			}
+			else if (!opt.empty() && opt.at(0) == '-') return usage(argv[0]);
+			else files.push_back(opt);
+		}
+	}
+	catch (std::exception& e) {
+		std::cerr << argv[0] << ": " << e.what() << std::endl;
+		return 2;
+	}
+	
+	size_t failed = 0;
+	report_iterator dest(std::cout, failed);
+	if (files.empty()) conv.run(std::cin, dest);
+	else conv.run(files.begin(), files.end(), dest);
+	return (failed > 0) ? 1 : 0;
+}
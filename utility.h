@@ -64,6 +64,102 @@ namespace faml {
 			return makelabel(tmp);
 		}
 		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  pdf_string
+		 *
+		 *  Returns the PDF literal string object, e.g., (abc), of the
+		 *  specified bytes. Parentheses and backslash are escaped, and
+		 *  CR/LF are written as \r and \n since the raw EOL characters
+		 *  in the string are normalized by PDF readers. Other bytes
+		 *  (including the binary UTF-16 code units) are written as is,
+		 *  so the literal string is never longer than the hexadecimal
+		 *  string, e.g., <616263>.
+		 */
+		/* ----------------------------------------------------------------- */
+		template <class Ch, class Tr>
+		inline std::basic_string<Ch, Tr> pdf_string(const std::basic_string<Ch, Tr>& s) {
+			typedef typename std::basic_string<Ch, Tr>::size_type size_type;
+			
+			std::basic_string<Ch, Tr> dest;
+			dest.reserve(s.size() + 2);
+			dest += '(';
+			for (size_type i = 0; i < s.size(); ++i) {
+				Ch c = s[i];
+				if (c == '\r') dest += "\\r";
+				else if (c == '\n') dest += "\\n";
+				else {
+					if (c == '(' || c == ')' || c == '\\') dest += '\\';
+					dest += c;
+				}
+			}
+			dest += ')';
+			return dest;
+		}
+		
+		/* ----------------------------------------------------------------- */
+		/*
+		 *  digest
+		 *
+		 *  The digest class computes two independent 64-bit hashes
+		 *  (FNV-1a and a multiply-xorshift hash) and counts the bytes
+		 *  of the data. The caches use it as the key instead of the
+		 *  data itself, so that they need not keep the data (the
+		 *  chance that different data give the same digest is
+		 *  negligible, though it is not a cryptographic hash).
+		 */
+		/* ----------------------------------------------------------------- */
+		class digest {
+		public:
+			typedef unsigned long long value_type;
+			typedef size_t size_type;
+			
+			digest() : first_(14695981039346656037ULL), second_(0x9e3779b97f4a7c15ULL), size_(0) {}
+			
+			template <class InputIterator>
+			digest(InputIterator first, InputIterator last) :
+				first_(14695981039346656037ULL), second_(0x9e3779b97f4a7c15ULL), size_(0) {
+				this->update(first, last);
+			}
+			
+			template <class InputIterator>
+			digest& update(InputIterator first, InputIterator last) {
+				for (; first != last; ++first) this->xupdate(static_cast<unsigned char>(*first));
+				return *this;
+			}
+			
+			digest& update(value_type x) {
+				for (int i = 0; i < 8; ++i, x >>= 8) this->xupdate(static_cast<unsigned char>(x & 0xff));
+				return *this;
+			}
+			
+			size_type size() const { return size_; }
+			
+			bool operator==(const digest& x) const {
+				return first_ == x.first_ && second_ == x.second_ && size_ == x.size_;
+			}
+			
+			bool operator!=(const digest& x) const { return !(*this == x); }
+			
+			bool operator<(const digest& x) const {
+				if (first_ != x.first_) return first_ < x.first_;
+				if (second_ != x.second_) return second_ < x.second_;
+				return size_ < x.size_;
+			}
+			
+		private:
+			value_type first_;
+			value_type second_;
+			size_type size_;
+			
+			void xupdate(unsigned char c) {
+				first_ = (first_ ^ c) * 1099511628211ULL;
+				second_ = (second_ + c + 1) * 0xff51afd7ed558ccdULL;
+				second_ ^= second_ >> 29;
+				++size_;
+			}
+		};
+		
 		/* ----------------------------------------------------------------- */
 		/*
 		 *  is_half
@@ -18,6 +18,7 @@
 #include "clx/format.h"
 #include "page.h"
 #include "page_property.h"
+#include "profile.h"
 #include "font.h"
 #include "text_contents.h"
 #include "contents/wmf.h"
@@ -56,6 +57,7 @@ namespace faml {
 				if (!font_(out, pm)) return false;
 				if (!fontj_(out, pm)) return false;
 				
+				scoped_phase<PDFManager> phase(pm, "metafile");
 				this->xproperty();
 				page_type newpage(page_);
 				this->xresources(out, pm);
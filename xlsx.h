@@ -51,6 +51,8 @@
 #include "clx/format.h"
 #include "clx/shared_ptr.h"
 #include "clx/tokenizer.h"
+#include "clx/utility.h"
+#include "clx/vstream.h"
 
 #include "unit.h"
 #include "code_convert.h"
@@ -59,9 +61,14 @@
 #include "font.h"
 #include "font_instance.h"
 #include "text_helper.h"
+#include "resample.h"
+#include "profile.h"
+#include "shape_cache.h"
+#include "font_factory.h"
 
 #include "contents/shape_factory.h"
 #include "contents/custom_shape.h"
+#include "officex/preset.h"
 #include "contents/barchart.h"
 #include "contents/bar3dchart_box.h"
 #include "contents/bar3dchart_cylinder.h"
@@ -106,25 +113,104 @@ namespace faml {
 			typedef basic_font<CharT, Traits> font_object;
 			typedef std::map<string_type, font_object> font_map;
 			
+			typedef faml::xlsx::basic_document<CharT, Traits> doc_type;
+			typedef faml::officex::basic_preset_geometry<CharT, Traits> preset_type;
+			typedef typename doc_type::storage_type storage_type;
+			
 			basic_xlsx(const string_type& path) :
-				doc_(path), in_(), pp_(a4::width, a4::height), f_(),
-				space_(3.6), vspace_(0.0), baseline_(1.2) {
-				this->xinit(path);
+				ff_(xfactory()), doc_(storage_type(path)), in_(), pp_(a4::width, a4::height), f_(),
+				space_(3.6), vspace_(0.0), baseline_(1.2), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  constructor
+			 *
+			 *  The following constructors read the xlsx data from the
+			 *  input stream, the memory buffer, or the file descriptor
+			 *  without creating any temporary file. The memory buffer is
+			 *  not copied, so it must be alive until the conversion is
+			 *  finished.
+			 */
+			/* ------------------------------------------------------------- */
+			explicit basic_xlsx(std::basic_istream<CharT, Traits>& in) :
+				ff_(xfactory()), doc_(storage_type(in)), in_(), pp_(a4::width, a4::height), f_(),
+				space_(3.6), vspace_(0.0), baseline_(1.2), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			basic_xlsx(const char_type* data, size_type n) :
+				ff_(xfactory()), doc_(storage_type(data, n)), in_(), pp_(a4::width, a4::height), f_(),
+				space_(3.6), vspace_(0.0), baseline_(1.2), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			explicit basic_xlsx(int fd) :
+				ff_(xfactory()), doc_(storage_type(fd)), in_(), pp_(a4::width, a4::height), f_(),
+				space_(3.6), vspace_(0.0), baseline_(1.2), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  constructor (with the font factory)
+			 *
+			 *  The fonts are created by ff, so the fonts registered to ff
+			 *  (and the properties read from them) are shared with the
+			 *  other documents. The other constructors use the empty
+			 *  factory, i.e., only the built-in fonts.
+			 */
+			/* ------------------------------------------------------------- */
+			basic_xlsx(const string_type& path, font_factory& ff) :
+				ff_(ff), doc_(storage_type(path)), in_(), pp_(a4::width, a4::height), f_(),
+				space_(3.6), vspace_(0.0), baseline_(1.2), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			basic_xlsx(std::basic_istream<CharT, Traits>& in, font_factory& ff) :
+				ff_(ff), doc_(storage_type(in)), in_(), pp_(a4::width, a4::height), f_(),
+				space_(3.6), vspace_(0.0), baseline_(1.2), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			basic_xlsx(const char_type* data, size_type n, font_factory& ff) :
+				ff_(ff), doc_(storage_type(data, n)), in_(), pp_(a4::width, a4::height), f_(),
+				space_(3.6), vspace_(0.0), baseline_(1.2), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
+			}
+			
+			basic_xlsx(int fd, font_factory& ff) :
+				ff_(ff), doc_(storage_type(fd)), in_(), pp_(a4::width, a4::height), f_(),
+				space_(3.6), vspace_(0.0), baseline_(1.2), dpi_(0.0), res_(0.0), presets_(NULL) {
+				this->xinit();
 			}
 			
 			template <class OutStream, class PDFManager>
 			bool operator()(OutStream& out, PDFManager& pm) {
 				// currently implementation
-				for (typename font_map::iterator pos = f_.begin(); pos != f_.end(); ++pos) {
-					(pos->second)(out, pm);
+				{
+					scoped_phase<PDFManager> phase(pm, "font");
+					for (typename font_map::iterator pos = f_.begin(); pos != f_.end(); ++pos) {
+						(pos->second)(out, pm);
+					}
+				}
+				
+				place_.clear();
+				if (dpi_ > 0.0) {
+					for (size_type i = 0; i < doc_.size(); ++i) this->xplacement(doc_.at(i).drawings());
 				}
 				
 				for (size_type i = 0; i < doc_.size(); ++i) {
 					if (doc_.at(i).empty()) continue; // empty worksheet.
+					scoped_page<PDFManager> timer(pm);
 					this->xadjust_size(doc_.at(i));
 					page_object newpage(pp_);
 					
-					if (!doc_.at(i).drawings().empty()) this->xobjects(out, pm, doc_.at(i).drawings());
+					if (!doc_.at(i).drawings().empty()) {
+						scoped_phase<PDFManager> phase(pm, "image");
+						this->xobjects(out, pm, doc_.at(i).drawings());
+					}
 					
 					int idx = 0;
 					idx = this->xcontents(out, pm, doc_.at(i));
@@ -137,6 +223,12 @@ namespace faml {
 					newpage.contents(idx);
 					
 					if (!cur_.fonts.empty()) this->xput_font_objects(out, pm);
+					if (!dibs_.empty() && !dibs_(out, pm, cur_.objs)) {
+						throw std::runtime_error("error is occured in metafile bitmap resource.");
+					}
+					if (!shapes_.empty() && !shapes_(out, pm, cur_.objs)) {
+						throw std::runtime_error("error is occured in shape resource.");
+					}
 					idx = this->xresources(out, pm);
 					if (idx < 0) throw std::runtime_error("something was happened in the contents object");
 					newpage.resources(idx);
@@ -144,13 +236,59 @@ namespace faml {
 					if (!newpage(out, pm)) return false;
 				}
 				
+				// subsets of the embedded fonts are made from the used glyphs.
+				{
+					scoped_phase<PDFManager> phase(pm, "font");
+					for (typename font_map::iterator pos = f_.begin(); pos != f_.end(); ++pos) {
+						if (!(pos->second).finish(out, pm)) {
+							throw std::runtime_error("error is occured in font file resource.");
+						}
+					}
+				}
+				
 				return true;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  dpi
+			 *
+			 *  Sets the maximum resolution of the embedded images. Images
+			 *  whose resolution at the placed size exceeds the value are
+			 *  downsampled. The value 0 (default) disables downsampling.
+			 */
+			/* ------------------------------------------------------------- */
+			void dpi(double value) { dpi_ = value; }
+			double dpi() const { return dpi_; }
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  resolution
+			 *
+			 *  Sets the resolution (dpi) of the device the pages are
+			 *  rendered on. Dense series of line, area and scatter charts
+			 *  are decimated at the resolution, so the drawn points differ
+			 *  by at most one device pixel. The value 0 (default) draws
+			 *  all points.
+			 */
+			/* ------------------------------------------------------------- */
+			void resolution(double value) { res_ = value; }
+			double resolution() const { return res_; }
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  presets
+			 *
+			 *  Sets the preset geometry read from presetShapeDefinitions.xml.
+			 *  Preset shapes that contents/ does not implement are drawn
+			 *  with the definitions. The object must be alive until the
+			 *  conversion is finished.
+			 */
+			/* ------------------------------------------------------------- */
+			void presets(preset_type& cp) { presets_ = &cp; }
+			
 		private:
 			typedef clx::basic_format<CharT, Traits> fmt;
-			typedef clx::basic_unzip<CharT, Traits> storage_type;
-			typedef faml::xlsx::basic_document<CharT, Traits> doc_type;
 			typedef basic_font_property<CharT, Traits> font_property;
 			typedef basic_extpiece<CharT, Traits> piece_type;
 			
@@ -162,6 +300,7 @@ namespace faml {
 			typedef clx::shared_ptr<shape_contents> shape_ptr;
 			
 			// member variables
+			font_factory& ff_;
 			doc_type doc_;
 			storage_type in_;
 			page_property pp_;
@@ -169,6 +308,10 @@ namespace faml {
 			double space_;
 			double vspace_;
 			double baseline_;
+			double dpi_;
+			double res_;
+			preset_type* presets_;
+			basic_placement<CharT, Traits> place_;
 			
 			/* ------------------------------------------------------------- */
 			//  xobject
@@ -179,6 +322,30 @@ namespace faml {
 				string_type path;
 			};
 			std::map<string_type, xobj_type> objs_;
+			basic_dib_cache<CharT, Traits> dibs_; // bitmaps in metafiles
+			basic_shape_cache<CharT, Traits> shapes_; // shapes and chart markers painted repeatedly
+			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  sst_entry
+			 *
+			 *  The sst_entry structure keeps the shared string converted
+			 *  into UTF-16BE pieces, and the widths of the pieces (in the
+			 *  unit of font size) for each font that has been used to
+			 *  draw the string. Entries are shared by all cells that
+			 *  refer to the same shared string.
+			 */
+			/* ------------------------------------------------------------- */
+			typedef std::map<string_type, std::vector<double> > width_map;
+			
+			struct sst_entry {
+				std::vector<piece_type> v;
+				width_map widths;
+			};
+			
+			typedef std::pair<size_type, string_type> sst_key; // (index, text format)
+			std::map<sst_key, sst_entry> ssts_;
+			std::map<string_type, bool> textfmt_; // number format -> has "@" or not
 			
 			/* ------------------------------------------------------------- */
 			/*
@@ -206,23 +373,32 @@ namespace faml {
 			};
 			current_status cur_;
 			
+			/* ------------------------------------------------------------- */
+			//  xfactory
+			/* ------------------------------------------------------------- */
+			static font_factory& xfactory() {
+				static font_factory dest;
+				return dest;
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  xinit
 			/* ------------------------------------------------------------- */
-			void xinit(const string_type& path) {
+			void xinit() {
 				pp_.margin(page_margin(30));
 				string_type latin(LITERAL(XLSX_DEFAULT_LATIN));
 				string_type japan(LITERAL(XLSX_DEFAULT_JAPAN));
 				
-				font_object f(latin, charset::utf16);
-				font_object fj(japan, charset::utf16);
+				font_object f = ff_.create(latin, charset::utf16);
+				font_object fj = ff_.create(japan, charset::utf16);
 				
 				f_[latin] = f;
 				f_[japan] = fj;
 				cur_.fused.insert(latin);
 				cur_.fused.insert(japan);
 				
-				if (!in_.open(path)) throw std::runtime_error("cannot find xlsx file");
+				in_ = doc_.storage();
+				if (!in_.is_open()) throw std::runtime_error("cannot find xlsx file");
 			}
 			
 			/* ------------------------------------------------------------- */
@@ -235,6 +411,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager>
 			int xresources(OutStream& out, PDFManager& pm) {
+				scoped_phase<PDFManager> phase(pm, "resource");
 				int index = static_cast<int>(pm.newindex());
 				
 				string_type proc = LITERAL("/PDF /Text");
@@ -276,6 +453,21 @@ namespace faml {
 				return index;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xplacement
+			 *
+			 *  Collects the largest size at which each image is placed
+			 *  (the size is used to determine the resolution of images).
+			 */
+			/* ------------------------------------------------------------- */
+			template <class Source>
+			void xplacement(const Source& src) {
+				for (size_type i = 0; i < src.size(); ++i) {
+					place_.add(src.at(i).reference(), emu(src.at(i).width()), emu(src.at(i).height()));
+				}
+			}
+			
 			/* ------------------------------------------------------------- */
 			//  xobjects
 			/* ------------------------------------------------------------- */
@@ -296,14 +488,18 @@ namespace faml {
 					
 					xobj_type elem;
 					elem.path = pos->path();
+					double pw = 0.0, ph = 0.0;
+					place_.find(ref, pw, ph);
 					if (ext == LITERAL(".jpeg") || ext == LITERAL(".jpg")) {
 						jpeg_resource<CharT, Traits> jpeg(vs);
+						jpeg.downsample(dpi_, pw, ph);
 						if (!jpeg(out, pm)) throw std::runtime_error("error is occured in jpeg resource.");
 						elem.index = jpeg.index();
 						elem.label = jpeg.label();
 					}
 					else if (ext == LITERAL(".png")) {
 						png_resource<CharT, Traits> png(vs);
+						png.downsample(dpi_, pw, ph);
 						if (!png(out, pm)) throw std::runtime_error("error is occured in gif resource.");
 						elem.index = png.index();
 						elem.label = png.label();
@@ -321,6 +517,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager>
 			bool xput_font_objects(OutStream& out, PDFManager& pm) {
+				scoped_phase<PDFManager> phase(pm, "font");
 				for (typename font_map::iterator pos = cur_.fonts.begin();
 					pos != cur_.fonts.end(); ++pos) {
 					(pos->second)(out, pm);
@@ -340,6 +537,7 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class PDFManager, class WorkSheet>
 			int xcontents(OutStream& out, PDFManager& pm, const WorkSheet& src) {
+				scoped_phase<PDFManager> phase(pm, "contents");
 				//cur_.fused.clear();
 				std::basic_stringstream<CharT, Traits> ss;
 				string_type filter;
@@ -540,7 +738,7 @@ namespace faml {
 				
 				string_type name = st.font().latin();
 				if (f_.find(name) == f_.end()) {
-					font_object f(name, charset::utf16);
+					font_object f = ff_.create(name, charset::utf16);
 					f_[name] = f;
 					cur_.fonts[name] = f;
 					cur_.fused.insert(name);
@@ -561,6 +759,7 @@ namespace faml {
 #else
 				text_helper h(f_[name].property(), charset::utf16);
 #endif
+				typename text_contents::state_type ts;
 				
 				double x = cur_.x + space_;
 				size_type i = 0;
@@ -578,10 +777,11 @@ namespace faml {
 					
 					//text_contents txt(tmp, coordinate(x, y), f_[latin], f_[japan], false);
 					text_contents txt(tmp, coordinate(x, y), f_[name], false);
+					txt.state(ts);
 					txt.font_size(hs);
 					if (v.at(i).fill().is_valid()) txt.font_color(v.at(i).fill());
 					else txt.font_color(color(st.font().rgb()));
-					txt.decorate(v.at(i).decorate());
+					txt.decorate(v.at(i).decorate() | st.font().decorate());
 					txt(out);
 					
 					y -= size;
@@ -594,6 +794,7 @@ namespace faml {
 						hs = size * XLSX_FONT_SCALE;
 					}
 				}
+				ts.flush(out);
 				
 				return true;
 			}
@@ -602,15 +803,14 @@ namespace faml {
 			//  xmove_vpos
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class Container, class StyleT, class Helper>
-			double xmove_vpos(OutStream& out, const Container& v,
+			double xmove_vpos(OutStream& out, const Container& v, const std::vector<double>& ws,
 				const StyleT& st, Helper& h/*, Helper& hj*/) {
 				double height = 0.0;
 				double total = 0.0;
 				for (size_type i = 0; i < v.size(); ++i) {
 					double size = (v.at(i).size() > 0) ? v.at(i).size() : st.font().size();
 					double hs = size * XLSX_FONT_SCALE;
-					double w = this->xgetw(v.at(i).data().begin(), v.at(i).data().end(), h) * hs;
-					total += w;
+					total += ws.at(i) * hs;
 				}
 				
 				double width = cur_.width - 2.0 * space_;
@@ -630,17 +830,20 @@ namespace faml {
 					typename string_type::const_iterator newline = std::find(pos, v.at(i).data().end(), LITERAL('\n'));
 					while (total > width || newline != v.at(i).data().end()) {
 						double limit = width / hs * 1000.0;
-						string_type tmp;
-						h.getline(pos, v.at(i).data().end(), std::inserter(tmp, tmp.end()), limit);
+						size_type used = 0, lw = 0;
+						typename string_type::const_iterator next = h.breakline(pos, v.at(i).data().end(), limit, used, lw);
+						string_type tmp(pos, next);
+						pos = next;
 						
 						if (tmp.empty() && pos != v.at(i).data().end()) {
 							tmp += *pos;
 							++pos;
 							tmp += *pos;
 							++pos;
+							lw = h.width(tmp.begin(), tmp.end());
 						}
 						
-						total -= this->xgetw(tmp.begin(), tmp.end(), h) * hs;
+						total -= lw / 1000.0 * hs;
 						utf16::chomp(tmp);
 						
 						if (!tmp.empty()) {
@@ -678,7 +881,8 @@ namespace faml {
 			//  xputsst
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class Container, class StyleT>
-			bool xputsst(OutStream& out, const Container& v, const StyleT& st, size_type type, bool empty) {
+			bool xputsst(OutStream& out, const Container& v, const StyleT& st,
+				size_type type, bool empty, width_map* widths) {
 				if (v.empty()) return true;
 				if (st.rotate() == 90 || st.rotate() == 180 || st.rotate() == 255) {
 					return this->xputsst_vert(out, v, st);
@@ -686,26 +890,36 @@ namespace faml {
 				
 				string_type name = st.font().latin();
 				if (f_.find(name) == f_.end()) {
-					font_object f(name, charset::utf16);
+					font_object f = ff_.create(name, charset::utf16);
 					f_[name] = f;
 					cur_.fonts[name] = f;
 					cur_.fused.insert(name);
 				}
 				text_helper h(f_[name].property(), charset::utf16);
+				typename text_contents::state_type ts;
+				
+				// widths of the pieces (cached in the shared string entry).
+				std::vector<double> tmpw;
+				std::vector<double>& ws = widths ? (*widths)[name] : tmpw;
+				if (ws.size() != v.size()) {
+					ws.clear();
+					for (size_type i = 0; i < v.size(); ++i) {
+						ws.push_back(this->xgetw(v.at(i).data().begin(), v.at(i).data().end(), h));
+					}
+				}
 				
 				// Š̕vZD
 				double total = 0.0;
 				for (size_type i = 0; i < v.size(); ++i) {
 					double size = (v.at(i).size() > 0) ? v.at(i).size() : st.font().size();
 					double hs = size * XLSX_FONT_SCALE;
-					double w = this->xgetw(v.at(i).data().begin(), v.at(i).data().end(), h) * hs;
-					total += w;
+					total += ws.at(i) * hs;
 				}
 				
 				double x = cur_.x + space_;
 				
 				double width = cur_.width - 2.0 * space_;
-				double y = this->xmove_vpos(out, v, st, h);
+				double y = this->xmove_vpos(out, v, ws, st, h);
 				
 				size_type i = 0;
 				double size = (v.at(i).size() > 0) ? v.at(i).size() : st.font().size();
@@ -723,16 +937,19 @@ namespace faml {
 					typename string_type::const_iterator newline = std::find(pos, v.at(i).data().end(), LITERAL('\n'));
 					while (total > width || newline != v.at(i).data().end()) {
 						double limit = width / hs * 1000.0;
-						string_type tmp;
-						h.getline(pos, v.at(i).data().end(), std::inserter(tmp, tmp.end()), limit);
+						size_type used = 0, lw = 0;
+						typename string_type::const_iterator next = h.breakline(pos, v.at(i).data().end(), limit, used, lw);
+						string_type tmp(pos, next);
+						pos = next;
 						if (tmp.empty() && pos != v.at(i).data().end()) {
 							tmp += *pos;
 							++pos;
 							tmp += *pos;
 							++pos;
+							lw = h.width(tmp.begin(), tmp.end());
 						}
 						
-						total -= this->xgetw(tmp.begin(), tmp.end(), h) * hs;
+						total -= lw / 1000.0 * hs;
 						utf16::chomp(tmp);
 						
 						if (!tmp.empty()) {
@@ -744,10 +961,11 @@ namespace faml {
 							
 							double pad = (size - st.font().size()) / 2.0;
 							text_contents txt(tmp, coordinate(x, y + pad), f_[name], false);
+							txt.state(ts);
 							txt.font_size(hs);
 							if (v.at(i).fill().is_valid()) txt.font_color(v.at(i).fill());
 							else txt.font_color(color(st.font().rgb()));
-							txt.decorate(v.at(i).decorate());
+							txt.decorate(v.at(i).decorate() | st.font().decorate());
 							txt(out);
 							
 							y -= size * baseline_;
@@ -804,10 +1022,11 @@ namespace faml {
 					if (st.valign() == 0) pad = 0.0;
 					else if (st.valign() == 1) pad /= 2.0;
 					text_contents txt(tmp, coordinate(x, y + pad), f_[name], false);
+					txt.state(ts);
 					txt.font_size(hs);
 					if (v.at(i).fill().is_valid()) txt.font_color(v.at(i).fill());
 					else txt.font_color(color(st.font().rgb()));
-					txt.decorate(v.at(i).decorate());
+					txt.decorate(v.at(i).decorate() | st.font().decorate());
 					txt(out);
 					x += w;
 					++i;
@@ -816,6 +1035,7 @@ namespace faml {
 					size = (v.at(i).size() > 0) ? v.at(i).size() : st.font().size();
 					hs = size * XLSX_FONT_SCALE;
 				}
+				ts.flush(out);
 				
 				return true;
 			}
@@ -825,11 +1045,12 @@ namespace faml {
 			/* ------------------------------------------------------------- */
 			template <class OutStream, class Type, class StyleT>
 			bool xputcell(OutStream& out, const Type& data, const StyleT& st, bool empty) {
+				scoped_timer timer("text");
 				string_type latin;
 				string_type japan;
 				string_type name = st.font().latin();
 				if (f_.find(name) == f_.end()) {
-					font_object f(name, charset::utf16);
+					font_object f = ff_.create(name, charset::utf16);
 					f_[name] = f;
 					cur_.fonts[name] = f;
 					cur_.fused.insert(name);
@@ -850,11 +1071,15 @@ namespace faml {
 				// 1. split string.
 				double size = st.font().size();
 				//double limit = (cur_.width - (space_ + 2.0) * 2.0) / size * 1000.0;
-				std::vector<string_type> v;
+				if ((data.type() & Type::sst)) {
+					sst_entry& elem = this->xsst(static_cast<size_type>(data.data()), st);
+					return this->xputsst(out, elem.v, st, data.type(), empty, &elem.widths);
+				}
+				
 				std::vector<piece_type> ssts;
 				string_type s = this->xgets(data, st,
 					static_cast<size_type>((cur_.width - space_ * 2.0) / (size * 0.6)), ssts);
-				if (!ssts.empty()) return this->xputsst(out, ssts, st, data.type(), empty);
+				if (!ssts.empty()) return this->xputsst(out, ssts, st, data.type(), empty, NULL);
 				
 				return true;
 			}
@@ -894,7 +1119,15 @@ namespace faml {
 						dynamic_cast<contents::basic_custom_shape<paths_type>* >(
 							sh.get())->paths(src.drawings().at(i).paths());
 					}
-					else sh = contents::makeshape(src.drawings().at(i).name(), coordinate(x, y), w, h);
+					else {
+						sh = contents::makeshape(src.drawings().at(i).name(), coordinate(x, y), w, h);
+						const paths_type* paths = NULL;
+						if (!sh && presets_ &&
+							(paths = presets_->find(src.drawings().at(i).name(), src.drawings().at(i).adjusts(), w, h))) {
+							sh = shape_ptr(new contents::basic_custom_shape<paths_type>(coordinate(x, y), w, h));
+							dynamic_cast<contents::basic_custom_shape<paths_type>* >(sh.get())->paths(*paths);
+						}
+					}
 					if (!sh) continue;
 					
 					if (src.drawings().at(i).name() == LITERAL("line")) {
@@ -926,7 +1159,7 @@ namespace faml {
 						pos != src.drawings().at(i).effects().end(); ++pos) {
 						sh->effect(pos->first, pos->second);
 					}
-					(*sh)(out);
+					shapes_.put(out, *sh);
 					
 					// put textbox.
 					this->xput_shape_text(out, src.drawings().at(i));
@@ -1051,7 +1284,7 @@ namespace faml {
 				for (size_type i = pos; i < src.size(); ++i) {
 					string_type latin = src.at(i).font().latin();
 					if (f_.find(latin) == f_.end()) {
-						font_object f(latin, charset::utf16);
+						font_object f = ff_.create(latin, charset::utf16);
 						f_[latin] = f;
 						cur_.fonts[latin] = f;
 						cur_.fused.insert(latin);
@@ -1060,16 +1293,14 @@ namespace faml {
 					
 					string_type japan = src.at(i).font().japan();
 					if (f_.find(japan) == f_.end()) {
-						font_object f(japan, charset::utf16);
+						font_object f = ff_.create(japan, charset::utf16);
 						f_[japan] = f;
 						cur_.fonts[japan] = f;
 						cur_.fused.insert(japan);
 					}
 					text_helper hj(f_[japan].property(), charset::utf16);
 					
-					std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(src.at(i).data());
-					//string_type s = win32conv(tmp.begin(), tmp.end());
-					string_type s = to_narrow(tmp.begin(), tmp.end());
+					string_type s = src.at(i).utf16();
 					bool newline = false;
 					if (s.size() >= 2 && s.at(s.size() - 2) == 0x00 &&
 						(s.at(s.size() - 1) == 0x0a || s.at(s.size() - 1) == 0x0d || s.at(s.size() - 1) == 0x0c)) {
@@ -1122,7 +1353,7 @@ namespace faml {
 				//string_type latin = src.at(pos).font().latin();
 				string_type latin = XLSX_DEFAULT_LATIN;
 				if (f_.find(latin) == f_.end()) {
-					font_object f(latin, charset::utf16);
+					font_object f = ff_.create(latin, charset::utf16);
 					f_[latin] = f;
 					cur_.fonts[latin] = f;
 					cur_.fused.insert(latin);
@@ -1132,15 +1363,13 @@ namespace faml {
 				//string_type japan = src.at(pos).font().japan();
 				string_type japan = XLSX_DEFAULT_JAPAN;
 				if (f_.find(japan) == f_.end()) {
-					font_object f(japan, charset::utf16);
+					font_object f = ff_.create(japan, charset::utf16);
 					f_[japan] = f;
 					cur_.fonts[japan] = f;
 					cur_.fused.insert(japan);
 				}
 				text_helper hj(f_[japan].property(), charset::utf16);
-				std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(src.at(pos).data());
-				//string_type s = win32conv(tmp.begin(), tmp.end());
-				string_type s = to_narrow(tmp.begin(), tmp.end());
+				string_type s = src.at(pos).utf16();
 				
 				typename string_type::iterator it = s.begin();
 				
@@ -1162,10 +1391,11 @@ namespace faml {
 						limit = static_cast<int>(width / size * 1000);
 					}
 					
-					if (is_ascii(it, s.end(), charset::utf16)) {
-						h.getline(it, s.end(), std::inserter(line, line.end()), limit, false);
-					}
-					else hj.getline(it, s.end(), std::inserter(line, line.end()), limit, false);
+					text_helper& hl = is_ascii(it, s.end(), charset::utf16) ? h : hj;
+					size_type used = 0, lw = 0;
+					typename string_type::iterator next = hl.breakline(it, s.end(), limit, used, lw, false);
+					line.assign(it, next);
+					it = next;
 					
 					if (line.empty()) {
 						if (it != s.end()) {
@@ -1173,13 +1403,12 @@ namespace faml {
 							++it;
 							line += *it;
 							++it;
+							lw = hl.width(line.begin(), line.end());
 						}
 						else break;
 					}
 					
-					double n = (is_ascii(line.begin(), line.end(), charset::utf16))
-						? h.width(line.begin(), line.end()) / 1000.0
-						: hj.width(line.begin(), line.end()) / 1000.0;
+					double n = lw / 1000.0;
 					double sp = width - n * size;
 					size_type rgb = src.at(pos).font().rgb();
 					if (rgb > 0x00ffffff) rgb = 0;
@@ -1237,9 +1466,8 @@ namespace faml {
 					if (pos == in_.end()) throw std::runtime_error("cannot find image file");
 					std::vector<char_type> s;
 					clx::read(*pos, s);
-					clx::basic_ivstream<CharT, Traits> vs(s);
-					
-					contents::basic_wmf<CharT, Traits> wmf(vs);
+					if (s.empty()) throw std::runtime_error("empty metafile");
+					contents::basic_wmf<CharT, Traits> wmf(&s[0], s.size());
 					try {
 						wmf.read_header();
 					}
@@ -1249,6 +1477,7 @@ namespace faml {
 					wmf.height(cur_.height);
 					wmf.font1st(f_[XLSX_DEFAULT_LATIN]);
 					wmf.font2nd(f_[XLSX_DEFAULT_JAPAN]);
+					wmf.images(dibs_);
 					wmf(out);
 				}
 				else if (ext == LITERAL(".emf")) {
@@ -1256,9 +1485,8 @@ namespace faml {
 					if (pos == in_.end()) throw std::runtime_error("cannot find image file");
 					std::vector<char_type> s;
 					clx::read(*pos, s);
-					clx::basic_ivstream<CharT, Traits> vs(s);
-					
-					contents::basic_emf<CharT, Traits> emf(vs);
+					if (s.empty()) throw std::runtime_error("empty metafile");
+					contents::basic_emf<CharT, Traits> emf(&s[0], s.size());
 					try {
 						emf.read_header();
 					}
@@ -1296,6 +1524,8 @@ namespace faml {
 				case 2:
 				{
 					contents::linechart<chart_type> ch(coordinate(x, y), w, h);
+					ch.marks(shapes_);
+					ch.resolution(res_ / 72.0);
 					this->xputchart_exec(out, src, pos, ch);
 					break;
 				}
@@ -1308,12 +1538,15 @@ namespace faml {
 				case 4:
 				{
 					contents::areachart<chart_type> ch(coordinate(x, y), w, h);
+					ch.resolution(res_ / 72.0);
 					this->xputchart_exec(out, src, pos, ch);
 					break;
 				}
 				case 5:
 				{
 					contents::scatterchart<chart_type> ch(coordinate(x, y), w, h);
+					ch.marks(shapes_);
+					ch.resolution(res_ / 72.0);
 					this->xputchart_exec(out, src, pos, ch);
 					break;
 				}
@@ -1412,37 +1645,21 @@ namespace faml {
 			}
 			
 			/* ------------------------------------------------------------- */
-			//  xsplit
+			/*
+			 *  xsplit
+			 *
+			 *  Splits the UTF-16BE string into pieces at the boundaries
+			 *  of ASCII/non-ASCII characters. The boundaries (runs) are
+			 *  the ones given by utf8_to_utf16be().
+			 */
 			/* ------------------------------------------------------------- */
 			template <class Container, class StyleT>
-			bool xsplit(const string_type& src, Container& dest, const StyleT& st, size_type rgb) {
-				typename string_type::const_iterator pos = src.begin();
-				bool ascii = is_ascii(pos, src.end(), charset::utf16);
-				string_type s;
-				while (pos != src.end()) {
-					if (ascii != is_ascii(pos, src.end(), charset::utf16)) {
-						piece_type elem;
-						elem.data(s);
-						elem.size(st.font().size());
-						elem.decorate(st.font().decorate());
-						if (rgb <= 0x00ffffff) elem.fill(color(rgb));
-						else elem.fill(color(st.font().rgb()));
-						dest.push_back(elem);
-						s.erase();
-						ascii = !ascii;
-					}
-					else {
-						s += *pos;
-						++pos;
-						if (pos == src.end()) break;
-						s += *pos;
-						++pos;
-					}
-				}
-				
-				if (!s.empty()) {
+			bool xsplit(const string_type& src, const std::vector<size_type>& runs,
+				Container& dest, const StyleT& st, size_type rgb) {
+				for (size_type i = 0; i < runs.size(); ++i) {
+					size_type last = (i + 1 < runs.size()) ? runs.at(i + 1) : src.size();
 					piece_type elem;
-					elem.data(s);
+					elem.data(src.substr(runs.at(i), last - runs.at(i)));
 					elem.size(st.font().size());
 					elem.decorate(st.font().decorate());
 					if (rgb <= 0x00ffffff) elem.fill(color(rgb));
@@ -1475,38 +1692,51 @@ namespace faml {
 						}
 						if (pos < dest.size() - 1) dest.erase(pos);
 					}
-					std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(dest);
-					//dest = win32conv(tmp.begin(), tmp.end());
-					dest = to_narrow(tmp.begin(), tmp.end());
-					this->xsplit(dest, v, st, fill);
-				}
-				else if ((data.type() & Type::sst)) {
-					int index = static_cast<int>(data.data());
-					for (size_type i = 0; i < doc_.sst().at(index).size(); ++i) {
-						piece_type elem(doc_.sst().at(index).at(i));
-						clx::escape_separator<char_type> sep(LITERAL(";"), LITERAL("\""), LITERAL("\\"));
-						clx::basic_tokenizer<clx::escape_separator<char_type>, string_type> tok(st.numfmt(), sep);
-						string_type s;
-						if (!tok.empty() && tok.at(0).find(LITERAL("@")) != string_type::npos) {
-							faml::xlsx::format(s, st.numfmt(), elem.data());
-						}
-						else s = elem.data();
-						
-						std::basic_string<wchar_t> tmp = babel::utf8_to_unicode(s);
-						s = to_narrow(tmp.begin(), tmp.end());
-						elem.data(s);
-						if (doc_.sst().at(index).at(i).size() > 0.0) elem.size(doc_.sst().at(index).at(i).size());
-						else elem.size(st.font().size());
-						elem.decorate(doc_.sst().at(index).at(i).decorate() | st.font().decorate());
-						if (!elem.fill().is_valid()) elem.fill(color(st.font().rgb()));
-						v.push_back(elem);
-						dest += s;
-					}
+					std::vector<size_type> runs;
+					dest = utf8_to_utf16be(dest, &runs);
+					this->xsplit(dest, runs, v, st, fill);
 				}
 				
 				return dest;
 			}
 			
+			/* ------------------------------------------------------------- */
+			/*
+			 *  xsst
+			 *
+			 *  Returns the shared string of the specified index. The
+			 *  string is converted at the first reference (for each text
+			 *  format, i.e., the number format that contains "@"). The
+			 *  size, decoration, and color of the cell style are applied
+			 *  when drawing, so they are not kept in the entry.
+			 */
+			/* ------------------------------------------------------------- */
+			template <class StyleT>
+			sst_entry& xsst(size_type index, const StyleT& st) {
+				typename std::map<string_type, bool>::iterator it = textfmt_.find(st.numfmt());
+				if (it == textfmt_.end()) {
+					clx::escape_separator<char_type> sep(LITERAL(";"), LITERAL("\""), LITERAL("\\"));
+					clx::basic_tokenizer<clx::escape_separator<char_type>, string_type> tok(st.numfmt(), sep);
+					bool text = !tok.empty() && tok.at(0).find(LITERAL("@")) != string_type::npos;
+					it = textfmt_.insert(std::make_pair(st.numfmt(), text)).first;
+				}
+				
+				sst_key key(index, it->second ? st.numfmt() : string_type());
+				typename std::map<sst_key, sst_entry>::iterator pos = ssts_.find(key);
+				if (pos != ssts_.end()) return pos->second;
+				
+				sst_entry& dest = ssts_[key];
+				for (size_type i = 0; i < doc_.sst().at(index).size(); ++i) {
+					piece_type elem(doc_.sst().at(index).at(i));
+					string_type s;
+					if (it->second) faml::xlsx::format(s, st.numfmt(), elem.data());
+					else s = elem.data();
+					elem.data(utf8_to_utf16be(s));
+					dest.v.push_back(elem);
+				}
+				return dest;
+			}
+			
 			/* ------------------------------------------------------------- */
 			/*
 			 *  xgetwidth
@@ -39,7 +39,9 @@
 #include <string>
 #include <vector>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
 #include "clx/tokenizer.h"
@@ -155,7 +157,7 @@ namespace faml {
 				if (!pos) throw std::runtime_error("cannot find <c:ptCount> tag");
 				attr_ptr attr = pos->first_attribute(LITERAL("val"));
 				if (!attr && attr->value_size() == 0) throw std::runtime_error("cannot find val attribute");
-				size_type count = clx::lexical_cast<size_type>(attr->value());
+				size_type count = officex::number_cast<size_type>(attr->value());
 				if (count == 0) return this->xread_from_reference(root);
 				data_.resize(count, 0);
 				
@@ -163,9 +165,9 @@ namespace faml {
 					if (string_type(child->name()) != LITERAL("c:pt")) continue;
 					attr = child->first_attribute(LITERAL("idx"));
 					if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find idx attribute");
-					size_type idx = clx::lexical_cast<size_type>(attr->value());
+					size_type idx = officex::number_cast<size_type>(attr->value());
 					pos = child->first_node(LITERAL("c:v"));
-					if (pos && pos->value_size() > 0) data_.at(idx) = clx::lexical_cast<value_type>(pos->value());
+					if (pos && pos->value_size() > 0) data_.at(idx) = officex::number_cast<value_type>(pos->value());
 				}
 				
 				return *this;
@@ -331,7 +333,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				node_ptr root = doc.first_node(LITERAL("c:chartSpace"));
 				if (!root) throw std::runtime_error("cannot find <c:chartSpace> (root) tag");
@@ -564,7 +569,7 @@ namespace faml {
 				if (!pos) throw std::runtime_error("cannot find <c:ptCount> tag");
 				attr_ptr attr = pos->first_attribute(LITERAL("val"));
 				if (!attr && attr->value_size() == 0) throw std::runtime_error("cannot find val attribute");
-				size_type n = clx::lexical_cast<size_type>(attr->value());
+				size_type n = officex::number_cast<size_type>(attr->value());
 				if (n == 0) return this->xread_label_from_reference(root, v);
 				label_.resize(n, string_type());
 				
@@ -572,7 +577,7 @@ namespace faml {
 					if (string_type(child->name()) != LITERAL("c:pt")) continue;
 					attr = child->first_attribute(LITERAL("idx"));
 					if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find idx attribute");
-					size_type idx = clx::lexical_cast<size_type>(attr->value());
+					size_type idx = officex::number_cast<size_type>(attr->value());
 					pos = child->first_node(LITERAL("c:v"));
 					if (pos && pos->value_size() > 0) label_.at(idx) = string_type(pos->value());
 				}
@@ -737,7 +742,7 @@ namespace faml {
 				node_ptr child = pos->first_node(LITERAL("c:majorUnit"));
 				if (child) {
 					attr_ptr attr = child->first_attribute(LITERAL("val"));
-					if (attr && attr->value_size() > 0) valax_.unit(clx::lexical_cast<double>(attr->value()));
+					if (attr && attr->value_size() > 0) valax_.unit(officex::number_cast<double>(attr->value()));
 				}
 				else valax_.unit(-1.0);
 				
@@ -760,13 +765,13 @@ namespace faml {
 				p2 = child->first_node(LITERAL("c:min"));
 				if (p2) {
 					attr_ptr attr = p2->first_attribute(LITERAL("val"));
-					if (attr && attr->value_size() > 0) valax_.min(clx::lexical_cast<double>(attr->value()));
+					if (attr && attr->value_size() > 0) valax_.min(officex::number_cast<double>(attr->value()));
 				}
 				
 				p2 = child->first_node(LITERAL("c:max"));
 				if (p2) {
 					attr_ptr attr = p2->first_attribute(LITERAL("val"));
-					if (attr && attr->value_size() > 0) valax_.max(clx::lexical_cast<double>(attr->value()));
+					if (attr && attr->value_size() > 0) valax_.max(officex::number_cast<double>(attr->value()));
 				}
 				
 				return *this;
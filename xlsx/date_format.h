@@ -8,6 +8,7 @@
 #include "clx/literal.h"
 #include "clx/predicate.h"
 #include "clx/date_time.h"
+#include "../officex/number.h"
 
 namespace faml {
 	namespace xlsx {
@@ -89,7 +90,7 @@ namespace faml {
 							if (last != string_type::npos && last + 1 < fmt.size()) ++last;
 							sys.erase(0, last);
 							try { // $-F800 と $-F400 は特殊コード．
-								size_t lang = clx::lexical_cast<size_t>(sys, std::ios::hex);
+								size_t lang = officex::number_cast<size_t>(sys, std::ios::hex);
 								if (lang == 0xf800) {
 									ss << clx::basic_format<Ch, Tr>(LITERAL("%d年%d月%d日")) %
 										t.year() % t.month() % t.day();
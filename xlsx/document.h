@@ -37,10 +37,11 @@
 
 #include <string>
 #include <vector>
-#include "clx/unzip.h"
 #include "clx/literal.h"
+#include "clx/utility.h"
 #include "clx/shared_ptr.h"
 #include "rapidxml/rapidxml.hpp"
+#include "../officex/archive.h"
 #include "../officex/theme.h"
 #include "../officex/reference.h"
 #include "worksheet.h"
@@ -62,7 +63,7 @@ namespace faml {
 			typedef size_t size_type;
 			typedef CharT char_type;
 			typedef std::basic_string<CharT, Traits> string_type;
-			typedef clx::basic_unzip<CharT, Traits> storage_type;
+			typedef faml::officex::basic_archive<CharT, Traits> storage_type;
 			typedef basic_worksheet<CharT, Traits> worksheet;
 			typedef std::vector<worksheet> container;
 			typedef typename container::value_type value_type;
@@ -83,10 +84,20 @@ namespace faml {
 				this->read(path);
 			}
 			
+			explicit basic_document(const storage_type& in) :
+				in_(), v_(), styles_(), sst_(), theme_() {
+				this->read(in);
+			}
+			
 			virtual ~basic_document() throw() {}
 			
 			basic_document& read(const string_type& path) {
-				if (!in_.open(path)) throw std::runtime_error("cannot find input file");
+				return this->read(storage_type(path));
+			}
+			
+			basic_document& read(const storage_type& in) {
+				if (!in.is_open()) throw std::runtime_error("cannot find input file");
+				in_ = in;
 				
 				// 1. theme1.xml
 				typename storage_type::iterator pos = in_.find(LITERAL("xl/theme/theme1.xml"));
@@ -39,7 +39,9 @@
 #include <string>
 #include <vector>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
 #include "../coordinate.h"
@@ -86,7 +88,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				std::map<string_type, string_type> rels;
 				this->xread_rels(rels, dm);
@@ -192,7 +197,7 @@ namespace faml {
 				// x-axis
 				node_ptr pos = root->first_node(LITERAL("xdr:col"));
 				if (!pos || pos->value_size() == 0) throw std::runtime_error("cannot find <xdr:col> tag");
-				size_type idx = clx::lexical_cast<size_type>(pos->value());
+				size_type idx = officex::number_cast<size_type>(pos->value());
 				
 				x = 0.0;
 				for (size_type i = 0; i < idx; ++i) {
@@ -204,12 +209,12 @@ namespace faml {
 				//x *= (11.0 * 0.5 * 12700); // convert xls unit to emu.
 				pos = root->first_node(LITERAL("xdr:colOff"));
 				if (!pos || pos->value_size() == 0) throw std::runtime_error("cannot find <xdr:colOff> tag");
-				x += clx::lexical_cast<double>(pos->value());
+				x += officex::number_cast<double>(pos->value());
 				
 				// y-axis
 				pos = root->first_node(LITERAL("xdr:row"));
 				if (!pos || pos->value_size() == 0) throw std::runtime_error("cannot find <xdr:row> tag");
-				idx = clx::lexical_cast<size_type>(pos->value());
+				idx = officex::number_cast<size_type>(pos->value());
 				
 				y = 0.0;
 				for (size_type i = 0; i < idx; ++i) {
@@ -219,7 +224,7 @@ namespace faml {
 				y *= 12700; // convert pt to emu.
 				pos = root->first_node(LITERAL("xdr:rowOff"));
 				if (!pos || pos->value_size() == 0) throw std::runtime_error("cannot find <xdr:rowOff> tag");
-				y += clx::lexical_cast<double>(pos->value());
+				y += officex::number_cast<double>(pos->value());
 				
 				return *this;
 			}
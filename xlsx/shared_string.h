@@ -40,7 +40,9 @@
 #include <string>
 #include <vector>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
 #include "../piece.h"
@@ -88,7 +90,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				// parser OpenXML.
 				typedef rapidxml::xml_node<char_type>* node_ptr;
@@ -151,7 +156,7 @@ namespace faml {
 						tmp = pos->first_node(LITERAL("sz"));
 						if (tmp) {
 							attr_ptr attr = tmp->first_attribute(LITERAL("val"));
-							if (attr && attr->value_size() > 0) elem.size(clx::lexical_cast<double>(attr->value()));
+							if (attr && attr->value_size() > 0) elem.size(officex::number_cast<double>(attr->value()));
 						}
 						else elem.size(-1);
 						
@@ -159,7 +164,7 @@ namespace faml {
 						if (tmp) {
 							attr_ptr attr = tmp->first_attribute(LITERAL("rgb"));
 							if (attr && attr->value_size() > 0) {
-								size_type rgb = clx::lexical_cast<size_type>(attr->value(), std::ios::hex);
+								size_type rgb = officex::number_cast<size_type>(attr->value(), std::ios::hex);
 								elem.fill(color_type(rgb & 0x00ffffff));
 							}
 						}
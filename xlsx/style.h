@@ -40,7 +40,9 @@
 #include <vector>
 #include <map>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
 #include "../officex/utility.h"
@@ -245,7 +247,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				node_ptr root = doc.first_node(LITERAL("styleSheet"));
 				if (!root) throw std::runtime_error("cannot find <styleSheet> (root) tag");
 				
@@ -300,7 +305,7 @@ namespace faml {
 					size_type index = 0;
 					attr_ptr attr = child->first_attribute(LITERAL("numFmtId"));
 					if (attr && attr->value_size() > 0) {
-						index = clx::lexical_cast<size_type>(attr->value());
+						index = officex::number_cast<size_type>(attr->value());
 					}
 					
 					string_type s;
@@ -334,7 +339,7 @@ namespace faml {
 					pos = child->first_node(LITERAL("sz"));
 					if (pos) {
 						attr_ptr attr = pos->first_attribute(LITERAL("val"));
-						if (attr) elem.size(clx::lexical_cast<double>(attr->value()));
+						if (attr) elem.size(officex::number_cast<double>(attr->value()));
 					}
 					
 					// 3. font color
@@ -475,7 +480,7 @@ namespace faml {
 					value_type elem;
 					attr_ptr attr = child->first_attribute(LITERAL("xfId"));
 					if (!attr) throw std::runtime_error("cannot find xfId attribute");
-					size_type index = clx::lexical_cast<size_type>(attr->value());
+					size_type index = officex::number_cast<size_type>(attr->value());
 					//if (index >= masters_.size()) throw std::runtime_error("wrong xfId");
 					if (index < masters_.size()) elem = masters_.at(index);
 					this->xread_style(child, elem);
@@ -526,13 +531,13 @@ namespace faml {
 					attr = pos->first_attribute(LITERAL("wrapText"));
 					if (attr) dest.wrap(true);
 					attr = pos->first_attribute(LITERAL("textRotation"));
-					if (attr && attr->value_size() > 0) dest.rotate(clx::lexical_cast<size_type>(attr->value()));
+					if (attr && attr->value_size() > 0) dest.rotate(officex::number_cast<size_type>(attr->value()));
 				}
 				
 				// 2. format code
 				attr_ptr attr = root->first_attribute(LITERAL("numFmtId"));
 				if (attr && attr->value_size() > 0) {
-					size_type index = clx::lexical_cast<size_type>(attr->value());
+					size_type index = officex::number_cast<size_type>(attr->value());
 					string_type code;
 					if (formats_.find(index) != formats_.end()) code = formats_[index];
 					else format_code(code, index);
@@ -542,7 +547,7 @@ namespace faml {
 				// 3. font
 				attr = root->first_attribute(LITERAL("fontId"));
 				if (attr && attr->value_size() > 0) {
-					size_type index = clx::lexical_cast<size_type>(attr->value());
+					size_type index = officex::number_cast<size_type>(attr->value());
 					if (index >= fonts_.size()) throw std::runtime_error("wrong fontId");
 					dest.font(fonts_.at(index));
 				}
@@ -550,7 +555,7 @@ namespace faml {
 				// 4. fill color
 				attr = root->first_attribute(LITERAL("fillId"));
 				if (attr) {
-					size_type index = clx::lexical_cast<size_type>(attr->value());
+					size_type index = officex::number_cast<size_type>(attr->value());
 					if (index >= fills_.size()) throw std::runtime_error("wrong fontId");
 					dest.rgb(fills_.at(index));
 				}
@@ -558,7 +563,7 @@ namespace faml {
 				// 5. border
 				attr = root->first_attribute(LITERAL("borderId"));
 				if (attr) {
-					size_type index = clx::lexical_cast<size_type>(attr->value());
+					size_type index = officex::number_cast<size_type>(attr->value());
 					if (index >= borders_.size()) throw std::runtime_error("wrong fontId");
 					dest.border(borders_.at(index));
 				}
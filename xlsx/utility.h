@@ -39,6 +39,7 @@
 #include "rapidxml/rapidxml.hpp"
 #include "clx/literal.h"
 #include "../officex/color.h"
+#include "../officex/number.h"
 
 namespace faml {
 	namespace xlsx {
@@ -62,7 +63,7 @@ namespace faml {
 				}
 			}
 			
-			dest.first = clx::lexical_cast<size_t>(s.substr(i));
+			dest.first = officex::number_cast<size_t>(s.substr(i));
 			return dest;
 		}
 		
@@ -82,9 +83,9 @@ namespace faml {
 			if (!root) return 0;
 			size_t dest = 0;
 			attr_ptr attr = root->first_attribute(LITERAL("rgb"));
-			if (attr) dest = clx::lexical_cast<size_t>(attr->value(), std::ios::hex) & 0x00ffffff;
+			if (attr) dest = officex::number_cast<size_t>(attr->value(), std::ios::hex) & 0x00ffffff;
 			else if ((attr = root->first_attribute(LITERAL("indexed"))) != NULL) {
-				size_t pos = clx::lexical_cast<size_t>(attr->value());
+				size_t pos = officex::number_cast<size_t>(attr->value());
 				dest = faml::officex::indexedrgb(pos, 8);
 			}
 			
@@ -102,7 +103,7 @@ namespace faml {
 			size_t dest = 0;
 			attr_ptr attr = root->first_attribute(LITERAL("theme"));
 			if (attr) {
-				size_t pos = clx::lexical_cast<size_t>(attr->value());
+				size_t pos = officex::number_cast<size_t>(attr->value());
 				if (pos == 0) pos = 1;
 				else if (pos == 1) pos = 0;
 				if (pos < v.size()) dest = v.at(pos);
@@ -39,7 +39,9 @@
 #include <string>
 #include <vector>
 #include "rapidxml/rapidxml.hpp"
+#include "../profile.h"
 #include "clx/lexical_cast.h"
+#include "../officex/number.h"
 #include "clx/literal.h"
 #include "clx/utility.h"
 #include "cell.h"
@@ -88,22 +90,22 @@ namespace faml {
 					size_type l = 0;
 					attr_ptr attr = child->first_attribute(LITERAL("min"));
 					if (!attr || attr->value_size() == 0) continue;
-					l = clx::lexical_cast<size_type>(attr->value());
+					l = officex::number_cast<size_type>(attr->value());
 					
 					size_type u = 0;
 					attr = child->first_attribute(LITERAL("max"));
 					if (!attr || attr->value_size() == 0) continue;
-					u = clx::lexical_cast<size_type>(attr->value());
+					u = officex::number_cast<size_type>(attr->value());
 					
 					double w = 0.0;
 					attr = child->first_attribute(LITERAL("width"));
 					if (!attr || attr->value_size() == 0) continue;
-					w = clx::lexical_cast<double>(attr->value());
+					w = officex::number_cast<double>(attr->value());
 					
 					bool hidden = false;
 					attr = child->first_attribute(LITERAL("hidden"));
 					if (attr && attr->value_size() > 0) {
-						int val = clx::lexical_cast<int>(attr->value());
+						int val = officex::number_cast<int>(attr->value());
 						if (val > 0) hidden = true;
 					}
 					
@@ -268,7 +270,10 @@ namespace faml {
 				
 				//rapidxml::xml_document<char_type> doc; // <- ??? compile error!!
 				rapidxml::xml_document<char> doc;
-				doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				{
+					faml::pdf::scoped_timer timer("xml");
+					doc.parse<0>(reinterpret_cast<char_type*>(&s.at(0)));
+				}
 				
 				return this->xread_data(doc.first_node(LITERAL("worksheet")));
 			}
@@ -327,9 +332,9 @@ namespace faml {
 				width_ = 8.0,
 				height_ = 13.5;
 				attr_ptr attr = root->first_attribute(LITERAL("defaultColWidth"));
-				if (attr) width_ = clx::lexical_cast<double>(attr->value());
+				if (attr) width_ = officex::number_cast<double>(attr->value());
 				attr = root->first_attribute(LITERAL("defaultRowHeight"));
-				if (attr) height_ = clx::lexical_cast<double>(attr->value());
+				if (attr) height_ = officex::number_cast<double>(attr->value());
 				ws_.read(root->first_node(LITERAL("cols")));
 				widths_.insert(ws_.begin(), ws_.end());
 				
@@ -346,11 +351,11 @@ namespace faml {
 					size_type index = 0;
 					attr = child->first_attribute(LITERAL("r"));
 					if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find r attribute");
-					index = clx::lexical_cast<size_type>(attr->value());
+					index = officex::number_cast<size_type>(attr->value());
 					
 					attr = child->first_attribute(LITERAL("ht"));
 					if (attr && attr->value_size() > 0) {
-						h = clx::lexical_cast<double>(attr->value());
+						h = officex::number_cast<double>(attr->value());
 						heights_[index] = h;
 					}
 					this->xread_rowdata(child, elem, merge, h);
@@ -403,7 +408,7 @@ namespace faml {
 					}
 					
 					attr = child->first_attribute(LITERAL("s"));
-					if (attr && attr->value_size() > 0) elem.style(clx::lexical_cast<size_type>(attr->value()));
+					if (attr && attr->value_size() > 0) elem.style(officex::number_cast<size_type>(attr->value()));
 					else elem.style(0);
 					
 					node_ptr pos = child->first_node(LITERAL("v"));
@@ -416,14 +421,14 @@ namespace faml {
 						attr = child->first_attribute(LITERAL("t"));
 						if (attr && string_type(attr->value()) == LITERAL("s")) {
 							elem.type(value_type::sst | m);
-							elem.data(clx::lexical_cast<double>(pos->value()));
+							elem.data(officex::number_cast<double>(pos->value()));
 						}
 						else {
 							node_ptr sib = child->first_node(LITERAL("f"));
 							if (sib && sib->value_size() == 0) elem.type(value_type::empty | m);
 							else {
 								elem.type(value_type::value | m);
-								elem.data(clx::lexical_cast<double>(pos->value()));
+								elem.data(officex::number_cast<double>(pos->value()));
 							}
 						}
 					}
@@ -436,13 +441,13 @@ namespace faml {
 				
 				attr_ptr attr = root->first_attribute(LITERAL("r"));
 				if (!attr || attr->value_size() == 0) throw std::runtime_error("cannot find <row r>");
-				size_type row = clx::lexical_cast<size_type>(attr->value());
+				size_type row = officex::number_cast<size_type>(attr->value());
 				attr = root->first_attribute(LITERAL("spans"));
 				size_type idx = 0;
 				if (attr && attr->value_size() > 0) {
 					string_type tmp(attr->value());
 					tmp.erase(0, 2);
-					idx = clx::lexical_cast<size_type>(tmp);
+					idx = officex::number_cast<size_type>(tmp);
 				}
 				
 				while (i <= idx) {